@@ -256,15 +256,11 @@ DEEGEN_DEFINE_LIB_FUNC_CONTINUATION(base_load_continuation)
         {
             if (v.Is<tInt32>())
             {
-                char buf[x_default_tostring_buffersize_int];
-                StringifyInt32UsingDefaultLuaFormattingOptions(buf, v.As<tInt32>());
-                v = TValue::Create<tString>(vm->CreateStringObjectFromRawCString(buf));
+                v = TValue::Create<tString>(vm->CreateStringObjectFromInt32(v.As<tInt32>()).As());
             }
             else if (v.Is<tDouble>())
             {
-                char buf[x_default_tostring_buffersize_double];
-                StringifyDoubleUsingDefaultLuaFormattingOptions(buf, v.As<tDouble>());
-                v = TValue::Create<tString>(vm->CreateStringObjectFromRawCString(buf));
+                v = TValue::Create<tString>(vm->CreateStringObjectFromDouble(v.As<tDouble>()).As());
             }
             else
             {
@@ -553,7 +549,7 @@ static bool WARN_UNUSED HasNoExoticToStringMetamethodForStringType(VM* vm)
 // This function may only be called if both the 'IsGlobalToStringFunctionUnchanged' check and
 // the 'HasNoExoticToStringMetamethodForStringType' check have passed.
 //
-static bool WARN_UNUSED TryPrintUsingFastPath(VM* vm, FILE* fp, TValue tv)
+static bool WARN_UNUSED TryPrintUsingFastPath(VM* vm, VMOutputBuffer& out, TValue tv)
 {
     if (tv.Is<tDouble>())
     {
@@ -561,10 +557,7 @@ static bool WARN_UNUSED TryPrintUsingFastPath(VM* vm, FILE* fp, TValue tv)
         {
             return false;
         }
-        double dbl = tv.As<tDouble>();
-        char buf[x_default_tostring_buffersize_double];
-        StringifyDoubleUsingDefaultLuaFormattingOptions(buf /*out*/, dbl);
-        fprintf(fp, "%s", buf);
+        out.AppendDouble(tv.As<tDouble>());
         return true;
     }
 
@@ -577,7 +570,7 @@ static bool WARN_UNUSED TryPrintUsingFastPath(VM* vm, FILE* fp, TValue tv)
             {
                 return false;
             }
-            fprintf(fp, "nil");
+            out.Append("nil", 3);
         }
         else
         {
@@ -586,7 +579,7 @@ static bool WARN_UNUSED TryPrintUsingFastPath(VM* vm, FILE* fp, TValue tv)
             {
                 return false;
             }
-            fprintf(fp, "%s", (miv.GetBooleanValue() ? "true" : "false"));
+            out.Append(miv.GetBooleanValue() ? "true" : "false");
         }
         return true;
     }
@@ -597,7 +590,7 @@ static bool WARN_UNUSED TryPrintUsingFastPath(VM* vm, FILE* fp, TValue tv)
     if (ty == HeapEntityType::String)
     {
         HeapString* hs = reinterpret_cast<HeapString*>(p);
-        fwrite(hs->m_string, sizeof(char), hs->m_length /*length*/, fp);
+        out.Append(hs->m_string, hs->m_length);
         return true;
     }
 
@@ -607,7 +600,7 @@ static bool WARN_UNUSED TryPrintUsingFastPath(VM* vm, FILE* fp, TValue tv)
         {
             return false;
         }
-        fprintf(fp, "function: %p", static_cast<void*>(p));
+        out.AppendObjectAddress("function", p);
         return true;
     }
 
@@ -617,16 +610,19 @@ static bool WARN_UNUSED TryPrintUsingFastPath(VM* vm, FILE* fp, TValue tv)
         {
             return false;
         }
-        fprintf(fp, "thread: %p", static_cast<void*>(p));
+        out.AppendObjectAddress("thread", p);
         return true;
     }
 
     if (ty == HeapEntityType::Userdata)
     {
-        // TODO: support userdata
-        //
-        Assert(false && "unimplemented");
-        __builtin_unreachable();
+        HeapPtr<HeapCDataObject> ud = tv.As<tUserdata>();
+        if (unlikely(HeapCDataObject::GetMetatable(ud).m_value != 0))
+        {
+            return false;
+        }
+        out.AppendObjectAddress("userdata", HeapCDataObject::GetAddressForDisplay(ud));
+        return true;
     }
 
     Assert(ty == HeapEntityType::Table);
@@ -636,7 +632,7 @@ static bool WARN_UNUSED TryPrintUsingFastPath(VM* vm, FILE* fp, TValue tv)
     {
         return false;
     }
-    fprintf(fp, "table: %p", static_cast<void*>(p));
+    out.AppendObjectAddress("table", p);
     return true;
 }
 
@@ -648,7 +644,7 @@ DEEGEN_DEFINE_LIB_FUNC_CONTINUATION(base_print_continuation)
     }
 
     VM* vm = VM::GetActiveVMForCurrentThread();
-    FILE* fp = vm->GetStdout();
+    VMOutputBuffer& out = vm->GetStdoutBuffer();
 
     TValue valueToPrint = GetReturnValuesBegin()[0];
     // Print the value returned from the 'tostring' function
@@ -657,14 +653,11 @@ DEEGEN_DEFINE_LIB_FUNC_CONTINUATION(base_print_continuation)
     if (valueToPrint.Is<tString>())
     {
         HeapString* hs = TranslateToRawPointer(vm, valueToPrint.As<tString>());
-        fwrite(hs->m_string, sizeof(char), hs->m_length /*length*/, fp);
+        out.Append(hs->m_string, hs->m_length);
     }
     else if (valueToPrint.Is<tDouble>())
     {
-        double dbl = valueToPrint.As<tDouble>();
-        char buf[x_default_tostring_buffersize_double];
-        StringifyDoubleUsingDefaultLuaFormattingOptions(buf /*out*/, dbl);
-        fprintf(fp, "%s", buf);
+        out.AppendDouble(valueToPrint.As<tDouble>());
     }
     else
     {
@@ -682,11 +675,12 @@ DEEGEN_DEFINE_LIB_FUNC_CONTINUATION(base_print_continuation)
     Assert(0 < curElementToPrint && curElementToPrint <= numElementsToPrint);
     if (curElementToPrint == numElementsToPrint)
     {
-        fprintf(fp, "\n");
+        out.AppendChar('\n');
+        out.EndOfOperation();
         Return();
     }
 
-    fprintf(fp, "\t");
+    out.AppendChar('\t');
 
     // Having returned from a call (which can do anything), we need to re-validate the fast path conditions.
     // However, we should not lookup the global 'tostring' again. Instead we should retrieve its cached value
@@ -704,17 +698,18 @@ DEEGEN_DEFINE_LIB_FUNC_CONTINUATION(base_print_continuation)
 
     while (curElementToPrint < numElementsToPrint)
     {
-        if (unlikely(!TryPrintUsingFastPath(vm, fp, sb[curElementToPrint])))
+        if (unlikely(!TryPrintUsingFastPath(vm, out, sb[curElementToPrint])))
         {
             goto make_call_slowpath;
         }
         curElementToPrint++;
         if (curElementToPrint < numElementsToPrint)
         {
-            fprintf(fp, "\t");
+            out.AppendChar('\t');
         }
     }
-    fprintf(fp, "\n");
+    out.AppendChar('\n');
+    out.EndOfOperation();
     Return();
 
 make_call_slowpath:
@@ -760,12 +755,13 @@ make_call_slowpath:
 DEEGEN_DEFINE_LIB_FUNC(base_print)
 {
     VM* vm = VM::GetActiveVMForCurrentThread();
-    FILE* fp = vm->GetStdout();
+    VMOutputBuffer& out = vm->GetStdoutBuffer();
 
     size_t numArgs = GetNumArgs();
     if (numArgs == 0)
     {
-        fprintf(fp, "\n");
+        out.AppendChar('\n');
+        out.EndOfOperation();
         Return();
     }
 
@@ -785,15 +781,16 @@ DEEGEN_DEFINE_LIB_FUNC(base_print)
     {
         if (cur > 0)
         {
-            fprintf(fp, "\t");
+            out.AppendChar('\t');
         }
-        if (unlikely(!TryPrintUsingFastPath(vm, fp, GetArg(cur))))
+        if (unlikely(!TryPrintUsingFastPath(vm, out, GetArg(cur))))
         {
             goto make_call_slowpath;
         }
         cur++;
     }
-    fprintf(fp, "\n");
+    out.AppendChar('\n');
+    out.EndOfOperation();
     Return();
 
 make_call_slowpath:
@@ -1254,10 +1251,7 @@ static TValue WARN_UNUSED LuaDefaultStringifyValue(VM* vm, TValue value)
 {
     if (value.Is<tDouble>())
     {
-        double dbl = value.AsDouble();
-        char buf[x_default_tostring_buffersize_double];
-        StringifyDoubleUsingDefaultLuaFormattingOptions(buf /*out*/, dbl);
-        return TValue::Create<tString>(vm->CreateStringObjectFromRawCString(buf));
+        return TValue::Create<tString>(vm->CreateStringObjectFromDouble(value.AsDouble()).As());
     }
     else if (value.Is<tMIV>())
     {
@@ -1303,11 +1297,8 @@ static TValue WARN_UNUSED LuaDefaultStringifyValue(VM* vm, TValue value)
         }
         else
         {
-            // TODO: support userdata
-            //
             Assert(p->m_type == HeapEntityType::Userdata);
-            Assert(false && "unimplemented");
-            __builtin_unreachable();
+            sprintf(buf, "userdata: %p", HeapCDataObject::GetAddressForDisplay(value.As<tUserdata>()));
         }
 
         return TValue::Create<tString>(vm->CreateStringObjectFromRawCString(buf));
@@ -1501,10 +1492,15 @@ DEEGEN_DEFINE_LIB_FUNC(base_unpack)
 
     size_t numValues = static_cast<size_t>(ub - lb + 1);
 
+    TValue* sb = GetStackBase();
+    if (unlikely(!GetCurrentCoroutine()->TryEnsureStackSpace(sb, numValues + x_minNilFillReturnValues)))
+    {
+        ThrowError("too many results to unpack");
+    }
+
     GetByIntegerIndexICInfo info;
     TableObject::PrepareGetByIntegerIndex(tableObj, info /*out*/);
 
-    TValue* sb = GetStackBase();
     if (likely(info.m_isContinuous))
     {
         // Value exists iff index is in [1, endIdx]
@@ -1563,11 +1559,44 @@ DEEGEN_DEFINE_LIB_FUNC(base_gcinfo)
     ThrowError("Library function 'gcinfo' is not implemented yet!");
 }
 
+// The type tag of the userdata created by 'newproxy', which have no payload
+//
+struct NewProxyUserdataTypeTag { };
+
 // newproxy -- undocumented feature, removed in 5.2
 //
+// newproxy ([m])
+// Creates a zero-sized userdata. If 'm' is false or absent, the userdata has no metatable. If 'm' is true, the userdata gets a
+// new empty metatable. Otherwise, 'm' must be a proxy created by 'newproxy(true)', and the new userdata shares its metatable.
+//
 DEEGEN_DEFINE_LIB_FUNC(base_newproxy)
 {
-    ThrowError("Library function 'newproxy' is not implemented yet!");
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    uint64_t typeTag = GetUserdataTypeTag<NewProxyUserdataTypeTag>();
+    TValue arg = (GetNumArgs() > 0) ? GetArg(0) : TValue::Create<tNil>();
+    UserHeapPointer<void> metatable;
+    if (!arg.IsTruthy())
+    {
+        metatable = UserHeapPointer<void>();
+    }
+    else if (arg.Is<tBool>())
+    {
+        metatable = TableObject::CreateEmptyTableObject(vm, 0 /*inlineCapacity*/, 0 /*initialButterflyArrayPartCapacity*/);
+    }
+    else
+    {
+        if (unlikely(!arg.Is<tUserdata>()))
+        {
+            ThrowError("bad argument #1 to 'newproxy' (boolean or proxy expected)");
+        }
+        HeapPtr<HeapCDataObject> proxy = arg.As<tUserdata>();
+        metatable = HeapCDataObject::GetMetatable(proxy);
+        if (unlikely(proxy->m_typeTag != typeTag || metatable.m_value == 0))
+        {
+            ThrowError("bad argument #1 to 'newproxy' (boolean or proxy expected)");
+        }
+    }
+    Return(TValue::Create<tUserdata>(HeapCDataObject::Create(vm, 0 /*length*/, typeTag, metatable)));
 }
 
 DEEGEN_END_LIB_FUNC_DEFINITIONS
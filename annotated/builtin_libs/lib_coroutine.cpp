@@ -16,6 +16,14 @@ static void ALWAYS_INLINE MoveArgumentsForCoroutine(TValue* dst, const TValue* s
     }
 }
 
+// Make sure the stack of 'coro' has space for 'num' values passed to it at 'dst', plus the nil padding (see x_minNilFillReturnValues),
+// and the one extra slot that 'MoveArgumentsForCoroutine' may copy
+//
+static bool WARN_UNUSED ALWAYS_INLINE EnsureStackSpaceForCoroutineValues(CoroutineRuntimeContext* coro, TValue* dst, size_t num)
+{
+    return coro->TryEnsureStackSpace(dst, num + x_minNilFillReturnValues + 1);
+}
+
 // Internal function, invoked when the coroutine execution finished successfully without errors
 // This should render the current coroutine dead, transfer control to the parent coroutine, and pass around the return values.
 //
@@ -29,14 +37,28 @@ DEEGEN_DEFINE_LIB_FUNC_CONTINUATION(coro_finish)
     Assert(targetCoro != nullptr);
     Assert(!targetCoro->m_coroutineStatus.IsDead() && !targetCoro->m_coroutineStatus.IsResumable());
 
+    // Make sure the parent coroutine has stack space for the return values. If not, the error is thrown in the current coroutine,
+    // which has no pcall frame left, so the current coroutine dies and the error is propagated to the parent coroutine.
+    //
+    TValue* dstStackBase = targetCoro->m_suspendPointStackBase;
+    if (unlikely(!EnsureStackSpaceForCoroutineValues(targetCoro, dstStackBase, numRets + 1)))
+    {
+        ThrowError("too many results to resume");
+    }
+
     // Update coroutine status: the current coroutine becomes dead
     //
     currentCoro->m_coroutineStatus.SetDead(true);
+    VM::GetActiveVMForCurrentThread()->UnregisterLiveCoroutine(currentCoro);
     Assert(currentCoro->m_coroutineStatus.IsDead() && !currentCoro->m_coroutineStatus.IsResumable());
 
+    // The stack of a dead coroutine is never used again, so return it to the VM.
+    // Note that the return values still live on this stack, but the stack content is not touched until a new coroutine is created.
+    //
+    currentCoro->ReleaseStackOfDeadCoroutine(VM::GetActiveVMForCurrentThread());
+
     // Set up the arguments returned to the parent coroutine
     //
-    TValue* dstStackBase = targetCoro->m_suspendPointStackBase;
     StackFrameHeader* dstHdr = StackFrameHeader::Get(dstStackBase);
     // DEVNOTE: 'm_numVariadicArguments' is repurposed by us here to distinguish whether
     // it is a coroutine.wrap or a coroutine.resume... 0 means coroutine.resume and 1 mean coroutine.wrap
@@ -47,8 +69,6 @@ DEEGEN_DEFINE_LIB_FUNC_CONTINUATION(coro_finish)
         // Note that we also need to pad nils to x_minNilFillReturnValues, as required by our internal call scheme.
         // However, since we know that the incoming return values also follows this scheme, it's sufficient to memcpy at least that many elements.
         //
-        // TODO: we need to check for stack overflow here once we implement resizable stack
-        //
         dstStackBase[0] = TValue::Create<tBool>(true);
         MoveArgumentsForCoroutine(dstStackBase + 1, retStart, std::max(numRets, static_cast<size_t>(x_minNilFillReturnValues) - 1));
 
@@ -59,8 +79,6 @@ DEEGEN_DEFINE_LIB_FUNC_CONTINUATION(coro_finish)
         Assert(dstHdr->m_numVariadicArguments == 1);
         // For coroutine.wrap, we should simply store all the return values
         //
-        // TODO: we need to check for stack overflow here once we implement resizable stack
-        //
         MoveArgumentsForCoroutine(dstStackBase, retStart, std::max(numRets, static_cast<size_t>(x_minNilFillReturnValues)));
 
         CoroSwitch(targetCoro, dstStackBase, numRets);
@@ -80,9 +98,12 @@ DEEGEN_DEFINE_LIB_FUNC_CONTINUATION(coro_init)
     //
     Assert(start == GetStackBase() + x_numSlotsForStackFrameHeader);
     Assert(GetStackBase()[0].Is<tFunction>());
+    VM::GetActiveVMForCurrentThread()->RegisterLiveCoroutine(GetCurrentCoroutine());
     MakeInPlaceCall(start, numArgs, DEEGEN_LIB_FUNC_RETURN_CONTINUATION(coro_finish));
 }
 
+// Returns nullptr if the coroutine stack region of the VM is exhausted
+//
 static CoroutineRuntimeContext* WARN_UNUSED ALWAYS_INLINE CreateNewCoroutine(UserHeapPointer<TableObject> globalObject,
                                                                              HeapPtr<FunctionObject> entryFn)
 {
@@ -96,7 +117,11 @@ static CoroutineRuntimeContext* WARN_UNUSED ALWAYS_INLINE CreateNewCoroutine(Use
     // which starts the execution of the coroutine.
     //
     VM* vm = VM::GetActiveVMForCurrentThread();
-    CoroutineRuntimeContext* coro = CoroutineRuntimeContext::Create(vm, globalObject);
+    CoroutineRuntimeContext* coro = CoroutineRuntimeContext::TryCreate(vm, globalObject);
+    if (unlikely(coro == nullptr))
+    {
+        return nullptr;
+    }
     StackFrameHeader* hdr = reinterpret_cast<StackFrameHeader*>(coro->m_stackBegin);
     hdr[0].m_func = nullptr;
     hdr[0].m_caller = nullptr;
@@ -130,6 +155,10 @@ DEEGEN_DEFINE_LIB_FUNC(coroutine_create)
     }
     CoroutineRuntimeContext* currentCoro = GetCurrentCoroutine();
     CoroutineRuntimeContext* newCoro = CreateNewCoroutine(currentCoro->m_globalObject, arg.As<tFunction>() /*entryFn*/);
+    if (unlikely(newCoro == nullptr))
+    {
+        ThrowError("too many live coroutines");
+    }
     Return(TValue::Create<tThread>(TranslateToHeapPtr(newCoro)));
 }
 
@@ -168,6 +197,13 @@ DEEGEN_DEFINE_LIB_FUNC(coroutine_resume)
         VM* vm = VM::GetActiveVMForCurrentThread();
         CoroutineRuntimeContext* targetCoro = TranslateToRawPointer(vm, arg.As<tThread>());
 
+        TValue* dstStackBase = targetCoro->m_suspendPointStackBase;
+        size_t numArgsToPass = GetNumArgs() - 1;
+        if (unlikely(!EnsureStackSpaceForCoroutineValues(targetCoro, dstStackBase, numArgsToPass)))
+        {
+            ThrowError("too many arguments to resume");
+        }
+
         // Update coroutine status: the target coroutine becomes no longer resumable and has the current coroutine as parent
         //
         Assert(!targetCoro->m_coroutineStatus.IsDead() && targetCoro->m_coroutineStatus.IsResumable());
@@ -177,10 +213,7 @@ DEEGEN_DEFINE_LIB_FUNC(coroutine_resume)
         currentCoro->m_suspendPointStackBase = GetStackBase();
 
         // Set up the arguments passed to the resumed coroutine
-        // TODO: we need to check for stack overflow here once we implement resizable stack
         //
-        TValue* dstStackBase = targetCoro->m_suspendPointStackBase;
-        size_t numArgsToPass = GetNumArgs() - 1;
         MoveArgumentsForCoroutine(dstStackBase, GetStackBase() + 1, numArgsToPass);
         for (size_t i = 0; i < x_minNilFillReturnValues; i++) { dstStackBase[numArgsToPass + i] = TValue::Create<tNil>(); }
 
@@ -306,6 +339,13 @@ DEEGEN_DEFINE_LIB_FUNC(coroutine_wrap_call)
         }
     }
 
+    TValue* dstStackBase = targetCoro->m_suspendPointStackBase;
+    size_t numArgsToPass = GetNumArgs();
+    if (unlikely(!EnsureStackSpaceForCoroutineValues(targetCoro, dstStackBase, numArgsToPass)))
+    {
+        ThrowError("too many arguments to resume");
+    }
+
     // Update coroutine status: the target coroutine becomes no longer resumable and has the current coroutine as parent
     //
     Assert(!targetCoro->m_coroutineStatus.IsDead() && targetCoro->m_coroutineStatus.IsResumable());
@@ -315,10 +355,7 @@ DEEGEN_DEFINE_LIB_FUNC(coroutine_wrap_call)
     currentCoro->m_suspendPointStackBase = GetStackBase();
 
     // Set up the arguments passed to the resumed coroutine
-    // TODO: we need to check for stack overflow here once we implement resizable stack
     //
-    TValue* dstStackBase = targetCoro->m_suspendPointStackBase;
-    size_t numArgsToPass = GetNumArgs();
     MoveArgumentsForCoroutine(dstStackBase, GetStackBase(), numArgsToPass);
     for (size_t i = 0; i < x_minNilFillReturnValues; i++) { dstStackBase[numArgsToPass + i] = TValue::Create<tNil>(); }
 
@@ -352,6 +389,10 @@ DEEGEN_DEFINE_LIB_FUNC(coroutine_wrap)
     }
     CoroutineRuntimeContext* currentCoro = GetCurrentCoroutine();
     CoroutineRuntimeContext* newCoro = CreateNewCoroutine(currentCoro->m_globalObject, arg.As<tFunction>() /*entryFn*/);
+    if (unlikely(newCoro == nullptr))
+    {
+        ThrowError("too many live coroutines");
+    }
     VM* vm = VM::GetActiveVMForCurrentThread();
     HeapPtr<FunctionObject> wrap = FunctionObject::CreateCFunc(vm, vm->GetLibFnProto<VM::LibFnProto::CoroutineWrapCall>(), 1 /*numUpValues*/).As();
     TValue uv = TValue::Create<tThread>(TranslateToHeapPtr(newCoro));
@@ -383,6 +424,12 @@ DEEGEN_DEFINE_LIB_FUNC(coroutine_yield)
 
     Assert(!targetCoro->m_coroutineStatus.IsDead() && !targetCoro->m_coroutineStatus.IsResumable());
 
+    TValue* dstStackBase = targetCoro->m_suspendPointStackBase;
+    if (unlikely(!EnsureStackSpaceForCoroutineValues(targetCoro, dstStackBase, numArgs + 1)))
+    {
+        ThrowError("too many results to resume");
+    }
+
     // Update the coroutine status: the current coroutine becomes resumable
     //
     currentCoro->m_coroutineStatus.SetResumable(true);
@@ -390,7 +437,6 @@ DEEGEN_DEFINE_LIB_FUNC(coroutine_yield)
 
     // Set up the arguments returned to the parent coroutine
     //
-    TValue* dstStackBase = targetCoro->m_suspendPointStackBase;
     StackFrameHeader* dstHdr = StackFrameHeader::Get(dstStackBase);
     // DEVNOTE: 'm_numVariadicArguments' is repurposed by us here to distinguish whether
     // it is a coroutine.wrap or a coroutine.resume... 0 means coroutine.resume and 1 mean coroutine.wrap
@@ -400,8 +446,6 @@ DEEGEN_DEFINE_LIB_FUNC(coroutine_yield)
         // For coroutine.resume, we should store 'true' plus all return values
         // Note that we also need to pad nils to x_minNilFillReturnValues, as required by our internal call scheme.
         //
-        // TODO: we need to check for stack overflow here once we implement resizable stack
-        //
         dstStackBase[0] = TValue::Create<tBool>(true);
         MoveArgumentsForCoroutine(dstStackBase + 1, sb, numArgs);
         // Pad x_minNilFillReturnValues - 1 nils
@@ -417,8 +461,6 @@ DEEGEN_DEFINE_LIB_FUNC(coroutine_yield)
         Assert(dstHdr->m_numVariadicArguments == 1);
         // For coroutine.wrap, we should simply store all the return values
         //
-        // TODO: we need to check for stack overflow here once we implement resizable stack
-        //
         MoveArgumentsForCoroutine(dstStackBase, sb, numArgs);
         // Pad x_minNilFillReturnValues nils
         //
@@ -222,8 +222,18 @@ DEEGEN_DEFINE_LIB_FUNC(debug_setmetatable)
         }
         else
         {
-            // TODO: support USERDATA
-            ReleaseAssert(false && "unimplemented");
+            Assert(ty == HeapEntityType::Userdata);
+            HeapCDataObject* obj = TranslateToRawPointer(vm, value.As<tUserdata>());
+            if (obj->m_kind == HeapCDataObject::Kind::Full)
+            {
+                setExoticMetatable(obj->m_metatable);
+            }
+            else
+            {
+                // All light userdata share one metatable
+                //
+                setExoticMetatable(vm->m_metatableForLightUserdata);
+            }
         }
     }
     else if (value.Is<tMIV>())
@@ -1,156 +1,391 @@
 #include "deegen_api.h"
 #include "runtime_utils.h"
+#include "lualib_tonumber_util.h"
+#include "lua_io_file.h"
 
-// io.close -- https://www.lua.org/manual/5.1/manual.html#pdf-io.close
+// Get the file handle for a file method, throw an error if 'self' is not a file handle or the file has been closed
 //
-// io.close ([file])
-// Equivalent to file:close(). Without a file, closes the default output file.
-//
-DEEGEN_DEFINE_LIB_FUNC(io_close)
-{
-    ThrowError("Library function 'io.close' is not implemented yet!");
-}
+#define GET_SELF_AS_OPEN_FILE(fnName, fileVar)                                                                      \
+    LuaIoFile* fileVar;                                                                                             \
+    {                                                                                                               \
+        if (unlikely(GetNumArgs() == 0))                                                                            \
+        {                                                                                                           \
+            ThrowError("bad argument #1 to '" PP_STRINGIFY(fnName) "' (FILE* expected, got no value)");             \
+        }                                                                                                           \
+        fileVar = VM::GetActiveVMForCurrentThread()->GetIoLibState()->TryGetFile(GetArg(0));                       \
+        if (unlikely(fileVar == nullptr))                                                                           \
+        {                                                                                                           \
+            ThrowError("bad argument #1 to '" PP_STRINGIFY(fnName) "' (FILE* expected)");                           \
+        }                                                                                                           \
+        if (unlikely(fileVar->IsClosed()))                                                                          \
+        {                                                                                                           \
+            ThrowError("attempt to use a closed file");                                                             \
+        }                                                                                                           \
+    }                                                                                                               \
+    Assert(true)        /* end with a statement so a comma can be added */
 
-// io.flush -- https://www.lua.org/manual/5.1/manual.html#pdf-io.flush
+// Get the default input or output file, throw an error if it has been closed
 //
-// io.flush ()
-// Equivalent to file:flush over the default output file.
+#define GET_DEFAULT_OPEN_FILE(handleMember, fileVar)                                                                \
+    LuaIoFile* fileVar;                                                                                             \
+    {                                                                                                               \
+        LuaIoLibState* macro_ioState = VM::GetActiveVMForCurrentThread()->GetIoLibState();                         \
+        fileVar = macro_ioState->TryGetFile(macro_ioState->handleMember);                                           \
+        Assert(fileVar != nullptr);                                                                                 \
+        if (unlikely(fileVar->IsClosed()))                                                                          \
+        {                                                                                                           \
+            ThrowError("default file is closed");                                                                   \
+        }                                                                                                           \
+    }                                                                                                               \
+    Assert(true)        /* end with a statement so a comma can be added */
+
+// Make the error message string returned by the io library on I/O failures
 //
-DEEGEN_DEFINE_LIB_FUNC(io_flush)
+static TValue WARN_UNUSED MakeIoErrorString(VM* vm, int err, const char* fileName)
 {
-    ThrowError("Library function 'io.flush' is not implemented yet!");
+    const char* errstr = strerror(err);
+    if (fileName == nullptr)
+    {
+        return TValue::Create<tString>(vm->CreateStringObjectFromRawCString(errstr));
+    }
+    std::pair<const void*, size_t> pieces[3] = {
+        std::make_pair(fileName, strlen(fileName)),
+        std::make_pair(": ", 2),
+        std::make_pair(errstr, strlen(errstr))
+    };
+    return TValue::Create<tString>(vm->CreateStringObjectFromConcatenation(pieces, 3).As());
 }
 
-// io.input -- https://www.lua.org/manual/5.1/manual.html#pdf-io.input
-//
-// io.input ([file])
-// When called with a file name, it opens the named file (in text mode), and sets its handle as the default input file.
-// When called with a file handle, it simply sets this file handle as the default input file.
-// When called without parameters, it returns the current default input file.
+// The mode string of io.open must match /[rwa]%+?b*/
 //
-// In case of errors this function raises the error, instead of returning an error code.
-//
-DEEGEN_DEFINE_LIB_FUNC(io_input)
+static bool WARN_UNUSED IsValidFileOpenMode(const char* mode)
 {
-    ThrowError("Library function 'io.input' is not implemented yet!");
+    if (*mode == '\0' || strchr("rwa", *mode) == nullptr)
+    {
+        return false;
+    }
+    mode++;
+    if (*mode == '+')
+    {
+        mode++;
+    }
+    while (*mode == 'b')
+    {
+        mode++;
+    }
+    return *mode == '\0';
 }
 
-// 'buf' must be 'limit + 1' bytes long
-// If -1 is returned, it means 'limit' bytes have been read but end-of-line is still not reached.
-// If -2 is returned, it means the file hit EOF without reading in any bytes
-// Otherwise, returns the length of the line, minus the '\n' if it exists.
-//
-static size_t WARN_UNUSED TryReadLineOnce(FILE* fp, char* buf, size_t limit)
+struct IoReadResult
 {
-    // Set up a sentry value so we know if 'fgets' read exactly 'limit' bytes
+    // The number of values written to 'results'
     //
-    buf[limit] = 1;
-
-    // Let fgets read at most 'limit' bytes and append the '\0'
+    size_t m_numResults;
+    // If not -1, the ordinal of the format that is invalid, and whether the format is not even an option string
     //
-    char* fgetsRet = fgets(buf, static_cast<int>(limit + 1), fp);
-    if (unlikely(fgetsRet == nullptr))
-    {
-        // EOF without any bytes read, or error. For error just treat it as EOF for now.
-        //
-        return static_cast<size_t>(-2);
-    }
+    ssize_t m_invalidFormatOrd;
+    bool m_isInvalidOption;
+};
 
-    // If our sentry value 1 is not overwritten, it means 'fgets' stopped short before reading 'x_internalBufferSize' characters.
-    // So a newline (or EOF) must have been encountered. We can quit now.
-    //
-    if (buf[limit] != '\0')
+// Implements file:read: read from 'file' according to each format, and store the values read into 'results'
+// Reading stops at the first format that fails, whose result is nil.
+// 'results' may overlap with 'formats', as long as 'results' does not start after 'formats'.
+//
+static IoReadResult WARN_UNUSED IoReadImpl(VM* vm, LuaIoFile* file, TValue* formats, size_t numFormats, TValue* results /*out*/)
+{
+    auto stringOrNil = [](UserHeapPointer<HeapString> s) -> TValue
     {
-        size_t len = strlen(buf);
-        Assert(len < limit);
-        if (len >= 1 && buf[len - 1] == '\n')
+        if (s.m_value == 0)
         {
-            len--;
+            return TValue::Create<tNil>();
         }
-        return len;
-    }
+        return TValue::Create<tString>(s.As());
+    };
 
-    // Now we know fgets has read exactly 'limit' characters.
-    //
-    if (buf[limit - 1] == '\n')
+    if (numFormats == 0)
     {
-        // The line (including '\n') happens to have exactly 'limit' bytes.
-        //
-        return limit - 1;
+        results[0] = stringOrNil(file->ReadLine(vm, false /*keepNewline*/));
+        return { .m_numResults = 1, .m_invalidFormatOrd = -1, .m_isInvalidOption = false };
     }
 
-    // The line might have more to read.
-    // (Note that it is possible that we have reached EOF here and the file doesn't end with a newline,
-    // but we won't know until we call fgets again).
-    //
-    return static_cast<size_t>(-1);
+    for (size_t i = 0; i < numFormats; i++)
+    {
+        TValue format = formats[i];
+        TValue result;
+        if (format.Is<tDouble>() || format.Is<tInt32>())
+        {
+            double n = format.Is<tDouble>() ? format.As<tDouble>() : format.As<tInt32>();
+            size_t numBytes = (n >= 0 && n < 1e18) ? static_cast<size_t>(n) : 0;
+            result = stringOrNil(file->ReadBytes(vm, numBytes));
+        }
+        else
+        {
+            if (!format.Is<tString>())
+            {
+                return { .m_numResults = i, .m_invalidFormatOrd = static_cast<ssize_t>(i), .m_isInvalidOption = true };
+            }
+            HeapString* hs = TranslateToRawPointer(vm, format.As<tString>());
+            if (hs->m_length < 2 || hs->m_string[0] != '*')
+            {
+                return { .m_numResults = i, .m_invalidFormatOrd = static_cast<ssize_t>(i), .m_isInvalidOption = true };
+            }
+            switch (hs->m_string[1])
+            {
+            case 'n':
+            {
+                double d;
+                if (file->ReadNumber(d /*out*/))
+                {
+                    result = TValue::Create<tDouble>(d);
+                }
+                else
+                {
+                    result = TValue::Create<tNil>();
+                }
+                break;
+            }
+            case 'a':
+            {
+                result = TValue::Create<tString>(file->ReadAll(vm).As());
+                break;
+            }
+            case 'l':
+            {
+                result = stringOrNil(file->ReadLine(vm, false /*keepNewline*/));
+                break;
+            }
+            case 'L':
+            {
+                result = stringOrNil(file->ReadLine(vm, true /*keepNewline*/));
+                break;
+            }
+            default:
+            {
+                return { .m_numResults = i, .m_invalidFormatOrd = static_cast<ssize_t>(i), .m_isInvalidOption = false };
+            }
+            }   /*switch*/
+        }
+
+        results[i] = result;
+        if (result.Is<tNil>())
+        {
+            return { .m_numResults = i + 1, .m_invalidFormatOrd = -1, .m_isInvalidOption = false };
+        }
+    }
+    return { .m_numResults = numFormats, .m_invalidFormatOrd = -1, .m_isInvalidOption = false };
 }
 
-static HeapPtr<HeapString> NO_INLINE ReadLinesSlowPath(FILE* fp, VM* vm, char* firstChunk, size_t firstChunkLen)
+// Implements file:write
+// Returns -1 on success, -2 on I/O failure, otherwise the ordinal of the first value that is neither a string nor a number
+//
+static ssize_t WARN_UNUSED IoWriteImpl(VM* vm, LuaIoFile* file, TValue* values, size_t numValues)
 {
-    // Just use a vector for simplicity now
+    // For io.stdout and io.stderr, append to the VM output buffer directly, and check for errors only once in the end
     //
-    std::vector<std::pair<const void*, size_t>> chunkList;
-    chunkList.push_back(std::make_pair(firstChunk, firstChunkLen));
+    if (VMOutputBuffer* out = file->GetOutputBuffer(); out != nullptr)
+    {
+        ssize_t badArgOrd = -1;
+        for (size_t i = 0; i < numValues; i++)
+        {
+            TValue val = values[i];
+            if (val.Is<tString>())
+            {
+                HeapString* hs = TranslateToRawPointer(vm, val.As<tString>());
+                out->Append(hs->m_string, hs->m_length);
+            }
+            else if (val.Is<tDouble>())
+            {
+                out->AppendDouble(val.As<tDouble>());
+            }
+            else if (val.Is<tInt32>())
+            {
+                out->AppendInt32(val.As<tInt32>());
+            }
+            else
+            {
+                badArgOrd = static_cast<ssize_t>(i);
+                break;
+            }
+        }
+        out->EndOfOperation();
+        if (unlikely(badArgOrd != -1))
+        {
+            return badArgOrd;
+        }
+        return out->CheckAndClearWriteError() ? -2 : -1;
+    }
 
-    constexpr size_t x_chunkSize = 65280;
-    while (true)
+    bool success = true;
+    for (size_t i = 0; i < numValues; i++)
     {
-        char* buf = new char[x_chunkSize + 1];
-        size_t len = TryReadLineOnce(fp, buf, x_chunkSize);
-        if (len == static_cast<size_t>(-2))
+        TValue val = values[i];
+        if (val.Is<tString>())
+        {
+            HeapString* hs = TranslateToRawPointer(vm, val.As<tString>());
+            success &= file->Write(hs->m_string, hs->m_length);
+        }
+        else if (val.Is<tDouble>())
+        {
+            char buf[x_default_tostring_buffersize_double];
+            char* bufEnd = StringifyDoubleUsingDefaultLuaFormattingOptions(buf /*out*/, val.As<tDouble>());
+            success &= file->Write(buf, static_cast<size_t>(bufEnd - buf));
+        }
+        else if (val.Is<tInt32>())
         {
-            // It means we reached EOF and the file did not end with a newline, we are done.
-            // We didn't read in anything useful in this iteration.
-            //
-            chunkList.push_back(std::make_pair(buf, 0));
-            break;
+            char buf[x_default_tostring_buffersize_int];
+            char* bufEnd = StringifyInt32UsingDefaultLuaFormattingOptions(buf /*out*/, val.As<tInt32>());
+            success &= file->Write(buf, static_cast<size_t>(bufEnd - buf));
         }
-        if (len == static_cast<size_t>(-1))
+        else
         {
-            // We read in full x_chunkSize bytes but still may have more to read.
-            //
-            chunkList.push_back(std::make_pair(buf, x_chunkSize));
-            continue;
+            return static_cast<ssize_t>(i);
         }
+    }
+    return success ? -1 : -2;
+}
 
-        Assert(len < x_chunkSize);
-        // We found a newline or EOF, we are done.
-        //
-        chunkList.push_back(std::make_pair(buf, len));
-        break;
+// Create the iterator function returned by io.lines and file:lines
+//
+static HeapPtr<FunctionObject> WARN_UNUSED CreateLinesIterator(VM* vm, TValue handle, bool closeAtEof)
+{
+    HeapPtr<FunctionObject> iter = FunctionObject::CreateCFunc(vm, vm->GetLibFnProto<VM::LibFnProto::IoFileLinesIter>(), 2 /*numUpValues*/).As();
+    TCSet(iter->m_upvalues[0], handle);
+    TCSet(iter->m_upvalues[1], TValue::Create<tBool>(closeAtEof));
+    return iter;
+}
+
+// io.close -- https://www.lua.org/manual/5.1/manual.html#pdf-io.close
+//
+// io.close ([file])
+// Equivalent to file:close(). Without a file, closes the default output file.
+//
+DEEGEN_DEFINE_LIB_FUNC(io_close)
+{
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    LuaIoFile* file;
+    if (GetNumArgs() == 0 || GetArg(0).Is<tNil>())
+    {
+        GET_DEFAULT_OPEN_FILE(m_defaultOutput, defaultOutput);
+        file = defaultOutput;
+    }
+    else
+    {
+        GET_SELF_AS_OPEN_FILE(close, self);
+        file = self;
     }
 
-    HeapPtr<HeapString> result = vm->CreateStringObjectFromConcatenation(chunkList.data(), chunkList.size()).As();
+    if (file->GetKind() == LuaIoFile::Kind::StandardStream)
+    {
+        Return(TValue::Create<tNil>(), TValue::Create<tString>(vm->CreateStringObjectFromRawCString("cannot close standard file")));
+    }
 
-    // The first element in 'chunkList' is the internal buffer, we must not free it. Free everything else.
-    //
-    for (size_t i = 1; i < chunkList.size(); i++)
+    int err = file->Close();
+    if (unlikely(err != 0))
+    {
+        Return(TValue::Create<tNil>(), MakeIoErrorString(vm, err, nullptr), TValue::Create<tDouble>(err));
+    }
+    Return(TValue::Create<tBool>(true));
+}
+
+// io.flush -- https://www.lua.org/manual/5.1/manual.html#pdf-io.flush
+//
+// io.flush ()
+// Equivalent to file:flush over the default output file.
+//
+DEEGEN_DEFINE_LIB_FUNC(io_flush)
+{
+    GET_DEFAULT_OPEN_FILE(m_defaultOutput, file);
+    if (unlikely(!file->Flush()))
     {
-        char* ptr = const_cast<char*>(reinterpret_cast<const char*>(chunkList[i].first));
-        delete [] ptr;
+        int err = errno;
+        Return(TValue::Create<tNil>(), MakeIoErrorString(VM::GetActiveVMForCurrentThread(), err, nullptr), TValue::Create<tDouble>(err));
     }
+    Return(TValue::Create<tBool>(true));
+}
 
-    return result;
+// io.input -- https://www.lua.org/manual/5.1/manual.html#pdf-io.input
+//
+// io.input ([file])
+// When called with a file name, it opens the named file (in text mode), and sets its handle as the default input file.
+// When called with a file handle, it simply sets this file handle as the default input file.
+// When called without parameters, it returns the current default input file.
+//
+// In case of errors this function raises the error, instead of returning an error code.
+//
+DEEGEN_DEFINE_LIB_FUNC(io_input)
+{
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    LuaIoLibState* ioState = vm->GetIoLibState();
+    if (GetNumArgs() > 0 && !GetArg(0).Is<tNil>())
+    {
+        TValue arg = GetArg(0);
+        if (arg.Is<tString>())
+        {
+            const char* fileName = reinterpret_cast<const char*>(TranslateToRawPointer(vm, arg.As<tString>())->m_string);
+            std::unique_ptr<LuaIoFile> file = LuaIoFile::Open(fileName, "r");
+            if (file.get() == nullptr)
+            {
+                ThrowError(MakeIoErrorString(vm, errno, fileName));
+            }
+            ioState->m_defaultInput = ioState->CreateHandle(vm, std::move(file));
+        }
+        else
+        {
+            if (unlikely(ioState->TryGetFile(arg) == nullptr))
+            {
+                ThrowError("bad argument #1 to 'input' (FILE* expected)");
+            }
+            ioState->m_defaultInput = arg;
+        }
+    }
+    Return(ioState->m_defaultInput);
 }
 
+// Internal function that reads stdin line by line, keeping the newlines
+// Used as the chunk reader by 'dofile' and 'loadfile' when reading from stdin
+//
 DEEGEN_DEFINE_LIB_FUNC(io_lines_iter)
 {
     VM* vm = VM::GetActiveVMForCurrentThread();
-    constexpr size_t x_internalBufferSize = 8192;
-    char internalBuf[x_internalBufferSize + 1];
-    size_t len = TryReadLineOnce(stdin, internalBuf, x_internalBufferSize);
-    if (len == static_cast<size_t>(-2))
+    UserHeapPointer<HeapString> line = vm->GetIoLibState()->m_stdin->ReadLine(vm, true /*keepNewline*/);
+    if (line.m_value == 0)
     {
         Return(TValue::Create<tNil>());
     }
-    if (len != static_cast<size_t>(-1))
+    Return(TValue::Create<tString>(line.As()));
+}
+
+// Internal function that implements the iterator function returned by io.lines and file:lines
+// Upvalue 0 is the file handle, and upvalue 1 is whether the file should be closed when the iterator hits EOF
+//
+DEEGEN_DEFINE_LIB_FUNC(iofile_lines_iter)
+{
+    HeapPtr<FunctionObject> func = GetStackFrameHeader()->m_func;
+    Assert(func->m_numUpvalues == 2);
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    LuaIoFile* file = vm->GetIoLibState()->TryGetFile(TCGet(func->m_upvalues[0]));
+    Assert(file != nullptr);
+    if (unlikely(file->IsClosed()))
+    {
+        ThrowError("file is already closed");
+    }
+
+    UserHeapPointer<HeapString> line = file->ReadLine(vm, false /*keepNewline*/);
+    if (likely(line.m_value != 0))
+    {
+        Return(TValue::Create<tString>(line.As()));
+    }
+
+    if (unlikely(file->CheckAndClearReadError()))
+    {
+        ThrowError(MakeIoErrorString(vm, errno, nullptr));
+    }
+    TValue closeAtEof = TCGet(func->m_upvalues[1]);
+    if (closeAtEof.Is<tBool>() && closeAtEof.As<tBool>())
     {
-        Assert(len < x_internalBufferSize);
-        Return(TValue::Create<tString>(vm->CreateStringObjectFromRawString(internalBuf, static_cast<uint32_t>(len)).As()));
+        std::ignore = file->Close();
     }
-    HeapPtr<HeapString> result = ReadLinesSlowPath(stdin, vm, internalBuf, x_internalBufferSize);
-    Return(TValue::Create<tString>(result));
+    Return(TValue::Create<tNil>());
 }
 
 // io.lines -- https://www.lua.org/manual/5.1/manual.html#pdf-io.lines
@@ -165,16 +400,26 @@ DEEGEN_DEFINE_LIB_FUNC(io_lines_iter)
 // The call io.lines() (with no file name) is equivalent to io.input():lines(); that is, it iterates over the lines of the
 // default input file. In this case it does not close the file when the loop ends.
 //
-// TODO: This is a makeshift implementation. This is not standard conforming.
-// Currently we are always read from stdin and does not support file input.
-//
 DEEGEN_DEFINE_LIB_FUNC(io_lines)
 {
-    if (GetNumArgs() > 0 && !GetArg(0).Is<tNil>())
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    LuaIoLibState* ioState = vm->GetIoLibState();
+    if (GetNumArgs() == 0 || GetArg(0).Is<tNil>())
+    {
+        GET_DEFAULT_OPEN_FILE(m_defaultInput, file);
+        std::ignore = file;
+        Return(TValue::Create<tFunction>(CreateLinesIterator(vm, ioState->m_defaultInput, false /*closeAtEof*/)));
+    }
+
+    GET_ARG_AS_STRING(lines, 1, fileName, fileNameLen);
+    std::ignore = fileNameLen;
+    std::unique_ptr<LuaIoFile> file = LuaIoFile::Open(fileName, "r");
+    if (file.get() == nullptr)
     {
-        ThrowError("Library function 'io.lines' with file input is not implemented yet!");
+        ThrowError(MakeIoErrorString(vm, errno, fileName));
     }
-    Return(VM_GetLibFunctionObject<VM::LibFn::IoLinesIter>());
+    TValue handle = ioState->CreateHandle(vm, std::move(file));
+    Return(TValue::Create<tFunction>(CreateLinesIterator(vm, handle, true /*closeAtEof*/)));
 }
 
 // io.open -- https://www.lua.org/manual/5.1/manual.html#pdf-io.open
@@ -195,7 +440,36 @@ DEEGEN_DEFINE_LIB_FUNC(io_lines)
 //
 DEEGEN_DEFINE_LIB_FUNC(io_open)
 {
-    ThrowError("Library function 'io.open' is not implemented yet!");
+    if (unlikely(GetNumArgs() == 0))
+    {
+        ThrowError("bad argument #1 to 'open' (string expected, got no value)");
+    }
+    GET_ARG_AS_STRING(open, 1, fileName, fileNameLen);
+    std::ignore = fileNameLen;
+
+    const char* mode = "r";
+    if (GetNumArgs() > 1 && !GetArg(1).Is<tNil>())
+    {
+        TValue modeArg = GetArg(1);
+        if (unlikely(!modeArg.Is<tString>()))
+        {
+            ThrowError("bad argument #2 to 'open' (string expected)");
+        }
+        mode = reinterpret_cast<const char*>(TranslateToRawPointer(modeArg.As<tString>()->m_string));
+        if (unlikely(!IsValidFileOpenMode(mode)))
+        {
+            ThrowError("bad argument #2 to 'open' (invalid mode)");
+        }
+    }
+
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    std::unique_ptr<LuaIoFile> file = LuaIoFile::Open(fileName, mode);
+    if (file.get() == nullptr)
+    {
+        int err = errno;
+        Return(TValue::Create<tNil>(), MakeIoErrorString(vm, err, fileName), TValue::Create<tDouble>(err));
+    }
+    Return(vm->GetIoLibState()->CreateHandle(vm, std::move(file)));
 }
 
 // io.output -- https://www.lua.org/manual/5.1/manual.html#pdf-io.output
@@ -205,7 +479,31 @@ DEEGEN_DEFINE_LIB_FUNC(io_open)
 //
 DEEGEN_DEFINE_LIB_FUNC(io_output)
 {
-    ThrowError("Library function 'io.output' is not implemented yet!");
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    LuaIoLibState* ioState = vm->GetIoLibState();
+    if (GetNumArgs() > 0 && !GetArg(0).Is<tNil>())
+    {
+        TValue arg = GetArg(0);
+        if (arg.Is<tString>())
+        {
+            const char* fileName = reinterpret_cast<const char*>(TranslateToRawPointer(vm, arg.As<tString>())->m_string);
+            std::unique_ptr<LuaIoFile> file = LuaIoFile::Open(fileName, "w");
+            if (file.get() == nullptr)
+            {
+                ThrowError(MakeIoErrorString(vm, errno, fileName));
+            }
+            ioState->m_defaultOutput = ioState->CreateHandle(vm, std::move(file));
+        }
+        else
+        {
+            if (unlikely(ioState->TryGetFile(arg) == nullptr))
+            {
+                ThrowError("bad argument #1 to 'output' (FILE* expected)");
+            }
+            ioState->m_defaultOutput = arg;
+        }
+    }
+    Return(ioState->m_defaultOutput);
 }
 
 // io.popen -- https://www.lua.org/manual/5.1/manual.html#pdf-io.popen
@@ -218,7 +516,36 @@ DEEGEN_DEFINE_LIB_FUNC(io_output)
 //
 DEEGEN_DEFINE_LIB_FUNC(io_popen)
 {
-    ThrowError("Library function 'io.popen' is not implemented yet!");
+    if (unlikely(GetNumArgs() == 0))
+    {
+        ThrowError("bad argument #1 to 'popen' (string expected, got no value)");
+    }
+    GET_ARG_AS_STRING(popen, 1, command, commandLen);
+    std::ignore = commandLen;
+
+    const char* mode = "r";
+    if (GetNumArgs() > 1 && !GetArg(1).Is<tNil>())
+    {
+        TValue modeArg = GetArg(1);
+        if (unlikely(!modeArg.Is<tString>()))
+        {
+            ThrowError("bad argument #2 to 'popen' (string expected)");
+        }
+        mode = reinterpret_cast<const char*>(TranslateToRawPointer(modeArg.As<tString>()->m_string));
+        if (unlikely(strcmp(mode, "r") != 0 && strcmp(mode, "w") != 0))
+        {
+            ThrowError("bad argument #2 to 'popen' (invalid mode)");
+        }
+    }
+
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    std::unique_ptr<LuaIoFile> file = LuaIoFile::OpenPipe(command, mode);
+    if (file.get() == nullptr)
+    {
+        int err = errno;
+        Return(TValue::Create<tNil>(), MakeIoErrorString(vm, err, command), TValue::Create<tDouble>(err));
+    }
+    Return(vm->GetIoLibState()->CreateHandle(vm, std::move(file)));
 }
 
 // io.read -- https://www.lua.org/manual/5.1/manual.html#pdf-io.read
@@ -228,7 +555,25 @@ DEEGEN_DEFINE_LIB_FUNC(io_popen)
 //
 DEEGEN_DEFINE_LIB_FUNC(io_read)
 {
-    ThrowError("Library function 'io.read' is not implemented yet!");
+    GET_DEFAULT_OPEN_FILE(m_defaultInput, file);
+    VM* vm = VM::GetActiveVMForCurrentThread();
+
+    size_t numFormats = GetNumArgs();
+    TValue singleResult;
+    TValue* results = (numFormats == 0) ? &singleResult : GetStackBase();
+    IoReadResult res = IoReadImpl(vm, file, GetStackBase(), numFormats, results /*out*/);
+    if (unlikely(res.m_invalidFormatOrd != -1))
+    {
+        char msg[100];
+        snprintf(msg, 100, "bad argument #%d to 'read' (%s)", static_cast<int>(res.m_invalidFormatOrd + 1), res.m_isInvalidOption ? "invalid option" : "invalid format");
+        ThrowError(MakeErrorMessage(msg));
+    }
+    if (unlikely(file->CheckAndClearReadError()))
+    {
+        int err = errno;
+        Return(TValue::Create<tNil>(), MakeIoErrorString(vm, err, nullptr), TValue::Create<tDouble>(err));
+    }
+    ReturnValueRange(results, res.m_numResults);
 }
 
 // io.tmpfile -- https://www.lua.org/manual/5.1/manual.html#pdf-io.tmpfile
@@ -238,7 +583,14 @@ DEEGEN_DEFINE_LIB_FUNC(io_read)
 //
 DEEGEN_DEFINE_LIB_FUNC(io_tmpfile)
 {
-    ThrowError("Library function 'io.tmpfile' is not implemented yet!");
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    std::unique_ptr<LuaIoFile> file = LuaIoFile::OpenTemporary();
+    if (file.get() == nullptr)
+    {
+        int err = errno;
+        Return(TValue::Create<tNil>(), MakeIoErrorString(vm, err, nullptr), TValue::Create<tDouble>(err));
+    }
+    Return(vm->GetIoLibState()->CreateHandle(vm, std::move(file)));
 }
 
 // io.type -- https://www.lua.org/manual/5.1/manual.html#pdf-io.type
@@ -249,7 +601,17 @@ DEEGEN_DEFINE_LIB_FUNC(io_tmpfile)
 //
 DEEGEN_DEFINE_LIB_FUNC(io_type)
 {
-    ThrowError("Library function 'io.type' is not implemented yet!");
+    if (unlikely(GetNumArgs() == 0))
+    {
+        ThrowError("bad argument #1 to 'type' (value expected)");
+    }
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    LuaIoFile* file = vm->GetIoLibState()->TryGetFile(GetArg(0));
+    if (file == nullptr)
+    {
+        Return(TValue::Create<tNil>());
+    }
+    Return(TValue::Create<tString>(vm->CreateStringObjectFromRawCString(file->IsClosed() ? "closed file" : "file")));
 }
 
 // io.write -- https://www.lua.org/manual/5.1/manual.html#pdf-io.write
@@ -257,62 +619,283 @@ DEEGEN_DEFINE_LIB_FUNC(io_type)
 // io.write (···)
 // Equivalent to io.output():write.
 //
-// TODO: This is a makeshift implementation. This is not standard conforming.
-// Currently we are always printing to stdout.
-//
 DEEGEN_DEFINE_LIB_FUNC(io_write)
 {
+    GET_DEFAULT_OPEN_FILE(m_defaultOutput, file);
     VM* vm = VM::GetActiveVMForCurrentThread();
-    FILE* fp = vm->GetStdout();
-    size_t numElementsToPrint = GetNumArgs();
-    bool success = true;
-    for (uint32_t i = 0; i < numElementsToPrint; i++)
+    ssize_t res = IoWriteImpl(vm, file, GetStackBase(), GetNumArgs());
+    if (likely(res == -1))
+    {
+        Return(TValue::Create<tBool>(true));
+    }
+    if (res == -2)
+    {
+        int err = errno;
+        Return(TValue::Create<tNil>(), MakeIoErrorString(vm, err, nullptr), TValue::Create<tDouble>(err));
+    }
+    char msg[100];
+    snprintf(msg, 100, "bad argument #%d to 'write' (string expected)", static_cast<int>(res + 1));
+    ThrowError(MakeErrorMessage(msg));
+}
+
+// file:close -- https://www.lua.org/manual/5.1/manual.html#pdf-file:close
+//
+// file:close ()
+// Closes file. Note that files are automatically closed when their handles are garbage collected, but that takes an unpredictable
+// amount of time to happen.
+//
+// DEVNOTE: we do not have a garbage collector yet, so files that are not closed explicitly stay open until the VM is destroyed.
+//
+DEEGEN_DEFINE_LIB_FUNC(iofile_close)
+{
+    GET_SELF_AS_OPEN_FILE(close, file);
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    if (file->GetKind() == LuaIoFile::Kind::StandardStream)
+    {
+        Return(TValue::Create<tNil>(), TValue::Create<tString>(vm->CreateStringObjectFromRawCString("cannot close standard file")));
+    }
+    int err = file->Close();
+    if (unlikely(err != 0))
     {
-        TValue val = GetArg(i);
-#if 0
-        if (val.Is<tInt32>())
+        Return(TValue::Create<tNil>(), MakeIoErrorString(vm, err, nullptr), TValue::Create<tDouble>(err));
+    }
+    Return(TValue::Create<tBool>(true));
+}
+
+// file:flush -- https://www.lua.org/manual/5.1/manual.html#pdf-file:flush
+//
+// file:flush ()
+// Saves any written data to file.
+//
+DEEGEN_DEFINE_LIB_FUNC(iofile_flush)
+{
+    GET_SELF_AS_OPEN_FILE(flush, file);
+    if (unlikely(!file->Flush()))
+    {
+        int err = errno;
+        Return(TValue::Create<tNil>(), MakeIoErrorString(VM::GetActiveVMForCurrentThread(), err, nullptr), TValue::Create<tDouble>(err));
+    }
+    Return(TValue::Create<tBool>(true));
+}
+
+// file:lines -- https://www.lua.org/manual/5.1/manual.html#pdf-file:lines
+//
+// file:lines ()
+// Returns an iterator function that, each time it is called, returns a new line from the file. Therefore, the construction
+//     for line in file:lines() do body end
+// will iterate over all lines of the file. (Unlike io.lines, this function does not close the file when the loop ends.)
+//
+DEEGEN_DEFINE_LIB_FUNC(iofile_lines)
+{
+    GET_SELF_AS_OPEN_FILE(lines, file);
+    std::ignore = file;
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    Return(TValue::Create<tFunction>(CreateLinesIterator(vm, GetArg(0), false /*closeAtEof*/)));
+}
+
+// file:read -- https://www.lua.org/manual/5.1/manual.html#pdf-file:read
+//
+// file:read (···)
+// Reads the file file, according to the given formats, which specify what to read. For each format, the function returns a string
+// (or a number) with the characters read, or nil if it cannot read data with the specified format. When called without formats,
+// it uses a default format that reads the entire next line (see below).
+//
+// The available formats are
+//     "*n": reads a number; this is the only format that returns a number instead of a string.
+//     "*a": reads the whole file, starting at the current position. On end of file, it returns the empty string.
+//     "*l": reads the next line (skipping the end of line), returning nil on end of file. This is the default format.
+//     number: reads a string with up to this number of characters, returning nil on end of file. If number is zero, it reads
+//             nothing and returns an empty string, or nil on end of file.
+//
+DEEGEN_DEFINE_LIB_FUNC(iofile_read)
+{
+    GET_SELF_AS_OPEN_FILE(read, file);
+    VM* vm = VM::GetActiveVMForCurrentThread();
+
+    size_t numFormats = GetNumArgs() - 1;
+    TValue singleResult;
+    TValue* results = (numFormats == 0) ? &singleResult : GetStackBase();
+    IoReadResult res = IoReadImpl(vm, file, GetStackBase() + 1, numFormats, results /*out*/);
+    if (unlikely(res.m_invalidFormatOrd != -1))
+    {
+        char msg[100];
+        snprintf(msg, 100, "bad argument #%d to 'read' (%s)", static_cast<int>(res.m_invalidFormatOrd + 1), res.m_isInvalidOption ? "invalid option" : "invalid format");
+        ThrowError(MakeErrorMessage(msg));
+    }
+    if (unlikely(file->CheckAndClearReadError()))
+    {
+        int err = errno;
+        Return(TValue::Create<tNil>(), MakeIoErrorString(vm, err, nullptr), TValue::Create<tDouble>(err));
+    }
+    ReturnValueRange(results, res.m_numResults);
+}
+
+// file:seek -- https://www.lua.org/manual/5.1/manual.html#pdf-file:seek
+//
+// file:seek ([whence] [, offset])
+// Sets and gets the file position, measured from the beginning of the file, to the position given by offset plus a base specified
+// by the string whence, as follows:
+//     "set": base is position 0 (beginning of the file);
+//     "cur": base is current position;
+//     "end": base is end of file;
+// In case of success, function seek returns the final file position, measured in bytes from the beginning of the file. If this
+// function fails, it returns nil, plus a string describing the error.
+//
+// The default value for whence is "cur", and for offset is 0.
+//
+DEEGEN_DEFINE_LIB_FUNC(iofile_seek)
+{
+    GET_SELF_AS_OPEN_FILE(seek, file);
+    size_t numArgs = GetNumArgs();
+
+    int whence = SEEK_CUR;
+    if (numArgs > 1 && !GetArg(1).Is<tNil>())
+    {
+        TValue whenceArg = GetArg(1);
+        if (unlikely(!whenceArg.Is<tString>()))
         {
-            char buf[x_default_tostring_buffersize_int];
-            char* bufEnd = StringifyInt32UsingDefaultLuaFormattingOptions(buf /*out*/, val.As<tInt32>());
-            size_t len = static_cast<size_t>(bufEnd - buf);
-            size_t written = fwrite(buf, 1, len, fp);
-            if (unlikely(len != written)) { success = false; break; }
+            ThrowError("bad argument #1 to 'seek' (string expected)");
         }
-        else
-#endif
-        if (val.Is<tDouble>())
+        const char* whenceStr = reinterpret_cast<const char*>(TranslateToRawPointer(whenceArg.As<tString>()->m_string));
+        if (strcmp(whenceStr, "set") == 0)
         {
-            double dbl = val.As<tDouble>();
-            char buf[x_default_tostring_buffersize_double];
-            char* bufEnd = StringifyDoubleUsingDefaultLuaFormattingOptions(buf /*out*/, dbl);
-            size_t len = static_cast<size_t>(bufEnd - buf);
-            size_t written = fwrite(buf, 1, len, fp);
-            if (unlikely(len != written)) { success = false; break; }
+            whence = SEEK_SET;
         }
-        else if (val.Is<tString>())
+        else if (strcmp(whenceStr, "cur") == 0)
         {
-            HeapString* hs = TranslateToRawPointer(vm, val.As<tString>());
-            size_t written = fwrite(hs->m_string, sizeof(char), hs->m_length /*length*/, fp);
-            if (unlikely(hs->m_length != written)) { success = false; break; }
+            whence = SEEK_CUR;
+        }
+        else if (strcmp(whenceStr, "end") == 0)
+        {
+            whence = SEEK_END;
         }
         else
         {
-            // TODO: make error message consistent with Lua
-            ThrowError("bad argument to 'write' (string expected)");
+            ThrowError("bad argument #1 to 'seek' (invalid option)");
         }
     }
 
-    if (likely(success))
+    int64_t offset = 0;
+    if (numArgs > 2 && !GetArg(2).Is<tNil>())
     {
-        Return(TValue::Create<tBool>(true));
+        auto [success, val] = LuaLib_ToNumber(GetArg(2));
+        if (unlikely(!success))
+        {
+            ThrowError("bad argument #2 to 'seek' (number expected)");
+        }
+        offset = static_cast<int64_t>(val);
+    }
+
+    int64_t pos = file->Seek(whence, offset);
+    if (unlikely(pos < 0))
+    {
+        int err = errno;
+        Return(TValue::Create<tNil>(), MakeIoErrorString(VM::GetActiveVMForCurrentThread(), err, nullptr), TValue::Create<tDouble>(err));
+    }
+    Return(TValue::Create<tDouble>(static_cast<double>(pos)));
+}
+
+// file:setvbuf -- https://www.lua.org/manual/5.1/manual.html#pdf-file:setvbuf
+//
+// file:setvbuf (mode [, size])
+// Sets the buffering mode for an output file. There are three available modes:
+//     "no": no buffering; the result of any output operation appears immediately.
+//     "full": full buffering; output operation is performed only when the buffer is full (or when you explicitly flush the file).
+//     "line": line buffering; output is buffered until a newline is output or there is any input from some special files (such
+//             as a terminal device).
+// For the last two cases, size specifies the size of the buffer, in bytes. The default is an appropriate size.
+//
+DEEGEN_DEFINE_LIB_FUNC(iofile_setvbuf)
+{
+    GET_SELF_AS_OPEN_FILE(setvbuf, file);
+    size_t numArgs = GetNumArgs();
+    if (unlikely(numArgs < 2 || !GetArg(1).Is<tString>()))
+    {
+        ThrowError("bad argument #1 to 'setvbuf' (string expected)");
+    }
+    const char* modeStr = reinterpret_cast<const char*>(TranslateToRawPointer(GetArg(1).As<tString>()->m_string));
+    int mode;
+    if (strcmp(modeStr, "no") == 0)
+    {
+        mode = _IONBF;
+    }
+    else if (strcmp(modeStr, "full") == 0)
+    {
+        mode = _IOFBF;
+    }
+    else if (strcmp(modeStr, "line") == 0)
+    {
+        mode = _IOLBF;
     }
     else
+    {
+        ThrowError("bad argument #1 to 'setvbuf' (invalid option)");
+    }
+
+    size_t size = LuaIoFile::x_writeBufferSize;
+    if (numArgs > 2 && !GetArg(2).Is<tNil>())
+    {
+        auto [success, val] = LuaLib_ToNumber(GetArg(2));
+        if (unlikely(!success))
+        {
+            ThrowError("bad argument #2 to 'setvbuf' (number expected)");
+        }
+        size = (val > 0 && val < 1e9) ? static_cast<size_t>(val) : 0;
+    }
+
+    if (unlikely(!file->SetVBuf(mode, size)))
+    {
+        int err = errno;
+        Return(TValue::Create<tNil>(), MakeIoErrorString(VM::GetActiveVMForCurrentThread(), err, nullptr), TValue::Create<tDouble>(err));
+    }
+    Return(TValue::Create<tBool>(true));
+}
+
+// file:write -- https://www.lua.org/manual/5.1/manual.html#pdf-file:write
+//
+// file:write (···)
+// Writes the value of each of its arguments to the file. The arguments must be strings or numbers. To write other values, use
+// tostring or string.format before write.
+//
+DEEGEN_DEFINE_LIB_FUNC(iofile_write)
+{
+    GET_SELF_AS_OPEN_FILE(write, file);
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    ssize_t res = IoWriteImpl(vm, file, GetStackBase() + 1, GetNumArgs() - 1);
+    if (likely(res == -1))
+    {
+        Return(TValue::Create<tBool>(true));
+    }
+    if (res == -2)
     {
         int err = errno;
-        const char* errstr = strerror(err);
-        TValue tvErrStr = TValue::CreatePointer(vm->CreateStringObjectFromRawString(errstr, static_cast<uint32_t>(strlen(errstr))));
-        Return(TValue::Create<tNil>(), tvErrStr, TValue::Create<tDouble>(err));
+        Return(TValue::Create<tNil>(), MakeIoErrorString(vm, err, nullptr), TValue::Create<tDouble>(err));
+    }
+    char msg[100];
+    snprintf(msg, 100, "bad argument #%d to 'write' (string expected)", static_cast<int>(res + 1));
+    ThrowError(MakeErrorMessage(msg));
+}
+
+// The '__tostring' metamethod of file handles
+//
+DEEGEN_DEFINE_LIB_FUNC(iofile_tostring)
+{
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    LuaIoFile* file = (GetNumArgs() > 0) ? vm->GetIoLibState()->TryGetFile(GetArg(0)) : nullptr;
+    if (unlikely(file == nullptr))
+    {
+        ThrowError("bad argument #1 to 'tostring' (FILE* expected)");
+    }
+    char buf[100];
+    if (file->IsClosed())
+    {
+        snprintf(buf, 100, "file (closed)");
+    }
+    else
+    {
+        snprintf(buf, 100, "file (%p)", static_cast<void*>(file));
     }
+    Return(TValue::Create<tString>(vm->CreateStringObjectFromRawCString(buf)));
 }
 
 DEEGEN_END_LIB_FUNC_DEFINITIONS
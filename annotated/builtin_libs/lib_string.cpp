@@ -63,14 +63,20 @@ DEEGEN_DEFINE_LIB_FUNC(string_byte)
         Return();
     }
 
+    size_t numValues = static_cast<size_t>(ub - lb + 1);
     TValue* sb = GetStackBase();
+    if (unlikely(!GetCurrentCoroutine()->TryEnsureStackSpace(sb, numValues + x_minNilFillReturnValues)))
+    {
+        ThrowError("string slice too long");
+    }
+
     ptr--;
     for (int64_t i = lb; i <= ub; i++)
     {
         uint8_t charVal = static_cast<uint8_t>(ptr[i]);
         sb[i - lb] = TValue::Create<tDouble>(charVal);
     }
-    ReturnValueRange(sb, static_cast<size_t>(ub - lb + 1));
+    ReturnValueRange(sb, numValues);
 }
 
 // Return -1 if not convertible to number, -2 if out of range
@@ -3,6 +3,50 @@
 #include "runtime_utils.h"
 #include "simple_string_stream.h"
 
+// table.concat fast path for a continuous array whose elements are all int32 or all double (see ArrayType::Kind),
+// so no type check is needed for each element.
+//
+// Stringify the elements in [start, end] directly into one buffer with the separators in between,
+// instead of collecting the pieces and stringifying the numbers in separate passes.
+//
+template<typename T>
+static HeapPtr<HeapString> WARN_UNUSED LuaLibTableConcatNumberArray(VM* vm,
+                                                                    TValue* arr,
+                                                                    int64_t start,
+                                                                    int64_t end,
+                                                                    const void* separator,
+                                                                    uint32_t separatorLength,
+                                                                    SimpleTempStringStream& buffer /*inout*/)
+{
+    static_assert(std::is_same_v<T, tDouble> || std::is_same_v<T, tInt32>);
+    Assert(start <= end);
+    size_t n = static_cast<size_t>(end - start + 1);
+    size_t spaceForOne = std::is_same_v<T, tDouble> ? x_default_tostring_buffersize_double : x_default_tostring_buffersize_int;
+    char* buf = buffer.Reserve(spaceForOne * n + static_cast<size_t>(separatorLength) * (n - 1));
+    char* cur = buf;
+    for (int64_t i = start; i <= end; i++)
+    {
+        Assert(arr[i].Is<T>());
+        // note that 'cur' points at the '\0' after the stringified number, which is overwritten by the separator or the next number
+        //
+        if constexpr(std::is_same_v<T, tDouble>)
+        {
+            cur = StringifyDoubleUsingDefaultLuaFormattingOptions(cur, arr[i].As<tDouble>());
+        }
+        else
+        {
+            cur = StringifyInt32UsingDefaultLuaFormattingOptions(cur, arr[i].As<tInt32>());
+        }
+        if (i < end)
+        {
+            memcpy(cur, separator, separatorLength);
+            cur += separatorLength;
+        }
+    }
+    Assert(cur < buffer.m_bufferEnd);
+    return vm->CreateStringObjectFromRawString(buf, SafeIntegerCast<uint32_t>(cur - buf)).As();
+}
+
 // table.concat -- https://www.lua.org/manual/5.1/manual.html#pdf-table.concat
 //
 // table.concat (table [, sep [, i [, j]]])
@@ -94,6 +138,37 @@ DEEGEN_DEFINE_LIB_FUNC(table_concat)
         Return(TValue::Create<tString>(vm->m_emptyString));
     }
 
+    // Fast path: [start, end] is within a continuous array whose elements are all numbers of the same type.
+    // The result length is checked to fit in uint32_t, otherwise we go to the general path, which handles the error.
+    //
+    {
+        ArrayType arrType = TCGet(tab->m_arrayType);
+        if (arrType.IsContinuous() &&
+            (arrType.ArrayKind() == ArrayType::Kind::Double || arrType.ArrayKind() == ArrayType::Kind::Int32) &&
+            start >= ArrayGrowthPolicy::x_arrayBaseOrd &&
+            end < static_cast<int64_t>(tab->m_butterfly->GetHeader()->m_arrayLengthIfContinuous) + ArrayGrowthPolicy::x_arrayBaseOrd)
+        {
+            uint64_t n = static_cast<uint64_t>(end - start + 1);
+            uint64_t maxResultLength = n * std::max(x_default_tostring_buffersize_double, x_default_tostring_buffersize_int) + static_cast<uint64_t>(separatorLength) * (n - 1);
+            if (maxResultLength < std::numeric_limits<uint32_t>::max())
+            {
+                TValue* arr = reinterpret_cast<TValue*>(tab->m_butterfly);
+                SimpleTempStringStream buffer;
+                HeapPtr<HeapString> result;
+                if (arrType.ArrayKind() == ArrayType::Kind::Double)
+                {
+                    result = LuaLibTableConcatNumberArray<tDouble>(vm, arr, start, end, separator, separatorLength, buffer /*inout*/);
+                }
+                else
+                {
+                    result = LuaLibTableConcatNumberArray<tInt32>(vm, arr, start, end, separator, separatorLength, buffer /*inout*/);
+                }
+                buffer.Destroy();
+                Return(TValue::Create<tString>(result));
+            }
+        }
+    }
+
     // Try to avoid temp buffer allocation if possible
     //
     constexpr size_t x_internalStringBufferLimit = 200;
@@ -439,6 +514,9 @@ static void LuaLibTableSortStringNonContinuousArrayNoMM(HeapPtr<TableObject> tab
 // which is what this struct does. Every step, it takes in the previous comparison result, and produces the next pair of
 // values to compare, until the sorting is complete.
 //
+// This is only used for table.sort using operator < that may call metamethods. Sorting with a user comparator is done
+// by a Lua function (see lualib_lua_implemented.cpp), which is naturally resumable.
+//
 struct QuickSortStateMachine
 {
     struct Result
@@ -498,7 +576,7 @@ struct QuickSortStateMachine
     //
     // The physical stack (the Lua stack) is arranged as follows:
     // Slot 0: the table
-    // Slot 1: the comparator, or nil if operator < is used
+    // Slot 1: unused (table.sort with a user comparator does not use this state machine)
     // Slot 2: h (int32), the height of the stack 's' in qsort function
     // Slot 3: pivot
     // Slot 4: i
@@ -851,28 +929,28 @@ LessThanComparisonResult WARN_UNUSED LuaLibTableSortDoLessThanComparison(TValue
             return LessThanComparisonResult::Error;
         }
 
-        if (lhs.Is<tTable>())
+        // Tables and full userdata each have their own metatable, so both operands must agree on the metamethod
+        //
+        if (lhs.Is<tTable>() || lhs.Is<tUserdata>())
         {
             HeapPtr<TableObject> lhsMetatable;
             {
-                HeapPtr<TableObject> tableObj = lhs.As<tTable>();
-                TableObject::GetMetatableResult result = TableObject::GetMetatable(tableObj);
-                if (result.m_result.m_value == 0)
+                UserHeapPointer<void> result = lhs.Is<tTable>() ? TableObject::GetMetatable(lhs.As<tTable>()).m_result : HeapCDataObject::GetMetatable(lhs.As<tUserdata>());
+                if (result.m_value == 0)
                 {
                     return LessThanComparisonResult::Error;
                 }
-                lhsMetatable = result.m_result.As<TableObject>();
+                lhsMetatable = result.As<TableObject>();
             }
 
             HeapPtr<TableObject> rhsMetatable;
             {
-                HeapPtr<TableObject> tableObj = rhs.As<tTable>();
-                TableObject::GetMetatableResult result = TableObject::GetMetatable(tableObj);
-                if (result.m_result.m_value == 0)
+                UserHeapPointer<void> result = rhs.Is<tTable>() ? TableObject::GetMetatable(rhs.As<tTable>()).m_result : HeapCDataObject::GetMetatable(rhs.As<tUserdata>());
+                if (result.m_value == 0)
                 {
                     return LessThanComparisonResult::Error;
                 }
-                rhsMetatable = result.m_result.As<TableObject>();
+                rhsMetatable = result.As<TableObject>();
             }
 
             metamethod = GetMetamethodFromMetatableForComparisonOperation<false /*canQuicklyRuleOutMM*/>(lhsMetatable, rhsMetatable, LuaMetamethodKind::Lt);
@@ -892,8 +970,6 @@ LessThanComparisonResult WARN_UNUSED LuaLibTableSortDoLessThanComparison(TValue
             return (lhsString->Compare(rhsString) < 0) ? LessThanComparisonResult::True : LessThanComparisonResult::False;
         }
 
-        Assert(!lhs.Is<tUserdata>() && "unimplemented");
-
         metamethod = GetMetamethodForValue(lhs, LuaMetamethodKind::Lt);
         if (metamethod.IsNil())
         {
@@ -1004,28 +1080,13 @@ DEEGEN_DEFINE_LIB_FUNC_CONTINUATION(table_sort_no_comparator_continuation)
 
 DEEGEN_DEFINE_LIB_FUNC_CONTINUATION(table_sort_usr_comparator_continuation)
 {
-    bool mmRes = false;
-    if (GetNumReturnValues() > 0)
-    {
-        mmRes = GetReturnValuesBegin()[0].IsTruthy();
-    }
-
-    TValue* sb = GetStackBase();
-    QuickSortStateMachine qsm = QuickSortStateMachine::GetFromStack(sb);
-    QuickSortStateMachine::Result action = qsm.Advance(mmRes);
-    if (action.finish)
+    // The Lua-implemented sort function returns false if it found that the comparator is inconsistent
+    //
+    if (unlikely(GetNumReturnValues() == 0 || !GetReturnValuesBegin()[0].IsTruthy()))
     {
-        Return();
+        ThrowError("invalid order function for sorting");
     }
-
-    TValue fn = sb[1];
-    Assert(fn.Is<tFunction>());
-    qsm.PutToStack();
-    TValue* callFrame = qsm.CallFrameEnd();
-    callFrame[0] = fn;
-    callFrame[x_numSlotsForStackFrameHeader] = action.lhs;
-    callFrame[x_numSlotsForStackFrameHeader + 1] = action.rhs;
-    MakeInPlaceCall(callFrame + x_numSlotsForStackFrameHeader, 2 /*numArgs*/, DEEGEN_LIB_FUNC_RETURN_CONTINUATION(table_sort_usr_comparator_continuation));
+    Return();
 }
 
 // table.sort -- https://www.lua.org/manual/5.1/manual.html#pdf-table.sort
@@ -1064,7 +1125,6 @@ DEEGEN_DEFINE_LIB_FUNC(table_sort)
         {
             ThrowError("bad argument #2 to 'sort' (function expected)");
         }
-        HeapPtr<FunctionObject> func = GetArg(1).As<tFunction>();
 
         size_t n = TableObject::GetTableLengthWithLuaSemantics(tab);
         if (n < 2)
@@ -1072,17 +1132,15 @@ DEEGEN_DEFINE_LIB_FUNC(table_sort)
             Return();
         }
 
-        TValue* sb = GetStackBase();
-        QuickSortStateMachine qsm = QuickSortStateMachine::Init(sb, tab, static_cast<int32_t>(n));
-        QuickSortStateMachine::Result action = qsm.InitialAdvance();
-        Assert(!action.finish);
-
-        qsm.PutToStack();
-        TValue* callFrame = qsm.CallFrameEnd();
-        callFrame[0] = TValue::Create<tFunction>(func);
-        callFrame[x_numSlotsForStackFrameHeader] = action.lhs;
-        callFrame[x_numSlotsForStackFrameHeader + 1] = action.rhs;
-        MakeInPlaceCall(callFrame + x_numSlotsForStackFrameHeader, 2 /*numArgs*/, DEEGEN_LIB_FUNC_RETURN_CONTINUATION(table_sort_usr_comparator_continuation));
+        // Sorting with a user comparator is done by a sort function implemented in Lua (see lualib_lua_implemented.cpp),
+        // so that the comparator is called from Lua code and is visible to the JIT
+        //
+        TValue* callFrame = GetStackBase();
+        callFrame[0] = vm->GetLibFn<VM::LibFn::TableSortWithComparator>();
+        callFrame[x_numSlotsForStackFrameHeader] = TValue::Create<tTable>(tab);
+        callFrame[x_numSlotsForStackFrameHeader + 1] = TValue::Create<tDouble>(static_cast<double>(n));
+        callFrame[x_numSlotsForStackFrameHeader + 2] = cmpFn;
+        MakeInPlaceCall(callFrame + x_numSlotsForStackFrameHeader, 3 /*numArgs*/, DEEGEN_LIB_FUNC_RETURN_CONTINUATION(table_sort_usr_comparator_continuation));
     }
     else
     {
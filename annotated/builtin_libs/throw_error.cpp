@@ -86,6 +86,10 @@ DEEGEN_DEFINE_LIB_FUNC_CONTINUATION(OnProtectedCallErrorReturn)
     hdr = reinterpret_cast<StackFrameHeader*>(hdr->m_caller) - 1;
     Assert(hdr != nullptr);
 
+    // The error is caught, so if it is a stack overflow, the raised stack limit is no longer needed
+    //
+    GetCurrentCoroutine()->ResetStackLimitAfterError();
+
     LongJump(hdr, stackbase /*retStart*/, 2 /*numRets*/);
 }
 
@@ -173,6 +177,11 @@ DEEGEN_DEFINE_LIB_FUNC(DeegenInternal_ThrowTValueErrorImpl)
         // Set the current coroutine dead
         //
         currentCoro->m_coroutineStatus.SetDead(true);
+        VM::GetActiveVMForCurrentThread()->UnregisterLiveCoroutine(currentCoro);
+
+        // The stack of a dead coroutine is never used again, so return it to the VM (the error object is not on the stack)
+        //
+        currentCoro->ReleaseStackOfDeadCoroutine(VM::GetActiveVMForCurrentThread());
 
         // Check if the parent coroutine resumed the current coroutine via coroutine.wrap or coroutine.resume
         // DEVNOTE: this is currently accomplished by a hack that repurposes 'm_numVariadicArguments' of the
@@ -185,8 +194,7 @@ DEEGEN_DEFINE_LIB_FUNC(DeegenInternal_ThrowTValueErrorImpl)
             // For coroutine.resume, the error should not be propagated further.
             // We should simply make coroutine.resume return 'false' plus the error object.
             // Note that we also need to pad nils to x_minNilFillReturnValues, as required by our internal call scheme.
-            //
-            // TODO: we need to check for stack overflow here once we implement resizable stack
+            // This only writes a few slots at the stack base of 'coroutine.resume', which is always within the stack limit margin.
             //
             dstStackBase[0] = TValue::Create<tBool>(false);
             dstStackBase[1] = errorObject;
@@ -288,6 +296,17 @@ DEEGEN_DEFINE_LIB_FUNC(DeegenInternal_ThrowTValueErrorImpl)
         // it as is fow now.
         //
         TValue* callFrameBegin = GetStackBase() + stackFrameSize;
+
+        // The handler frame is placed without a stack check, and may be beyond the stack limit if we are handling a stack overflow.
+        // If the handler (which may be a library function that uses a few slots without checking) would not fit in the reserved
+        // stack, treat this as too many nested errors, since only nested error handlers can get this far.
+        //
+        if (unlikely(callFrameBegin + x_numSlotsForStackFrameHeader + CoroutineRuntimeContext::x_stackLimitMarginSlots > currentCoro->m_stackBegin + currentCoro->m_numStackSlots))
+        {
+            errorObject = MakeErrorMessageForTooManyNestedErrors();
+            goto handle_pcall;
+        }
+
         callFrameBegin[0] = TValue::CreatePointer(handler);
         callFrameBegin[x_numSlotsForStackFrameHeader] = errorObject;
         MakeInPlaceCall(callFrameBegin + x_numSlotsForStackFrameHeader, 1 /*numArgs*/, DEEGEN_LIB_FUNC_RETURN_CONTINUATION(OnProtectedCallErrorReturn));
@@ -301,6 +320,10 @@ handle_pcall:
         stackbase[0] = TValue::CreateFalse();
         stackbase[1] = errorObject;
 
+        // The error is caught, so if it is a stack overflow, the raised stack limit is no longer needed
+        //
+        GetCurrentCoroutine()->ResetStackLimitAfterError();
+
         // We need to return to the caller of 'pcall'
         //
         LongJump(protectedCallFrame, stackbase /*retStart*/, 2 /*numReturnValues*/);
@@ -139,4 +139,96 @@ DEEGEN_DEFINE_BYTECODE_BY_TEMPLATE_INSTANTIATION(CallM, CallOperation, true /*pa
 DEEGEN_DEFINE_BYTECODE_BY_TEMPLATE_INSTANTIATION(CallR, CallOperation, false /*passVariadicRes*/, true /*storeVariadicRes*/);
 DEEGEN_DEFINE_BYTECODE_BY_TEMPLATE_INSTANTIATION(CallMR, CallOperation, true /*passVariadicRes*/, true /*storeVariadicRes*/);
 
+// A call 'select(selector, ...)' that takes one result, where the variadic arguments have been stored as the variadic results
+// (by StoreVarArgsAsVariadicResults) right before this bytecode
+//
+// The parser emits this bytecode instead of CallM only if the callee is named 'select', but the semantics is exactly the same
+// as CallM with one fixed argument and one result. If the callee turns out to be the true 'select', the result is read directly
+// from the variadic results, so we do not need to set up a call frame, copy the variadic arguments into it, and copy the
+// return value back. Otherwise (or if 'select' would throw an error), we make the call normally.
+//
+static void NO_RETURN CallSelectVarArgsReturnContinuation(TValue* base)
+{
+    StoreReturnValuesTo(base /*dst*/, 1 /*numToStore*/);
+    Return();
+}
+
+static void NO_RETURN CallSelectVarArgsGenericCallSlowPath(TValue* base)
+{
+    TValue func = base[0];
+    TValue* argStart = base + x_numSlotsForStackFrameHeader;
+
+    if (likely(func.Is<tFunction>()))
+    {
+        MakeInPlaceCallPassingVariadicRes(func.As<tFunction>(), argStart, 1 /*numArgs*/, CallSelectVarArgsReturnContinuation);
+    }
+
+    HeapPtr<FunctionObject> callTarget = GetCallTargetViaMetatable(func);
+    if (unlikely(callTarget == nullptr))
+    {
+        ThrowError(MakeErrorMessageForUnableToCall(func));
+    }
+    MakeCallPassingVariadicRes(callTarget, func, argStart, static_cast<size_t>(1) /*numArgs*/, CallSelectVarArgsReturnContinuation);
+}
+
+static void NO_RETURN CallSelectVarArgsImpl(TValue* base)
+{
+    if (likely(base[0].m_value == VM_GetLibFunctionObject<VM::LibFn::BaseSelect>().m_value))
+    {
+        TValue selector = base[x_numSlotsForStackFrameHeader];
+        size_t numVarArgs = VariadicResultsAccessor::GetNum();
+        if (likely(selector.Is<tDouble>()))
+        {
+            // Same logic as base_select, note that the selector itself counts as an argument of 'select'
+            //
+            int64_t ord = static_cast<int64_t>(selector.As<tDouble>());
+            int64_t range = static_cast<int64_t>(numVarArgs + 1);
+            if (ord < 0)
+            {
+                ord += range;
+            }
+            else if (ord > range)
+            {
+                ord = range;
+            }
+            if (likely(ord >= 1))
+            {
+                base[0] = (ord < range) ? VariadicResultsAccessor::GetPtr()[ord - 1] : TValue::Create<tNil>();
+                Return();
+            }
+        }
+        else if (selector.Is<tString>())
+        {
+            HeapPtr<HeapString> str = selector.As<tString>();
+            if (likely(str->m_length == 1 && str->m_string[0] == static_cast<uint8_t>('#')))
+            {
+                base[0] = TValue::Create<tDouble>(static_cast<double>(numVarArgs));
+                Return();
+            }
+        }
+    }
+
+    EnterSlowPath<CallSelectVarArgsGenericCallSlowPath>();
+}
+
+DEEGEN_DEFINE_BYTECODE(CallSelectVarArgs)
+{
+    Operands(
+        BytecodeRangeBaseRW("base")
+    );
+    Result(NoOutput);
+    Implementation(CallSelectVarArgsImpl);
+    Variant();
+    DfgVariant();
+    DeclareReads(
+        Range(Op("base"), 1),
+        Range(Op("base") + x_numSlotsForStackFrameHeader, 1),
+        VariadicResults()
+    );
+    DeclareWrites(
+        Range(Op("base"), 1).TypeDeductionRule(ValueProfile)
+    );
+    DeclareUsedByInPlaceCall(Op("base"));
+}
+
 DEEGEN_END_BYTECODE_DEFINITIONS
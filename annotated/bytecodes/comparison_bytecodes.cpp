@@ -154,28 +154,28 @@ void NO_RETURN ComparisonOperationImpl(TValue lhs, TValue rhs)
                 }
             }
 
-            if (lhs.Is<tTable>())
+            // Tables and full userdata each have their own metatable, so we must check that both operands agree on the metamethod
+            //
+            if (lhs.Is<tTable>() || lhs.Is<tUserdata>())
             {
                 HeapPtr<TableObject> lhsMetatable;
                 {
-                    HeapPtr<TableObject> tableObj = lhs.As<tTable>();
-                    TableObject::GetMetatableResult result = TableObject::GetMetatable(tableObj);
-                    if (result.m_result.m_value == 0)
+                    UserHeapPointer<void> result = lhs.Is<tTable>() ? TableObject::GetMetatable(lhs.As<tTable>()).m_result : HeapCDataObject::GetMetatable(lhs.As<tUserdata>());
+                    if (result.m_value == 0)
                     {
                         goto fail;
                     }
-                    lhsMetatable = result.m_result.As<TableObject>();
+                    lhsMetatable = result.As<TableObject>();
                 }
 
                 HeapPtr<TableObject> rhsMetatable;
                 {
-                    HeapPtr<TableObject> tableObj = rhs.As<tTable>();
-                    TableObject::GetMetatableResult result = TableObject::GetMetatable(tableObj);
-                    if (result.m_result.m_value == 0)
+                    UserHeapPointer<void> result = rhs.Is<tTable>() ? TableObject::GetMetatable(rhs.As<tTable>()).m_result : HeapCDataObject::GetMetatable(rhs.As<tUserdata>());
+                    if (result.m_value == 0)
                     {
                         goto fail;
                     }
-                    rhsMetatable = result.m_result.As<TableObject>();
+                    rhsMetatable = result.As<TableObject>();
                 }
 
                 metamethod = GetMetamethodFromMetatableForComparisonOperation<false /*canQuicklyRuleOutMM*/>(lhsMetatable, rhsMetatable, GetMetamethodKind<opKind>());
@@ -207,8 +207,6 @@ void NO_RETURN ComparisonOperationImpl(TValue lhs, TValue rhs)
                 goto do_metamethod_call;
             }
 
-            Assert(!lhs.Is<tUserdata>() && "unimplemented");
-
             metamethod = GetMetamethodForValue(lhs, GetMetamethodKind<opKind>());
             if (metamethod.IsNil())
             {
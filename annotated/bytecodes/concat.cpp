@@ -22,16 +22,12 @@ struct ScanForMetamethodCallResult
 
 inline HeapPtr<HeapString> WARN_UNUSED StringifyDoubleToStringObject(double value)
 {
-    char buf[x_default_tostring_buffersize_double];
-    char* bufEnd = StringifyDoubleUsingDefaultLuaFormattingOptions(buf /*out*/, value);
-    return VM::GetActiveVMForCurrentThread()->CreateStringObjectFromRawString(buf, static_cast<uint32_t>(bufEnd - buf)).As();
+    return VM::GetActiveVMForCurrentThread()->CreateStringObjectFromDouble(value).As();
 }
 
 inline HeapPtr<HeapString> WARN_UNUSED StringifyInt32ToStringObject(int32_t value)
 {
-    char buf[x_default_tostring_buffersize_int];
-    char* bufEnd = StringifyInt32UsingDefaultLuaFormattingOptions(buf /*out*/, value);
-    return VM::GetActiveVMForCurrentThread()->CreateStringObjectFromRawString(buf, static_cast<uint32_t>(bufEnd - buf)).As();
+    return VM::GetActiveVMForCurrentThread()->CreateStringObjectFromInt32(value).As();
 }
 
 inline std::optional<HeapPtr<HeapString>> WARN_UNUSED TryGetStringOrConvertNumberToString(TValue value)
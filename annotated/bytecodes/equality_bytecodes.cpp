@@ -63,30 +63,55 @@ void NO_RETURN EqualityOperationImpl(TValue lhs, TValue rhs)
     Assert(!lhs.Is<tInt32>() && "unimplemented");
     Assert(!rhs.Is<tInt32>() && "unimplemented");
 
-    if (likely(lhs.Is<tTable>() && rhs.Is<tTable>()))
     {
         // Consider metamethod call
+        // This only happens if both are tables or both are full userdata. Light userdata are interned, so two light userdata
+        // holding the same pointer are bitwise equal and have been handled above, and __eq is never considered for them.
         //
         HeapPtr<TableObject> lhsMetatable;
+        HeapPtr<TableObject> rhsMetatable;
+        if (likely(lhs.Is<tTable>() && rhs.Is<tTable>()))
         {
-            HeapPtr<TableObject> tableObj = lhs.As<tTable>();
-            TableObject::GetMetatableResult gmr = TableObject::GetMetatable(tableObj);
-            if (gmr.m_result.m_value == 0)
             {
-                goto not_equal;
+                HeapPtr<TableObject> tableObj = lhs.As<tTable>();
+                TableObject::GetMetatableResult gmr = TableObject::GetMetatable(tableObj);
+                if (gmr.m_result.m_value == 0)
+                {
+                    goto not_equal;
+                }
+                lhsMetatable = gmr.m_result.As<TableObject>();
             }
-            lhsMetatable = gmr.m_result.As<TableObject>();
-        }
 
-        HeapPtr<TableObject> rhsMetatable;
+            {
+                HeapPtr<TableObject> tableObj = rhs.As<tTable>();
+                TableObject::GetMetatableResult gmr = TableObject::GetMetatable(tableObj);
+                if (gmr.m_result.m_value == 0)
+                {
+                    goto not_equal;
+                }
+                rhsMetatable = gmr.m_result.As<TableObject>();
+            }
+        }
+        else if (lhs.Is<tUserdata>() && rhs.Is<tUserdata>())
         {
-            HeapPtr<TableObject> tableObj = rhs.As<tTable>();
-            TableObject::GetMetatableResult gmr = TableObject::GetMetatable(tableObj);
-            if (gmr.m_result.m_value == 0)
+            HeapPtr<HeapCDataObject> lhsUd = lhs.As<tUserdata>();
+            HeapPtr<HeapCDataObject> rhsUd = rhs.As<tUserdata>();
+            if (lhsUd->m_kind != HeapCDataObject::Kind::Full || rhsUd->m_kind != HeapCDataObject::Kind::Full)
+            {
+                goto not_equal;
+            }
+            UserHeapPointer<void> lhsMt = TCGet(lhsUd->m_metatable);
+            UserHeapPointer<void> rhsMt = TCGet(rhsUd->m_metatable);
+            if (lhsMt.m_value == 0 || rhsMt.m_value == 0)
             {
                 goto not_equal;
             }
-            rhsMetatable = gmr.m_result.As<TableObject>();
+            lhsMetatable = lhsMt.As<TableObject>();
+            rhsMetatable = rhsMt.As<TableObject>();
+        }
+        else
+        {
+            goto not_equal;
         }
 
         TValue metamethod = GetMetamethodFromMetatableForComparisonOperation<true /*supportsQuicklyRuleOutMM*/>(lhsMetatable, rhsMetatable, LuaMetamethodKind::Eq);
@@ -133,13 +158,20 @@ DEEGEN_DEFINE_BYTECODE_TEMPLATE(EqualityOperation, bool compareForNotEqual, bool
     );
     Result(shouldBranch ? ConditionalBranch : BytecodeValue);
     Implementation(EqualityOperationImpl<compareForNotEqual, shouldBranch>);
-    // TODO: we need quickening since we want to dynamically specialize for double, not-double, and maybe table
+    // Dynamically specialize for double, for comparing against nil or boolean, and for strings.
+    // Comparing doubles is the most common case, so it is the first (initial) quickening candidate.
+    //
     Variant(
         Op("lhs").IsBytecodeSlot(),
         Op("rhs").IsBytecodeSlot()
-    ).EnableHotColdSplitting(
+    ).AddQuickeningCandidate(
         Op("lhs").HasType<tDoubleNotNaN>(),
         Op("rhs").HasType<tDoubleNotNaN>()
+    ).AddQuickeningCandidate(
+        Op("rhs").HasType<tMIV>()
+    ).AddQuickeningCandidate(
+        Op("lhs").HasType<tString>(),
+        Op("rhs").HasType<tString>()
     );
     Variant(
         Op("lhs").IsBytecodeSlot(),
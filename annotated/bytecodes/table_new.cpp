@@ -3,25 +3,50 @@
 
 #include "runtime_utils.h"
 
-static void NO_RETURN TableNewImpl(uint8_t inlineStorageSizeStepping, uint16_t arrayPartSizeHint)
+static void NO_RETURN TableNewImpl(TValue tvProfile, uint8_t inlineStorageSizeStepping, uint16_t arrayPartSizeHint)
 {
     VM* vm = VM::GetActiveVMForCurrentThread();
-    SystemHeapPointer<Structure> structure = Structure::GetInitialStructureForSteppingKnowingAlreadyBuilt(vm, inlineStorageSizeStepping);
-    HeapPtr<TableObject> obj;
-    // We use the 'impl' version and pass in inlineCapacity directly so that Clang can do
-    // constant propagation for specialized 'inlineStorageSizeStepping' values
+    // This is a bit hacky but 'tvProfile' is always a pointer in the constant table, disguised as a TValue..
     //
-    [[clang::always_inline]] obj = TableObject::CreateEmptyTableObjectImpl(
-        vm,
-        TranslateToRawPointer(vm, structure.As()),
-        internal::x_inlineStorageSizeForSteppingArray[inlineStorageSizeStepping] /*inlineCapacity*/,
-        arrayPartSizeHint);
+    TableAllocationSiteProfile* profile = reinterpret_cast<TableAllocationSiteProfile*>(tvProfile.m_value);
+    HeapPtr<TableObject> obj;
+    if (likely(profile->m_inlineStorageSizeStepping == inlineStorageSizeStepping && profile->m_arrayPartSizeHint == arrayPartSizeHint))
+    {
+        // The allocation-site feedback agrees with the parser's guess
+        //
+        SystemHeapPointer<Structure> structure = Structure::GetInitialStructureForSteppingKnowingAlreadyBuilt(vm, inlineStorageSizeStepping);
+        // We use the 'impl' version and pass in inlineCapacity directly so that Clang can do
+        // constant propagation for specialized 'inlineStorageSizeStepping' values
+        //
+        [[clang::always_inline]] obj = TableObject::CreateEmptyTableObjectImpl(
+            vm,
+            TranslateToRawPointer(vm, structure.As()),
+            internal::x_inlineStorageSizeForSteppingArray[inlineStorageSizeStepping] /*inlineCapacity*/,
+            arrayPartSizeHint);
+    }
+    else
+    {
+        // Objects from this site grew larger than the parser's guess, presize according to the allocation-site feedback
+        //
+        uint8_t stepping = profile->m_inlineStorageSizeStepping;
+        SystemHeapPointer<Structure> structure = Structure::GetInitialStructureForSteppingKnowingAlreadyBuilt(vm, stepping);
+        obj = TableObject::CreateEmptyTableObjectImpl(
+            vm,
+            TranslateToRawPointer(vm, structure.As()),
+            internal::x_inlineStorageSizeForSteppingArray[stepping] /*inlineCapacity*/,
+            profile->m_arrayPartSizeHint);
+    }
+    if (unlikely(profile->IsObserving()))
+    {
+        profile->ObserveAllocation(vm, obj);
+    }
     Return(TValue::Create<tTable>(obj));
 }
 
 DEEGEN_DEFINE_BYTECODE(TableNew)
 {
     Operands(
+        Constant("allocationSiteProfile"),
         Literal<uint8_t>("inlineStorageSizeStepping"),
         Literal<uint16_t>("arrayPartSizeHint")
     );
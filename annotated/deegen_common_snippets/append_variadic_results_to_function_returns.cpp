@@ -6,6 +6,7 @@ static uint64_t DeegenSnippet_AppendVariadicResultsToFunctionReturns(uint64_t* r
     uint32_t num = coroCtx->m_numVariadicRets;
     uint64_t* src = reinterpret_cast<uint64_t*>(coroCtx->m_variadicRetStart);
     uint64_t* dst = retStart + numRet;
+    Assert(coroCtx->IsStackWritableWithoutCheck(reinterpret_cast<TValue*>(dst + num + 2)));
 
     size_t i = 0;
 #pragma clang loop unroll(disable)
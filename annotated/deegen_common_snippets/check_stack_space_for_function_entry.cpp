@@ -0,0 +1,16 @@
+#include "define_deegen_common_snippet.h"
+#include "runtime_utils.h"
+
+// Returns 0 if the stack has space for a call frame ending at 'frameEnd', otherwise the error object to throw
+//
+static uint64_t DeegenSnippet_CheckStackSpaceForFunctionEntry(CoroutineRuntimeContext* coroCtx, uint64_t* frameEnd)
+{
+    TValue* end = reinterpret_cast<TValue*>(frameEnd);
+    if (likely(end <= coroCtx->m_stackLimit))
+    {
+        return 0;
+    }
+    return coroCtx->GrowStackForFunctionEntry(end);
+}
+
+DEFINE_DEEGEN_COMMON_SNIPPET("CheckStackSpaceForFunctionEntry", DeegenSnippet_CheckStackSpaceForFunctionEntry)
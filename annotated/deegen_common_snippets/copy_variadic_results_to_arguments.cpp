@@ -6,6 +6,7 @@ static void DeegenSnippet_CopyVariadicResultsToArguments(uint64_t* dst, Coroutin
     uint32_t num = coroCtx->m_numVariadicRets;
 
     uint64_t* src = reinterpret_cast<uint64_t*>(coroCtx->m_variadicRetStart);
+    Assert(coroCtx->IsStackWritableWithoutCheck(reinterpret_cast<TValue*>(dst + num)));
     memmove(dst, src, sizeof(uint64_t) * num);
 }
 
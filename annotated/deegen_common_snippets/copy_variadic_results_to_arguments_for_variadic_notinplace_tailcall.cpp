@@ -10,6 +10,7 @@ static uint64_t DeegenSnippet_CopyVariadicResultsToArgumentsForVariadicNotInPlac
     {
         uint64_t* dst = stackBase + totalNumArgs;
         uint64_t* src = reinterpret_cast<uint64_t*>(coroCtx->m_variadicRetStart);
+        Assert(coroCtx->IsStackWritableWithoutCheck(reinterpret_cast<TValue*>(dst + num)));
         memmove(dst, src, sizeof(uint64_t) * num);
     }
     return totalNumArgs + num;
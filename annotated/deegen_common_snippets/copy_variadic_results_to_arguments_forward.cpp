@@ -6,6 +6,7 @@ static void DeegenSnippet_CopyVariadicResultsToArgumentsForwardMayOvercopy(uint6
     uint32_t num = coroCtx->m_numVariadicRets;
 
     uint64_t* src = reinterpret_cast<uint64_t*>(coroCtx->m_variadicRetStart);
+    Assert(coroCtx->IsStackWritableWithoutCheck(reinterpret_cast<TValue*>(dst + num + 2)));
 
     // What we need is just a memmove. We hand-implement it because:
     // 1. Calling 'memmove' will result in a ton of code, which is bad for our case.
@@ -0,0 +1,17 @@
+#include "define_deegen_common_snippet.h"
+#include "runtime_utils.h"
+
+// The megamorphic dispatch path for a JIT call IC site that has reached the maximum number of IC entries
+// ExecutableCode::m_bestEntryPoint is always kept up-to-date on tier-up, so it already serves as a one-load
+// dispatch table for all the call targets. We only need to record the event for statistics purpose.
+//
+static std::pair<HeapPtr<ExecutableCode>, void*> DeegenSnippet_GetCalleeEntryPointForMegamorphicCallSite(uint64_t target)
+{
+    VM::VM_IncrementNumJitCallIcMegamorphicCalls();
+    HeapPtr<FunctionObject> o = reinterpret_cast<HeapPtr<FunctionObject>>(target);
+    HeapPtr<ExecutableCode> ec = TCGet(o->m_executable).As();
+    void* entrypoint = ec->m_bestEntryPoint;
+    return std::make_pair(ec, entrypoint);
+}
+
+DEFINE_DEEGEN_COMMON_SNIPPET("GetCalleeEntryPointForMegamorphicCallSite", DeegenSnippet_GetCalleeEntryPointForMegamorphicCallSite)
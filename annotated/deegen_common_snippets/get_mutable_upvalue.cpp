@@ -6,7 +6,7 @@ static TValue DeegenSnippet_GetMutableUpvalueValue(uint64_t* stackBase, size_t u
     StackFrameHeader* hdr = StackFrameHeader::Get(stackBase);
     Assert(upvalueOrd < hdr->m_func->m_numUpvalues);
     Upvalue* uvPtr = FunctionObject::GetMutableUpvaluePtr(hdr->m_func, upvalueOrd);
-    return *(uvPtr->m_ptr);
+    return TCGet(*uvPtr->GetValuePtr());
 }
 
 DEFINE_DEEGEN_COMMON_SNIPPET("GetMutableUpvalueValue", DeegenSnippet_GetMutableUpvalueValue)
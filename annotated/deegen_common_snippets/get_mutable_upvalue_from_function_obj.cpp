@@ -5,7 +5,7 @@ static TValue DeegenSnippet_GetMutableUpvalueValueFromFunctionObject(HeapPtr<Fun
 {
     Assert(upvalueOrd < func->m_numUpvalues);
     Upvalue* uvPtr = FunctionObject::GetMutableUpvaluePtr(func, upvalueOrd);
-    return *(uvPtr->m_ptr);
+    return TCGet(*uvPtr->GetValuePtr());
 }
 
 DEFINE_DEEGEN_COMMON_SNIPPET("GetMutableUpvalueValueFromFunctionObject", DeegenSnippet_GetMutableUpvalueValueFromFunctionObject)
@@ -0,0 +1,9 @@
+#include "define_deegen_common_snippet.h"
+#include "runtime_utils.h"
+
+static bool DeegenSnippet_IsJitCallIcSiteMegamorphic(JitCallInlineCacheSite* site)
+{
+    return site->IsMegamorphic();
+}
+
+DEFINE_DEEGEN_COMMON_SNIPPET("IsJitCallIcSiteMegamorphic", DeegenSnippet_IsJitCallIcSiteMegamorphic)
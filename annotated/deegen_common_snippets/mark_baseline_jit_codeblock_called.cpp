@@ -0,0 +1,9 @@
+#include "define_deegen_common_snippet.h"
+#include "runtime_utils.h"
+
+static void DeegenSnippet_MarkBaselineJitCodeBlockCalled(BaselineCodeBlock* bcb)
+{
+    bcb->m_calledSinceLastEvictionScan = 1;
+}
+
+DEFINE_DEEGEN_COMMON_SNIPPET("MarkBaselineJitCodeBlockCalled", DeegenSnippet_MarkBaselineJitCodeBlockCalled)
@@ -21,6 +21,7 @@ static void* DeegenSnippet_MoveVariadicResultsForPrepend(uint64_t* stackBase, Co
     //
     {
         uint64_t elementsToMove = (numResults + 1) / 2 * 2;
+        Assert(coroCtx->IsStackWritableWithoutCheck(reinterpret_cast<TValue*>(dst + elementsToMove)));
         uint64_t* fromPtr = src + elementsToMove;
         uint64_t* toPtr = dst + elementsToMove;
 #pragma clang loop unroll(disable)
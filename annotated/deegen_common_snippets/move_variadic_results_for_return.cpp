@@ -13,6 +13,7 @@ static void* DeegenSnippet_MoveVariadicResultsForReturn(uint64_t* stackBase, Cor
         // However, we still need to append nil if needed. For simplicity, just always append x_minNilFillReturnValues nils
         //
         uint64_t* varResEnd = src + numResults;
+        Assert(coroCtx->IsStackWritableWithoutCheck(reinterpret_cast<TValue*>(varResEnd + x_minNilFillReturnValues)));
         uint64_t nilVal = TValue::Create<tNil>().m_value;
         for (size_t i = 0; i < x_minNilFillReturnValues; i++)
         {
@@ -28,6 +29,7 @@ static void* DeegenSnippet_MoveVariadicResultsForReturn(uint64_t* stackBase, Cor
     //
     {
         uint64_t elementsToMove = (numResults + 1) / 2 * 2;
+        Assert(coroCtx->IsStackWritableWithoutCheck(reinterpret_cast<TValue*>(dst + numResults + x_minNilFillReturnValues)));
         uint64_t* fromPtr = src + elementsToMove;
         uint64_t* toPtr = dst + elementsToMove;
 #pragma clang loop unroll(disable)
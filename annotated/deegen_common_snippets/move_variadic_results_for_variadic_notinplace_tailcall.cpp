@@ -13,6 +13,7 @@ static bool DeegenSnippet_MoveVariadicResultsForVariadicNotInPlaceTailCall(uint6
         return false;
     }
 
+    Assert(coroCtx->IsStackWritableWithoutCheck(reinterpret_cast<TValue*>(dst + coroCtx->m_numVariadicRets)));
     memmove(dst, src, sizeof(uint64_t) * coroCtx->m_numVariadicRets);
     return true;
 }
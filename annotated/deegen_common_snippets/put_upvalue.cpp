@@ -6,8 +6,7 @@ static void DeegenSnippet_PutUpvalue(uint64_t* stackBase, size_t upvalueOrd, TVa
     StackFrameHeader* hdr = StackFrameHeader::Get(stackBase);
     Assert(upvalueOrd < hdr->m_func->m_numUpvalues);
     Upvalue* uv = FunctionObject::GetMutableUpvaluePtr(hdr->m_func, upvalueOrd);
-    TValue* ptr = uv->m_ptr;
-    *ptr = valueToPut;
+    TCSet(*uv->GetValuePtr(), valueToPut);
 }
 
 DEFINE_DEEGEN_COMMON_SNIPPET("PutUpvalue", DeegenSnippet_PutUpvalue)
@@ -5,8 +5,7 @@ static void DeegenSnippet_PutUpvalueFromFunctionObject(HeapPtr<FunctionObject> f
 {
     Assert(upvalueOrd < func->m_numUpvalues);
     Upvalue* uv = FunctionObject::GetMutableUpvaluePtr(func, upvalueOrd);
-    TValue* ptr = uv->m_ptr;
-    *ptr = valueToPut;
+    TCSet(*uv->GetValuePtr(), valueToPut);
 }
 
 DEFINE_DEEGEN_COMMON_SNIPPET("PutUpvalueFromFunctionObject", DeegenSnippet_PutUpvalueFromFunctionObject)
@@ -0,0 +1,9 @@
+#include "define_deegen_common_snippet.h"
+#include "interpreter_bytecode_pair_profile.h"
+
+static void DeegenSnippet_RecordInterpreterBytecodePair(uint64_t curOpcode, uint64_t nextOpcode)
+{
+    g_interpreterBytecodePairCounters[curOpcode * g_interpreterNumOpcodes + nextOpcode]++;
+}
+
+DEFINE_DEEGEN_COMMON_SNIPPET("RecordInterpreterBytecodePair", DeegenSnippet_RecordInterpreterBytecodePair)
@@ -0,0 +1,150 @@
+# Sweeps the VM options (see luajitr --list-vm-options) over the luabench benchmarks using the in-process
+# benchmark driver (luajitr_bench), and reports the best value of each option by geomean and for each benchmark.
+#
+# The options are tuned one at a time in the order given (coordinate descent): each option is swept with
+# the other options fixed at the best values found so far. Repeat with --rounds to refine.
+#
+# Example:
+#   python3 autotune_vm_options.py --bench-binary=build/luajitr_bench \
+#       --sweep=tier_up_multiplier=5,10,20,40 --sweep=max_call_ic_entries=2,3,4,8 fib nbody
+#
+
+import argparse
+import json
+import math
+import os
+import subprocess
+import sys
+import tempfile
+
+default_sweeps = [
+  'tier_up_multiplier=5,10,20,40,80',
+  'max_call_ic_entries=2,3,4,6,8',
+  'array_initial_capacity=2,4,8,16',
+  'array_growth_factor=2,3,4',
+]
+
+def parse_sweep(s):
+  pos = s.find('=')
+  if pos == -1:
+    sys.exit('[ERROR] --sweep expects name=v1,v2,..., got "' + s + '"')
+  values = [v for v in s[pos+1:].split(',') if v != '']
+  if len(values) == 0:
+    sys.exit('[ERROR] --sweep "' + s + '" has no values')
+  return (s[0:pos], values)
+
+def options_to_string(options):
+  return ','.join(name + '=' + value for (name, value) in options.items())
+
+def geomean(values):
+  assert(len(values) > 0)
+  return math.exp(sum(math.log(v) for v in values) / len(values))
+
+# Runs the benchmarks with the given VM options, returns a map from benchmark name to the median time
+#
+def run_benchmarks(args, options):
+  fd, json_file = tempfile.mkstemp(suffix='.json')
+  os.close(fd)
+  try:
+    cmd = [args.bench_binary,
+           '--iterations=' + str(args.iterations),
+           '--warmup=' + str(args.warmup),
+           '--tier=' + args.tier,
+           '--bench-dir=' + args.bench_dir,
+           '--input=' + args.input,
+           '--json=' + json_file,
+           '--vm-options=' + options_to_string(options)] + args.benchmarks
+    print('$ ' + ' '.join(cmd), file=sys.stderr)
+    r = subprocess.run(cmd, stdout=subprocess.DEVNULL)
+    if r.returncode != 0:
+      print('[WARNING] luajitr_bench exited with ' + str(r.returncode), file=sys.stderr)
+    try:
+      with open(json_file) as f:
+        output = json.load(f)
+    except ValueError:
+      # luajitr_bench did not get to write the results (e.g., invalid VM options)
+      #
+      return {}
+  finally:
+    os.remove(json_file)
+  result = {}
+  for res in output['results']:
+    result[res['benchmark']] = res['time']['median']
+  return result
+
+def main():
+  parser = argparse.ArgumentParser(description='Autotune the VM options over luabench')
+  parser.add_argument('--bench-binary', default='./luajitr_bench', help='path to luajitr_bench')
+  parser.add_argument('--bench-dir', default='luabench', help='directory of the benchmark scripts')
+  parser.add_argument('--input', default='luabench/FASTA_5000000', help='file fed to stdin of each run')
+  parser.add_argument('--tier', default='tierup', help='tier configuration to run (interpreter, baseline, tierup)')
+  parser.add_argument('--iterations', type=int, default=3, help='number of measured iterations per configuration')
+  parser.add_argument('--warmup', type=int, default=1, help='number of warmup iterations per configuration')
+  parser.add_argument('--base-options', default='', help='VM options fixed for all runs, as name=value,...')
+  parser.add_argument('--sweep', action='append', default=[], help='an option and the values to sweep, as name=v1,v2,... (repeatable)')
+  parser.add_argument('--rounds', type=int, default=1, help='number of rounds of coordinate descent')
+  parser.add_argument('--json', default='', help='write all measurements and the tuned options as JSON to this file')
+  parser.add_argument('benchmarks', nargs='*', help='benchmarks to run (default: all benchmarks of luajitr_bench)')
+  args = parser.parse_args()
+
+  sweeps = [parse_sweep(s) for s in (args.sweep if len(args.sweep) > 0 else default_sweeps)]
+
+  base = {}
+  for item in args.base_options.split(','):
+    if item != '':
+      (name, values) = parse_sweep(item)
+      base[name] = values[0]
+
+  # Measurements of every configuration run, keyed by the options string, so no configuration is run twice
+  #
+  measurements = {}
+  def measure(options):
+    key = options_to_string(options)
+    if not key in measurements:
+      measurements[key] = run_benchmarks(args, options)
+    return measurements[key]
+
+  best = dict(base)
+  per_benchmark_best = {}
+  for round in range(args.rounds):
+    for (name, values) in sweeps:
+      print('\n== Round ' + str(round + 1) + ': sweeping ' + name + ' ==', file=sys.stderr)
+      best_value = None
+      best_geomean = None
+      for value in values:
+        options = dict(best)
+        options[name] = value
+        times = measure(options)
+        if len(times) == 0:
+          print('[WARNING] all benchmarks failed with ' + options_to_string(options), file=sys.stderr)
+          continue
+        g = geomean(list(times.values()))
+        print('%s=%-10s geomean %.4fs' % (name, value, g), file=sys.stderr)
+        if best_geomean is None or g < best_geomean:
+          best_value = value
+          best_geomean = g
+        for (bench, t) in times.items():
+          entry = per_benchmark_best.setdefault(bench, {}).get(name)
+          if entry is None or t < entry[1]:
+            per_benchmark_best[bench][name] = (value, t)
+      if best_value is not None:
+        best[name] = best_value
+
+  print('\n== Best value of each option for each benchmark ==')
+  for (bench, entries) in sorted(per_benchmark_best.items()):
+    print('%-20s %s' % (bench, ' '.join('%s=%s' % (name, entries[name][0]) for (name, _) in sweeps if name in entries)))
+
+  print('\n== Best options by geomean ==')
+  print(options_to_string(best))
+
+  if args.json != '':
+    with open(args.json, 'w') as f:
+      json.dump({
+        'tier': args.tier,
+        'best_options': best,
+        'per_benchmark_best': { bench: { name: v[0] for (name, v) in entries.items() } for (bench, entries) in per_benchmark_best.items() },
+        'measurements': measurements,
+      }, f, indent=4)
+
+if __name__ == '__main__':
+  main()
@@ -62,7 +62,7 @@ constexpr bool DeegenBytecodeOperandIsLiteralType(DeegenBytecodeOperandType valu
 struct DeegenFrontendBytecodeDefinitionDescriptor
 {
     constexpr static size_t x_maxOperands = 10;
-    constexpr static size_t x_maxQuickenings = 1;   // currently only hot-cold splitting supported
+    constexpr static size_t x_maxQuickenings = 4;   // the maximum number of 'AddQuickeningCandidate' per variant
     constexpr static size_t x_maxVariants = 50;
 
     struct Operand
@@ -694,11 +694,20 @@ struct DeegenFrontendBytecodeDefinitionDescriptor
             SpecializedOperand value[x_maxOperands];
         };
 
+        // Add a quickening candidate: the speculated types of some of the operands.
+        //
+        // The interpreter starts out quickened for the first candidate. When an execution does not satisfy the first candidate,
+        // the bytecode quickens itself (by rewriting its opcode) to the first of the other candidates that the execution satisfies,
+        // or dequickens itself to the generic implementation if there is none. A bytecode quickened for a candidate other than the
+        // first one dequickens itself on the first execution that does not satisfy the candidate, and a dequickened bytecode never
+        // quickens again, so each bytecode transitions at most twice.
+        //
+        // So the most probable candidate should be listed first. The JIT tiers do not rewrite bytecodes, so for them the first
+        // candidate behaves exactly the same as 'EnableHotColdSplitting'.
+        //
         template<typename... Args>
         consteval SpecializedVariant& AddQuickeningCandidate(Args... args)
         {
-            // TODO: this is not implemented yet..
-            //
             ReleaseAssert(!m_enableHCS && "this function call must not be used together with 'EnableHotColdSplitting'.");
             AddNewQuickening(args...);
             return *this;
@@ -133,9 +133,45 @@ void AstBytecodeReturn::DoLoweringForInterpreter(InterpreterBytecodeImplCreator*
     Value* opcode = BytecodeVariantDefinition::DecodeBytecodeOpcode(bytecodeTarget, m_origin /*insertBefore*/);
     ReleaseAssert(llvm_value_has_type<uint64_t>(opcode));
 
+    if (x_deegen_enable_interpreter_bytecode_pair_profiling)
+    {
+        Value* curOpcode = BytecodeVariantDefinition::DecodeBytecodeOpcode(ifi->GetCurBytecode(), m_origin /*insertBefore*/);
+        ifi->CallDeegenCommonSnippet("RecordInterpreterBytecodePair", { curOpcode, opcode }, m_origin /*insertBefore*/);
+    }
+
     Value* targetFunction = GetInterpreterFunctionFromInterpreterOpcode(ifi->GetModule(), opcode, m_origin /*insertBefore*/);
     ReleaseAssert(llvm_value_has_type<void*>(targetFunction));
 
+    // If the next bytecode is frequently a specific bytecode B (see x_deegen_interpreter_fused_dispatch_pairs),
+    // check if the target is B's interpreter function, and if so, jump to it directly
+    //
+    for (const DeegenInterpreterFusedDispatchPair& pair : x_deegen_interpreter_fused_dispatch_pairs)
+    {
+        if (ifi->GetBytecodeDef()->m_bytecodeName != pair.m_bytecodeName)
+        {
+            continue;
+        }
+        std::string nextFnName = std::string(x_deegen_interpreter_function_name_prefix) + pair.m_nextFunctionName;
+        Function* nextFn = ifi->GetModule()->getFunction(nextFnName);
+        if (nextFn == nullptr)
+        {
+            nextFn = Function::Create(RegisterPinningScheme::GetFunctionType(ctx), GlobalValue::ExternalLinkage, nextFnName, ifi->GetModule());
+            ReleaseAssert(nextFn->getName() == nextFnName);
+            nextFn->setCallingConv(CallingConv::GHC);
+            nextFn->setDSOLocal(true);
+        }
+
+        Value* isNextFn = new ICmpInst(m_origin /*insertBefore*/, ICmpInst::ICMP_EQ, targetFunction, nextFn);
+        Instruction* thenBlockTerminator = SplitBlockAndInsertIfThen(isNextFn, m_origin /*splitBefore*/, true /*isUnreachable*/);
+
+        ifi->GetExecFnContext()->PrepareDispatch<InterpreterInterface>()
+            .Set<RPV_StackBase>(ifi->GetStackBase())
+            .Set<RPV_CodeBlock>(ifi->GetInterpreterCodeBlock())
+            .Set<RPV_CurBytecode>(bytecodeTarget)
+            .Dispatch(nextFn, thenBlockTerminator /*insertBefore*/);
+        thenBlockTerminator->eraseFromParent();
+    }
+
     ifi->GetExecFnContext()->PrepareDispatch<InterpreterInterface>()
         .Set<RPV_StackBase>(ifi->GetStackBase())
         .Set<RPV_CodeBlock>(ifi->GetInterpreterCodeBlock())
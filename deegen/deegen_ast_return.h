@@ -85,6 +85,13 @@ public:
 
 constexpr const char* x_deegen_interpreter_dispatch_table_symbol_name = "__deegen_interpreter_dispatch_table";
 
+// The interpreter function name of each opcode (without x_deegen_interpreter_function_name_prefix), in opcode order,
+// used by the runtime to print the interpreter bytecode pair profile
+//
+constexpr const char* x_deegen_interpreter_opcode_name_table_symbol_name = "deegen_interpreter_opcode_name_table";
+
+constexpr const char* x_deegen_interpreter_function_name_prefix = "__deegen_interpreter_op_";
+
 llvm::Value* GetInterpreterFunctionFromInterpreterOpcode(llvm::Module* module, llvm::Value* opcode, llvm::Instruction* insertBefore);
 
 }   // namespace dast
@@ -25,7 +25,7 @@ DfgJitImplCreator* DeegenBytecodeImplCreatorBase::AsDfgJIT()
 }
 
 DeegenBytecodeImplCreatorBase::DeegenBytecodeImplCreatorBase(DeegenBytecodeImplCreatorBase* other)
-    : DeegenBytecodeImplCreatorBase(other->m_bytecodeDef, other->m_processKind)
+    : DeegenBytecodeImplCreatorBase(other->m_bytecodeDef, other->m_processKind, other->m_quickeningOrd)
 {
     using namespace llvm;
     ReleaseAssert(other->m_module != nullptr);
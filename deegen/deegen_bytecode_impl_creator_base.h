@@ -18,11 +18,12 @@ class DeegenBytecodeImplCreatorBase
 public:
     virtual ~DeegenBytecodeImplCreatorBase() = default;
 
-    DeegenBytecodeImplCreatorBase(BytecodeVariantDefinition* bytecodeDef, BytecodeIrComponentKind processKind)
+    DeegenBytecodeImplCreatorBase(BytecodeVariantDefinition* bytecodeDef, BytecodeIrComponentKind processKind, size_t quickeningOrd = 0)
         : m_module(nullptr)
         , m_execFnContext(nullptr)
         , m_bytecodeDef(bytecodeDef)
         , m_processKind(processKind)
+        , m_quickeningOrd(quickeningOrd)
         , m_valuePreserver()
     { }
 
@@ -30,9 +31,14 @@ public:
 
     bool WARN_UNUSED IsReturnContinuation() const { return m_processKind == BytecodeIrComponentKind::ReturnContinuation; }
     bool WARN_UNUSED IsMainComponent() const { return m_processKind == BytecodeIrComponentKind::Main; }
+    BytecodeIrComponentKind WARN_UNUSED GetProcessKind() const { return m_processKind; }
 
     BytecodeVariantDefinition* GetBytecodeDef() const { return m_bytecodeDef; }
 
+    // The quickening candidate that this component is specialized for, see BytecodeIrComponent::m_quickeningOrd
+    //
+    size_t WARN_UNUSED GetQuickeningOrd() const { return m_quickeningOrd; }
+
     ExecutorFunctionContext* GetExecFnContext()
     {
         ReleaseAssert(m_execFnContext.get() != nullptr);
@@ -92,6 +98,7 @@ protected:
     std::unique_ptr<ExecutorFunctionContext> m_execFnContext;
     BytecodeVariantDefinition* m_bytecodeDef;
     BytecodeIrComponentKind m_processKind;
+    size_t m_quickeningOrd;
     LLVMValuePreserver m_valuePreserver;
 
     static constexpr const char* x_coroutineCtx = "coroutineCtx";
@@ -139,15 +139,20 @@ BytecodeIrComponent::BytecodeIrComponent(BytecodeIrComponent::ProcessFusedInIcEf
     DoOptimization();
 }
 
-BytecodeIrComponent::BytecodeIrComponent(BytecodeVariantDefinition* bytecodeDef, llvm::Function* implTmp, BytecodeIrComponentKind processKind)
+BytecodeIrComponent::BytecodeIrComponent(BytecodeVariantDefinition* bytecodeDef, llvm::Function* implTmp, BytecodeIrComponentKind processKind, size_t quickeningOrd)
     : m_processKind(processKind)
     , m_bytecodeDef(bytecodeDef)
     , m_module(nullptr)
     , m_impl(nullptr)
+    , m_quickeningOrd(quickeningOrd)
     , m_isSlowPathRetCont(false)
     , m_hasDeterminedIsSlowPathRetCont(false)
 {
     using namespace llvm;
+    ReleaseAssertImp(m_quickeningOrd > 0, m_processKind == BytecodeIrComponentKind::QuickenedVariant || m_processKind == BytecodeIrComponentKind::QuickeningSlowPath);
+    ReleaseAssertImp(m_processKind == BytecodeIrComponentKind::QuickenedVariant, m_quickeningOrd > 0);
+    ReleaseAssertImp(m_quickeningOrd > 0, m_quickeningOrd < bytecodeDef->GetNumQuickenings());
+
     m_module = llvm::CloneModule(*implTmp->getParent());
     m_impl = m_module->getFunction(implTmp->getName());
     ReleaseAssert(m_impl != nullptr);
@@ -227,13 +232,13 @@ void BytecodeIrComponent::DoOptimization()
     // Run TValue typecheck strength reduction
     //
     DesugarAndSimplifyLLVMModule(m_module.get(), DesugarUpToExcluding(DesugaringLevel::TypeSpecialization));
-    if (m_processKind == BytecodeIrComponentKind::Main || m_processKind == BytecodeIrComponentKind::FusedInInlineCacheEffect)
+    if (m_processKind == BytecodeIrComponentKind::Main || m_processKind == BytecodeIrComponentKind::FusedInInlineCacheEffect || m_processKind == BytecodeIrComponentKind::QuickenedVariant)
     {
         if (m_bytecodeDef->HasQuickeningSlowPath())
         {
             // In this case, we are the fast path
             //
-            TValueTypecheckOptimizationPass::DoOptimizationForBytecodeQuickeningFastPath(m_bytecodeDef, m_impl);
+            TValueTypecheckOptimizationPass::DoOptimizationForBytecodeQuickeningFastPath(m_bytecodeDef, m_impl, m_quickeningOrd);
         }
         else
         {
@@ -242,9 +247,11 @@ void BytecodeIrComponent::DoOptimization()
     }
     else if (m_processKind == BytecodeIrComponentKind::QuickeningSlowPath)
     {
-        TValueTypecheckOptimizationPass::DoOptimizationForBytecodeQuickeningSlowPath(m_bytecodeDef, m_impl);
+        TValueTypecheckOptimizationPass::DoOptimizationForBytecodeQuickeningSlowPath(m_bytecodeDef, m_impl, m_quickeningOrd);
     }
-    else if (m_processKind == BytecodeIrComponentKind::ReturnContinuation || m_processKind == BytecodeIrComponentKind::SlowPath)
+    else if (m_processKind == BytecodeIrComponentKind::ReturnContinuation ||
+             m_processKind == BytecodeIrComponentKind::SlowPath ||
+             m_processKind == BytecodeIrComponentKind::DequickenedVariant)
     {
         TValueTypecheckOptimizationPass::DoOptimizationForBytecode(m_bytecodeDef, m_impl);
     }
@@ -266,6 +273,7 @@ BytecodeIrComponent::BytecodeIrComponent(llvm::LLVMContext& ctx, BytecodeVariant
     }
 
     m_bytecodeDef = bytecodeDef;
+    m_quickeningOrd = 0;
     JSONCheckedGet(j, "ident_func_name", m_identFuncName);
     std::string moduleStr = base64_decode(JSONCheckedGet<std::string>(j, "llvm_module"));
     m_module = ParseLLVMModuleFromString(ctx, "bytecode_ir_component_module" /*moduleName*/, moduleStr);
@@ -290,6 +298,9 @@ BytecodeIrComponent::BytecodeIrComponent(llvm::LLVMContext& ctx, BytecodeVariant
 
 json_t WARN_UNUSED BytecodeIrComponent::SaveToJSON()
 {
+    // Only the interpreter uses the quickening candidates other than the first one, and those are never saved
+    //
+    ReleaseAssert(m_quickeningOrd == 0);
     json_t j;
     j["kind"] = static_cast<int>(m_processKind);
     j["ident_func_name"] = m_identFuncName;
@@ -405,6 +416,20 @@ BytecodeIrInfo WARN_UNUSED BytecodeIrInfo::Create(BytecodeVariantDefinition* byt
             //
             r.m_quickeningSlowPath = std::make_unique<BytecodeIrComponent>(bytecodeDef, mainImplFn, BytecodeIrComponentKind::QuickeningSlowPath);
 
+            // Similarly, each of the other quickening candidates has its own slow path, which is only used by the interpreter
+            //
+            if (bytecodeDef->m_quickeningKind == BytecodeQuickeningKind::QuickeningSelector && !bytecodeDef->m_isDfgVariant)
+            {
+                for (size_t quickeningOrd = 1; quickeningOrd < bytecodeDef->GetNumQuickenings(); quickeningOrd++)
+                {
+                    std::string spName = GetQuickeningSlowPathFuncName(bytecodeDef, quickeningOrd) + "_impl";
+                    mainImplFn->setName(spName);
+                    ReleaseAssert(mainImplFn->getName().str() == spName);
+                    r.m_otherQuickeningSlowPaths.push_back(std::make_unique<BytecodeIrComponent>(
+                        bytecodeDef, mainImplFn, BytecodeIrComponentKind::QuickeningSlowPath, quickeningOrd));
+                }
+            }
+
             // Revert the name
             //
             mainImplFn->setName(oldName);
@@ -469,7 +494,7 @@ BytecodeIrInfo WARN_UNUSED BytecodeIrInfo::Create(BytecodeVariantDefinition* byt
 
     if (hasICFusedIntoInterpreterOpcode && bytecodeDef->HasQuickeningSlowPath())
     {
-        fprintf(stderr, "[LOCKDOWN] FuseICIntoInterpreterOpcode() currently cannot be used together with EnableHotColdSplitting().\n");
+        fprintf(stderr, "[LOCKDOWN] FuseICIntoInterpreterOpcode() currently cannot be used together with EnableHotColdSplitting() or AddQuickeningCandidate().\n");
         abort();
     }
 
@@ -593,6 +618,39 @@ BytecodeIrInfo WARN_UNUSED BytecodeIrInfo::Create(BytecodeVariantDefinition* byt
         }
     }
 
+    // Create the quickened variant for each quickening candidate except the first one, and the dequickened variant.
+    // They are assigned the opcodes immediately following the main bytecode function (which is quickened for the first candidate)
+    // in this order, so the interpreter can requicken or dequicken a bytecode by adding a delta to its opcode.
+    //
+    if (bytecodeDef->m_quickeningKind == BytecodeQuickeningKind::QuickeningSelector && !bytecodeDef->m_isDfgVariant)
+    {
+        ReleaseAssert(!hasICFusedIntoInterpreterOpcode);
+        size_t numQuickenings = bytecodeDef->GetNumQuickenings();
+        ReleaseAssert(r.m_otherQuickeningSlowPaths.size() + 1 == numQuickenings);
+
+        std::string oldName = mainImplFn->getName().str();
+        for (size_t affliatedOrd = 0; affliatedOrd < numQuickenings; affliatedOrd++)
+        {
+            std::string desiredName = GetQuickeningVariantFuncName(bytecodeDef, affliatedOrd) + "_impl";
+            mainImplFn->setName(desiredName);
+            ReleaseAssert(mainImplFn->getName().str() == desiredName);
+
+            std::unique_ptr<BytecodeIrComponent> component;
+            if (affliatedOrd + 1 < numQuickenings)
+            {
+                component = std::make_unique<BytecodeIrComponent>(bytecodeDef, mainImplFn, BytecodeIrComponentKind::QuickenedVariant, affliatedOrd + 1 /*quickeningOrd*/);
+            }
+            else
+            {
+                component = std::make_unique<BytecodeIrComponent>(bytecodeDef, mainImplFn, BytecodeIrComponentKind::DequickenedVariant);
+            }
+            r.m_affliatedBytecodeFnNames.push_back(component->m_identFuncName);
+            r.m_quickeningVariants.push_back(std::move(component));
+        }
+        mainImplFn->setName(oldName);
+        ReleaseAssert(mainImplFn->getName().str() == oldName);
+    }
+
     r.m_interpreterMainComponent = std::make_unique<BytecodeIrComponent>(bytecodeDef, mainImplFn, BytecodeIrComponentKind::Main);
 
     ReleaseAssert(!bytecodeDef->IsBytecodeStructLengthTentativelyFinalized());
@@ -22,7 +22,13 @@ enum class BytecodeIrComponentKind
     SlowPath,
     // This is an affliated bytecode created by FuseICIntoInterpreterOpcode() API
     //
-    FusedInInlineCacheEffect
+    FusedInInlineCacheEffect,
+    // This is an affliated bytecode created by AddQuickeningCandidate() API, quickened for a candidate other than the first one
+    //
+    QuickenedVariant,
+    // This is an affliated bytecode created by AddQuickeningCandidate() API, which executes the unquickened logic
+    //
+    DequickenedVariant
 };
 
 // Describes a subcomponent of a bytecode (the main function, a slow path, a quickening variant, etc)
@@ -46,6 +52,11 @@ struct BytecodeIrComponent
     //
     std::string m_identFuncName;
 
+    // For Main, QuickenedVariant and QuickeningSlowPath, the ordinal of the quickening candidate this component is specialized for
+    // Always 0 for other kinds
+    //
+    size_t m_quickeningOrd;
+
     // True if this return continuation is only used by the slow path
     //
     bool m_isSlowPathRetCont;
@@ -65,7 +76,7 @@ struct BytecodeIrComponent
     // This function clones the module, so the original module is untouched.
     // The cloned module is owned by this class.
     //
-    BytecodeIrComponent(BytecodeVariantDefinition* bytecodeDef, llvm::Function* impl, BytecodeIrComponentKind processKind);
+    BytecodeIrComponent(BytecodeVariantDefinition* bytecodeDef, llvm::Function* impl, BytecodeIrComponentKind processKind, size_t quickeningOrd = 0);
 
     struct ProcessFusedInIcEffectTag { };
 
@@ -116,6 +127,14 @@ struct BytecodeIrInfo
     //
     std::unique_ptr<BytecodeIrComponent> m_quickeningSlowPath;
 
+    // If the bytecode has more than one quickening candidate, this holds the quickened variant for each candidate
+    // except the first one, followed by the dequickened variant.
+    // The slow path of the quickened variant for candidate i is stored in m_otherQuickeningSlowPaths[i - 1].
+    // Only useful for interpreter
+    //
+    std::vector<std::unique_ptr<BytecodeIrComponent>> m_quickeningVariants;
+    std::vector<std::unique_ptr<BytecodeIrComponent>> m_otherQuickeningSlowPaths;
+
     // Holds all the slow paths generated by EnterSlowPath API
     // Note that the m_identFuncName of these submodules may not be unique across translational units.
     // We will rename them after the Main processor links all the submodules together.
@@ -163,9 +182,22 @@ struct BytecodeIrInfo
         return GetBaseName(bytecodeDef) + "_retcont_" + std::to_string(rcOrd);
     }
 
-    static std::string GetQuickeningSlowPathFuncName(BytecodeVariantDefinition* bytecodeDef)
+    static std::string GetQuickeningSlowPathFuncName(BytecodeVariantDefinition* bytecodeDef, size_t quickeningOrd = 0)
+    {
+        std::string res = GetBaseName(bytecodeDef) + "_quickening_slowpath";
+        if (quickeningOrd > 0)
+        {
+            res += "_" + std::to_string(quickeningOrd);
+        }
+        return res;
+    }
+
+    // The quickened variant for candidate i (i > 0) is named 'quickened_(i-1)', and the dequickened variant is named
+    // 'quickened_(numQuickenings-1)', so that the affliated opcodes are named consecutively
+    //
+    static std::string GetQuickeningVariantFuncName(BytecodeVariantDefinition* bytecodeDef, size_t affliatedOrd)
     {
-        return GetBaseName(bytecodeDef) + "_quickening_slowpath";
+        return GetBaseName(bytecodeDef) + "_quickened_" + std::to_string(affliatedOrd);
     }
 
     BytecodeIrInfo() = default;
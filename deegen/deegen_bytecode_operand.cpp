@@ -879,10 +879,16 @@ std::vector<BytecodeVariantCollection> WARN_UNUSED BytecodeVariantDefinition::Pa
                 def->m_quickeningKind = BytecodeQuickeningKind::LockedQuickening;
                 ReleaseAssert(numQuickenings == 1);
             }
+            else if (numQuickenings > 0)
+            {
+                // The DFG JIT never rewrites bytecodes, so a DFG variant can only use EnableHotColdSplitting
+                //
+                ReleaseAssert(!isDfgVariant && "AddQuickeningCandidate cannot be used in DfgVariant, use EnableHotColdSplitting instead!");
+                def->m_quickeningKind = BytecodeQuickeningKind::QuickeningSelector;
+            }
             else
             {
                 def->m_quickeningKind = BytecodeQuickeningKind::NoQuickening;
-                ReleaseAssert(numQuickenings == 0);
             }
 
             def->m_operandRegPrefInfo = bcLevelOperandRegPrefInfo;
@@ -1094,25 +1100,36 @@ std::vector<BytecodeVariantCollection> WARN_UNUSED BytecodeVariantDefinition::Pa
                 def->m_list[i]->SetOperandOrdinal(i);
             }
 
-            if (def->m_quickeningKind == BytecodeQuickeningKind::LockedQuickening)
+            if (def->m_quickeningKind == BytecodeQuickeningKind::LockedQuickening || def->m_quickeningKind == BytecodeQuickeningKind::QuickeningSelector)
             {
                 LLVMConstantArrayReader quickeningListReader(module, variantReader.Get<&Desc::SpecializedVariant::m_quickenings>());
-                LLVMConstantStructReader quickeningReaderTmp(module, quickeningListReader.Get<Desc::SpecializedVariant::Quickening>(0 /*ord*/));
-                LLVMConstantArrayReader quickeningReader(module, quickeningReaderTmp.Get<&Desc::SpecializedVariant::Quickening::value>());
-                for (size_t opOrd = 0; opOrd < numOperands; opOrd++)
+                auto readQuickening = [&](size_t quickeningOrd) WARN_UNUSED -> std::vector<BytecodeOperandQuickeningDescriptor>
                 {
-                    ParsedSpecializedOperand spOp = readSpecializedOperand(quickeningReader.Get<SpecializedOperand>(opOrd));
-                    ReleaseAssert(!spOp.m_regInfo.m_isInitialized && "Specifying a RegHint in EnableHotColdSplitting has no effect!");
-                    if (spOp.m_kind == DeegenSpecializationKind::NotSpecialized)
+                    LLVMConstantStructReader quickeningReaderTmp(module, quickeningListReader.Get<Desc::SpecializedVariant::Quickening>(quickeningOrd));
+                    LLVMConstantArrayReader quickeningReader(module, quickeningReaderTmp.Get<&Desc::SpecializedVariant::Quickening::value>());
+                    std::vector<BytecodeOperandQuickeningDescriptor> res;
+                    for (size_t opOrd = 0; opOrd < numOperands; opOrd++)
                     {
-                        continue;
+                        ParsedSpecializedOperand spOp = readSpecializedOperand(quickeningReader.Get<SpecializedOperand>(opOrd));
+                        ReleaseAssert(!spOp.m_regInfo.m_isInitialized && "Specifying a RegHint in EnableHotColdSplitting or AddQuickeningCandidate has no effect!");
+                        if (spOp.m_kind == DeegenSpecializationKind::NotSpecialized)
+                        {
+                            continue;
+                        }
+                        ReleaseAssert(spOp.m_kind == DeegenSpecializationKind::SpeculatedTypeForOptimizer);
+                        ReleaseAssert(def->m_list[opOrd]->GetKind() == BcOperandKind::Slot || def->m_list[opOrd]->GetKind() == BcOperandKind::Constant);
+                        TypeMaskTy specMask = SafeIntegerCast<TypeMaskTy>(spOp.m_value);
+                        res.push_back({ .m_operandOrd = opOrd, .m_speculatedMask = specMask });
                     }
-                    ReleaseAssert(spOp.m_kind == DeegenSpecializationKind::SpeculatedTypeForOptimizer);
-                    ReleaseAssert(def->m_list[opOrd]->GetKind() == BcOperandKind::Slot || def->m_list[opOrd]->GetKind() == BcOperandKind::Constant);
-                    TypeMaskTy specMask = SafeIntegerCast<TypeMaskTy>(spOp.m_value);
-                    def->m_quickening.push_back({ .m_operandOrd = opOrd, .m_speculatedMask = specMask });
+                    ReleaseAssert(res.size() > 0);
+                    return res;
+                };
+
+                def->m_quickening = readQuickening(0 /*quickeningOrd*/);
+                for (size_t quickeningOrd = 1; quickeningOrd < numQuickenings; quickeningOrd++)
+                {
+                    def->m_allOtherQuickenings.push_back(readQuickening(quickeningOrd));
                 }
-                ReleaseAssert(def->m_quickening.size() > 0);
             }
 
             enum class GenerateRCWKind
@@ -1759,7 +1776,7 @@ json_t WARN_UNUSED BytecodeVariantDefinition::SaveToJSON()
         j["quickening_descriptor"] = serializedQuickeningDescList;
     }
 
-    // m_allOtherQuickenings not serialized since it's not used right now.
+    // m_allOtherQuickenings not serialized since only the interpreter uses it (the JIT tiers never rewrite the bytecode).
     // m_sameLengthConstraintList not serialized since JIT doesn't care about it.
     // m_metadataStructInfo and m_interpreterCallIcMetadata not serialized since JIT doesn't need it.
     //
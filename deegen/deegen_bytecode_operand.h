@@ -839,6 +839,28 @@ public:
                m_quickeningKind == BytecodeQuickeningKind::Quickened;
     }
 
+    // The number of quickening candidates: 0 if no quickening, 1 for hot-cold splitting, or the number of
+    // 'AddQuickeningCandidate' for QuickeningSelector
+    //
+    size_t WARN_UNUSED GetNumQuickenings()
+    {
+        if (!HasQuickeningSlowPath())
+        {
+            return 0;
+        }
+        return 1 + m_allOtherQuickenings.size();
+    }
+
+    std::vector<BytecodeOperandQuickeningDescriptor>& WARN_UNUSED GetQuickening(size_t quickeningOrd)
+    {
+        ReleaseAssert(quickeningOrd < GetNumQuickenings());
+        if (quickeningOrd == 0)
+        {
+            return m_quickening;
+        }
+        return m_allOtherQuickenings[quickeningOrd - 1];
+    }
+
     void AddBytecodeMetadata(std::unique_ptr<BytecodeMetadataStruct> s)
     {
         if (m_bytecodeMetadataMaybeNull.get() == nullptr)
@@ -1189,7 +1211,7 @@ struct BytecodeOpcodeRawValueMap
         return m_list[opcodeOrd];
     }
 
-    // Get the list of all primary (not fused-ic) bytecodes in the order they show up in the interpreter dispatch table
+    // Get the list of all primary (not fused-ic or quickening variant) bytecodes in the order they show up in the interpreter dispatch table
     //
     std::vector<std::string> WARN_UNUSED GetPrimaryBytecodeList() const
     {
@@ -1204,6 +1226,10 @@ struct BytecodeOpcodeRawValueMap
         return res;
     }
 
+    // Returns the number of affliated interpreter opcodes following the primary opcode of the bytecode.
+    // These are either the FuseICIntoInterpreterOpcode specializations or the quickened/dequickened variants,
+    // which the JIT tiers all treat the same as the primary opcode.
+    //
     size_t WARN_UNUSED GetNumInterpreterFusedIcVariants(const std::string& bytecodeName) const
     {
         size_t opOrd = GetOpcode(bytecodeName);
@@ -1212,7 +1238,9 @@ struct BytecodeOpcodeRawValueMap
         size_t numFusedIcVariants = 0;
         while (opOrd + numFusedIcVariants + 1 < GetDispatchTableLength())
         {
-            if (GetBytecode(opOrd + numFusedIcVariants + 1) == bytecodeName + "_fused_ic_" + std::to_string(numFusedIcVariants))
+            std::string name = GetBytecode(opOrd + numFusedIcVariants + 1);
+            std::string suffix = std::to_string(numFusedIcVariants);
+            if (name == bytecodeName + "_fused_ic_" + suffix || name == bytecodeName + "_quickened_" + suffix)
             {
                 numFusedIcVariants++;
             }
@@ -1226,7 +1254,7 @@ struct BytecodeOpcodeRawValueMap
 
     static bool WARN_UNUSED IsFusedIcVariant(const std::string& bytecodeName)
     {
-        return bytecodeName.find("_fused_ic_") != std::string::npos;
+        return bytecodeName.find("_fused_ic_") != std::string::npos || bytecodeName.find("_quickened_") != std::string::npos;
     }
 
     static BytecodeOpcodeRawValueMap WARN_UNUSED ParseFromJSON(json_t j);
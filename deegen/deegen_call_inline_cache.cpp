@@ -2279,19 +2279,11 @@ DeegenCallIcLogicCreator::BaselineJitCodegenResult WARN_UNUSED DeegenCallIcLogic
     Value* icSite = GetElementPtrInst::CreateInBounds(llvm_type_of<uint8_t>(ctx), slowPathData,
                                                       { CreateLLVMConstantInt<uint64_t>(ctx, icSiteOffsetInSlowPathData) }, "", entryBB);
 
-    // Read icSite->m_numEntries
+    // If the IC site has reached the maximum number of IC entries (which is a runtime-configurable VM option),
+    // the site is megamorphic. Don't create more ICs, just dispatch to the callee through the megamorphic path and return.
     //
-    Value* numExistingICs;
-    {
-        static_assert(std::is_same_v<typeof_member_t<&JitCallInlineCacheSite::m_numEntries>, uint8_t>);
-        Value* ptr = GetElementPtrInst::CreateInBounds(llvm_type_of<uint8_t>(ctx), icSite,
-                                                       { CreateLLVMConstantInt<uint64_t>(ctx, offsetof_member_v<&JitCallInlineCacheSite::m_numEntries>) }, "", entryBB);
-        numExistingICs = new LoadInst(llvm_type_of<uint8_t>(ctx), ptr, "", entryBB);
-    }
-
-    // If m_numEntries >= x_maxJitCallInlineCacheEntries, don't create more ICs. Just get the result and return.
-    //
-    Value* isIcCountReachedMaximum = new ICmpInst(entryBB, ICmpInst::ICMP_UGE, numExistingICs, CreateLLVMConstantInt<uint8_t>(ctx, x_maxJitCallInlineCacheEntries));
+    Value* isIcCountReachedMaximum = CreateCallToDeegenCommonSnippet(module.get(), "IsJitCallIcSiteMegamorphic", { icSite }, entryBB);
+    ReleaseAssert(llvm_value_has_type<bool>(isIcCountReachedMaximum));
 
     BasicBlock* skipIcCreationBB = BasicBlock::Create(ctx, "", fn);
     BasicBlock* prepareCreateIcBB = BasicBlock::Create(ctx, "", fn);
@@ -2311,7 +2303,7 @@ DeegenCallIcLogicCreator::BaselineJitCodegenResult WARN_UNUSED DeegenCallIcLogic
         ReleaseAssert(llvm_value_has_type<uint64_t>(targetTv));
         CallInst* targetFnObject = CreateCallToDeegenCommonSnippet(module.get(), "GetFuncObjAsU64FromTValue", { targetTv }, skipIcCreationBB);
         ReleaseAssert(llvm_value_has_type<uint64_t>(targetFnObject));
-        Value* codeBlockAndEntryPoint = CreateCallToDeegenCommonSnippet(module.get(), "GetCalleeEntryPoint", { targetFnObject }, skipIcCreationBB);
+        Value* codeBlockAndEntryPoint = CreateCallToDeegenCommonSnippet(module.get(), "GetCalleeEntryPointForMegamorphicCallSite", { targetFnObject }, skipIcCreationBB);
 
         Value* calleeCbHeapPtr = ExtractValueInst::Create(codeBlockAndEntryPoint, { 0 /*idx*/ }, "", skipIcCreationBB);
         Value* codePointer = ExtractValueInst::Create(codeBlockAndEntryPoint, { 1 /*idx*/ }, "", skipIcCreationBB);
@@ -2,6 +2,7 @@
 #include "deegen_register_pinning_scheme.h"
 #include "deegen_bytecode_operand.h"
 #include "deegen_ast_return.h"
+#include "deegen_ast_throw_error.h"
 #include "deegen_options.h"
 #include "invoke_clang_helper.h"
 #include "tvalue.h"
@@ -242,6 +243,69 @@ void DeegenFunctionEntryLogicCreator::Run(llvm::LLVMContext& ctx)
         bytecodePtr->setName("bytecodePtr");
     }
 
+    // Check that the stack has space for the callee's stack frame, committing more stack if needed.
+    // This must happen before the stack frame fixup below, since the fixup writes to the stack frame.
+    // If the stack overflows, throw out the error as if it were thrown by the callee, whose call frame header has been set up by the caller.
+    //
+    {
+        // For variadic argument functions, the stack frame fixup moves the stack frame to after the arguments
+        // (see 'FixupStackFrameForVariadicArgFunction'), so the stack frame begins at most here
+        //
+        Value* frameBase = preFixupStackBase;
+        if (m_acceptVarArgs)
+        {
+            frameBase = GetElementPtrInst::CreateInBounds(llvm_type_of<uint64_t>(ctx), frameBase, { numArgs }, "", normalBB);
+            frameBase = GetElementPtrInst::CreateInBounds(llvm_type_of<uint64_t>(ctx), frameBase, { CreateLLVMConstantInt<uint64_t>(ctx, x_numSlotsForStackFrameHeader) }, "", normalBB);
+        }
+
+        Value* frameEnd;
+        if (m_tier == DeegenEngineTier::DfgJIT)
+        {
+            // The DFG stack frame also contains the register spill area, so it is larger than the interpreter stack frame
+            //
+            Value* dfgCodeBlock = CreateCallToDeegenCommonSnippet(module.get(), "GetDfgJitCodeBlockFromCodeBlockHeapPtr", { calleeCodeBlockHeapPtr }, normalBB);
+            frameEnd = CreateCallToDeegenCommonSnippet(module.get(), "GetEndOfCallFrameFromDfgCodeBlock", { frameBase, dfgCodeBlock }, normalBB);
+        }
+        else
+        {
+            // The baseline JIT stack frame has the same size as the interpreter stack frame
+            //
+            frameEnd = CreateCallToDeegenCommonSnippet(module.get(), "GetEndOfCallFrameFromInterpreterCodeBlock", { frameBase, calleeCodeBlock }, normalBB);
+        }
+        ReleaseAssert(llvm_value_has_type<void*>(frameEnd));
+
+        // The variadic arguments may be passed on as variadic results (e.g., 'f(...)' or 'return x, ...'), which copies them
+        // beyond the end of the stack frame without a stack check. So also check for the space of a call frame header and all
+        // the arguments after the stack frame, so those copies always stay within the unchecked margin of the stack.
+        //
+        if (m_acceptVarArgs)
+        {
+            frameEnd = GetElementPtrInst::CreateInBounds(llvm_type_of<uint64_t>(ctx), frameEnd, { numArgs }, "", normalBB);
+            frameEnd = GetElementPtrInst::CreateInBounds(llvm_type_of<uint64_t>(ctx), frameEnd, { CreateLLVMConstantInt<uint64_t>(ctx, x_numSlotsForStackFrameHeader) }, "", normalBB);
+        }
+
+        Value* errorObject = CreateCallToDeegenCommonSnippet(module.get(), "CheckStackSpaceForFunctionEntry", { coroutineCtx, frameEnd }, normalBB);
+        ReleaseAssert(llvm_value_has_type<uint64_t>(errorObject));
+
+        Value* isStackOverflow = new ICmpInst(normalBB, ICmpInst::ICMP_NE, errorObject, CreateLLVMConstantInt<uint64_t>(ctx, 0));
+        Function* expectIntrin = Intrinsic::getDeclaration(module.get(), Intrinsic::expect, { Type::getInt1Ty(ctx) });
+        isStackOverflow = CallInst::Create(expectIntrin, { isStackOverflow, CreateLLVMConstantInt<bool>(ctx, false) }, "", normalBB);
+
+        BasicBlock* stackOverflowBB = BasicBlock::Create(ctx, "", func);
+        BasicBlock* stackOkBB = BasicBlock::Create(ctx, "", func);
+        BranchInst::Create(stackOverflowBB, stackOkBB, isStackOverflow, normalBB);
+
+        Value* errorObjectAsPtr = new IntToPtrInst(errorObject, llvm_type_of<void*>(ctx), "", stackOverflowBB);
+        funcCtx->PrepareDispatch<FunctionEntryInterface>()
+            .Set<RPV_StackBase>(preFixupStackBase)
+            .Set<RPV_NumArgsAsPtr>(errorObjectAsPtr)        // numArgs repurposed as errorObj
+            .Set<RPV_InterpCodeBlockHeapPtrAsPtr>(UndefValue::get(llvm_type_of<void*>(ctx)))
+            .Set<RPV_IsMustTailCall>(UndefValue::get(llvm_type_of<uint64_t>(ctx)))
+            .Dispatch(GetThrowTValueErrorDispatchTargetFunction(module.get()), stackOverflowBB /*insertAtEnd*/);
+
+        normalBB = stackOkBB;
+    }
+
     Value* stackBaseAfterFixUp = nullptr;
     if (!m_acceptVarArgs)
     {
@@ -337,6 +401,10 @@ void DeegenFunctionEntryLogicCreator::Run(llvm::LLVMContext& ctx)
         if (m_tier == DeegenEngineTier::BaselineJIT)
         {
             jitCodeBlock = CreateCallToDeegenCommonSnippet(module.get(), "GetBaselineJitCodeBlockFromCodeBlockHeapPtr", { calleeCodeBlockHeapPtr }, dummyInst);
+
+            // Record that the function has been called, so the JIT code eviction logic knows the code is not cold
+            //
+            CreateCallToDeegenCommonSnippet(module.get(), "MarkBaselineJitCodeBlockCalled", { jitCodeBlock }, dummyInst);
         }
         else
         {
@@ -106,7 +106,12 @@ void InterpreterBytecodeImplCreator::CreateWrapperFunction()
         m_valuePreserver.Preserve(x_curBytecode, bytecodePtr);
     }
 
-    if (m_processKind == BytecodeIrComponentKind::Main && m_bytecodeDef->m_isInterpreterToBaselineJitOsrEntryPoint && x_allow_interpreter_tier_up_to_baseline_jit)
+    // The quickened and dequickened variants replace the main component once the bytecode is requickened, so they need the OSR entry check as well
+    //
+    bool isMainOrQuickeningVariant = (m_processKind == BytecodeIrComponentKind::Main ||
+                                      m_processKind == BytecodeIrComponentKind::QuickenedVariant ||
+                                      m_processKind == BytecodeIrComponentKind::DequickenedVariant);
+    if (isMainOrQuickeningVariant && m_bytecodeDef->m_isInterpreterToBaselineJitOsrEntryPoint && x_allow_interpreter_tier_up_to_baseline_jit)
     {
         BasicBlock* tierUpBB = BasicBlock::Create(ctx, "", m_wrapper);
         {
@@ -142,7 +147,7 @@ void InterpreterBytecodeImplCreator::CreateWrapperFunction()
     if (m_processKind == BytecodeIrComponentKind::QuickeningSlowPath)
     {
         ReleaseAssert(m_bytecodeDef->HasQuickeningSlowPath());
-        alreadyDecodedArgs = TypeBasedHCSHelper::GetQuickeningSlowPathAdditionalArgs(m_bytecodeDef);
+        alreadyDecodedArgs = TypeBasedHCSHelper::GetQuickeningSlowPathAdditionalArgs(m_bytecodeDef, m_quickeningOrd);
     }
 
     std::vector<Value*> opcodeValues;
@@ -243,9 +248,9 @@ void InterpreterBytecodeImplCreator::CreateWrapperFunction()
         }
     }
 
-    if (m_processKind == BytecodeIrComponentKind::Main && m_bytecodeDef->HasQuickeningSlowPath())
+    if ((m_processKind == BytecodeIrComponentKind::Main || m_processKind == BytecodeIrComponentKind::QuickenedVariant) && m_bytecodeDef->HasQuickeningSlowPath())
     {
-        // If we are the main function and we are a quickening bytecode, we need to check that the quickening condition holds.
+        // If we are the main function (or a quickened variant) and we are a quickening bytecode, we need to check that the quickening condition holds.
         // We can only run 'm_impl' if the condition holds. If not, we must transfer control to the quickening slow path.
         //
         TypeBasedHCSHelper::GenerateCheckConditionLogic(this, usageValues, currentBlock /*inout*/);
@@ -255,6 +260,15 @@ void InterpreterBytecodeImplCreator::CreateWrapperFunction()
         CallInst::Create(m_impl, usageValues, "", currentBlock);
         new UnreachableInst(ctx, currentBlock);
     }
+    else if (m_processKind == BytecodeIrComponentKind::QuickeningSlowPath && m_bytecodeDef->m_quickeningKind == BytecodeQuickeningKind::QuickeningSelector)
+    {
+        // The quickening condition failed, so we need to requicken or dequicken the bytecode before executing the generic logic
+        //
+        TypeBasedHCSHelper::GenerateInterpreterRequickeningLogic(this, usageValues, currentBlock /*inout*/);
+
+        CallInst::Create(m_impl, usageValues, "", currentBlock);
+        new UnreachableInst(ctx, currentBlock);
+    }
     else
     {
         // Otherwise, it's as simple as calling 'm_impl'
@@ -300,7 +314,7 @@ void InterpreterBytecodeImplCreator::LowerGetBytecodeMetadataPtrAPI()
 }
 
 InterpreterBytecodeImplCreator::InterpreterBytecodeImplCreator(BytecodeIrComponent& bic)
-    : DeegenBytecodeImplCreatorBase(bic.m_bytecodeDef, bic.m_processKind)
+    : DeegenBytecodeImplCreatorBase(bic.m_bytecodeDef, bic.m_processKind, bic.m_quickeningOrd)
 {
     using namespace llvm;
     m_module = CloneModule(*bic.m_module.get());
@@ -445,6 +459,24 @@ void InterpreterBytecodeImplCreator::DoLowering()
     }
 }
 
+// Return true if the interpreter function is listed in x_deegen_interpreter_cold_function_names
+// 'genericFnName' is the name before the function is renamed to its interpreter name (see the end of DoLoweringForAll)
+//
+static bool WARN_UNUSED IsInterpreterFunctionColdByProfile(const std::string& genericFnName)
+{
+    std::string fnName = BytecodeIrInfo::ToInterpreterName(genericFnName);
+    ReleaseAssert(fnName.starts_with(x_deegen_interpreter_function_name_prefix));
+    std::string_view name = std::string_view(fnName).substr(strlen(x_deegen_interpreter_function_name_prefix));
+    for (const char* coldFnName : x_deegen_interpreter_cold_function_names)
+    {
+        if (name == coldFnName)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 std::unique_ptr<llvm::Module> WARN_UNUSED InterpreterBytecodeImplCreator::DoLoweringForAll(BytecodeIrInfo& bi)
 {
     using namespace llvm;
@@ -487,6 +519,20 @@ std::unique_ptr<llvm::Module> WARN_UNUSED InterpreterBytecodeImplCreator::DoLowe
 
     std::unordered_map<std::string /*funcName*/, PerComponentInfo> componentInfoMap;
 
+    // The main function and its variants are hot, unless the profile says they are cold (see x_deegen_interpreter_cold_function_names).
+    // The return continuations used by the main function are hot unless all of them are cold.
+    //
+    bool allMainFunctionsColdByProfile = true;
+    auto getSectionForMainFunction = [&](const std::string& fnName) -> const char*
+    {
+        if (IsInterpreterFunctionColdByProfile(fnName))
+        {
+            return x_cold_code_section_name;
+        }
+        allMainFunctionsColdByProfile = false;
+        return x_hot_code_section_name;
+    };
+
     // Process the main component
     //
     {
@@ -528,7 +574,7 @@ std::unique_ptr<llvm::Module> WARN_UNUSED InterpreterBytecodeImplCreator::DoLowe
         ReleaseAssert(mainEntryFn != nullptr);
 
         ReleaseAssert(!mainEntryFn->hasSection());
-        mainEntryFn->setSection(x_hot_code_section_name);
+        mainEntryFn->setSection(getSectionForMainFunction(mainComponent->m_resultFuncName));
     }
 
     // Link in all the sub-components
@@ -539,7 +585,7 @@ std::unique_ptr<llvm::Module> WARN_UNUSED InterpreterBytecodeImplCreator::DoLowe
     //
     // Link in the FuseICIntoInterpreterOpcode specializations, if any
     //
-    ReleaseAssert(bi.m_affliatedBytecodeFnNames.size() == bi.m_fusedICs.size());
+    ReleaseAssert(bi.m_affliatedBytecodeFnNames.size() >= bi.m_fusedICs.size());
     for (size_t fusedInIcOrd = 0; fusedInIcOrd < bi.m_fusedICs.size(); fusedInIcOrd++)
     {
         std::unique_ptr<InterpreterBytecodeImplCreator> component = InterpreterBytecodeImplCreator::LowerOneComponent(*bi.m_fusedICs[fusedInIcOrd].get());
@@ -565,7 +611,40 @@ std::unique_ptr<llvm::Module> WARN_UNUSED InterpreterBytecodeImplCreator::DoLowe
         ReleaseAssert(linkedInFn != nullptr);
         ReleaseAssert(!linkedInFn->empty());
         ReleaseAssert(!linkedInFn->hasSection());
-        linkedInFn->setSection(x_hot_code_section_name);
+        linkedInFn->setSection(getSectionForMainFunction(expectedFnName));
+    }
+
+    // Link in the quickened and dequickened variants, if any
+    //
+    ReleaseAssert(bi.m_affliatedBytecodeFnNames.size() == bi.m_fusedICs.size() + bi.m_quickeningVariants.size());
+    ReleaseAssert(bi.m_fusedICs.size() == 0 || bi.m_quickeningVariants.size() == 0);
+    for (size_t variantOrd = 0; variantOrd < bi.m_quickeningVariants.size(); variantOrd++)
+    {
+        std::unique_ptr<InterpreterBytecodeImplCreator> component = InterpreterBytecodeImplCreator::LowerOneComponent(*bi.m_quickeningVariants[variantOrd].get());
+
+        std::unique_ptr<Module> spModule = std::move(component->m_module);
+        std::string expectedFnName = bi.m_quickeningVariants[variantOrd]->m_identFuncName;
+        ReleaseAssert(expectedFnName == BytecodeIrInfo::GetQuickeningVariantFuncName(bytecodeDef, variantOrd));
+        ReleaseAssert(spModule->getFunction(expectedFnName) != nullptr);
+        ReleaseAssert(!spModule->getFunction(expectedFnName)->empty());
+        ReleaseAssert(expectedFnName == bi.m_affliatedBytecodeFnNames[variantOrd]);
+
+        ReleaseAssert(!componentInfoMap.count(expectedFnName));
+        componentInfoMap[expectedFnName] = PerComponentInfo {
+            .m_mayFallthroughToNextBytecode = component->m_mayFallthroughToNextBytecode,
+            .m_mayMakeTailCall = component->m_mayMakeTailCall
+        };
+
+        Linker linker(*module.get());
+        // linkInModule returns true on error
+        //
+        ReleaseAssert(linker.linkInModule(std::move(spModule)) == false);
+
+        Function* linkedInFn = module->getFunction(expectedFnName);
+        ReleaseAssert(linkedInFn != nullptr);
+        ReleaseAssert(!linkedInFn->empty());
+        ReleaseAssert(!linkedInFn->hasSection());
+        linkedInFn->setSection(getSectionForMainFunction(expectedFnName));
     }
 
     // Link in the quickening slow path if needed
@@ -601,6 +680,37 @@ std::unique_ptr<llvm::Module> WARN_UNUSED InterpreterBytecodeImplCreator::DoLowe
         linkedInFn->setSection(x_cold_code_section_name);
     }
 
+    // Link in the slow paths of the quickened variants, if any
+    //
+    ReleaseAssert(bi.m_quickeningVariants.size() == 0 || bi.m_quickeningVariants.size() == bi.m_otherQuickeningSlowPaths.size() + 1);
+    for (size_t spOrd = 0; spOrd < bi.m_otherQuickeningSlowPaths.size(); spOrd++)
+    {
+        std::unique_ptr<InterpreterBytecodeImplCreator> component = InterpreterBytecodeImplCreator::LowerOneComponent(*bi.m_otherQuickeningSlowPaths[spOrd].get());
+
+        std::unique_ptr<Module> spModule = std::move(component->m_module);
+        std::string expectedSpName = bi.m_otherQuickeningSlowPaths[spOrd]->m_identFuncName;
+        ReleaseAssert(expectedSpName == BytecodeIrInfo::GetQuickeningSlowPathFuncName(bytecodeDef, spOrd + 1 /*quickeningOrd*/));
+        ReleaseAssert(spModule->getFunction(expectedSpName) != nullptr);
+        ReleaseAssert(!spModule->getFunction(expectedSpName)->empty());
+
+        ReleaseAssert(!componentInfoMap.count(expectedSpName));
+        componentInfoMap[expectedSpName] = PerComponentInfo {
+            .m_mayFallthroughToNextBytecode = component->m_mayFallthroughToNextBytecode,
+            .m_mayMakeTailCall = component->m_mayMakeTailCall
+        };
+
+        Linker linker(*module.get());
+        // linkInModule returns true on error
+        //
+        ReleaseAssert(linker.linkInModule(std::move(spModule)) == false);
+
+        Function* linkedInFn = module->getFunction(expectedSpName);
+        ReleaseAssert(linkedInFn != nullptr);
+        ReleaseAssert(!linkedInFn->empty());
+        ReleaseAssert(!linkedInFn->hasSection());
+        linkedInFn->setSection(x_cold_code_section_name);
+    }
+
     // Note that some of the return continuations could be dead (due to optimizations), however, since return continuations
     // may arbitrarily call each other, we cannot know a return continuation is dead until we have linked in all the return continuations.
     // So first we need to link in all return continuations.
@@ -643,7 +753,7 @@ std::unique_ptr<llvm::Module> WARN_UNUSED InterpreterBytecodeImplCreator::DoLowe
         if (fnNamesOfAllReturnContinuationsUsedByMainFn.count(expectedRcName))
         {
             fnNamesOfAllReturnContinuationsUsedByMainFn.erase(expectedRcName);
-            linkedInFn->setSection(x_hot_code_section_name);
+            linkedInFn->setSection(allMainFunctionsColdByProfile ? x_cold_code_section_name : x_hot_code_section_name);
             bic->m_isSlowPathRetCont = false;
         }
         else
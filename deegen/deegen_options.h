@@ -44,6 +44,21 @@ constexpr size_t x_interpreter_tier_up_threshold_bytecode_length_multiplier = 20
 //
 constexpr size_t x_forbid_tier_up_to_dfg_num_bytecodes_threshold = 200000;
 
+// DFG code is jettisoned (unlinked, so the function runs in the lower tier again and may be recompiled to DFG later)
+// once it has OSR exited this many times.
+//
+constexpr size_t x_dfg_osr_exit_jettison_threshold = 100;
+
+// A function may be recompiled to DFG at most this many times after its DFG code is jettisoned.
+// After that, the function stays in the lower tier.
+//
+constexpr size_t x_dfg_max_num_recompilations = 3;
+
+// When a function is recompiled to DFG, the speculations made at a bytecode that has OSR exited at least this many times
+// are widened to cover the types seen at the exits, so the recompiled code does not exit at the same place again.
+//
+constexpr size_t x_dfg_osr_exit_site_widening_threshold = 10;
+
 static_assert(!(!x_allow_interpreter_tier_up_to_baseline_jit && x_allow_baseline_jit_tier_up_to_optimizing_jit),
               "Enabling optimizing JIT requires enabling baseline JIT as well!");
 
@@ -58,3 +73,74 @@ static_assert(!(!x_allow_interpreter_tier_up_to_baseline_jit && x_allow_baseline
 //       We should modify CMake to also pass -mllvm -XXXX if this is true.
 //
 constexpr bool x_finetune_llvm_do_not_avoid_3_ops_lea_inst = true;
+
+// When this option is true, the interpreter counts every dispatch from one bytecode to the next by the (current, next)
+// pair of interpreter opcodes (see interpreter_bytecode_pair_profile.h). This is a profiling-only build mode, as it
+// slows down the interpreter considerably.
+//
+// To collect the profile over luabench, run 'luajitr_bench --tier=interpreter --bytecode-pair-profile=<file>',
+// or for a single script, run luajitr with environment variable LJR_BYTECODE_PAIR_PROFILE=<file>.
+//
+constexpr bool x_deegen_enable_interpreter_bytecode_pair_profiling = false;
+
+// A pair (A, B) where bytecode B frequently executes right after bytecode A in the interpreter
+//
+struct DeegenInterpreterFusedDispatchPair
+{
+    // The name of bytecode A, as in DEEGEN_DEFINE_BYTECODE. All the interpreter functions of A are affected.
+    //
+    const char* m_bytecodeName;
+    // The interpreter function name of B, as printed by the bytecode pair profile (e.g., 'Call_4' for variant 4 of Call).
+    // This must be the main function of a variant of B.
+    //
+    const char* m_nextFunctionName;
+    // The operands that the variant of B is specialized on, as a comma-separated list of 'name=slot', 'name=constant' or
+    // 'name=<value>' (for literals) in operand order, e.g. 'numArgs=1,numRets=0'. Unspecialized operands are not listed.
+    // The variant ordinal in the function name depends on the order of the Variant() list of B, so the build fails if the
+    // named variant is not specialized exactly like this (and prints how it is specialized).
+    //
+    const char* m_nextVariantOperands;
+};
+
+// For each pair (A, B) below, the interpreter functions of A check if the next bytecode is B by comparing the
+// function pointer loaded from the dispatch table with B's interpreter function, and if so, jump to B directly.
+// Otherwise, they dispatch through the dispatch table as usual. A direct jump is cheaper and better predicted than
+// an indirect jump, so this gets most of the benefit of a fused superinstruction for A+B, without adding opcodes.
+//
+// Each check costs a compare-and-branch when the next bytecode is not B, so only list the most frequent pairs
+// found by x_deegen_enable_interpreter_bytecode_pair_profiling, and at most a couple of pairs for each A.
+// The build fails if a bytecode or interpreter function name listed here does not exist.
+//
+// The list below is a seed picked from common statement shapes; it has not been refreshed from a luabench profile yet.
+//
+constexpr DeegenInterpreterFusedDispatchPair x_deegen_interpreter_fused_dispatch_pairs[] = {
+    // 'f()' as a statement: GlobalGet f, Call with 0 args and 0 results
+    //
+    { "GlobalGet", "Call_0", "numArgs=0,numRets=0" },
+    // 'obj:f()' as a statement: TableGetById obj.f, Call with 1 arg (obj) and 0 results
+    //
+    { "TableGetById", "Call_4", "numArgs=1,numRets=0" },
+    // 'if a + b < c', 'while i + 1 <= n', etc: arithmetic on slots followed by a comparison on slots
+    //
+    { "Add", "BranchIfNLT_0", "lhs=slot,rhs=slot" },
+    { "Sub", "BranchIfNLT_0", "lhs=slot,rhs=slot" },
+    { "Add", "BranchIfNLE_0", "lhs=slot,rhs=slot" },
+};
+
+// The interpreter functions (named as printed by the bytecode pair profile, e.g., 'Call_4') that are cold in the profile.
+//
+// By default, the main function of every bytecode (and its quickened and IC-fused variants) is put in the interpreter's hot
+// code section, and only the slow paths and the return continuations used by slow paths are put in the cold code section.
+// The functions listed here are put in the cold code section as well, so that the hot section only contains the handlers
+// that are actually executed, which keeps them contiguous and reduces the i-cache and iTLB footprint of the interpreter.
+// If all the interpreter functions of a bytecode are listed, the return continuations of the bytecode are also made cold.
+//
+// This only affects the code layout, not the behavior. To refresh the list, build with x_deegen_enable_interpreter_bytecode_pair_profiling
+// set to true, run 'luajitr_bench --tier=interpreter --bytecode-pair-profile=<file>' over all of luabench, and paste the list
+// at the end of <file> here. The list must come from such a run: a function that is executed but listed here is laid out
+// away from the other handlers, which is worse than not listing anything. It is empty until the profile is collected.
+//
+// The build fails if a name listed here does not exist, is listed twice, or is the target of a fused dispatch pair
+// (which is hot by definition).
+//
+constexpr std::array<const char*, 0> x_deegen_interpreter_cold_function_names = {};
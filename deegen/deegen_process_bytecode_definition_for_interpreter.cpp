@@ -2211,7 +2211,9 @@ ProcessBytecodeDefinitionForInterpreterResult WARN_UNUSED ProcessBytecodeDefinit
         fprintf(fp, "    {\n");
         fprintf(fp, "        CRTP* crtp = static_cast<CRTP*>(this);\n");
         fprintf(fp, "        uint8_t* base = crtp->GetBytecodeStart() + bcPos;\n");
-        fprintf(fp, "        size_t opcode = UnalignedLoad<uint16_t>(base);\n");
+        // The bytecode may have been quickened (or dequickened) by the interpreter, so canonicalize the opcode first
+        //
+        fprintf(fp, "        size_t opcode = crtp->GetCanonicalizedOpcodeFromOpcode(UnalignedLoad<uint16_t>(base));\n");
         fprintf(fp, "        Assert(opcode >= CRTP::template GetBytecodeOpcodeBase<%s>());\n", generatedClassName.c_str());
         fprintf(fp, "        opcode -= CRTP::template GetBytecodeOpcodeBase<%s>();\n", generatedClassName.c_str());
         fprintf(fp, "        Assert(opcode < %d);\n", static_cast<int>(currentBytecodeVariantOrdinal));
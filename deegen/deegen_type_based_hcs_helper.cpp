@@ -7,7 +7,7 @@
 
 namespace dast {
 
-std::unordered_map<uint64_t /*operandOrd*/, uint64_t /*argOrd*/> TypeBasedHCSHelper::GetQuickeningSlowPathAdditionalArgs(BytecodeVariantDefinition* bytecodeDef)
+std::unordered_map<uint64_t /*operandOrd*/, uint64_t /*argOrd*/> TypeBasedHCSHelper::GetQuickeningSlowPathAdditionalArgs(BytecodeVariantDefinition* bytecodeDef, size_t quickeningOrd)
 {
     ReleaseAssert(bytecodeDef->HasQuickeningSlowPath());
 
@@ -25,7 +25,7 @@ std::unordered_map<uint64_t /*operandOrd*/, uint64_t /*argOrd*/> TypeBasedHCSHel
     std::reverse(fprList.begin(), fprList.end());
 
     std::unordered_map<uint64_t /*operandOrd*/, uint64_t /*argOrd*/> res;
-    for (auto& it : bytecodeDef->m_quickening)
+    for (auto& it : bytecodeDef->GetQuickening(quickeningOrd))
     {
         TypeMaskTy mask = it.m_speculatedMask;
         // This is the only case that we want to (and can) use FPR to hold the TValue directly
@@ -69,7 +69,10 @@ void TypeBasedHCSHelper::GenerateCheckConditionLogic(DeegenBytecodeImplCreatorBa
     using namespace llvm;
     LLVMContext& ctx = ifi->GetModule()->getContext();
 
-    ReleaseAssert(ifi->IsMainComponent());
+    // Besides the main component, the interpreter's quickened variants for the other quickening candidates also check their conditions
+    //
+    ReleaseAssert(ifi->IsMainComponent() || (ifi->IsInterpreter() && ifi->GetProcessKind() == BytecodeIrComponentKind::QuickenedVariant));
+    size_t quickeningOrd = ifi->GetQuickeningOrd();
 
     Function* wrapper = bb->getParent();
     ReleaseAssert(wrapper != nullptr);
@@ -86,7 +89,7 @@ void TypeBasedHCSHelper::GenerateCheckConditionLogic(DeegenBytecodeImplCreatorBa
     //
     BasicBlock* slowpathBB;
     {
-        std::string slowpathName = BytecodeIrInfo::GetQuickeningSlowPathFuncName(ifi->GetBytecodeDef());
+        std::string slowpathName = BytecodeIrInfo::GetQuickeningSlowPathFuncName(ifi->GetBytecodeDef(), quickeningOrd);
         if (shouldBranchToSaveRegStub)
         {
             slowpathName += "_save_registers";
@@ -161,7 +164,7 @@ void TypeBasedHCSHelper::GenerateCheckConditionLogic(DeegenBytecodeImplCreatorBa
         //
         if (ifi->IsInterpreter() || ifi->IsBaselineJIT())
         {
-            std::unordered_map<uint64_t /*operandOrd*/, uint64_t /*argOrd*/> extraArgs = GetQuickeningSlowPathAdditionalArgs(ifi->GetBytecodeDef());
+            std::unordered_map<uint64_t /*operandOrd*/, uint64_t /*argOrd*/> extraArgs = GetQuickeningSlowPathAdditionalArgs(ifi->GetBytecodeDef(), quickeningOrd);
             for (auto& it : extraArgs)
             {
                 uint64_t operandOrd = it.first;
@@ -214,7 +217,7 @@ void TypeBasedHCSHelper::GenerateCheckConditionLogic(DeegenBytecodeImplCreatorBa
     Function* expectIntrin = Intrinsic::getDeclaration(ifi->GetModule(), Intrinsic::expect, { Type::getInt1Ty(ctx) });
     TypeCheckFunctionSelector tcFnSelector(ifi->GetModule());
 
-    for (auto& it : ifi->GetBytecodeDef()->m_quickening)
+    for (auto& it : ifi->GetBytecodeDef()->GetQuickening(quickeningOrd))
     {
         size_t operandOrd = it.m_operandOrd;
         ReleaseAssert(operandOrd < bytecodeOperandUsageValueList.size());
@@ -250,4 +253,86 @@ void TypeBasedHCSHelper::GenerateCheckConditionLogic(DeegenBytecodeImplCreatorBa
     }
 }
 
+void TypeBasedHCSHelper::GenerateInterpreterRequickeningLogic(InterpreterBytecodeImplCreator* ifi,
+                                                             std::vector<llvm::Value*> bytecodeOperandUsageValueList,
+                                                             llvm::BasicBlock*& bb /*inout*/)
+{
+    using namespace llvm;
+    LLVMContext& ctx = ifi->GetModule()->getContext();
+
+    BytecodeVariantDefinition* bytecodeDef = ifi->GetBytecodeDef();
+    ReleaseAssert(ifi->GetProcessKind() == BytecodeIrComponentKind::QuickeningSlowPath);
+    ReleaseAssert(bytecodeDef->m_quickeningKind == BytecodeQuickeningKind::QuickeningSelector && !bytecodeDef->m_isDfgVariant);
+
+    Function* wrapper = bb->getParent();
+    ReleaseAssert(wrapper != nullptr);
+
+    // The opcodes are laid out as follow:
+    //     base + 0: quickened for candidate 0 (the main component)
+    //     base + i: quickened for candidate i, for 0 < i < numQuickenings
+    //     base + numQuickenings: dequickened
+    //
+    size_t numQuickenings = bytecodeDef->GetNumQuickenings();
+    size_t quickeningOrd = ifi->GetQuickeningOrd();
+    ReleaseAssert(numQuickenings > 1 && quickeningOrd < numQuickenings);
+
+    Type* opcodeTy = Type::getIntNTy(ctx, static_cast<uint32_t>(BytecodeVariantDefinition::x_opcodeSizeBytes * 8));
+
+    Value* delta;
+    if (quickeningOrd > 0)
+    {
+        // We are quickened for a candidate other than the first one, and the candidate failed: always dequicken
+        //
+        delta = ConstantInt::get(opcodeTy, numQuickenings - quickeningOrd);
+    }
+    else
+    {
+        // Find the first of the other candidates satisfied by the operands, or dequicken if there is none
+        //
+        BasicBlock* joinBB = BasicBlock::Create(ctx, "", wrapper);
+        PHINode* phi = PHINode::Create(opcodeTy, static_cast<uint32_t>(numQuickenings), "", joinBB);
+
+        TypeCheckFunctionSelector tcFnSelector(ifi->GetModule());
+        for (size_t candidateOrd = 1; candidateOrd < numQuickenings; candidateOrd++)
+        {
+            BasicBlock* nextCandidateBB = BasicBlock::Create(ctx, "", wrapper);
+            for (auto& it : bytecodeDef->GetQuickening(candidateOrd))
+            {
+                size_t operandOrd = it.m_operandOrd;
+                ReleaseAssert(operandOrd < bytecodeOperandUsageValueList.size());
+                TypeCheckFunctionSelector::QueryResult res = tcFnSelector.Query(it.m_speculatedMask, x_typeMaskFor<tBoxedValueTop>);
+                ReleaseAssert(res.m_opKind == TypeCheckFunctionSelector::QueryResult::CallFunction);
+                Function* callee = res.m_func;
+                ReleaseAssert(callee != nullptr && callee->arg_size() == 1 && llvm_value_has_type<uint64_t>(callee->getArg(0)) && llvm_type_has_type<bool>(callee->getReturnType()));
+                CallInst* checkPassed = CallInst::Create(callee, { bytecodeOperandUsageValueList[operandOrd] }, "", bb);
+                checkPassed->addRetAttr(Attribute::ZExt);
+
+                BasicBlock* newBB = BasicBlock::Create(ctx, "", wrapper);
+                BranchInst::Create(newBB /*ifTrue*/, nextCandidateBB /*ifFalse*/, checkPassed /*cond*/, bb);
+                bb = newBB;
+            }
+            // All checks of this candidate passed
+            //
+            BranchInst::Create(joinBB, bb);
+            phi->addIncoming(ConstantInt::get(opcodeTy, candidateOrd), bb);
+            bb = nextCandidateBB;
+        }
+        // None of the candidates is satisfied
+        //
+        BranchInst::Create(joinBB, bb);
+        phi->addIncoming(ConstantInt::get(opcodeTy, numQuickenings), bb);
+        bb = joinBB;
+        delta = phi;
+    }
+
+    // Update the opcode. Similar to the FuseICIntoInterpreterOpcode case, we do not know the absolute opcode value
+    // at this point, but the affliated opcodes are laid out right after the main opcode, so we can update it by a delta.
+    //
+    Value* bytecodePtr = ifi->GetCurBytecode();
+    ReleaseAssert(llvm_value_has_type<void*>(bytecodePtr));
+    Value* originalOpcode = new LoadInst(opcodeTy, bytecodePtr, "", false /*isVolatile*/, Align(1), bb);
+    Value* newOpcode = BinaryOperator::CreateAdd(originalOpcode, delta, "", bb);
+    new StoreInst(newOpcode, bytecodePtr, false /*isVolatile*/, Align(1), bb);
+}
+
 }   // namespace dast
@@ -16,9 +16,18 @@ struct TypeBasedHCSHelper
                                             std::vector<llvm::Value*> bytecodeOperandUsageValueList,
                                             llvm::BasicBlock*& bb /*inout*/);
 
-    // Get the arguments to be passed to the slow path
+    // Get the arguments to be passed to the slow path of the given quickening candidate
     //
-    static std::unordered_map<uint64_t /*operandOrd*/, uint64_t /*argOrd*/> GetQuickeningSlowPathAdditionalArgs(BytecodeVariantDefinition* bytecodeDef);
+    static std::unordered_map<uint64_t /*operandOrd*/, uint64_t /*argOrd*/> GetQuickeningSlowPathAdditionalArgs(BytecodeVariantDefinition* bytecodeDef, size_t quickeningOrd = 0);
+
+    // Interpreter only, for bytecodes with more than one quickening candidate.
+    // Emit the logic at end of 'bb' in the quickening slow path that rewrites the opcode of the current bytecode:
+    // the slow path of the first candidate requickens the bytecode to the first other candidate that the operands satisfy
+    // (or dequickens it if there is none), and the slow path of any other candidate dequickens the bytecode.
+    //
+    static void GenerateInterpreterRequickeningLogic(InterpreterBytecodeImplCreator* ifi,
+                                                     std::vector<llvm::Value*> bytecodeOperandUsageValueList,
+                                                     llvm::BasicBlock*& bb /*inout*/);
 
     static llvm::Value* WARN_UNUSED GetBytecodeOperandUsageValueFromAlreadyDecodedArgs(llvm::Function* interfaceFn, uint64_t argOrd, llvm::BasicBlock* bb);
 };
@@ -110,8 +110,23 @@ void FPS_ProcessBytecodeDefinitionForBaselineJit()
                 callIcSiteOffsetInSlowPathData = 0;
             }
             ReleaseAssert(callIcSiteOffsetInSlowPathData <= 65535);
-            fprintf(hdrFp, "    .m_callIcSiteOffsetInSlowPathData = %llu\n,", static_cast<unsigned long long>(callIcSiteOffsetInSlowPathData));
-            fprintf(hdrFp, "    .m_unused = 0\n");
+            fprintf(hdrFp, "    .m_callIcSiteOffsetInSlowPathData = %llu,\n", static_cast<unsigned long long>(callIcSiteOffsetInSlowPathData));
+            size_t numGenericIcSites = res.m_bytecodeDef->GetNumGenericICsInJitTier();
+            ReleaseAssert(numGenericIcSites <= 255);
+            size_t genericIcSiteOffsetInSlowPathData;
+            if (numGenericIcSites > 0)
+            {
+                genericIcSiteOffsetInSlowPathData = res.m_bytecodeDef->GetBaselineJitSlowPathDataLayout()->m_genericICs.GetOffsetForSite(0);
+                ReleaseAssert(res.m_bytecodeDef->GetBaselineJitSlowPathDataLayout()->m_genericICs.GetSizePerSite() == sizeof(JitGenericInlineCacheSite));
+            }
+            else
+            {
+                genericIcSiteOffsetInSlowPathData = 0;
+            }
+            ReleaseAssert(genericIcSiteOffsetInSlowPathData <= 65535);
+            fprintf(hdrFp, "    .m_genericIcSiteOffsetInSlowPathData = %llu,\n", static_cast<unsigned long long>(genericIcSiteOffsetInSlowPathData));
+            fprintf(hdrFp, "    .m_numGenericIcSites = %llu,\n", static_cast<unsigned long long>(numGenericIcSites));
+            fprintf(hdrFp, "    .m_unused = { }\n");
             fprintf(hdrFp, "};\n");
 
             for (size_t k = start; k < end; k++)
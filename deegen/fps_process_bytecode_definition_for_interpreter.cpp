@@ -4,6 +4,7 @@
 #include "llvm/IRReader/IRReader.h"
 #include "deegen_process_bytecode_definition_for_interpreter.h"
 #include "deegen_ast_return.h"
+#include "deegen_options.h"
 #include "base64_util.h"
 #include "json_parse_dump.h"
 
@@ -129,6 +130,122 @@ void FPS_GenerateBytecodeBuilderAPIHeader()
         }
     }
 
+    // Check that all the names in x_deegen_interpreter_fused_dispatch_pairs and x_deegen_interpreter_cold_function_names exist,
+    // so that a stale entry fails the build instead of silently becoming a useless check in the interpreter or a no-op
+    //
+    {
+        std::unordered_set<std::string> allBytecodeNames;
+        for (auto& name : allClassNames)
+        {
+            std::string prefixToRemove = "DeegenGenerated_BytecodeBuilder_";
+            ReleaseAssert(name.starts_with(prefixToRemove));
+            allBytecodeNames.insert(name.substr(prefixToRemove.length()));
+        }
+        std::unordered_set<std::string> allInterpreterFnNames;
+        for (json_t& j : jlist)
+        {
+            for (auto& arr : j["cdecl-names"])
+            {
+                ReleaseAssert(arr.is_array());
+                for (auto& x : arr)
+                {
+                    ReleaseAssert(x.is_string());
+                    allInterpreterFnNames.insert(x.get<std::string>());
+                }
+            }
+        }
+        // The operand specialization of each variant, keyed by the variant's main interpreter function name (without the prefix),
+        // in the form of DeegenInterpreterFusedDispatchPair::m_nextVariantOperands
+        //
+        std::unordered_map<std::string, std::string> variantOperandsMap;
+        for (json_t& j : jlist)
+        {
+            for (json_t& info : j["all-bytecode-info"])
+            {
+                json_t& def = info["bytecode_variant_definition"];
+                std::string fnName = JSONCheckedGet<std::string>(def, "bytecode_name") + "_" + std::to_string(JSONCheckedGet<size_t>(def, "bytecode_variant_ord"));
+                std::string desc;
+                for (json_t& op : def["operand_list"])
+                {
+                    std::string kind = JSONCheckedGet<std::string>(op, "kind");
+                    std::string value;
+                    if (kind == "Slot")
+                    {
+                        value = "slot";
+                    }
+                    else if (kind == "Constant")
+                    {
+                        value = "constant";
+                    }
+                    else if (kind == "SpecializedLiteral")
+                    {
+                        uint64_t concreteValue = JSONCheckedGet<uint64_t>(op, "lit_concrete_value");
+                        value = JSONCheckedGet<bool>(op, "lit_is_signed") ? std::to_string(static_cast<int64_t>(concreteValue)) : std::to_string(concreteValue);
+                    }
+                    else
+                    {
+                        continue;
+                    }
+                    if (desc != "") { desc += ","; }
+                    desc += JSONCheckedGet<std::string>(op, "name") + "=" + value;
+                }
+                ReleaseAssert(!variantOperandsMap.count(fnName));
+                variantOperandsMap[fnName] = desc;
+            }
+        }
+
+        for (const DeegenInterpreterFusedDispatchPair& pair : x_deegen_interpreter_fused_dispatch_pairs)
+        {
+            if (!allBytecodeNames.count(pair.m_bytecodeName))
+            {
+                fprintf(stderr, "[ERROR] x_deegen_interpreter_fused_dispatch_pairs: unknown bytecode '%s'\n", pair.m_bytecodeName);
+                abort();
+            }
+            if (!allInterpreterFnNames.count(std::string(x_deegen_interpreter_function_name_prefix) + pair.m_nextFunctionName))
+            {
+                fprintf(stderr, "[ERROR] x_deegen_interpreter_fused_dispatch_pairs: unknown interpreter function '%s'\n", pair.m_nextFunctionName);
+                abort();
+            }
+            if (!variantOperandsMap.count(pair.m_nextFunctionName))
+            {
+                fprintf(stderr, "[ERROR] x_deegen_interpreter_fused_dispatch_pairs: '%s' is not the main function of a bytecode variant\n", pair.m_nextFunctionName);
+                abort();
+            }
+            if (variantOperandsMap[pair.m_nextFunctionName] != pair.m_nextVariantOperands)
+            {
+                fprintf(stderr, "[ERROR] x_deegen_interpreter_fused_dispatch_pairs: '%s' is specialized on '%s', not '%s'\n",
+                        pair.m_nextFunctionName, variantOperandsMap[pair.m_nextFunctionName].c_str(), pair.m_nextVariantOperands);
+                abort();
+            }
+        }
+        std::unordered_set<std::string> coldFnNames;
+        for (const char* coldFnName : x_deegen_interpreter_cold_function_names)
+        {
+            if (!allInterpreterFnNames.count(std::string(x_deegen_interpreter_function_name_prefix) + coldFnName))
+            {
+                fprintf(stderr, "[ERROR] x_deegen_interpreter_cold_function_names: unknown interpreter function '%s'\n", coldFnName);
+                abort();
+            }
+            if (coldFnNames.count(coldFnName))
+            {
+                fprintf(stderr, "[ERROR] x_deegen_interpreter_cold_function_names: '%s' is listed twice\n", coldFnName);
+                abort();
+            }
+            coldFnNames.insert(coldFnName);
+        }
+        // A fused dispatch target is one of the most frequently executed functions, so the two lists cannot both be
+        // up to date if they overlap
+        //
+        for (const DeegenInterpreterFusedDispatchPair& pair : x_deegen_interpreter_fused_dispatch_pairs)
+        {
+            if (coldFnNames.count(pair.m_nextFunctionName))
+            {
+                fprintf(stderr, "[ERROR] x_deegen_interpreter_cold_function_names: '%s' is the target of a fused dispatch pair\n", pair.m_nextFunctionName);
+                abort();
+            }
+        }
+    }
+
     fprintf(hdrOutFile.fp(), "#define GENERATED_ALL_BYTECODE_BUILDER_BYTECODE_NAMES ");
     for (size_t i = 0; i < allClassNames.size(); i++)
     {
@@ -223,6 +340,44 @@ void FPS_GenerateBytecodeBuilderAPIHeader()
         }
     }
 
+    fprintf(cppOutFile.fp(), "        for (size_t i = 0; i < %u; i++) {\n", SafeIntegerCast<unsigned int>(totalSize));
+    fprintf(cppOutFile.fp(), "            ReleaseAssert(r[i] != nullptr);\n");
+    fprintf(cppOutFile.fp(), "        }\n");
+    fprintf(cppOutFile.fp(), "        return r;\n");
+    fprintf(cppOutFile.fp(), "    }\n");
+
+    // Also build the interpreter function name of each opcode in the same order, used by the runtime to print the
+    // interpreter bytecode pair profile
+    //
+    fprintf(cppOutFile.fp(), "    static constexpr auto getNames() {\n");
+    fprintf(cppOutFile.fp(), "        std::array<const char*, %u> r;\n", SafeIntegerCast<unsigned int>(totalSize));
+    fprintf(cppOutFile.fp(), "        for (size_t i = 0; i < %u; i++) {\n", SafeIntegerCast<unsigned int>(totalSize));
+    fprintf(cppOutFile.fp(), "            r[i] = nullptr;\n");
+    fprintf(cppOutFile.fp(), "        }\n");
+
+    for (json_t& j : jlist)
+    {
+        size_t len = j["class-names"].size();
+        for (size_t i = 0; i < len; i++)
+        {
+            std::string className = j["class-names"][i].get<std::string>();
+            auto& arr = j["cdecl-names"][i];
+
+            fprintf(cppOutFile.fp(), "        {\n");
+            fprintf(cppOutFile.fp(), "            constexpr size_t base = BytecodeBuilder::GetBytecodeOpcodeBase<%s>();\n", className.c_str());
+            int k = 0;
+            for (auto& x : arr)
+            {
+                std::string val = x.get<std::string>();
+                ReleaseAssert(val.starts_with(x_deegen_interpreter_function_name_prefix));
+                val = val.substr(strlen(x_deegen_interpreter_function_name_prefix));
+                fprintf(cppOutFile.fp(), "            r[base + %d] = \"%s\";\n", k, val.c_str());
+                k++;
+            }
+            fprintf(cppOutFile.fp(), "        }\n");
+        }
+    }
+
     fprintf(cppOutFile.fp(), "        for (size_t i = 0; i < %u; i++) {\n", SafeIntegerCast<unsigned int>(totalSize));
     fprintf(cppOutFile.fp(), "            ReleaseAssert(r[i] != nullptr);\n");
     fprintf(cppOutFile.fp(), "        }\n");
@@ -256,6 +411,20 @@ void FPS_GenerateBytecodeBuilderAPIHeader()
     }
     fprintf(cppOutFile.fp(), "\n};\n");
 
+    fprintf(cppOutFile.fp(), "\n");
+    fprintf(cppOutFile.fp(), "constexpr std::array<const char*, %u> x_tmpOpcodeNameTable = DeegenBytecodeBuilder::DeegenInterpreterDispatchTableBuilder::getNames();\n", SafeIntegerCast<unsigned int>(totalSize));
+    fprintf(cppOutFile.fp(), "extern \"C\" const char* const %s[%u];\n", x_deegen_interpreter_opcode_name_table_symbol_name, SafeIntegerCast<unsigned int>(totalSize));
+    fprintf(cppOutFile.fp(), "extern \"C\" const char* const %s[%u] = {\n", x_deegen_interpreter_opcode_name_table_symbol_name, SafeIntegerCast<unsigned int>(totalSize));
+    for (size_t i = 0; i < totalSize; i++)
+    {
+        if (i > 0)
+        {
+            fprintf(cppOutFile.fp(), ",\n");
+        }
+        fprintf(cppOutFile.fp(), "    x_tmpOpcodeNameTable[%u]", SafeIntegerCast<unsigned int>(i));
+    }
+    fprintf(cppOutFile.fp(), "\n};\n");
+
     fprintf(cppOutFile.fp(), "#pragma clang diagnostic pop\n");
 
     // This is even more hacky.. We want to generate the list of bytecodes in the same order as the dispatching array.
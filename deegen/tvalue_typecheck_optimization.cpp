@@ -1111,7 +1111,9 @@ struct ConstraintAndOperandList
     std::vector<uint32_t> m_operandList;
 };
 
-static ConstraintAndOperandList WARN_UNUSED CreateBaseConstraint(BytecodeVariantDefinition* bvd, bool forQuickeningFastPath)
+// 'quickeningOrd' is the quickening candidate to assume, only meaningful if 'forQuickeningFastPath' is true
+//
+static ConstraintAndOperandList WARN_UNUSED CreateBaseConstraint(BytecodeVariantDefinition* bvd, bool forQuickeningFastPath, size_t quickeningOrd = 0)
 {
     using AndConstraint = TValueTypecheckOptimizationPass::AndConstraint;
     using LeafConstraint = TValueTypecheckOptimizationPass::LeafConstraint;
@@ -1159,7 +1161,7 @@ static ConstraintAndOperandList WARN_UNUSED CreateBaseConstraint(BytecodeVariant
 
         if (forQuickeningFastPath)
         {
-            for (auto& quickeningInfo : bvd->m_quickening)
+            for (auto& quickeningInfo : bvd->GetQuickening(quickeningOrd))
             {
                 if (quickeningInfo.m_operandOrd == operand->OperandOrdinal())
                 {
@@ -1210,27 +1212,27 @@ void TValueTypecheckOptimizationPass::DoOptimizationForBytecode(BytecodeVariantD
     pass.Run();
 }
 
-void TValueTypecheckOptimizationPass::DoOptimizationForBytecodeQuickeningFastPath(BytecodeVariantDefinition* bvd, llvm::Function* implFunction)
+void TValueTypecheckOptimizationPass::DoOptimizationForBytecodeQuickeningFastPath(BytecodeVariantDefinition* bvd, llvm::Function* implFunction, size_t quickeningOrd)
 {
     using namespace llvm;
     TValueTypecheckOptimizationPass pass;
     pass.SetTargetFunction(implFunction);
 
-    ConstraintAndOperandList r = CreateBaseConstraint(bvd, true /*forQuickeningFastPath*/);
+    ConstraintAndOperandList r = CreateBaseConstraint(bvd, true /*forQuickeningFastPath*/, quickeningOrd);
     pass.SetOperandList(r.m_operandList);
     pass.SetConstraint(std::move(r.m_constraint));
 
     pass.Run();
 }
 
-void TValueTypecheckOptimizationPass::DoOptimizationForBytecodeQuickeningSlowPath(BytecodeVariantDefinition* bvd, llvm::Function* implFunction)
+void TValueTypecheckOptimizationPass::DoOptimizationForBytecodeQuickeningSlowPath(BytecodeVariantDefinition* bvd, llvm::Function* implFunction, size_t quickeningOrd)
 {
     using namespace llvm;
     TValueTypecheckOptimizationPass pass;
     pass.SetTargetFunction(implFunction);
 
     ConstraintAndOperandList b = CreateBaseConstraint(bvd, false /*forQuickeningFastPath*/);
-    ConstraintAndOperandList e = CreateBaseConstraint(bvd, true /*forQuickeningFastPath*/);
+    ConstraintAndOperandList e = CreateBaseConstraint(bvd, true /*forQuickeningFastPath*/, quickeningOrd);
 
     // Create joint condition 'b & !e'
     //
@@ -177,8 +177,8 @@ public:
     void DoOptimization();
 
     static void DoOptimizationForBytecode(BytecodeVariantDefinition* bvd, llvm::Function* implFunction);
-    static void DoOptimizationForBytecodeQuickeningFastPath(BytecodeVariantDefinition* bvd, llvm::Function* implFunction);
-    static void DoOptimizationForBytecodeQuickeningSlowPath(BytecodeVariantDefinition* bvd, llvm::Function* implFunction);
+    static void DoOptimizationForBytecodeQuickeningFastPath(BytecodeVariantDefinition* bvd, llvm::Function* implFunction, size_t quickeningOrd = 0);
+    static void DoOptimizationForBytecodeQuickeningSlowPath(BytecodeVariantDefinition* bvd, llvm::Function* implFunction, size_t quickeningOrd = 0);
 
 private:
     llvm::Function* m_targetFunction;
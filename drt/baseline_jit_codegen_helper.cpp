@@ -2,6 +2,7 @@
 #include "runtime_utils.h"
 #include "bytecode_builder.h"
 #include "temp_arena_allocator.h"
+#include "deegen_options.h"
 
 // These tables are generated by Deegen
 //
@@ -21,6 +22,8 @@ BaselineCodeBlock* NO_INLINE deegen_baseline_jit_do_codegen(CodeBlock* cb)
     //
     ReleaseAssert(cb->m_baselineCodeBlock == nullptr);
 
+    PerfTimer compilationTimer;
+
     uint8_t* bytecodeStream = cb->GetBytecodeStream();
     uint8_t* bytecodeStreamEnd = bytecodeStream + cb->GetBytecodeLength();
 
@@ -93,6 +96,7 @@ BaselineCodeBlock* NO_INLINE deegen_baseline_jit_do_codegen(CodeBlock* cb)
     //
     VM* vm = VM::GetActiveVMForCurrentThread();
     vm->IncrementNumTotalBaselineJitCompilations();
+    vm->RegisterBaselineJitCompiledCodeBlock(cb);
     JitMemoryAllocator* jitAlloc = vm->GetJITMemoryAlloc();
     void* regionVoidPtr = jitAlloc->AllocateGivenSize(totalJitRegionSize);
     Assert(regionVoidPtr != nullptr);
@@ -266,9 +270,87 @@ BaselineCodeBlock* NO_INLINE deegen_baseline_jit_do_codegen(CodeBlock* cb)
     Assert(cb->m_bestEntryPoint == cb->m_owner->GetInterpreterEntryPoint());
     cb->UpdateBestEntryPoint(bcb->m_jitCodeEntry);
     Assert(cb->m_bestEntryPoint == bcb->m_jitCodeEntry);
+
+    double compilationTime = compilationTimer.GetElapsedTime();
+    vm->AddBaselineJitCompilationTime(compilationTime);
+    vm->RecordEvent(VMEventKind::BaselineJitCompile, cb, VMEvent::x_unknownBytecodeOffset, static_cast<uint64_t>(compilationTime * 1e9));
     return bcb;
 }
 
+size_t EvictBaselineJitCode(CodeBlock* cb)
+{
+    BaselineCodeBlock* bcb = cb->m_baselineCodeBlock;
+    ReleaseAssert(bcb != nullptr);
+    // DFG code may OSR exit into the baseline JIT code, so it must never be evicted while DFG code exists
+    //
+    ReleaseAssert(cb->m_dfgCodeBlock == nullptr);
+
+    VM* vm = VM::GetActiveVMForCurrentThread();
+
+    // Destroy all the call IC and generic IC entries owned by the JIT code.
+    // The call IC entries must be unlinked from the target CodeBlocks, otherwise the targets will patch freed memory when they tier up.
+    //
+    for (size_t bcIndex = 0; bcIndex < bcb->m_numBytecodes; bcIndex++)
+    {
+        uint8_t* slowPathData = bcb->GetSlowPathDataAtBytecodeIndex(bcIndex);
+        BytecodeOpcodeTy opcode = UnalignedLoad<BytecodeOpcodeTy>(slowPathData);
+        Assert(opcode < DeegenBytecodeBuilder::BytecodeBuilder::GetTotalBytecodeKinds());
+        const BytecodeBaselineJitTraits& trait = deegen_baseline_jit_bytecode_trait_table[opcode];
+
+        JitCallInlineCacheSite* callIcSites = reinterpret_cast<JitCallInlineCacheSite*>(slowPathData + trait.m_callIcSiteOffsetInSlowPathData);
+        for (size_t i = 0; i < trait.m_numCallIcSites; i++)
+        {
+            JitCallInlineCacheSite* site = callIcSites + i;
+            SpdsPtr<JitCallInlineCacheEntry> node = TCGet(site->m_linkedListHead);
+            while (!node.IsInvalidPtr())
+            {
+                JitCallInlineCacheEntry* entry = TranslateToRawPointer(vm, node.AsPtr());
+                node = TCGet(entry->m_callSiteNextNode);
+                entry->Destroy(vm);
+            }
+            ConstructInPlace(site);
+        }
+
+        JitGenericInlineCacheSite* genericIcSites = reinterpret_cast<JitGenericInlineCacheSite*>(slowPathData + trait.m_genericIcSiteOffsetInSlowPathData);
+        for (size_t i = 0; i < trait.m_numGenericIcSites; i++)
+        {
+            JitGenericInlineCacheSite* site = genericIcSites + i;
+            SpdsPtr<JitGenericInlineCacheEntry> node = TCGet(site->m_linkedListHead);
+            while (!node.IsInvalidPtr())
+            {
+                JitGenericInlineCacheEntry* entry = TranslateToRawPointer(vm, node.AsPtr());
+                node = entry->m_nextNode;
+                vm->GetJITMemoryAlloc()->Free(entry->m_jitAddr);
+                vm->DeallocateSpdsRegionObject(entry);
+            }
+            ConstructInPlace(site);
+        }
+    }
+
+    // Redirect all callers back to the interpreter
+    //
+    Assert(cb->m_bestEntryPoint == bcb->m_jitCodeEntry);
+    cb->UpdateBestEntryPoint(cb->m_owner->GetInterpreterEntryPoint());
+
+    // Reset the tier-up counter so that the function only gets compiled again after it becomes hot again
+    //
+    if (vm->InterpreterCanTierUpFurther())
+    {
+        cb->m_interpreterTierUpCounter = vm->GetInterpreterTierUpThreshold(cb->m_bytecodeLengthIncludingTailPadding);
+    }
+    else
+    {
+        cb->m_interpreterTierUpCounter = 1LL << 62;
+    }
+
+    // Free the JIT code. Note that the BaselineCodeBlock itself lives in the system heap which currently never frees memory.
+    //
+    size_t jitRegionSize = bcb->m_jitRegionSize;
+    vm->GetJITMemoryAlloc()->Free(bcb->m_jitRegionStart);
+    cb->m_baselineCodeBlock = nullptr;
+    return jitRegionSize;
+}
+
 BaselineCodeBlockAndEntryPoint NO_INLINE WARN_UNUSED deegen_prepare_tier_up_into_baseline_jit(HeapPtr<CodeBlock> cbHeapPtr)
 {
     CodeBlock* cb = TranslateToRawPointer(cbHeapPtr);
@@ -300,6 +382,11 @@ BaselineCodeBlockAndEntryPoint NO_INLINE WARN_UNUSED deegen_prepare_osr_entry_in
     size_t bytecodeIndex = bcb->GetBytecodeIndexFromBytecodePtr(curBytecode);
     uint8_t* slowPathDataStruct = bcb->GetSlowPathDataAtBytecodeIndex(bytecodeIndex);
 
+    VM::GetActiveVMForCurrentThread()->RecordEvent(VMEventKind::BaselineJitOsrEntry,
+                                                   cb,
+                                                   SafeIntegerCast<uint32_t>(bcb->GetBytecodeOffsetFromBytecodeIndex(bytecodeIndex)),
+                                                   0 /*arg*/);
+
     // Currently the slowPathData always start with the opcode, followed immediately by the jitAddr for this bytecode
     //
     uint32_t jitAddr = UnalignedLoad<uint32_t>(slowPathDataStruct + sizeof(BytecodeOpcodeTy));
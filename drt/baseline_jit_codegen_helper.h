@@ -20,11 +20,15 @@ struct BytecodeBaselineJitTraits
     uint8_t m_numCondBrLatePatches;
     uint8_t m_numCallIcSites;
     uint16_t m_callIcSiteOffsetInSlowPathData;
-    uint16_t m_unused;
+    // The generic IC sites are needed to reclaim the IC stubs when the JIT code is evicted
+    //
+    uint16_t m_genericIcSiteOffsetInSlowPathData;
+    uint8_t m_numGenericIcSites;
+    uint8_t m_unused[15];
 };
 // Make sure the size of this struct is a power of 2 to make addressing cheap
 //
-static_assert(sizeof(BytecodeBaselineJitTraits) == 16);
+static_assert(sizeof(BytecodeBaselineJitTraits) == 32);
 
 enum class BaselineJitCondBrLatePatchKind : uint32_t
 {
@@ -117,6 +121,14 @@ class BaselineCodeBlock;
 
 BaselineCodeBlock* NO_INLINE deegen_baseline_jit_do_codegen(CodeBlock* cb);
 
+// Throw away the baseline JIT code of 'cb' and all the IC stubs owned by it, and make the CodeBlock execute in the interpreter again.
+// The CodeBlock may later tier up and get compiled again.
+//
+// The caller is responsible for making sure that no call frame of 'cb' is live.
+// Returns the size of the JIT region freed (not including IC stubs).
+//
+size_t EvictBaselineJitCode(CodeBlock* cb);
+
 struct BaselineCodeBlockAndEntryPoint
 {
     // Member order hard-coded as we directly access it as (ptr, ptr) from LLVM
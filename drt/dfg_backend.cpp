@@ -3435,6 +3435,7 @@ private:
         dcb->m_owner = cb;
         TestAssert(m_slowPathDataEndOffset >= m_slowPathDataStartOffset);
         dcb->m_slowPathDataStreamLength = m_slowPathDataEndOffset - m_slowPathDataStartOffset;
+        dcb->m_numOsrExits = 0;
 
         // Allocate the JIT region
         //     [ data section ] [ JIT fast path ] [ JIT slow path ]
@@ -13,11 +13,46 @@ static TypeMaskTy ALWAYS_INLINE GetRawPredictionForEdge(Edge& e)
     return *addr;
 }
 
+// If the bytecode that 'node' comes from has OSR exited too often in previous DFG code (see DfgOsrExitProfile),
+// return the types that the speculations of the node should be widened to cover. Otherwise return tBottom.
+//
+static TypeMaskTy WARN_UNUSED GetOsrExitWideningMaskForNode(Node* node)
+{
+    CodeOrigin origin = node->GetNodeOrigin();
+    CodeBlock* cb = origin.GetInlinedCallFrame()->GetCodeBlock();
+    if (likely(cb->m_dfgOsrExitProfile == nullptr))
+    {
+        return x_typeMaskFor<tBottom>;
+    }
+    DfgOsrExitProfile::Site* site = cb->m_dfgOsrExitProfile->GetSite(origin.GetBytecodeIndex());
+    if (site == nullptr || site->m_numExits < VM::GetActiveVMForCurrentThread()->GetOptions().m_dfgOsrExitSiteWideningThreshold)
+    {
+        return x_typeMaskFor<tBottom>;
+    }
+    return site->m_exitValueTypeMask & x_typeMaskFor<tBoxedValueTop>;
+}
+
+// Widen the prediction of an edge with the widening mask from the OSR exit profile.
+// Edges that are statically known to not need a check have no speculation to widen.
+//
+static TypeMaskTy ALWAYS_INLINE GetWidenedPredictionForEdge(Edge& e, TypeMaskTy wideningMask)
+{
+    TypeMaskTy prediction = GetRawPredictionForEdge(e);
+    if (likely(wideningMask == x_typeMaskFor<tBottom>) || e.IsStaticallyKnownNoCheckNeeded())
+    {
+        return prediction;
+    }
+    return prediction | wideningMask;
+}
+
 // Implementation for the API expected by the generated C++ code
 //
 struct NodeAccessorForSpeculationAssignment
 {
-    NodeAccessorForSpeculationAssignment(Node* node) : m_node(node) { }
+    NodeAccessorForSpeculationAssignment(Node* node, TypeMaskTy wideningMask)
+        : m_node(node)
+        , m_wideningMask(wideningMask)
+    { }
 
     uint8_t* ALWAYS_INLINE GetInlinedNsd()
     {
@@ -33,13 +68,13 @@ struct NodeAccessorForSpeculationAssignment
     TypeMaskTy ALWAYS_INLINE GetPredictionForNodesWithFixedNumInputs(uint32_t inputOrd)
     {
         Edge& e = m_node->GetInputEdgeForNodeWithFixedNumInputs<knownInputSize>(inputOrd);
-        return GetRawPredictionForEdge(e);
+        return GetWidenedPredictionForEdge(e, m_wideningMask);
     }
 
     TypeMaskTy ALWAYS_INLINE GetPredictionForInput(uint32_t inputOrd)
     {
         Edge& e = m_node->GetInputEdge(inputOrd);
-        return GetRawPredictionForEdge(e);
+        return GetWidenedPredictionForEdge(e, m_wideningMask);
     }
 
     void ALWAYS_INLINE SetVariantOrd(uint8_t variantOrd)
@@ -121,6 +156,9 @@ struct NodeAccessorForSpeculationAssignment
     }
 
     Node* m_node;
+    // The types that the predictions of the inputs are widened to cover, see GetOsrExitWideningMaskForNode
+    //
+    TypeMaskTy m_wideningMask;
 };
 
 using SpeculationAssignmentImplFn = void(*)(NodeAccessorForSpeculationAssignment);
@@ -163,7 +201,7 @@ private:
         TestAssert(static_cast<size_t>(kind) < x_speculation_assignment_fn_for_guest_language_nodes.size());
         SpeculationAssignmentImplFn implFn = x_speculation_assignment_fn_for_guest_language_nodes[static_cast<size_t>(kind)];
 
-        NodeAccessorForSpeculationAssignment accessor(node);
+        NodeAccessorForSpeculationAssignment accessor(node, GetOsrExitWideningMaskForNode(node));
         implFn(accessor);
 
         TestAssert(node->HasAssignedDfgVariantOrd());
@@ -258,7 +296,7 @@ private:
             }
             else
             {
-                TypeMask prediction = GetRawPredictionForEdge(e);
+                TypeMask prediction = GetWidenedPredictionForEdge(e, GetOsrExitWideningMaskForNode(node));
 
                 // If the input is guaranteed to see only boxed value, we can filter out the prediction for non-boxed values
                 //
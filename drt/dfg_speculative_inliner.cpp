@@ -38,27 +38,28 @@ SpeculativeInliner::SpeculativeInliner(TempArenaAllocator& alloc,
     , m_inlinedCallFrame(inlinedCallFrame)
     , m_baselineCodeBlock(inlinedCallFrame->GetCodeBlock()->m_baselineCodeBlock)
     , m_tempInputEdgeRes(alloc)
+    , m_heuristic(&VM::GetActiveVMForCurrentThread()->GetOptions().m_speculativeInlinerHeuristic)
     , m_remainingInlineBudget(0)
 {
     m_tempBv.Reset(alloc, inlinedCallFrame->GetCodeBlock()->m_stackFrameNumSlots);
     if (inlinedCallFrame->IsRootFrame())
     {
-        if (m_baselineCodeBlock->m_numBytecodes >= SpeculativeInlinerHeuristic::x_disableAllInliningCutOff)
+        if (m_baselineCodeBlock->m_numBytecodes >= m_heuristic->m_disableAllInliningCutOff)
         {
             m_remainingInlineBudget = 0;
         }
         else
         {
-            m_remainingInlineBudget = SpeculativeInlinerHeuristic::x_inlineBudgetForRootFunction;
+            m_remainingInlineBudget = m_heuristic->m_inlineBudgetForRootFunction;
         }
     }
     else if (inlinedCallFrame->IsDirectCall())
     {
-        m_remainingInlineBudget = SpeculativeInlinerHeuristic::x_inlineBudgetForInlinedDirectCall;
+        m_remainingInlineBudget = m_heuristic->m_inlineBudgetForInlinedDirectCall;
     }
     else
     {
-        m_remainingInlineBudget = SpeculativeInlinerHeuristic::x_inlineBudgetForInlinedClosureCall;
+        m_remainingInlineBudget = m_heuristic->m_inlineBudgetForInlinedClosureCall;
     }
 }
 
@@ -96,7 +97,8 @@ static size_t WARN_UNUSED FindMonomorphicSpeculativeInliningCallSite(JitCallInli
     return candidate;
 }
 
-static size_t ComputeInliningCostForFunction(InlinedCallFrame* activeInlineFrame,
+static size_t ComputeInliningCostForFunction(const SpeculativeInlinerHeuristic& heuristic,
+                                             InlinedCallFrame* activeInlineFrame,
                                              BaselineCodeBlock* targetBcb,
                                              size_t remainingInlineBudget)
 {
@@ -127,12 +129,12 @@ static size_t ComputeInliningCostForFunction(InlinedCallFrame* activeInlineFrame
             frame = frame->GetCallerCodeOrigin().GetInlinedCallFrame();
         }
 
-        if (depth > SpeculativeInlinerHeuristic::x_maximumInliningDepth)
+        if (depth > heuristic.m_maximumInliningDepth)
         {
             return infiniteCost;
         }
 
-        if (recursiveDepth > SpeculativeInlinerHeuristic::x_maximumRecursiveInliningCount)
+        if (recursiveDepth > heuristic.m_maximumRecursiveInliningCount)
         {
             return infiniteCost;
         }
@@ -207,7 +209,7 @@ bool WARN_UNUSED SpeculativeInliner::TrySpeculativeInliningSlowPath(Node* prolog
     // Now determine if we should inline based on heuristic
     //
     {
-        size_t inliningCost = ComputeInliningCostForFunction(m_inlinedCallFrame, calleeBcb, m_remainingInlineBudget);
+        size_t inliningCost = ComputeInliningCostForFunction(*m_heuristic, m_inlinedCallFrame, calleeBcb, m_remainingInlineBudget);
         if (inliningCost > m_remainingInlineBudget)
         {
             return false;
@@ -4,6 +4,7 @@
 #include "bytecode_builder.h"
 #include "dfg_code_origin.h"
 #include "dfg_node.h"
+#include "dfg_speculative_inliner_heuristic.h"
 
 namespace dfg {
 
@@ -59,6 +60,7 @@ private:
     BaselineCodeBlock* m_baselineCodeBlock;
     TempBitVector m_tempBv;
     TempVector<uint32_t> m_tempInputEdgeRes;
+    const SpeculativeInlinerHeuristic* m_heuristic;
     size_t m_remainingInlineBudget;
 };
 
@@ -28,6 +28,7 @@ void* WARN_UNUSED JitGenericInlineCacheSite::InsertForBaselineJIT(uint16_t trait
     JitGenericInlineCacheEntry* entry = JitGenericInlineCacheEntry::Create(vm, TCGet(m_linkedListHead), traitKind, allocationStepping);
     TCSet(m_linkedListHead, SpdsPtr<JitGenericInlineCacheEntry> { entry });
     m_numEntries++;
+    vm->RecordEventAtJitIcSite(VMEventKind::BaselineJitGenericIcInsert, this, m_numEntries);
     return entry->m_jitAddr;
 }
 
@@ -133,5 +134,6 @@ void* WARN_UNUSED JitGenericInlineCacheSite::InsertForDfgJIT(uint16_t dfgOpOrd,
     JitGenericInlineCacheEntry* entry = JitGenericInlineCacheEntry::Create(vm, TCGet(m_linkedListHead), traitOrd, allocationStepping);
     TCSet(m_linkedListHead, SpdsPtr<JitGenericInlineCacheEntry> { entry });
     m_numEntries++;
+    vm->RecordEventAtJitIcSite(VMEventKind::DfgJitGenericIcInsert, this, m_numEntries);
     return entry->m_jitAddr;
 }
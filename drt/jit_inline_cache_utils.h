@@ -65,10 +65,22 @@ struct JitCallInlineCacheTraitsHolder final : public JitCallInlineCacheTraits
 
 extern "C" const JitCallInlineCacheTraits* const deegen_jit_call_inline_cache_trait_table[];
 
+// The default maximum number of IC entries a JIT call IC site may hold.
+// The actual limit is a VM-wide runtime knob (see VM::SetMaxJitCallInlineCacheEntries), this is only its default value.
+//
+// Once a site has reached the limit, it is considered megamorphic: no more IC entries are created, and every call that
+// misses the existing entries goes to the megamorphic dispatch path, which directly dispatches to the callee's best entry point.
+//
 // TODO: tune
 //
 constexpr size_t x_maxJitCallInlineCacheEntries = 3;
 
+// The upper bound of the runtime-configurable limit above.
+// The IC entry count is stored as a uint8_t in the site, and a long chain of IC entries is slower than the megamorphic path anyway.
+//
+constexpr size_t x_jitCallInlineCacheEntriesHardLimit = 32;
+static_assert(x_maxJitCallInlineCacheEntries <= x_jitCallInlineCacheEntriesHardLimit);
+
 // Describes a Generic IC entry
 // TODO: we need to think about the GC story
 //
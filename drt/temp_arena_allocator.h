@@ -57,7 +57,7 @@ public:
         }
 
         {
-            // std::lock_guard<std::mutex> guard(m_lock);
+            std::lock_guard<std::mutex> guard(m_lock);
             if (m_freeListSize < x_maxChunksInMemoryPool)
             {
                 m_freeListSize++;
@@ -78,7 +78,7 @@ private:
     //
     uintptr_t WARN_UNUSED TryGetMemoryChunk()
     {
-        // std::lock_guard<std::mutex> guard(m_lock);
+        std::lock_guard<std::mutex> guard(m_lock);
 
         if (m_freeList == 0)
         {
@@ -92,7 +92,9 @@ private:
         return result;
     }
 
-    // std::mutex m_lock;
+    // The pool is shared by all the VMs in the process, which may be running concurrently on different threads
+    //
+    std::mutex m_lock;
     size_t m_freeListSize;
     uintptr_t m_freeList;
 };
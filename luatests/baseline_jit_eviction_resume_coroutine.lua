@@ -0,0 +1,3 @@
+-- Resume the coroutine left suspended by baseline_jit_eviction_suspended_coroutine.lua
+print(coroutine.resume(suspendedCoroutine, 20))
+print(coroutine.status(suspendedCoroutine))
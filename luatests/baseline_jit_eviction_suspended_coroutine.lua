@@ -0,0 +1,14 @@
+-- Leave a coroutine suspended inside nested calls, so 'inner' and 'outer' have live frames on its stack
+local function inner(x)
+	local y = coroutine.yield(x)
+	return y * 2
+end
+local function outer(x)
+	return inner(x + 1) + 1
+end
+local function unused(x)
+	return x - 1
+end
+print(unused(10))
+suspendedCoroutine = coroutine.create(function(x) return outer(x) end)
+print(coroutine.resume(suspendedCoroutine, 1))
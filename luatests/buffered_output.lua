@@ -0,0 +1,33 @@
+-- Exercise the buffered output path shared by print, io.write and io.stdout
+
+print()
+print(nil, true, false, "str")
+print(1, 2.5, 100, -3, 1e15, 2^53)
+io.write(1, " ", 2.5, " ", -7, " ", "x", "\n")
+io.stdout:write("a", 1, "b", 2, "\n")
+
+-- Output from different paths must come out in program order
+--
+print(io.write("x"), "after")
+local t = setmetatable({}, { __tostring = function() io.write("<inside>") return "T" end })
+print("before", t, "after")
+
+-- A long string is written directly together with the buffered bytes
+--
+local long = string.rep("0123456789", 500)
+io.write("<", long, ">\n")
+print(#long, "done")
+
+-- Many small writes
+--
+for i = 1, 2000 do
+	io.write(i % 10)
+	if i % 100 == 0 then io.write("\n") end
+end
+
+io.stdout:setvbuf("no")
+print("unbuffered")
+io.stdout:setvbuf("full")
+print("fully buffered")
+print(io.stdout:flush())
+print(io.write(""))
@@ -0,0 +1,43 @@
+-- Coroutines abandoned while suspended (e.g., a generator left by 'break') are never freed, since there is no GC.
+-- Each of them keeps its stack reserved, so many of them must still fit in the coroutine stack region,
+-- and running out of coroutine stack space must be a catchable error instead of a fatal one.
+
+local function range(n)
+	return coroutine.wrap(function()
+		for i = 1, n do
+			coroutine.yield(i)
+		end
+	end)
+end
+
+local total = 0
+for i = 1, 12000 do
+	for v in range(10) do
+		total = total + v
+		if v == 3 then
+			break
+		end
+	end
+end
+print(total)
+
+-- Keep creating suspended coroutines until the coroutine stack space runs out
+--
+local cos = {}
+local ok, msg = pcall(function()
+	while true do
+		local co = coroutine.create(function(x) return coroutine.yield(x) + 1 end)
+		coroutine.resume(co, #cos)
+		cos[#cos + 1] = co
+	end
+end)
+print(ok, msg)
+print(#cos > 0)
+print(pcall(coroutine.wrap, function() end))
+
+-- The suspended coroutines still work, and the stack of a coroutine that finishes is reused
+--
+print(coroutine.resume(cos[1], 41))
+print(coroutine.status(cos[1]))
+local co = coroutine.create(function() return "reused" end)
+print(coroutine.resume(co))
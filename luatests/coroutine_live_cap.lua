@@ -0,0 +1,22 @@
+-- Run with the 'max_live_coroutines' VM option set to 25000 (see test_lua_programs.cpp), which raises the cap on the number of
+-- live coroutines above the default (about 16K) by lowering the stack limit of coroutines
+
+local cos = {}
+local ok, msg = pcall(function()
+	while true do
+		local co = coroutine.create(function(x) return coroutine.yield(x) + 1 end)
+		coroutine.resume(co, #cos)
+		cos[#cos + 1] = co
+	end
+end)
+print(ok, msg)
+print(#cos >= 25000)
+
+-- The stack of a finished coroutine is reused, and the lower stack limit still allows moderate recursion
+--
+local function depth(n)
+	if n == 0 then return 0 end
+	return 1 + depth(n - 1)
+end
+print(coroutine.resume(cos[1], 41))
+print(coroutine.resume(coroutine.create(depth), 100))
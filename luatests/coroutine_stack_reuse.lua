@@ -0,0 +1,39 @@
+-- Create many short-lived coroutines. The stack of a dead coroutine is reused by later coroutines,
+-- so the total number of coroutines created over time is not limited by the coroutine stack region.
+-- The coroutines capture their locals as upvalues, which must be closed before the stack is reused.
+
+local getters = {}
+local total = 0
+for i = 1, 100000 do
+	local co = coroutine.create(function(a)
+		local x = a
+		local function get() return x end
+		x = x + coroutine.yield(get)
+		return get
+	end)
+	local ok1, get1 = coroutine.resume(co, i)
+	local ok2, get2 = coroutine.resume(co, 1)
+	assert(ok1 and ok2 and get1 == get2)
+	total = total + get2()
+	if i % 25000 == 0 then
+		getters[#getters + 1] = get1
+	end
+end
+print(total)
+for _, g in ipairs(getters) do
+	print(g())
+end
+
+-- Coroutines that die with an error
+--
+local lastGet
+for i = 1, 50000 do
+	local co = coroutine.create(function()
+		local y = i * 2
+		lastGet = function() return y end
+		error("boom")
+	end)
+	local ok = coroutine.resume(co)
+	assert(not ok)
+end
+print(lastGet())
@@ -0,0 +1,68 @@
+-- Each sequence below runs through its own equality sites, which see different operand types over time.
+-- In the interpreter, a slot/slot equality site starts quickened for double/double, requickens for
+-- nil/boolean or string/string operands, and dequickens for anything else. The results must stay correct.
+
+local mt = { __eq = function(a, b) return true end }
+local t1 = setmetatable({}, mt)
+local t2 = setmetatable({}, mt)
+local t3 = {}
+local nan = 0 / 0
+
+-- Fresh functions for every sequence, so each sequence starts from the initial quickening state
+--
+local function makeSites()
+	return loadstring([[
+		return function(a, b) return a == b end,
+			function(a, b) return a ~= b end,
+			function(a, b) if a == b then return true else return false end end,
+			function(a, b) if a ~= b then return true else return false end end
+	]])()
+end
+
+local function run(name, cases)
+	local eq, ne, eqBranch, neBranch = makeSites()
+	local results = { "", "", "", "" }
+	for i = 1, #cases do
+		local a, b = cases[i][1], cases[i][2]
+		local r = { eq(a, b), ne(a, b), eqBranch(a, b), neBranch(a, b) }
+		for k = 1, 4 do
+			results[k] = results[k] .. (r[k] and "T" or "F")
+		end
+	end
+	print(name, results[1], results[2], results[3], results[4])
+end
+
+local function P(a, b) return { a, b } end
+
+-- double/double, then requicken for nil/boolean, then dequicken for string/string and mixed types
+--
+run("requicken_miv", {
+	P(1, 1), P(1, 2), P(0.5, 0.5), P(1, 1.0),
+	P(nil, nil), P(nil, false), P(true, true), P(false, true), P(1, nil),
+	P("a", "a"), P("a", "b"),
+	P(1, "1"), P(t1, t1), P(t1, t2), P(t1, t3), P(nil, 1), P(nan, nan), P(2, 2)
+})
+
+-- double/double, then requicken for string/string, then dequicken for mixed types
+--
+run("requicken_string", {
+	P(1, 1), P(2, 3),
+	P("x", "x"), P("x", "y"), P("", ""),
+	P(true, nil), P(t1, t2), P(3, 3), P("x", 1)
+})
+
+-- double/double, then dequicken directly
+--
+run("dequicken", {
+	P(1, 1), P(t3, 1), P(1, 1), P(t3, t3), P(nil, nil), P("a", "a")
+})
+
+-- the very first execution already fails the double/double check
+--
+run("string_first", {
+	P("a", "a"), P("a", "b"), P(1, 1), P(nil, false), P(t1, t2)
+})
+
+run("nan_first", {
+	P(nan, nan), P(nan, 1), P(1, 1), P(true, true)
+})
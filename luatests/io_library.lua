@@ -0,0 +1,79 @@
+-- Exercise the io library: file handles, read formats, line iteration and buffered writes
+
+print(io.type(io.stdout), io.type(42), io.type({}))
+
+local f = io.tmpfile()
+print(io.type(f))
+
+-- Lines of various lengths, including some much longer than 16 bytes and one longer than the read buffer
+--
+for i = 1, 100 do
+	f:write("line ", i, " ", string.rep("x", i % 37), "\n")
+end
+f:write(string.rep("0123456789", 10000), "\n")
+f:write("3.5 -17 0x1F 1e3\n")
+f:write("last line without newline")
+
+print(f:seek("set"))
+local count, total = 0, 0
+for line in f:lines() do
+	count = count + 1
+	total = total + #line
+end
+print(count, total)
+
+-- The file is not closed by file:lines, so we can rewind and read again using the different formats
+--
+print(f:seek("set"))
+print(f:read())
+print(f:read("*l", "*l"))
+print(f:read(6), f:read(0), f:read("*l"))
+for i = 1, 96 do f:read("*l") end
+local long = f:read("*l")
+print(#long, long:sub(1, 12), long:sub(-12))
+print(f:read("*n", "*n", "*n", "*n"))
+print(f:read("*l"))
+print(f:read("*a"))
+print(f:read("*a"), f:read("*l"), f:read(1), f:read(0))
+
+-- Read the whole file with "*a"
+--
+print(f:seek("set", 5))
+local all = f:read("*a")
+print(#all, all:sub(1, 3))
+print(f:seek("cur"), f:seek("end"))
+
+-- Switching between writing and reading on a file opened for update
+--
+print(f:seek("set"))
+print(f:read(4))
+f:write("LINE")
+print(f:seek("set"))
+print(f:read("*l"))
+print(f:read("*n"), f:read("*l"))
+f:close()
+print(io.type(f), tostring(f))
+print(pcall(f.read, f))
+print(pcall(io.read, "*x"))
+
+-- io.lines on a file name closes the file when done
+--
+local n = 0
+for line in io.lines("luatests/io_library.lua") do
+	n = n + 1
+	if n == 1 then print(line) end
+end
+print(n > 50)
+
+-- io.open failure returns nil plus a message
+--
+local ok, msg = io.open("luatests/this_file_does_not_exist.txt")
+print(ok, msg)
+print(pcall(io.open, "luatests/io_library.lua", "rw"))
+
+-- The default output file
+--
+print(io.output() == io.stdout)
+io.write("written by io.write ", 1, " ", 2.5, "\n")
+io.stdout:write("written by io.stdout:write\n")
+print(io.close(io.stdout))
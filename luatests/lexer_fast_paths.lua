@@ -0,0 +1,43 @@
+-- Exercise the lexer fast paths: identifiers, whitespace runs, comments and string literal bodies,
+-- including runs that end right before, at, or right after a 16-byte boundary.
+
+local a_very_long_identifier_name_that_spans_multiple_blocks = 1
+local abcdefghijklmno = 2                -- 15 characters
+local abcdefghijklmnop = 3               -- 16 characters
+local abcdefghijklmnopq = 4              -- 17 characters
+print(a_very_long_identifier_name_that_spans_multiple_blocks + abcdefghijklmno + abcdefghijklmnop + abcdefghijklmnopq)
+
+print(                                          "spaces"	 	 	 	 	 	 	 	 	 	 	 	)
+
+-- A short comment that is long enough to span several vector blocks ....................................
+--[[ A long comment ]] print("after long comment")
+--[==[ A level-2 long comment
+that spans ]] multiple ]=] lines
+]==] print("after level-2 long comment")
+
+local s1 = "0123456789abcdef"
+print(#s1, s1)
+local s2 = "0123456789abcde\"f0123456789\\abcdef\t|"
+print(#s2, s2)
+print('it"s a "quoted" string with double quotes inside it')
+
+local ls = [==[
+first line of a long string]]with]=]brackets
+second line]==]
+print(#ls)
+print(ls)
+
+-- The source is provided in pieces, so runs also get split at the end of the input buffer
+--
+local pieces = { "return 'abcdefghijklmnopqrst", "uvwxyz' .. [[0123456789", "abcdefghij]] -- trailing com", "ment" }
+local i = 0
+local f = load(function() i = i + 1 return pieces[i] end)
+print(f())
+
+-- Run this file again through loadfile, which maps the whole file into memory instead of reading it from a string
+--
+if not lexer_test_reloaded then
+	lexer_test_reloaded = true
+	print('-- reload --')
+	loadfile("luatests/lexer_fast_paths.lua")()
+end
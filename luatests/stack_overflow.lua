@@ -0,0 +1,65 @@
+-- Deep recursion, and stack overflow errors when the recursion goes beyond the stack limit
+
+local function depth(n)
+  if n == 0 then return 0 end
+  return 1 + depth(n - 1)
+end
+
+local function infinite(n)
+  return 1 + infinite(n + 1)
+end
+
+-- Deep recursion that needs much more stack than initially committed
+--
+print(depth(50000))
+
+-- A runaway recursion results in a catchable error, after which the stack is usable again
+--
+for i = 1, 3 do
+  print(pcall(infinite, 1))
+end
+print(depth(50000))
+
+-- Tail calls do not grow the stack
+--
+local function loop(n)
+  if n == 0 then return "done" end
+  return loop(n - 1)
+end
+print(loop(1000000))
+
+-- The error handler of xpcall gets to run after a stack overflow
+--
+print(xpcall(function() return infinite(1) end, function(m) return "handled: " .. m end))
+
+-- An error handler that overflows the stack as well
+--
+print(xpcall(function() return infinite(1) end, function(m) return infinite(1) end))
+print(depth(50000))
+
+-- Coroutines have their own stack limit
+--
+local co = coroutine.create(function(n) return depth(n) end)
+print(coroutine.resume(co, 500))
+co = coroutine.create(infinite)
+print(coroutine.resume(co, 1))
+print(coroutine.status(co))
+
+co = coroutine.wrap(function()
+  local ok, m = pcall(infinite, 1)
+  coroutine.yield(ok, m)
+  return depth(500)
+end)
+print(co())
+print(co())
+
+-- Passing too many values
+--
+local big = {}
+for i = 1, 40000 do big[i] = i end
+co = coroutine.create(function(...) return select('#', ...) end)
+print(pcall(coroutine.resume, co, unpack(big)))
+print(coroutine.status(co))
+print(coroutine.resume(co, unpack(big, 1, 1000)))
+print(pcall(unpack, {}, 1, 2000000))
+print(select('#', unpack(big)))
@@ -0,0 +1,40 @@
+-- Stack writes whose size is not known at function entry: string.byte over a long string, and passing on a
+-- large variadic argument list, deep inside a coroutine (whose stack limit is small) and in the root coroutine
+
+local function count(...) return select('#', ...) end
+local function forward(...) return count(...) end
+local function prepend(...) return 1, 2, ... end
+local function ret(...) return ... end
+
+local function atDepth(n, f)
+  if n == 0 then return f() end
+  local ok, r = atDepth(n - 1, f)
+  return ok, r
+end
+
+local big = {}
+for i = 1, 20000 do big[i] = i end
+local s = string.rep("x", 20000)
+
+local cases = {
+  { "byte_short", function() return pcall(count, string.byte(s, 1, 3000)) end },
+  { "byte_long", function() return pcall(string.byte, s, 1, -1) end },
+  { "forward", function() return pcall(forward, unpack(big, 1, 2000)) end },
+  { "forward_overflow", function() return pcall(forward, unpack(big, 1, 5000)) end },
+  { "prepend", function() return pcall(function(...) return count(prepend(...)) end, unpack(big, 1, 2000)) end },
+  { "return", function() return pcall(function(...) return count(ret(...)) end, unpack(big, 1, 2000)) end },
+}
+
+local co = coroutine.wrap(function()
+  for _, c in ipairs(cases) do
+    print(c[1], atDepth(20, c[2]))
+  end
+  -- The stack is usable again after the errors
+  --
+  print("after", atDepth(20, cases[3][2]))
+end)
+co()
+
+print(pcall(string.byte, string.rep("x", 2000000), 1, -1))
+print(count(string.byte(s, 1, -1)))
+print(forward(unpack(big)))
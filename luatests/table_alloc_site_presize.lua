@@ -0,0 +1,128 @@
+-- Tables that are built up after construction, so their TableNew sites get presized by the allocation-site feedback
+
+local function newPoint(x, y, z)
+  local p = {}
+  p.x = x
+  p.y = y
+  p.z = z
+  p.tag = "pt"
+  p.w = x + y + z
+  return p
+end
+
+local sum = 0
+local points = {}
+for i = 1, 100 do
+  local p = newPoint(i, i * 2, i * 3)
+  points[i] = p
+  sum = sum + p.x + p.y + p.z + p.w
+end
+print(sum)
+print(points[1].x, points[1].w, points[100].tag, points[50].z)
+
+-- Array parts built by appending
+--
+local function makeList(n)
+  local t = {}
+  for i = 1, n do
+    t[#t + 1] = i * i
+  end
+  return t
+end
+local total = 0
+for i = 1, 50 do
+  local t = makeList(i)
+  total = total + #t + t[#t]
+end
+print(total)
+print(table.concat(makeList(5), ","))
+
+-- Objects from the same site that get smaller over time
+--
+local function makeVar(n)
+  local o = {}
+  for i = 1, n do
+    o["k" .. i] = i
+  end
+  return o
+end
+local acc = 0
+for i = 1, 20 do
+  local o = makeVar(21 - i)
+  for k, v in pairs(o) do
+    acc = acc + v
+  end
+end
+print(acc)
+
+-- Objects larger than what the feedback presizes
+--
+local big
+for i = 1, 10 do
+  big = makeVar(100)
+end
+local bs = 0
+for k, v in pairs(big) do
+  bs = bs + v
+end
+print(bs, big.k100, big.k1)
+
+local huge
+for i = 1, 3 do
+  huge = makeVar(300)
+end
+local hs = 0
+for k, v in pairs(huge) do
+  hs = hs + v
+end
+print(hs)
+
+-- Objects that get a metatable after construction
+--
+local mt = { __index = function(t, k) return k .. "!" end }
+local function newObj(v)
+  local o = setmetatable({}, mt)
+  o.v = v
+  return o
+end
+local s = ""
+for i = 1, 12 do
+  local o = newObj(i)
+  if i % 4 == 0 then
+    s = s .. o.v .. o.missing .. " "
+  end
+end
+print(s)
+
+-- Arrays with holes
+--
+local function sparse()
+  local t = {}
+  t[1] = 1
+  t[3] = 3
+  t[5] = 5
+  return t
+end
+local c = 0
+for i = 1, 20 do
+  local t = sparse()
+  c = c + t[1] + t[3] + t[5] + (t[2] or 0)
+end
+print(c)
+
+-- Constructors with fields, extended afterwards
+--
+local function mk(v)
+  local o = { a = v, b = v }
+  o.c = v
+  o.d = v
+  o.e = v
+  o.f = v
+  return o
+end
+local m = 0
+for i = 1, 30 do
+  local o = mk(i)
+  m = m + o.a + o.b + o.c + o.d + o.e + o.f
+end
+print(m)
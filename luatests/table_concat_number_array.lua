@@ -0,0 +1,29 @@
+local t = {}
+for i = 1, 10 do
+	t[i] = i * 3
+end
+print(table.concat(t))
+print(table.concat(t, ", "))
+print(table.concat(t, "-", 3, 6))
+print(table.concat(t, 0.5, 9))
+print(table.concat(t, "", 10, 10))
+print(table.concat(t, "x", 5, 4))
+
+local d = {}
+for i = 1, 5 do
+	d[i] = i / 4
+end
+print(table.concat(d, " "))
+local z = 0
+d[6] = -1e15
+d[7] = 1 / z
+d[8] = -z
+print(table.concat(d, ","))
+
+local big = {}
+for i = 1, 1000 do
+	big[i] = i
+end
+print(#table.concat(big))
+print(#table.concat(big, ","))
+print(string.sub(table.concat(big, ","), -15))
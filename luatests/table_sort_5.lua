@@ -0,0 +1,122 @@
+-- table.sort with a user comparator on inputs with different patterns
+
+local seed = 1
+local function rand(n)
+  seed = (seed * 16807) % 2147483647
+  return seed % n
+end
+
+local function check(t, n, lt)
+  for i = 1, n - 1 do
+    if lt(t[i + 1], t[i]) then
+      return false
+    end
+  end
+  return true
+end
+
+local function makeInput(kind, n)
+  local t = {}
+  for i = 1, n do
+    if kind == "random" then t[i] = rand(1000000)
+    elseif kind == "few_unique" then t[i] = rand(4)
+    elseif kind == "sorted" then t[i] = i
+    elseif kind == "reversed" then t[i] = n - i
+    elseif kind == "all_equal" then t[i] = 7
+    elseif kind == "organ_pipe" then t[i] = (i <= n / 2) and i or n - i
+    elseif kind == "sawtooth" then t[i] = i % 37
+    else t[i] = (i == n) and 0 or i end
+  end
+  return t
+end
+
+local kinds = { "random", "few_unique", "sorted", "reversed", "all_equal", "organ_pipe", "sawtooth", "sorted_tail_min" }
+local sizes = { 0, 1, 2, 3, 10, 24, 25, 100, 129, 1000, 5000 }
+local lt = function(a, b) return a < b end
+local gt = function(a, b) return a > b end
+
+for _, kind in ipairs(kinds) do
+  local ok = true
+  for _, n in ipairs(sizes) do
+    local t = makeInput(kind, n)
+    local t2 = {}
+    local sum = 0
+    for i = 1, n do
+      t2[i] = t[i]
+      sum = sum + t[i]
+    end
+    table.sort(t, lt)
+    ok = ok and check(t, n, lt)
+    table.sort(t2, gt)
+    ok = ok and check(t2, n, gt)
+    for i = 1, n do sum = sum - t[i] end
+    ok = ok and sum == 0
+  end
+  print(kind, ok)
+end
+
+-- Sort records by a field, with ties broken by another field
+--
+local records = {}
+for i = 1, 300 do
+  records[i] = { key = rand(10), id = i }
+end
+table.sort(records, function(a, b)
+  if a.key ~= b.key then return a.key < b.key end
+  return a.id > b.id
+end)
+local ok = true
+for i = 1, 299 do
+  local a, b = records[i], records[i + 1]
+  ok = ok and (a.key < b.key or (a.key == b.key and a.id > b.id))
+end
+print("records", ok)
+
+-- Strings
+--
+local words = { "pear", "apple", "fig", "banana", "cherry", "date", "kiwi", "lemon", "mango", "apple" }
+table.sort(words, function(a, b) return #a < #b or (#a == #b and a < b) end)
+print(table.concat(words, " "))
+
+-- The number of comparisons is O(n log n) for sorted and reversed input
+--
+for _, kind in ipairs({ "sorted", "reversed", "all_equal" }) do
+  local t = makeInput(kind, 10000)
+  local cnt = 0
+  table.sort(t, function(a, b) cnt = cnt + 1; return a < b end)
+  print(kind, cnt < 10000 * 20)
+end
+
+-- The comparator may yield
+--
+local co = coroutine.wrap(function()
+  local t = { 5, 3, 8, 1, 9, 2 }
+  table.sort(t, function(a, b) coroutine.yield(); return a < b end)
+  return table.concat(t, " ")
+end)
+local res = co()
+local numYields = 0
+while res == nil do
+  numYields = numYields + 1
+  res = co()
+end
+print(res, numYields > 0)
+
+-- Errors in the comparator propagate
+--
+print(pcall(table.sort, { 3, 2, 1 }, function(a, b) error("cmp error", 0) end))
+
+-- An inconsistent comparator either sorts somehow or reports an invalid order function, but never loses elements
+--
+for _, cmp in ipairs({ function(a, b) return true end, function(a, b) return a <= b end }) do
+  local t = {}
+  for i = 1, 200 do t[i] = rand(5) end
+  local success, msg = pcall(table.sort, t, cmp)
+  local n = 0
+  for i = 1, 200 do if t[i] ~= nil then n = n + 1 end end
+  print(success or msg:find("invalid order function for sorting") ~= nil, n)
+end
+
+-- Bad arguments
+--
+print(pcall(table.sort, { 2, 1 }, 1))
@@ -0,0 +1,75 @@
+-- Exercise userdata through newproxy: metatables, metamethods, equality and use as table keys
+
+local a = newproxy()
+print(type(a), getmetatable(a))
+print(tostring(a):match("^userdata: ") ~= nil)
+print(a == a, a == newproxy(), rawequal(a, a))
+
+local p = newproxy(true)
+local mt = getmetatable(p)
+print(type(mt), next(mt))
+
+-- A proxy created from another proxy shares its metatable
+--
+local q = newproxy(p)
+print(getmetatable(q) == mt, p == q)
+
+print(pcall(newproxy, a))
+print(pcall(newproxy, {}))
+print(pcall(newproxy, 1))
+
+-- Metamethods
+--
+local values = {}
+values[p] = 10
+values[q] = 20
+mt.__index = function(self, k) return k .. "=" .. values[self] end
+mt.__newindex = function(self, k, v) values[self] = v end
+mt.__call = function(self, x) return values[self] + x end
+mt.__len = function(self) return values[self] end
+mt.__tostring = function(self) return "proxy(" .. values[self] .. ")" end
+mt.__lt = function(x, y) return values[x] < values[y] end
+mt.__le = function(x, y) return values[x] <= values[y] end
+mt.__eq = function(x, y) return values[x] % 10 == values[y] % 10 end
+mt.__concat = function(x, y) return tostring(x) .. "|" .. tostring(y) end
+
+print(p.foo, q.bar)
+print(p(1), q(2), #p, #q)
+print(tostring(p), tostring(q))
+print(p < q, p <= q, p > q, p >= q)
+print(p == q, p ~= q)
+print(p .. q)
+p.x = 30
+print(p.x, p < q)
+print(p)
+
+-- Userdata as table keys
+--
+local t = {}
+t[p] = "p"
+t[q] = "q"
+t[a] = "a"
+local n = 0
+for k, v in pairs(t) do n = n + 1 end
+print(n, t[p], t[q], t[a], t[newproxy()])
+
+-- Comparing userdata without metamethods fails
+--
+print((pcall(function() return a < newproxy() end)))
+print((pcall(function() return a.x end)))
+
+-- debug.setmetatable on a userdata
+--
+debug.setmetatable(a, { __index = function(_, k) return "a." .. k end })
+print(a.y, getmetatable(a) ~= mt)
+debug.setmetatable(a, nil)
+print(getmetatable(a))
+
+-- The __metatable field hides the metatable
+--
+mt.__metatable = "locked"
+print(getmetatable(p), getmetatable(q))
+
+-- io file handles are userdata
+--
+print(type(io.stdout), io.type(io.stdout), io.type(p))
@@ -0,0 +1,83 @@
+-- select('#', ...) and select(n, ...) on varargs, including the cases where 'select' is not the builtin
+
+local function count(...)
+  return (select('#', ...))
+end
+
+local function nth(n, ...)
+  local v = select(n, ...)
+  return v
+end
+
+print(count(), count(nil), count(1, nil, 3), count(nil, nil, nil, nil))
+print(nth(1, "a", "b", "c"), nth(3, "a", "b", "c"), nth(4, "a", "b", "c"))
+print(nth(-1, "a", "b", "c"), nth(-3, "a", "b", "c"))
+print(nth(1), nth(2, nil, "x"))
+
+-- Error cases behave the same as calling select
+--
+print(pcall(nth, 0, 1, 2))
+print(pcall(nth, -4, 1, 2, 3))
+print(pcall(nth, "x", 1, 2))
+print(pcall(nth, nil, 1, 2))
+
+-- A typical vararg loop
+--
+local function sum(...)
+  local s = 0
+  for i = 1, select('#', ...) do
+    local v = select(i, ...)
+    if v ~= nil then
+      s = s + v
+    end
+  end
+  return s
+end
+local total = 0
+for i = 1, 1000 do
+  total = total + sum(i, nil, 2, 3)
+end
+print(total)
+
+-- Forwarders that use select to inspect their arguments
+--
+local log = {}
+local function logWrapper(fn)
+  return function(...)
+    local n = select('#', ...)
+    log[#log + 1] = n
+    return fn(...)
+  end
+end
+local add = logWrapper(function(a, b) return a + b end)
+print(add(1, 2), add(3, 4, 5), table.concat(log, ","))
+
+-- A global 'select' that is not the builtin
+--
+local realSelect = select
+local function useGlobalSelect(...)
+  local n = select('#', ...)
+  return n
+end
+print(useGlobalSelect(1, 2))
+select = function(x, ...) return "fake " .. x .. " " .. realSelect('#', ...) end
+print(useGlobalSelect(1, 2))
+select = setmetatable({}, { __call = function(self, x, ...) return "callable " .. x .. " " .. realSelect('#', ...) end })
+print(useGlobalSelect(1, 2, 3))
+select = 1
+print(pcall(useGlobalSelect, 1))
+select = realSelect
+print(useGlobalSelect(1, 2, 3, 4))
+
+-- An upvalue named 'select'
+--
+do
+  local select = select
+  local function countViaUpvalue(...)
+    local n = select('#', ...)
+    return n
+  end
+  print(countViaUpvalue(1, 2, 3))
+  select = function() return "upvalue" end
+  print(countViaUpvalue(1, 2, 3))
+end
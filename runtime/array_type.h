@@ -26,6 +26,9 @@ struct ArrayGrowthPolicy
     // If the index falls between the two cutoffs, we count the # of elements in the array,
     // and grow the vector if there are at least index / x_densityCutoff elements after the growth.
     //
+    // The VM reads this value (as well as x_initialVectorPartCapacity and x_vectorGrowthFactor below) from VMOptions,
+    // so the value here is only the default.
+    //
     constexpr static uint32_t x_densityCutoff = 8;
 
     // If the index is greater than this cutoff, it unconditionally goes to the sparse map
@@ -41,7 +44,12 @@ struct ArrayGrowthPolicy
     //
     constexpr static uint32_t x_vectorGrowthFactor = 2;
 
-    static_assert(x_unconditionallySparseMapCutoff < std::numeric_limits<uint32_t>::max() / 2 / x_vectorGrowthFactor);
+    // The growth factor set in VMOptions must not exceed this value
+    //
+    constexpr static uint32_t x_maxVectorGrowthFactor = 16;
+
+    static_assert(x_vectorGrowthFactor <= x_maxVectorGrowthFactor);
+    static_assert(x_unconditionallySparseMapCutoff < std::numeric_limits<uint32_t>::max() / 2 / x_maxVectorGrowthFactor);
 };
 
 struct ArrayType
@@ -1,6 +1,7 @@
 #include "runtime_utils.h"
 #include "api_define_lib_function.h"
 #include "lj_parser_wrapper.h"
+#include "lua_io_file.h"
 #include <numbers>
 
 #define LUA_LIB_BASE_FUNCTION_LIST      \
@@ -71,6 +72,17 @@
   , type                                \
   , write                               \
 
+// The methods of file handles, e.g., file:read
+//
+#define LUA_LIB_IOFILE_FUNCTION_LIST    \
+    close                               \
+  , flush                               \
+  , lines                               \
+  , read                                \
+  , seek                                \
+  , setvbuf                             \
+  , write                               \
+
 #define LUA_LIB_MATH_FUNCTION_LIST      \
     abs                                 \
   , acos                                \
@@ -148,6 +160,7 @@ PP_FOR_EACH_CARTESIAN_PRODUCT(macro, (base), (LUA_LIB_BASE_FUNCTION_LIST))
 PP_FOR_EACH_CARTESIAN_PRODUCT(macro, (coroutine), (LUA_LIB_COROUTINE_FUNCTION_LIST))
 PP_FOR_EACH_CARTESIAN_PRODUCT(macro, (debug), (LUA_LIB_DEBUG_FUNCTION_LIST))
 PP_FOR_EACH_CARTESIAN_PRODUCT(macro, (io), (LUA_LIB_IO_FUNCTION_LIST))
+PP_FOR_EACH_CARTESIAN_PRODUCT(macro, (iofile), (LUA_LIB_IOFILE_FUNCTION_LIST))
 PP_FOR_EACH_CARTESIAN_PRODUCT(macro, (math), (LUA_LIB_MATH_FUNCTION_LIST))
 PP_FOR_EACH_CARTESIAN_PRODUCT(macro, (os), (LUA_LIB_OS_FUNCTION_LIST))
 PP_FOR_EACH_CARTESIAN_PRODUCT(macro, (package), (LUA_LIB_PACKAGE_FUNCTION_LIST))
@@ -163,6 +176,7 @@ PP_FOR_EACH_CARTESIAN_PRODUCT(macro, (table), (LUA_LIB_TABLE_FUNCTION_LIST))
 [[maybe_unused]] constexpr uint32_t x_num_functions_in_lib_coroutine = 0 PP_FOR_EACH(macro, LUA_LIB_COROUTINE_FUNCTION_LIST);
 [[maybe_unused]] constexpr uint32_t x_num_functions_in_lib_debug = 0 PP_FOR_EACH(macro, LUA_LIB_DEBUG_FUNCTION_LIST);
 [[maybe_unused]] constexpr uint32_t x_num_functions_in_lib_io = 0 PP_FOR_EACH(macro, LUA_LIB_IO_FUNCTION_LIST);
+[[maybe_unused]] constexpr uint32_t x_num_functions_in_lib_iofile = 0 PP_FOR_EACH(macro, LUA_LIB_IOFILE_FUNCTION_LIST);
 [[maybe_unused]] constexpr uint32_t x_num_functions_in_lib_math = 0 PP_FOR_EACH(macro, LUA_LIB_MATH_FUNCTION_LIST);
 [[maybe_unused]] constexpr uint32_t x_num_functions_in_lib_os = 0 PP_FOR_EACH(macro, LUA_LIB_OS_FUNCTION_LIST);
 [[maybe_unused]] constexpr uint32_t x_num_functions_in_lib_package = 0 PP_FOR_EACH(macro, LUA_LIB_PACKAGE_FUNCTION_LIST);
@@ -214,6 +228,8 @@ struct CreateGlobalObjectHelper
 DEEGEN_FORWARD_DECLARE_LIB_FUNC(coroutine_wrap_call);
 DEEGEN_FORWARD_DECLARE_LIB_FUNC(base_ipairs_iterator);
 DEEGEN_FORWARD_DECLARE_LIB_FUNC(io_lines_iter);
+DEEGEN_FORWARD_DECLARE_LIB_FUNC(iofile_lines_iter);
+DEEGEN_FORWARD_DECLARE_LIB_FUNC(iofile_tostring);
 
 #define INSERT_LIBFN(libName, fnName)                                               \
     [[maybe_unused]] HeapPtr<FunctionObject> libfn_ ## libName ##_ ## fnName =      \
@@ -244,6 +260,7 @@ UserHeapPointer<TableObject> CreateGlobalObject(VM* vm)
     vm->InitializeLibFn<VM::LibFn::BaseIPairsIter>(TValue::Create<tFunction>(h.CreateCFunc(DEEGEN_CODE_POINTER_FOR_LIB_FUNC(base_ipairs_iterator))));
     vm->InitializeLibFn<VM::LibFn::BaseToString>(TValue::Create<tFunction>(libfn_base_tostring));
     vm->InitializeLibFn<VM::LibFn::BaseLoad>(TValue::Create<tFunction>(libfn_base_load));
+    vm->InitializeLibFn<VM::LibFn::BaseSelect>(TValue::Create<tFunction>(libfn_base_select));
     vm->InitializeLibFn<VM::LibFn::BaseNextValidationOk>(TValue::Create<tTable>(TableObject::CreateEmptyTableObject(vm, 0U /*inlineCapacity*/, 0 /*initialButterflyArrayPartCapacity*/)));
     vm->m_stringNameForToStringMetamethod = vm->CreateStringObjectFromRawCString("__tostring");
     vm->m_toStringString = vm->CreateStringObjectFromRawCString("tostring");
@@ -264,11 +281,27 @@ UserHeapPointer<TableObject> CreateGlobalObject(VM* vm)
 
     // Initialize io library
     // The io library has 3 non-function fields: stdin, stdout, stderr
-    // TODO: we need to implement these fields.
     //
     HeapPtr<TableObject> libobj_io = h.InsertObject(globalObject, "io", x_num_functions_in_lib_io + 3);
     PP_FOR_EACH_CARTESIAN_PRODUCT(INSERT_LIBFN, (io), (LUA_LIB_IO_FUNCTION_LIST))
 
+    // File handles are userdata of a native class, so all file handles share one metatable, whose '__index' field is the table of file methods
+    //
+    {
+        NativeClassBuilder fileClass(vm, x_num_functions_in_lib_iofile);
+#define macro(libName, fnName) fileClass.AddMethod(PP_STRINGIFY(fnName), DEEGEN_CODE_POINTER_FOR_LIB_FUNC(libName ## _ ## fnName));
+        PP_FOR_EACH_CARTESIAN_PRODUCT(macro, (iofile), (LUA_LIB_IOFILE_FUNCTION_LIST))
+#undef macro
+        fileClass.AddMetamethod("__tostring", DEEGEN_CODE_POINTER_FOR_LIB_FUNC(iofile_tostring));
+
+        Assert(vm->m_ioLibState == nullptr);
+        vm->m_ioLibState = new LuaIoLibState(vm, fileClass.Finish());
+        h.InsertField(libobj_io, "stdin", vm->m_ioLibState->m_stdinHandle);
+        h.InsertField(libobj_io, "stdout", vm->m_ioLibState->m_stdoutHandle);
+        h.InsertField(libobj_io, "stderr", vm->m_ioLibState->m_stderrHandle);
+        vm->InitializeLibFnProto<VM::LibFnProto::IoFileLinesIter>(ExecutableCode::CreateCFunction(vm, DEEGEN_CODE_POINTER_FOR_LIB_FUNC(iofile_lines_iter)));
+    }
+
     // Initialize math library
     // The math library has 2 non-function fields: huge and pi
     // Additionally, it has 1 field for compatibility: math.mod = math.fmod
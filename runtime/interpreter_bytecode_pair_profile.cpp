@@ -0,0 +1,141 @@
+#include "interpreter_bytecode_pair_profile.h"
+#include "deegen_options.h"
+#include "bytecode_builder.h"
+
+// Generated by deegen together with the interpreter dispatch table, holds the interpreter function name of each opcode
+//
+extern "C" const char* const deegen_interpreter_opcode_name_table[];
+
+const size_t g_interpreterNumOpcodes = DeegenBytecodeBuilder::BytecodeBuilder::GetTotalBytecodeKinds();
+
+uint64_t* const g_interpreterBytecodePairCounters =
+    x_deegen_enable_interpreter_bytecode_pair_profiling ? new uint64_t[g_interpreterNumOpcodes * g_interpreterNumOpcodes]() : nullptr;
+
+bool WARN_UNUSED IsInterpreterBytecodePairProfilingEnabled()
+{
+    return x_deegen_enable_interpreter_bytecode_pair_profiling;
+}
+
+void ResetInterpreterBytecodePairProfile()
+{
+    if (!x_deegen_enable_interpreter_bytecode_pair_profiling)
+    {
+        return;
+    }
+    memset(g_interpreterBytecodePairCounters, 0, sizeof(uint64_t) * g_interpreterNumOpcodes * g_interpreterNumOpcodes);
+}
+
+// An interpreter function is considered cold if it belongs to the least executed functions that together
+// account for at most this fraction of all executions
+//
+constexpr double x_coldInterpreterFunctionMaxExecutionFraction = 0.0001;
+
+// Print the interpreter functions that are cold in the profile, in the form of x_deegen_interpreter_cold_function_names
+//
+static void PrintInterpreterColdFunctionList(FILE* fp)
+{
+    // The profile counts dispatches between bytecodes, so a bytecode reached without a dispatch (e.g., the first bytecode of a function)
+    // is only counted as the source of a pair, and a bytecode that does not dispatch (e.g., a return) only as the target of a pair.
+    // So approximate the number of executions of each opcode by the larger of the two.
+    //
+    std::vector<std::pair<uint64_t /*count*/, size_t /*opcode*/>> counts;
+    uint64_t total = 0;
+    for (size_t opcode = 0; opcode < g_interpreterNumOpcodes; opcode++)
+    {
+        uint64_t numDispatchesFrom = 0;
+        uint64_t numDispatchesTo = 0;
+        for (size_t other = 0; other < g_interpreterNumOpcodes; other++)
+        {
+            numDispatchesFrom += g_interpreterBytecodePairCounters[opcode * g_interpreterNumOpcodes + other];
+            numDispatchesTo += g_interpreterBytecodePairCounters[other * g_interpreterNumOpcodes + opcode];
+        }
+        uint64_t count = std::max(numDispatchesFrom, numDispatchesTo);
+        counts.push_back(std::make_pair(count, opcode));
+        total += count;
+    }
+    std::sort(counts.begin(), counts.end());
+
+    std::vector<std::pair<std::string, uint64_t>> coldFunctions;
+    uint64_t cumulative = 0;
+    for (auto& [count, opcode] : counts)
+    {
+        if (static_cast<double>(cumulative + count) > static_cast<double>(total) * x_coldInterpreterFunctionMaxExecutionFraction)
+        {
+            break;
+        }
+        cumulative += count;
+        coldFunctions.push_back(std::make_pair(std::string(deegen_interpreter_opcode_name_table[opcode]), count));
+    }
+    std::sort(coldFunctions.begin(), coldFunctions.end());
+
+    fprintf(fp, "\n== Interpreter functions that are cold in the profile: %llu of %llu, %.4f%% of executions (see x_deegen_interpreter_cold_function_names) ==\n",
+            static_cast<unsigned long long>(coldFunctions.size()),
+            static_cast<unsigned long long>(g_interpreterNumOpcodes),
+            (total == 0) ? 0.0 : static_cast<double>(cumulative) * 100 / static_cast<double>(total));
+    if (coldFunctions.empty())
+    {
+        fprintf(fp, "constexpr std::array<const char*, 0> x_deegen_interpreter_cold_function_names = {};\n");
+        return;
+    }
+    fprintf(fp, "constexpr auto x_deegen_interpreter_cold_function_names = std::to_array<const char*>({\n");
+    for (auto& [name, count] : coldFunctions)
+    {
+        fprintf(fp, "    \"%s\",    // %llu\n", name.c_str(), static_cast<unsigned long long>(count));
+    }
+    fprintf(fp, "});\n");
+}
+
+void PrintInterpreterBytecodePairProfile(FILE* fp, size_t maxPairs)
+{
+    if (!x_deegen_enable_interpreter_bytecode_pair_profiling)
+    {
+        fprintf(fp, "Bytecode pair profiling is not enabled in this build (see x_deegen_enable_interpreter_bytecode_pair_profiling)\n");
+        return;
+    }
+
+    struct PairCount
+    {
+        uint64_t m_count;
+        size_t m_curOpcode;
+        size_t m_nextOpcode;
+    };
+
+    std::vector<PairCount> pairs;
+    uint64_t total = 0;
+    for (size_t cur = 0; cur < g_interpreterNumOpcodes; cur++)
+    {
+        for (size_t next = 0; next < g_interpreterNumOpcodes; next++)
+        {
+            uint64_t count = g_interpreterBytecodePairCounters[cur * g_interpreterNumOpcodes + next];
+            if (count > 0)
+            {
+                pairs.push_back({ .m_count = count, .m_curOpcode = cur, .m_nextOpcode = next });
+                total += count;
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end(), [](const PairCount& lhs, const PairCount& rhs) {
+        if (lhs.m_count != rhs.m_count) { return lhs.m_count > rhs.m_count; }
+        return std::make_pair(lhs.m_curOpcode, lhs.m_nextOpcode) < std::make_pair(rhs.m_curOpcode, rhs.m_nextOpcode);
+    });
+
+    fprintf(fp, "== Interpreter bytecode pair profile: %llu dispatches, %llu distinct pairs ==\n",
+            static_cast<unsigned long long>(total), static_cast<unsigned long long>(pairs.size()));
+    fprintf(fp, "%-6s %-16s %-8s %-8s %s\n", "rank", "count", "%", "cum %", "bytecode -> next bytecode");
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < pairs.size() && i < maxPairs; i++)
+    {
+        const PairCount& p = pairs[i];
+        cumulative += p.m_count;
+        fprintf(fp, "%-6llu %-16llu %-8.3f %-8.3f %s -> %s\n",
+                static_cast<unsigned long long>(i + 1),
+                static_cast<unsigned long long>(p.m_count),
+                static_cast<double>(p.m_count) * 100 / static_cast<double>(total),
+                static_cast<double>(cumulative) * 100 / static_cast<double>(total),
+                deegen_interpreter_opcode_name_table[p.m_curOpcode],
+                deegen_interpreter_opcode_name_table[p.m_nextOpcode]);
+    }
+
+    PrintInterpreterColdFunctionList(fp);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "common_utils.h"
+
+// The number of times the interpreter dispatched from a bytecode to the next one, for each pair of interpreter opcodes
+//
+// The counting logic is only generated into the interpreter when x_deegen_enable_interpreter_bytecode_pair_profiling
+// is true (see deegen_options.h), otherwise the counters are not allocated and all the functions below are no-ops.
+// Since the pairs are counted by interpreter opcode, the quickened variants of a bytecode are counted separately.
+//
+// The most frequent pairs are the candidates for x_deegen_interpreter_fused_dispatch_pairs (see deegen_options.h).
+//
+// The counters are global to the process (not per VM), so the profile of multiple runs in one process accumulates.
+//
+// The counter of the pair (curOpcode, nextOpcode) is g_interpreterBytecodePairCounters[curOpcode * g_interpreterNumOpcodes + nextOpcode]
+//
+extern uint64_t* const g_interpreterBytecodePairCounters;
+extern const size_t g_interpreterNumOpcodes;
+
+bool WARN_UNUSED IsInterpreterBytecodePairProfilingEnabled();
+void ResetInterpreterBytecodePairProfile();
+
+// Print the 'maxPairs' most frequent pairs, with the interpreter function names of the opcodes
+// (which are also the names used by x_deegen_interpreter_fused_dispatch_pairs)
+//
+// The output ends with the least executed interpreter functions, in the form of x_deegen_interpreter_cold_function_names
+// (see deegen_options.h), so the profile can be fed back to deegen to lay out the interpreter code.
+//
+void PrintInterpreterBytecodePairProfile(FILE* fp, size_t maxPairs);
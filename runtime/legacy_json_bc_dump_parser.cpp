@@ -1465,8 +1465,11 @@ std::unique_ptr<ScriptModule> WARN_UNUSED ScriptModule::LegacyParseScriptFromJSO
                 // Create the structure now, so we can call GetInitialStructureForSteppingKnowingAlreadyBuilt at runtime
                 //
                 std::ignore = Structure::GetInitialStructureForStepping(vm, stepping);
+                TValue tvProfile;
+                tvProfile.m_value = reinterpret_cast<uint64_t>(TableAllocationSiteProfile::Create(vm, stepping, static_cast<uint16_t>(arrayPartHint)));
 
                 bw.CreateTableNew({
+                    .allocationSiteProfile = tvProfile,
                     .inlineStorageSizeStepping = stepping,
                     .arrayPartSizeHint = static_cast<uint16_t>(arrayPartHint),
                     .output = local(opdata[0])
@@ -1474,6 +1477,7 @@ std::unique_ptr<ScriptModule> WARN_UNUSED ScriptModule::LegacyParseScriptFromJSO
 
 #ifndef NDEBUG
                 auto operands = bw.DecodeTableNew(bcPosForCurBytecode);
+                Assert(operands.allocationSiteProfile == tvProfile);
                 Assert(operands.inlineStorageSizeStepping == stepping);
                 Assert(operands.arrayPartSizeHint == static_cast<uint16_t>(arrayPartHint));
                 Assert(operands.output == local(opdata[0]));
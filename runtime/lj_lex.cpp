@@ -75,8 +75,12 @@
 
 #include "lj_parser_wrapper.h"
 #include "lj_parse_details.h"
+#include "parsed_module_cache.h"
 
 #include "vm.h"
+#include "mmap_utils.h"
+
+#include <sys/stat.h>
 
 #define TKSTR1(name) +1
 #define TKSTR2(name, sym) +1
@@ -137,6 +141,119 @@ static ALWAYS_INLINE LexChar lex_savenext(LexState* ls)
     return lex_next(ls);
 }
 
+/* -- Vectorized scanning fast paths ---------------------------------------- */
+
+// The helpers below find the end of a run of characters of some class in the buffered input [p, pe).
+// Each returns a pointer to the first character that does not belong to the run, or 'pe' if the whole range
+// belongs to the run. The caller is responsible for handling the end of the buffer (by calling lex_next).
+//
+// 16 characters are checked at a time using SSE, and the tail shorter than 16 characters takes the scalar path.
+// Nothing is ever read outside [p, pe).
+//
+template<typename SimdMatcher, typename ScalarMatcher>
+static ALWAYS_INLINE const char* lex_find_run_end(const char* p, const char* pe, const SimdMatcher& inRunSimd, const ScalarMatcher& inRunScalar)
+{
+    while (pe - p >= 16)
+    {
+        __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(inRunSimd(input)));
+        if (mask != 0xffffU)
+        {
+            return p + __builtin_ctz(~mask);
+        }
+        p += 16;
+    }
+    while (p < pe && inRunScalar((uint8_t)*p))
+    {
+        p++;
+    }
+    return p;
+}
+
+/* Find the end of an identifier body: [A-Za-z0-9_] and all characters >= 0x80 (same as lj_char_isident). */
+static const char* lex_find_ident_end(const char* p, const char* pe)
+{
+    return lex_find_run_end(p, pe,
+        [](__m128i x) {
+            __m128i highBit = _mm_cmplt_epi8(x, _mm_setzero_si128());
+            __m128i lower = _mm_or_si128(x, _mm_set1_epi8(0x20));
+            __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+            __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(x, _mm_set1_epi8('9' + 1)));
+            __m128i underscore = _mm_cmpeq_epi8(x, _mm_set1_epi8('_'));
+            return _mm_or_si128(_mm_or_si128(highBit, alpha), _mm_or_si128(digit, underscore));
+        },
+        [](uint8_t c) { return lj_char_isident(c) != 0; });
+}
+
+/* Find the end of a run of non-newline whitespaces: ' ', '\t', '\v' and '\f'. */
+static const char* lex_find_hspace_end(const char* p, const char* pe)
+{
+    return lex_find_run_end(p, pe,
+        [](__m128i x) {
+            __m128i space = _mm_cmpeq_epi8(x, _mm_set1_epi8(' '));
+            __m128i tab = _mm_cmpeq_epi8(x, _mm_set1_epi8('\t'));
+            __m128i vtabOrFormFeed = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('\n')), _mm_cmplt_epi8(x, _mm_set1_epi8('\r')));
+            return _mm_or_si128(_mm_or_si128(space, tab), vtabOrFormFeed);
+        },
+        [](uint8_t c) { return c == ' ' || c == '\t' || c == '\v' || c == '\f'; });
+}
+
+/* Find the end of a short comment body, i.e., the next '\n' or '\r'. */
+static const char* lex_find_eol(const char* p, const char* pe)
+{
+    return lex_find_run_end(p, pe,
+        [](__m128i x) {
+            __m128i eol = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\r')));
+            return _mm_xor_si128(eol, _mm_set1_epi8(-1));
+        },
+        [](uint8_t c) { return c != '\n' && c != '\r'; });
+}
+
+/* Find the end of a run of ordinary characters in a quoted string, i.e., the next delimiter, '\\', '\n' or '\r'. */
+static const char* lex_find_string_special(const char* p, const char* pe, LexChar delim)
+{
+    __m128i delimVec = _mm_set1_epi8((char)delim);
+    return lex_find_run_end(p, pe,
+        [&](__m128i x) {
+            __m128i eol = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\r')));
+            __m128i special = _mm_or_si128(_mm_or_si128(eol, _mm_cmpeq_epi8(x, _mm_set1_epi8('\\'))), _mm_cmpeq_epi8(x, delimVec));
+            return _mm_xor_si128(special, _mm_set1_epi8(-1));
+        },
+        [&](uint8_t c) { return c != delim && c != '\\' && c != '\n' && c != '\r'; });
+}
+
+/* Find the end of a run of ordinary characters in a long string or long comment, i.e., the next ']', '\n' or '\r'. */
+static const char* lex_find_longstring_special(const char* p, const char* pe)
+{
+    return lex_find_run_end(p, pe,
+        [](__m128i x) {
+            __m128i eol = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\r')));
+            __m128i special = _mm_or_si128(eol, _mm_cmpeq_epi8(x, _mm_set1_epi8(']')));
+            return _mm_xor_si128(special, _mm_set1_epi8(-1));
+        },
+        [](uint8_t c) { return c != ']' && c != '\n' && c != '\r'; });
+}
+
+/* Skip the current character and all buffered characters before 'end', then get the next character. */
+static ALWAYS_INLINE LexChar lex_skiprun(LexState* ls, const char* end)
+{
+    Assert(ls->p <= end && end <= ls->pe);
+    ls->p = end;
+    return lex_next(ls);
+}
+
+/* Save the current character and all buffered characters before 'end', then get the next character. */
+static ALWAYS_INLINE LexChar lex_saverun(LexState* ls, const char* end)
+{
+    Assert(ls->p <= end && end <= ls->pe);
+    size_t len = (size_t)(end - ls->p);
+    char* buf = ls->sb->Reserve(len + 1);
+    buf[0] = (char)ls->c;
+    memcpy(buf + 1, ls->p, len);
+    ls->sb->Update(buf + len + 1);
+    return lex_skiprun(ls, end);
+}
+
 #define LJ_MAX_LINE 0x7fffff00
 
 /* Skip line break. Handles "\n", "\r", "\r\n" or "\n\r". */
@@ -230,7 +347,11 @@ static void lex_longstring(LexState* ls, TValue* tv, int sep)
         }
         default:
         {
-            lex_savenext(ls);
+            const char* end = lex_find_longstring_special(ls->p, ls->pe);
+            if (tv)
+                lex_saverun(ls, end);
+            else
+                lex_skiprun(ls, end); /* The content of a comment is never used. */
             break;
         }
         }   /* switch ls->c */
@@ -401,7 +522,7 @@ static void lex_string(LexState* ls, TValue* tv)
         }
         default:
         {
-            lex_savenext(ls);
+            lex_saverun(ls, lex_find_string_special(ls->p, ls->pe, delim));
             break;
         }
         } /* switch ls->c */
@@ -428,7 +549,7 @@ static LexToken lex_scan(LexState* ls, TValue* tv)
             /* Identifier or reserved word. */
             do
             {
-                lex_savenext(ls);
+                lex_saverun(ls, lex_find_ident_end(ls->p, ls->pe));
             } while (lj_char_isident(ls->c));
             TValue tvStr = lj_parse_keepstr(ls, ls->sb->Begin(), ls->sb->Len());
             *tv = tvStr;
@@ -453,7 +574,7 @@ static LexToken lex_scan(LexState* ls, TValue* tv)
         case '\v':
         case '\f':
         {
-            lex_next(ls);
+            lex_skiprun(ls, lex_find_hspace_end(ls->p, ls->pe));
             continue;
         }
         case '-':
@@ -479,7 +600,7 @@ static LexToken lex_scan(LexState* ls, TValue* tv)
             /* Short comment "--.*\n". */
             while (!lex_iseol(ls) && ls->c != LEX_EOF)
             {
-                lex_next(ls);
+                lex_skiprun(ls, lex_find_eol(ls->p, ls->pe));
             }
             continue;
         }
@@ -675,7 +796,32 @@ void lj_lex_init(VM* vm)
     }
 }
 
-ParseResult WARN_UNUSED ParseLuaScript(CoroutineRuntimeContext* coroCtx, lua_Reader rd, void* ud)
+std::unique_ptr<ScriptModule> WARN_UNUSED CreateScriptModuleFromUnlinkedCodeBlocks(CoroutineRuntimeContext* coroCtx, std::vector<UnlinkedCodeBlock*>&& ucbList)
+{
+    VM* vm = VM::GetActiveVMForCurrentThread();
+    Assert(ucbList.size() > 0);
+    UnlinkedCodeBlock* chunkFn = ucbList.back();
+    std::unique_ptr<ScriptModule> module = std::make_unique<ScriptModule>();
+    module->m_unlinkedCodeBlocks = std::move(ucbList);
+    module->m_defaultGlobalObject = coroCtx->m_globalObject;
+    for (UnlinkedCodeBlock* ucb : module->m_unlinkedCodeBlocks)
+    {
+        AssertIff(ucb != chunkFn, ucb->m_parent != nullptr);
+        AssertIff(ucb != chunkFn, ucb->m_uvFixUpCompleted);
+        Assert(ucb->m_defaultCodeBlock == nullptr);
+        ucb->m_defaultCodeBlock = CodeBlock::Create(vm, ucb, coroCtx->m_globalObject);
+    }
+    chunkFn->m_uvFixUpCompleted = true;
+    Assert(chunkFn->m_numFixedArguments == 0);
+    Assert(chunkFn->m_numUpvalues == 0);
+    UserHeapPointer<FunctionObject> entryPointFunc = FunctionObject::Create(vm, chunkFn->GetCodeBlock(coroCtx->m_globalObject));
+    module->m_defaultEntryPoint = entryPointFunc;
+    return module;
+}
+
+// If 'vmStateRecord' is not nullptr, the VM state created by the parser is recorded into it
+//
+static ParseResult WARN_UNUSED ParseLuaScriptImpl(CoroutineRuntimeContext* coroCtx, lua_Reader rd, void* ud, ParserVmStateRecord* vmStateRecord)
 {
     SimpleTempStringStream ss;
     LexState ls;
@@ -684,31 +830,17 @@ ParseResult WARN_UNUSED ParseLuaScript(CoroutineRuntimeContext* coroCtx, lua_Rea
     ls.chunkarg = "?";
     ls.mode = nullptr;
     ls.sb = &ss;
+    ls.vmStateRecord = vmStateRecord;
 
     if (!setjmp(ls.longjmp_buf))
     {
-        VM* vm = VM::GetActiveVMForCurrentThread();
         lj_lex_setup(coroCtx, &ls);
         UnlinkedCodeBlock* chunkFn = lj_parse(&ls);
-        std::unique_ptr<ScriptModule> module = std::make_unique<ScriptModule>();
-        module->m_unlinkedCodeBlocks = std::move(ls.ucbList);
-        module->m_defaultGlobalObject = coroCtx->m_globalObject;
-        Assert(module->m_unlinkedCodeBlocks.size() > 0);
-        Assert(module->m_unlinkedCodeBlocks.back() == chunkFn);
-        for (UnlinkedCodeBlock* ucb : module->m_unlinkedCodeBlocks)
-        {
-            AssertIff(ucb != chunkFn, ucb->m_parent != nullptr);
-            AssertIff(ucb != chunkFn, ucb->m_uvFixUpCompleted);
-            Assert(ucb->m_defaultCodeBlock == nullptr);
-            ucb->m_defaultCodeBlock = CodeBlock::Create(vm, ucb, coroCtx->m_globalObject);
-        }
-        chunkFn->m_uvFixUpCompleted = true;
-        Assert(chunkFn->m_numFixedArguments == 0);
-        Assert(chunkFn->m_numUpvalues == 0);
-        UserHeapPointer<FunctionObject> entryPointFunc = FunctionObject::Create(vm, chunkFn->GetCodeBlock(coroCtx->m_globalObject));
-        module->m_defaultEntryPoint = entryPointFunc;
+        Assert(ls.ucbList.size() > 0);
+        Assert(ls.ucbList.back() == chunkFn);
+        std::ignore = chunkFn;
         return {
-            .m_scriptModule = std::move(module),
+            .m_scriptModule = CreateScriptModuleFromUnlinkedCodeBlocks(coroCtx, std::move(ls.ucbList)),
             .errMsg = TValue::Create<tNil>()
         };
     }
@@ -807,17 +939,53 @@ static const char* Parser_LuaSimpleStringReader(CoroutineRuntimeContext* /*ctx*/
     return state->m_data;
 }
 
-ParseResult WARN_UNUSED ParseLuaScript(CoroutineRuntimeContext* ctx, const std::string& str)
+ParseResult WARN_UNUSED ParseLuaScript(CoroutineRuntimeContext* coroCtx, lua_Reader rd, void* ud)
 {
+    return ParseLuaScriptImpl(coroCtx, rd, ud, nullptr /*vmStateRecord*/);
+}
+
+// Look up the source in the process-wide parsed module cache, and link the cached module into the current VM if found.
+// Otherwise, parse the source and populate the cache.
+//
+static ParseResult WARN_UNUSED ParseLuaScriptWithModuleCache(CoroutineRuntimeContext* ctx, const char* data, size_t length)
+{
+    ParsedModuleCache& cache = ParsedModuleCache::Get();
+    std::shared_ptr<const ParsedModuleImage> image = cache.Find(data, length);
+    if (image != nullptr)
+    {
+        VM* vm = VM::GetActiveVMForCurrentThread();
+        std::vector<UnlinkedCodeBlock*> ucbList = image->Link(vm, ctx->m_globalObject);
+        return {
+            .m_scriptModule = CreateScriptModuleFromUnlinkedCodeBlocks(ctx, std::move(ucbList)),
+            .errMsg = TValue::Create<tNil>()
+        };
+    }
+
+    ParserVmStateRecord vmStateRecord;
     LuaSimpleStringReaderState state;
-    state.m_data = str.data();
-    state.m_length = str.length();
+    state.m_data = data;
+    state.m_length = length;
     state.m_provided = false;
-    return ParseLuaScript(ctx, Parser_LuaSimpleStringReader, &state);
+    ParseResult res = ParseLuaScriptImpl(ctx, Parser_LuaSimpleStringReader, &state, &vmStateRecord);
+    if (res.m_scriptModule.get() != nullptr)
+    {
+        cache.Insert(data, length, res.m_scriptModule->m_unlinkedCodeBlocks, vmStateRecord);
+    }
+    return res;
+}
+
+ParseResult WARN_UNUSED ParseLuaScript(CoroutineRuntimeContext* ctx, const std::string& str)
+{
+    return ParseLuaScript(ctx, str.data(), str.length());
 }
 
 ParseResult WARN_UNUSED ParseLuaScript(CoroutineRuntimeContext* ctx, const char* data, size_t length)
 {
+    if (ParsedModuleCache::IsEnabled())
+    {
+        return ParseLuaScriptWithModuleCache(ctx, data, length);
+    }
+
     LuaSimpleStringReaderState state;
     state.m_data = data;
     state.m_length = length;
@@ -909,6 +1077,44 @@ ParseResult WARN_UNUSED ParseLuaScriptFromFile(CoroutineRuntimeContext* ctx, con
         };
     }
 
+    // For regular files, map the whole file into memory, so the lexer scans the source in place
+    // (and its vectorized fast paths see the whole source as one buffer) instead of copying it through stdio buffers.
+    //
+    {
+        struct stat st;
+        int fd = fileno(fp);
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+        {
+            size_t length = static_cast<size_t>(st.st_size);
+            void* data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                fclose(fp);
+                Auto(do_munmap(data, length));
+                madvise(data, length, MADV_SEQUENTIAL);
+                return ParseLuaScript(ctx, reinterpret_cast<const char*>(data), length);
+            }
+        }
+    }
+
+    // The parsed module cache is keyed by the source content, so read the whole file first
+    //
+    if (ParsedModuleCache::IsEnabled())
+    {
+        std::string content;
+        LuaSimpleFileReaderState state;
+        state.fp = fp;
+        while (true)
+        {
+            size_t size;
+            const char* buf = Parser_LuaSimpleFileReader(ctx, &state, &size /*out*/);
+            if (buf == nullptr) { break; }
+            content.append(buf, size);
+        }
+        fclose(fp);
+        return ParseLuaScript(ctx, content.data(), content.length());
+    }
+
     LuaSimpleFileReaderState state;
     state.fp = fp;
     ParseResult res = ParseLuaScript(ctx, Parser_LuaSimpleFileReader, &state);
@@ -40,6 +40,8 @@
 #include "tvalue.h"
 #include "simple_string_stream.h"
 
+struct ParserVmStateRecord;
+
 using BCPos = uint32_t;
 using BCLine = uint32_t;
 using MSize = uint64_t;
@@ -182,6 +184,7 @@ typedef struct LexState {
   const char* errorMsg;
   jmp_buf longjmp_buf;
   std::vector<UnlinkedCodeBlock*> ucbList;
+  ParserVmStateRecord* vmStateRecord;	/* If not nullptr, record VM state created by the parser. */
 } LexState;
 
 NO_INLINE NO_RETURN void parser_throw(LexState* ls);
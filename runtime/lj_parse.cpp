@@ -82,6 +82,7 @@
 
 #include "vm.h"
 #include "bytecode_builder.h"
+#include "lj_parser_wrapper.h"
 
 #include "deegen/deegen_options.h"
 
@@ -1978,6 +1979,51 @@ static void fs_fixup_uv2(FuncState *fs, UnlinkedCodeBlock* ucb)
     }
 }
 
+/* Check if the CALLM at 'pc' is 'select(x, ...)' taking one result, i.e.:
+**     GGET/UGET  A                "select"
+**     <one instruction putting the selector to the first argument slot>
+**     VARG       <second argument slot> (all varargs)
+**     CALLM      A                (1 fixed argument, 1 result)
+** Like predict_next, detecting select() by name is simplistic, but quite effective.
+** The CallSelectVarArgs bytecode backs off to a normal call if the callee is not the true select() at runtime.
+*/
+static bool predict_select_varargs(FuncState *fs, BCPos pc)
+{
+    BCIns ins = fs->bcbase[pc].inst;
+    Assert(bc_op(ins) == BC_CALLM);
+    if (pc < 4 || bc_c(ins) != 1 || bc_b(ins) != 2)
+        return false;
+    BCReg base = bc_a(ins);
+    BCIns varg = fs->bcbase[pc-1].inst;
+    if (bc_op(varg) != BC_VARG || bc_a(varg) != base+2+LJ_FR2 || bc_b(varg) != 0)
+        return false;
+    BCIns ld = fs->bcbase[pc-3].inst;
+    HeapPtr<HeapString> name;
+    switch (bc_op(ld)) {
+    case BC_UGET:
+        if (bc_a(ld) != base) return false;
+        name = fs->ls->vstack[fs->uvmap[bc_d(ld)]].name;
+        break;
+    case BC_GGET:
+    {
+        if (bc_a(ld) != base) return false;
+        TValue cst = bc_cst(ld);
+        Assert(cst.Is<tString>());
+        name = cst.As<tString>();
+        break;
+    }
+    default:
+        return false;
+    }
+    return name->m_length == 6 &&
+           name->m_string[0] == 's' &&
+           name->m_string[1] == 'e' &&
+           name->m_string[2] == 'l' &&
+           name->m_string[3] == 'e' &&
+           name->m_string[4] == 'c' &&
+           name->m_string[5] == 't';
+}
+
 /* Fixup bytecode for prototype. */
 static void fs_fixup_bc(FuncState *fs, UnlinkedCodeBlock* ucb, BytecodeBuilder& bw, MSize n)
 {
@@ -2524,7 +2570,13 @@ static void fs_fixup_bc(FuncState *fs, UnlinkedCodeBlock* ucb, BytecodeBuilder&
             // B stores # fixed results + 1, and if opdata[1] == 0, it stores all results
             //
             uint32_t opB = bc_b(ins);
-            if (opB == 0)
+            if (predict_select_varargs(fs, static_cast<BCPos>(bcOrd)))
+            {
+                bw.CreateCallSelectVarArgs({
+                    .base = Local { bc_a(ins) }
+                });
+            }
+            else if (opB == 0)
             {
                 bw.CreateCallMR({
                     .base = Local { bc_a(ins) },
@@ -2674,8 +2726,17 @@ static void fs_fixup_bc(FuncState *fs, UnlinkedCodeBlock* ucb, BytecodeBuilder&
             // Create the structure now, so we can call GetInitialStructureForSteppingKnowingAlreadyBuilt at runtime
             //
             std::ignore = Structure::GetInitialStructureForStepping(vm, stepping);
+            TableAllocationSiteProfile* profile = TableAllocationSiteProfile::Create(vm, stepping, static_cast<uint16_t>(arrayPartHint));
+            TValue tvProfile;
+            tvProfile.m_value = reinterpret_cast<uint64_t>(profile);
+            if (fs->ls->vmStateRecord != nullptr)
+            {
+                fs->ls->vmStateRecord->m_tableNewSteppings.push_back(stepping);
+                fs->ls->vmStateRecord->m_tableNewProfiles.push_back(tvProfile);
+            }
 
             bw.CreateTableNew({
+                .allocationSiteProfile = tvProfile,
                 .inlineStorageSizeStepping = stepping,
                 .arrayPartSizeHint = static_cast<uint16_t>(arrayPartHint),
                 .output = Local { bc_a(ins) }
@@ -3198,6 +3259,7 @@ static UnlinkedCodeBlock* fs_finish(LexState *ls, BCLine /*line*/)
     ucb->m_numFixedArguments = fs->numparams;
     ucb->m_hasVariadicArguments = (fs->flags & PROTO_VARARG) > 0;
     ucb->m_stackFrameNumSlots = fs->framesize;
+    ucb->m_lineDefined = static_cast<uint32_t>(fs->linedefined);
     ucb->m_bytecodeBuilder = new BytecodeBuilder();
     fs_fixup_bc(fs, ucb, *ucb->m_bytecodeBuilder, fs->pc);
 
@@ -3313,6 +3375,87 @@ static void expr_kvalue(FuncState * /*fs*/, TValue *v, ExpDesc *e)
     }
 }
 
+// Create the template table used by TDUP, and insert all the key-value pairs described by the recipe
+// This is also used to re-create the template table when a cached parsed module is linked into another VM
+//
+HeapPtr<TableObject> WARN_UNUSED CreateTableDupTemplateTable(VM* vm, const TableDupTemplateRecipe& recipe)
+{
+    // debug knob to dump info about the template table
+    //
+    constexpr bool x_debug_dump_table_info = false;
+
+    // TODO: we need to anchor this table
+    //
+    HeapPtr<TableObject> tab = TableObject::CreateEmptyTableObject(vm, recipe.m_numPropertyPartKeys /*inlineCapacity*/, recipe.m_initButterflyArrayPartCapacity);
+
+    if (x_debug_dump_table_info)
+    {
+        fprintf(stderr, "TDUP: inline capacity hint = %u, array part hint = %u\n",
+                static_cast<unsigned int>(recipe.m_numPropertyPartKeys), static_cast<unsigned int>(recipe.m_initButterflyArrayPartCapacity));
+    }
+    for (const auto& it : recipe.m_propertyPartKVs)
+    {
+        TValue key = it.first;
+        TValue value = it.second;
+        Assert(!key.Is<tInt32>());
+        if (key.Is<tNil>()) { continue; }
+        if (value.m_value == TValue::CreateImpossibleValue().m_value)
+        {
+            value = TValue::Create<tNil>();
+        }
+        if (x_debug_dump_table_info)
+        {
+            fprintf(stderr, "TDUP table KV: key = ");
+            PrintTValue(stderr, key);
+            fprintf(stderr, ", value = ");
+            PrintTValue(stderr, value);
+            fprintf(stderr, "\n");
+        }
+        if (key.Is<tDouble>())
+        {
+            double indexDouble = key.As<tDouble>();
+            Assert(!IsNaN(indexDouble));
+            TableObject::RawPutByValDoubleIndex(tab, indexDouble, value);
+        }
+        else if (key.Is<tHeapEntity>())
+        {
+            PutByIdICInfo icInfo;
+            TableObject::PreparePutById(tab, UserHeapPointer<void> { key.As<tHeapEntity>() }, icInfo /*out*/);
+            TableObject::PutById(tab, key.As<tHeapEntity>(), value, icInfo);
+        }
+        else
+        {
+            Assert(key.Is<tBool>());
+            UserHeapPointer<HeapString> specialKey = VM_GetSpecialKeyForBoolean(key.As<tBool>());
+            PutByIdICInfo icInfo;
+            TableObject::PreparePutById(tab, specialKey, icInfo /*out*/);
+            TableObject::PutById(tab, specialKey.As<void>(), value, icInfo);
+        }
+    }
+
+    // Put all the integer key-values in ascending order (the recipe has them sorted), to get a continuous array if possible
+    //
+    if (recipe.m_arrayPartKVs.size() > 0)
+    {
+        Assert(std::is_sorted(recipe.m_arrayPartKVs.begin(), recipe.m_arrayPartKVs.end()));
+        for (const auto& it : recipe.m_arrayPartKVs)
+        {
+            int32_t key = it.first;
+            TValue value; value.m_value = it.second;
+            Assert(value.m_value != TValue::CreateImpossibleValue().m_value);
+            if (x_debug_dump_table_info)
+            {
+                fprintf(stderr, "TDUP table KV (array part): key = %d, value = ", static_cast<int>(key));
+                PrintTValue(stderr, value);
+                fprintf(stderr, "\n");
+            }
+            TableObject::RawPutByValIntegerIndex(tab, key, value);
+        }
+    }
+
+    return tab;
+}
+
 /* Parse table constructor expression. */
 static void expr_table(LexState *ls, ExpDesc *e)
 {
@@ -3430,76 +3573,25 @@ nonconst:
             }
         }
 
-        // Create the table, and insert all key-value pairs
-        //
-        VM* vm = VM::GetActiveVMForCurrentThread();
-        // TODO: we need to anchor this table
+        // Put all the integer key-values in ascending order, to get a continuous array if possible
         //
-        HeapPtr<TableObject> tab = TableObject::CreateEmptyTableObject(vm, numPropertyPartKeys /*inlineCapacity*/, initButterflyArrayPartCapacity);
+        std::sort(tplTableArrayPartKVs.begin(), tplTableArrayPartKVs.end());
 
-        if (x_debug_dump_table_info)
-        {
-            fprintf(stderr, "TDUP: inline capacity hint = %u, array part hint = %u\n",
-                    static_cast<unsigned int>(numPropertyPartKeys), static_cast<unsigned int>(initButterflyArrayPartCapacity));
-        }
-        for (auto& it: tplTableKVs)
-        {
-            TValue key = it.first;
-            TValue value = it.second;
-            Assert(!key.Is<tInt32>());
-            if (key.Is<tNil>()) { continue; }
-            if (value.m_value == TValue::CreateImpossibleValue().m_value)
-            {
-                value = TValue::Create<tNil>();
-            }
-            if (x_debug_dump_table_info)
-            {
-                fprintf(stderr, "TDUP table KV: key = ");
-                PrintTValue(stderr, key);
-                fprintf(stderr, ", value = ");
-                PrintTValue(stderr, value);
-                fprintf(stderr, "\n");
-            }
-            if (key.Is<tDouble>())
-            {
-                double indexDouble = key.As<tDouble>();
-                Assert(!IsNaN(indexDouble));
-                TableObject::RawPutByValDoubleIndex(tab, indexDouble, value);
-            }
-            else if (key.Is<tHeapEntity>())
-            {
-                PutByIdICInfo icInfo;
-                TableObject::PreparePutById(tab, UserHeapPointer<void> { key.As<tHeapEntity>() }, icInfo /*out*/);
-                TableObject::PutById(tab, key.As<tHeapEntity>(), value, icInfo);
-            }
-            else
-            {
-                Assert(key.Is<tBool>());
-                UserHeapPointer<HeapString> specialKey = VM_GetSpecialKeyForBoolean(key.As<tBool>());
-                PutByIdICInfo icInfo;
-                TableObject::PreparePutById(tab, specialKey, icInfo /*out*/);
-                TableObject::PutById(tab, specialKey.As<void>(), value, icInfo);
-            }
-        }
+        TableDupTemplateRecipe recipe {
+            .m_numPropertyPartKeys = numPropertyPartKeys,
+            .m_initButterflyArrayPartCapacity = initButterflyArrayPartCapacity,
+            .m_propertyPartKVs = std::move(tplTableKVs),
+            .m_arrayPartKVs = std::move(tplTableArrayPartKVs)
+        };
 
-        // Put all the integer key-values in ascending order, to get a continuous array if possible
+        VM* vm = VM::GetActiveVMForCurrentThread();
+        HeapPtr<TableObject> tab = CreateTableDupTemplateTable(vm, recipe);
+
+        // Record the recipe if requested, so the template table can be re-created in another VM
         //
-        if (tplTableArrayPartKVs.size() > 0)
+        if (ls->vmStateRecord != nullptr)
         {
-            std::sort(tplTableArrayPartKVs.begin(), tplTableArrayPartKVs.end());
-            for (auto& it : tplTableArrayPartKVs)
-            {
-                int32_t key = it.first;
-                TValue value; value.m_value = it.second;
-                Assert(value.m_value != TValue::CreateImpossibleValue().m_value);
-                if (x_debug_dump_table_info)
-                {
-                    fprintf(stderr, "TDUP table KV (array part): key = %d, value = ", static_cast<int>(key));
-                    PrintTValue(stderr, value);
-                    fprintf(stderr, "\n");
-                }
-                TableObject::RawPutByValIntegerIndex(tab, key, value);
-            }
+            ls->vmStateRecord->m_tableDupTemplates.push_back(std::make_pair(TValue::Create<tTable>(tab), std::move(recipe)));
         }
 
         fs->bcbase[pc].inst = BCINS_AD(BC_TDUP, freg-1, TValue::Create<tTable>(tab));
@@ -26,3 +26,37 @@ ParseResult WARN_UNUSED ParseLuaScript(CoroutineRuntimeContext* ctx, HeapPtr<Tab
 
 ParseResult WARN_UNUSED ParseLuaScriptFromFile(CoroutineRuntimeContext* ctx, const char* fileName);
 
+// Describes how the parser built a template table for TDUP
+// The property part KVs may contain nil keys (which are skipped), the array part KVs must be sorted by key
+//
+struct TableDupTemplateRecipe
+{
+    uint32_t m_numPropertyPartKeys;
+    uint32_t m_initButterflyArrayPartCapacity;
+    std::vector<std::pair<TValue, TValue>> m_propertyPartKVs;
+    std::vector<std::pair<int32_t, uint64_t /*tv*/>> m_arrayPartKVs;
+};
+
+HeapPtr<TableObject> WARN_UNUSED CreateTableDupTemplateTable(VM* vm, const TableDupTemplateRecipe& recipe);
+
+// The VM-specific state that the parser created as a side effect (other than the UnlinkedCodeBlocks and their constants)
+// Only recorded when requested, so that a parsed module can be re-linked into another VM (see parsed_module_cache.h)
+//
+struct ParserVmStateRecord
+{
+    // Each template table created for TDUP, and the recipe to re-create it
+    //
+    std::vector<std::pair<TValue /*table*/, TableDupTemplateRecipe>> m_tableDupTemplates;
+    // The initial structure steppings that TNEW expects to be already built
+    //
+    std::vector<uint8_t> m_tableNewSteppings;
+    // The TableAllocationSiteProfile created for each TNEW (a pointer disguised as TValue), which is re-created fresh in every VM
+    //
+    std::vector<TValue> m_tableNewProfiles;
+};
+
+// Create a ScriptModule from the UnlinkedCodeBlocks of a freshly parsed (or linked) chunk
+// The UnlinkedCodeBlocks must be in topological order (i.e., the chunk function must be the last one)
+//
+std::unique_ptr<ScriptModule> WARN_UNUSED CreateScriptModuleFromUnlinkedCodeBlocks(CoroutineRuntimeContext* ctx, std::vector<UnlinkedCodeBlock*>&& ucbList);
+
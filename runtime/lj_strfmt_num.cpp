@@ -32,6 +32,7 @@
 
 #include "lj_strfmt_num.h"
 #include "lj_strfmt_details.h"
+#include "misc_math_helper.h"
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wold-style-cast"
@@ -82,7 +83,7 @@ static const int8_t four_ulp_m_e[] = {
 };
 
 /* min(2^32-1, 10^e-1) for e in range 0 through 10 */
-static uint32_t ndigits_dec_threshold[] = {
+static const uint32_t ndigits_dec_threshold[] = {
     0, 9U, 99U, 999U, 9999U, 99999U, 999999U,
     9999999U, 99999999U, 999999999U, 0xffffffffU
 };
@@ -645,9 +646,132 @@ g_format_like_f:
 
 /* -- Conversions to strings ---------------------------------------------- */
 
+// Fast path for non-integer doubles that '%.14g' prints in fixed notation, that is, whose decimal exponent X
+// (after rounding to 14 significant digits) satisfies -4 <= X < 14. Returns nullptr if the slow path must be taken.
+//
+// We scale |d| by an exact power of 10 into [1e13, 1e14) and round it to an integer to get the 14 significant digits.
+// The product is computed in long double (64-bit mantissa, which represents every 10^k for k <= 27 exactly), so it
+// incurs a single rounding error of at most 2^-18 since the product is below 2^47. Therefore the rounding direction
+// is exact unless the fractional part is very close to 0.5 (this includes the exact ties, which '%.14g' breaks by
+// the exact binary value), and only those ambiguous cases fall back to the slow path.
+//
+static char* TryStringifyNonIntegerDoubleInFixedNotation(char* buf /*out*/, double d)
+{
+    static_assert(std::numeric_limits<long double>::digits >= 64);
+    static constexpr long double x_pow10[19] = {
+        1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L,
+        1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L
+    };
+
+    double a = std::fabs(d);
+    if (!(a >= 1e-5 && a < 1e14))
+    {
+        return nullptr;
+    }
+
+    // log10 may be off by one near powers of 10, so fix up the exponent by checking the range of the scaled value.
+    // X = -5 is allowed here since the value may round up to 1e-4.
+    //
+    int x = static_cast<int>(std::floor(std::log10(a)));
+    long double m;
+    while (true)
+    {
+        if (x < -5 || x > 13)
+        {
+            return nullptr;
+        }
+        m = static_cast<long double>(a) * x_pow10[13 - x];
+        if (m < 1e13L) { x--; continue; }
+        if (m >= 1e14L) { x++; continue; }
+        break;
+    }
+
+    long double intPart = floorl(m);
+    long double frac = m - intPart;
+    if (fabsl(frac - 0.5L) < 1e-5L)
+    {
+        return nullptr;
+    }
+    uint64_t r = static_cast<uint64_t>(intPart) + (frac > 0.5L ? 1 : 0);
+    if (r == 100000000000000ULL)
+    {
+        r = 10000000000000ULL;
+        x++;
+    }
+    if (x < -4 || x > 13)
+    {
+        return nullptr;
+    }
+
+    // r is in [1e13, 1e14), so the part above the low 9 digits is exactly 5 digits
+    //
+    char digits[16];
+    lj_strfmt_wint(digits, static_cast<int32_t>(r / 1000000000));
+    lj_strfmt_wuint9(digits + 5, static_cast<uint32_t>(r % 1000000000));
+    int numDigits = 14;
+    while (digits[numDigits - 1] == '0') { numDigits--; }
+
+    char* p = buf;
+    if (d < 0) { *p++ = '-'; }
+    if (x >= 0)
+    {
+        int numIntDigits = x + 1;
+        memcpy(p, digits, static_cast<size_t>(numIntDigits));
+        p += numIntDigits;
+        if (numDigits > numIntDigits)
+        {
+            *p++ = '.';
+            memcpy(p, digits + numIntDigits, static_cast<size_t>(numDigits - numIntDigits));
+            p += numDigits - numIntDigits;
+        }
+    }
+    else
+    {
+        *p++ = '0';
+        *p++ = '.';
+        for (int i = 0; i < -x - 1; i++) { *p++ = '0'; }
+        memcpy(p, digits, static_cast<size_t>(numDigits));
+        p += numDigits;
+    }
+    return p;
+}
+
+
 char* StringifyDoubleUsingDefaultLuaFormattingOptions(char* buf /*out*/, double d)
 {
-    char* res = lj_strfmt_wfnum(NULL, STRFMT_G14, d, buf);
+    // Fast path for integer-valued doubles of at most 14 digits, which '%.14g' prints exactly as the integer.
+    // Note that -0 must go to the slow path as it prints as "-0".
+    //
+    if (d > -1e14 && d < 1e14)
+    {
+        int64_t k = static_cast<int64_t>(d);
+        if (UnsafeFloatEqual(static_cast<double>(k), d) && (k != 0 || !std::signbit(d)))
+        {
+            char* res;
+            if (likely(IntegerCanBeRepresentedIn<int32_t>(k)))
+            {
+                res = lj_strfmt_wint(buf, static_cast<int32_t>(k));
+            }
+            else
+            {
+                // |k| < 10^14, so the part above the low 9 digits fits in int32_t
+                //
+                char* p = buf;
+                uint64_t u = static_cast<uint64_t>(k);
+                if (k < 0) { u = static_cast<uint64_t>(-k); *p++ = '-'; }
+                p = lj_strfmt_wint(p, static_cast<int32_t>(u / 1000000000));
+                res = lj_strfmt_wuint9(p, static_cast<uint32_t>(u % 1000000000));
+            }
+            *res = '\0';
+            return res;
+        }
+    }
+
+    char* res = TryStringifyNonIntegerDoubleInFixedNotation(buf, d);
+    if (res == nullptr)
+    {
+        res = lj_strfmt_wfnum(NULL, STRFMT_G14, d, buf);
+    }
     *res = '\0';
     return res;
 }
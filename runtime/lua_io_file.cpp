@@ -0,0 +1,613 @@
+#include "lua_io_file.h"
+#include "runtime_utils.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+LuaIoFile::LuaIoFile(FILE* fp, Kind kind)
+    : m_fp(fp)
+    , m_outputBuffer(nullptr)
+    , m_kind(kind)
+    , m_lastOp(LastOp::None)
+    , m_readFromDescriptor(kind != Kind::File)
+    , m_hasReadError(false)
+    , m_readBuffer(nullptr)
+    , m_readBegin(0)
+    , m_readEnd(0)
+{
+    Assert(m_fp != nullptr);
+}
+
+LuaIoFile::LuaIoFile(VMOutputBuffer* outputBuffer)
+    : LuaIoFile(outputBuffer->GetFilePointer(), Kind::StandardStream)
+{
+    m_outputBuffer = outputBuffer;
+}
+
+LuaIoFile::~LuaIoFile()
+{
+    if (m_fp != nullptr)
+    {
+        if (m_kind == Kind::StandardStream)
+        {
+            std::ignore = Flush();
+        }
+        else
+        {
+            std::ignore = Close();
+        }
+    }
+    delete [] m_readBuffer;
+}
+
+std::unique_ptr<LuaIoFile> WARN_UNUSED LuaIoFile::Open(const char* fileName, const char* mode)
+{
+    FILE* fp = fopen(fileName, mode);
+    if (fp == nullptr)
+    {
+        return nullptr;
+    }
+    std::unique_ptr<LuaIoFile> file(new LuaIoFile(fp, Kind::File));
+    std::ignore = file->SetVBuf(_IOFBF, x_writeBufferSize);
+    return file;
+}
+
+std::unique_ptr<LuaIoFile> WARN_UNUSED LuaIoFile::OpenPipe(const char* command, const char* mode)
+{
+    // Flush all pending output, so the output of the child process shows up after it
+    //
+    VM::GetActiveVMForCurrentThread()->FlushOutputBuffers();
+    fflush(nullptr);
+    FILE* fp = popen(command, mode);
+    if (fp == nullptr)
+    {
+        return nullptr;
+    }
+    return std::unique_ptr<LuaIoFile>(new LuaIoFile(fp, Kind::Pipe));
+}
+
+std::unique_ptr<LuaIoFile> WARN_UNUSED LuaIoFile::OpenTemporary()
+{
+    FILE* fp = tmpfile();
+    if (fp == nullptr)
+    {
+        return nullptr;
+    }
+    std::unique_ptr<LuaIoFile> file(new LuaIoFile(fp, Kind::File));
+    std::ignore = file->SetVBuf(_IOFBF, x_writeBufferSize);
+    return file;
+}
+
+int WARN_UNUSED LuaIoFile::Close()
+{
+    Assert(!IsClosed() && m_kind != Kind::StandardStream);
+    int err = 0;
+    if (m_kind == Kind::Pipe)
+    {
+        if (pclose(m_fp) == -1)
+        {
+            err = errno;
+        }
+    }
+    else
+    {
+        if (fclose(m_fp) != 0)
+        {
+            err = errno;
+        }
+    }
+    m_fp = nullptr;
+    m_writeBuffer.reset();
+    delete [] m_readBuffer;
+    m_readBuffer = nullptr;
+    m_readBegin = 0;
+    m_readEnd = 0;
+    return err;
+}
+
+void LuaIoFile::DiscardReadBuffer()
+{
+    m_readBegin = 0;
+    m_readEnd = 0;
+}
+
+void LuaIoFile::PrepareForRead()
+{
+    Assert(!IsClosed());
+    if (unlikely(m_readBuffer == nullptr))
+    {
+        m_readBuffer = new char[x_readBufferSize];
+        Assert(m_readBegin == 0 && m_readEnd == 0);
+    }
+    if (unlikely(m_lastOp == LastOp::Write))
+    {
+        fflush(m_fp);
+    }
+    m_lastOp = LastOp::Read;
+}
+
+void LuaIoFile::PrepareForWrite()
+{
+    Assert(!IsClosed());
+    if (unlikely(m_lastOp == LastOp::Read))
+    {
+        // Give back the bytes that are buffered but not consumed. Even if there is no such byte, the C standard still
+        // requires a positioning call when switching from reading to writing.
+        //
+        if (!m_readFromDescriptor)
+        {
+            std::ignore = fseeko(m_fp, -static_cast<off_t>(GetNumBufferedBytes()), SEEK_CUR);
+        }
+        DiscardReadBuffer();
+    }
+    m_lastOp = LastOp::Write;
+}
+
+size_t WARN_UNUSED LuaIoFile::ReadFromUnderlyingFile(char* dst, size_t len)
+{
+    if (m_readFromDescriptor)
+    {
+        if (m_kind == Kind::StandardStream)
+        {
+            // Same as a line-buffered stdout in C, make sure a prompt written without a newline is visible before we block
+            //
+            std::ignore = VM::GetActiveVMForCurrentThread()->GetStdoutBuffer().Flush();
+        }
+        while (true)
+        {
+            ssize_t res = read(fileno(m_fp), dst, len);
+            if (likely(res >= 0))
+            {
+                return static_cast<size_t>(res);
+            }
+            if (errno != EINTR)
+            {
+                m_hasReadError = true;
+                return 0;
+            }
+        }
+    }
+    else
+    {
+        size_t res = fread_unlocked(dst, 1, len, m_fp);
+        if (res < len && ferror(m_fp))
+        {
+            m_hasReadError = true;
+            clearerr(m_fp);
+        }
+        return res;
+    }
+}
+
+bool WARN_UNUSED LuaIoFile::FillReadBuffer()
+{
+    Assert(m_readBuffer != nullptr);
+    if (m_readBegin > 0)
+    {
+        size_t numBuffered = GetNumBufferedBytes();
+        memmove(m_readBuffer, m_readBuffer + m_readBegin, numBuffered);
+        m_readBegin = 0;
+        m_readEnd = numBuffered;
+    }
+    Assert(m_readEnd < x_readBufferSize);
+    size_t numRead = ReadFromUnderlyingFile(m_readBuffer + m_readEnd, x_readBufferSize - m_readEnd);
+    m_readEnd += numRead;
+    return numRead > 0;
+}
+
+bool WARN_UNUSED LuaIoFile::CheckAndClearReadError()
+{
+    bool result = m_hasReadError;
+    m_hasReadError = false;
+    return result;
+}
+
+// Returns a pointer to the first '\n' in [p, pe), or 'pe' if not found
+// 16 bytes are checked at a time using SSE, and the tail shorter than 16 bytes takes the scalar path.
+//
+static const char* WARN_UNUSED FindNewline(const char* p, const char* pe)
+{
+    __m128i newline = _mm_set1_epi8('\n');
+    while (pe - p >= 16)
+    {
+        __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(input, newline)));
+        if (mask != 0)
+        {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+    while (p < pe && *p != '\n')
+    {
+        p++;
+    }
+    return p;
+}
+
+UserHeapPointer<HeapString> WARN_UNUSED LuaIoFile::ReadLine(VM* vm, bool keepNewline)
+{
+    PrepareForRead();
+
+    // The buffered bytes before 'searchFrom' are known to not contain a newline
+    //
+    size_t searchFrom = m_readBegin;
+    while (true)
+    {
+        const char* nl = FindNewline(m_readBuffer + searchFrom, m_readBuffer + m_readEnd);
+        if (likely(nl < m_readBuffer + m_readEnd))
+        {
+            const char* lineBegin = m_readBuffer + m_readBegin;
+            size_t len = static_cast<size_t>(nl - lineBegin);
+            m_readBegin += len + 1;
+            return vm->CreateStringObjectFromRawString(lineBegin, static_cast<uint32_t>(len + (keepNewline ? 1 : 0)));
+        }
+
+        size_t numScanned = GetNumBufferedBytes();
+        if (unlikely(numScanned == x_readBufferSize))
+        {
+            return ReadLongLineSlowPath(vm, keepNewline);
+        }
+
+        if (!FillReadBuffer())
+        {
+            // The last line of the file does not end with a newline
+            //
+            if (numScanned == 0)
+            {
+                return UserHeapPointer<HeapString>();
+            }
+            UserHeapPointer<HeapString> result = vm->CreateStringObjectFromRawString(m_readBuffer + m_readBegin, static_cast<uint32_t>(numScanned));
+            DiscardReadBuffer();
+            return result;
+        }
+        searchFrom = m_readBegin + numScanned;
+    }
+}
+
+UserHeapPointer<HeapString> WARN_UNUSED NO_INLINE LuaIoFile::ReadLongLineSlowPath(VM* vm, bool keepNewline)
+{
+    Assert(GetNumBufferedBytes() == x_readBufferSize);
+    std::string line(m_readBuffer + m_readBegin, GetNumBufferedBytes());
+    DiscardReadBuffer();
+    while (FillReadBuffer())
+    {
+        const char* nl = FindNewline(m_readBuffer, m_readBuffer + m_readEnd);
+        if (nl < m_readBuffer + m_readEnd)
+        {
+            size_t len = static_cast<size_t>(nl - m_readBuffer);
+            line.append(m_readBuffer, len + (keepNewline ? 1 : 0));
+            m_readBegin = len + 1;
+            break;
+        }
+        line.append(m_readBuffer, m_readEnd);
+        DiscardReadBuffer();
+    }
+    return vm->CreateStringObjectFromRawString(line.data(), SafeIntegerCast<uint32_t>(line.length()));
+}
+
+UserHeapPointer<HeapString> WARN_UNUSED LuaIoFile::ReadAll(VM* vm)
+{
+    PrepareForRead();
+
+    // For regular files, we know how many bytes are left, so we can read them directly into the string object
+    //
+    if (!m_readFromDescriptor)
+    {
+        struct stat st;
+        off_t pos = ftello(m_fp);
+        if (fstat(fileno(m_fp), &st) == 0 && S_ISREG(st.st_mode) && pos >= 0 && st.st_size >= pos)
+        {
+            size_t numBuffered = GetNumBufferedBytes();
+            size_t expectedLen = static_cast<size_t>(st.st_size - pos) + numBuffered;
+            HeapString* s = vm->AllocateStringObjectForPrefill(expectedLen);
+            memcpy(s->m_string, m_readBuffer + m_readBegin, numBuffered);
+            DiscardReadBuffer();
+            size_t len = numBuffered + ReadFromUnderlyingFile(reinterpret_cast<char*>(s->m_string) + numBuffered, expectedLen - numBuffered);
+            if (likely(len < expectedLen || !FillReadBuffer()))
+            {
+                return vm->InternPrefilledStringObject(s, len);
+            }
+
+            // The file has grown since we checked its size, read the rest in the slow way
+            //
+            std::string rest;
+            do
+            {
+                rest.append(m_readBuffer, m_readEnd);
+                DiscardReadBuffer();
+            }
+            while (FillReadBuffer());
+            std::pair<const void*, size_t> pieces[2] = {
+                std::make_pair(s->m_string, len),
+                std::make_pair(rest.data(), rest.length())
+            };
+            return vm->CreateStringObjectFromConcatenation(pieces, 2);
+        }
+    }
+
+    std::string data(m_readBuffer + m_readBegin, GetNumBufferedBytes());
+    DiscardReadBuffer();
+    while (FillReadBuffer())
+    {
+        data.append(m_readBuffer, m_readEnd);
+        DiscardReadBuffer();
+    }
+    return vm->CreateStringObjectFromRawString(data.data(), SafeIntegerCast<uint32_t>(data.length()));
+}
+
+UserHeapPointer<HeapString> WARN_UNUSED LuaIoFile::ReadBytes(VM* vm, size_t n)
+{
+    PrepareForRead();
+
+    if (n == 0)
+    {
+        if (GetNumBufferedBytes() == 0 && !FillReadBuffer())
+        {
+            return UserHeapPointer<HeapString>();
+        }
+        return vm->m_emptyString;
+    }
+
+    if (n <= x_readBufferSize)
+    {
+        while (GetNumBufferedBytes() < n)
+        {
+            if (!FillReadBuffer())
+            {
+                break;
+            }
+        }
+        size_t len = std::min(n, GetNumBufferedBytes());
+        if (len == 0)
+        {
+            return UserHeapPointer<HeapString>();
+        }
+        UserHeapPointer<HeapString> result = vm->CreateStringObjectFromRawString(m_readBuffer + m_readBegin, static_cast<uint32_t>(len));
+        m_readBegin += len;
+        return result;
+    }
+
+    // A large read, read directly into the string object
+    //
+    HeapString* s = vm->AllocateStringObjectForPrefill(n);
+    size_t len = GetNumBufferedBytes();
+    memcpy(s->m_string, m_readBuffer + m_readBegin, len);
+    DiscardReadBuffer();
+    while (len < n)
+    {
+        size_t numRead = ReadFromUnderlyingFile(reinterpret_cast<char*>(s->m_string) + len, n - len);
+        if (numRead == 0)
+        {
+            break;
+        }
+        len += numRead;
+    }
+    if (len == 0)
+    {
+        return UserHeapPointer<HeapString>();
+    }
+    return vm->InternPrefilledStringObject(s, len);
+}
+
+bool WARN_UNUSED LuaIoFile::ReadNumber(double& result /*out*/)
+{
+    PrepareForRead();
+
+    // Returns the next byte without consuming it, or -1 on EOF
+    //
+    auto peek = [&]() -> int
+    {
+        if (unlikely(m_readBegin == m_readEnd))
+        {
+            if (!FillReadBuffer())
+            {
+                return -1;
+            }
+        }
+        return static_cast<uint8_t>(m_readBuffer[m_readBegin]);
+    };
+
+    while (true)
+    {
+        int c = peek();
+        if (c == -1)
+        {
+            return false;
+        }
+        if (c != ' ' && (c < '\t' || c > '\r'))
+        {
+            break;
+        }
+        m_readBegin++;
+    }
+
+    // Same as Lua 5.2: only consume the longest prefix that may form a number, so the rest of the input is left untouched
+    //
+    constexpr size_t x_maxNumberLength = 200;
+    char buf[x_maxNumberLength + 1];
+    size_t len = 0;
+
+    auto accept = [&](const char* set) -> bool
+    {
+        int c = peek();
+        if (c == -1 || c == 0 || strchr(set, c) == nullptr || len >= x_maxNumberLength)
+        {
+            return false;
+        }
+        buf[len++] = static_cast<char>(c);
+        m_readBegin++;
+        return true;
+    };
+
+    auto acceptDigits = [&](bool isHex) -> size_t
+    {
+        size_t count = 0;
+        while (accept(isHex ? "0123456789abcdefABCDEF" : "0123456789"))
+        {
+            count++;
+        }
+        return count;
+    };
+
+    std::ignore = accept("+-");
+    bool isHex = false;
+    size_t numDigits = 0;
+    if (accept("0"))
+    {
+        if (accept("xX"))
+        {
+            isHex = true;
+        }
+        else
+        {
+            numDigits = 1;
+        }
+    }
+    numDigits += acceptDigits(isHex);
+    if (accept("."))
+    {
+        numDigits += acceptDigits(isHex);
+    }
+    if (numDigits > 0 && accept(isHex ? "pP" : "eE"))
+    {
+        std::ignore = accept("+-");
+        std::ignore = acceptDigits(false /*isHex*/);
+    }
+    buf[len] = '\0';
+
+    StrScanResult ssr = TryConvertStringToDoubleWithLuaSemantics(buf, len);
+    if (ssr.fmt != StrScanFmt::STRSCAN_NUM)
+    {
+        return false;
+    }
+    result = ssr.d;
+    return true;
+}
+
+bool WARN_UNUSED LuaIoFile::Write(const void* data, size_t len)
+{
+    if (m_outputBuffer != nullptr)
+    {
+        m_outputBuffer->Append(data, len);
+        return !m_outputBuffer->CheckAndClearWriteError();
+    }
+    PrepareForWrite();
+    return fwrite_unlocked(data, 1, len, m_fp) == len;
+}
+
+bool WARN_UNUSED LuaIoFile::Flush()
+{
+    Assert(!IsClosed());
+    if (m_outputBuffer != nullptr)
+    {
+        return m_outputBuffer->Flush();
+    }
+    if (m_lastOp == LastOp::Read)
+    {
+        return true;
+    }
+    return fflush_unlocked(m_fp) == 0;
+}
+
+int64_t WARN_UNUSED LuaIoFile::Seek(int whence, int64_t offset)
+{
+    Assert(!IsClosed());
+    if (m_outputBuffer != nullptr && !m_outputBuffer->Flush())
+    {
+        return -1;
+    }
+    size_t numBuffered = (m_lastOp == LastOp::Read) ? GetNumBufferedBytes() : 0;
+    if (whence == SEEK_CUR)
+    {
+        offset -= static_cast<int64_t>(numBuffered);
+    }
+
+    int64_t result;
+    if (m_lastOp == LastOp::Read && m_readFromDescriptor)
+    {
+        result = lseek(fileno(m_fp), offset, whence);
+    }
+    else
+    {
+        if (fseeko(m_fp, offset, whence) != 0)
+        {
+            return -1;
+        }
+        result = ftello(m_fp);
+    }
+
+    if (result >= 0)
+    {
+        DiscardReadBuffer();
+        m_lastOp = LastOp::None;
+    }
+    return result;
+}
+
+bool WARN_UNUSED LuaIoFile::SetVBuf(int mode, size_t size)
+{
+    Assert(!IsClosed());
+    if (m_outputBuffer != nullptr)
+    {
+        // The FILE is only written when the VM output buffer is flushed, so only the mode matters
+        //
+        m_outputBuffer->SetFullyBuffered(mode == _IOFBF);
+        return m_outputBuffer->Flush();
+    }
+    if (m_lastOp == LastOp::Write)
+    {
+        fflush(m_fp);
+    }
+
+    if (mode == _IONBF)
+    {
+        if (setvbuf(m_fp, nullptr, _IONBF, 0) != 0)
+        {
+            return false;
+        }
+        m_writeBuffer.reset();
+        return true;
+    }
+
+    // The old buffer may still be in use by the FILE if setvbuf fails, so only release it on success
+    //
+    size = std::max(size, static_cast<size_t>(BUFSIZ));
+    std::unique_ptr<char[]> buf(new char[size]);
+    if (setvbuf(m_fp, buf.get(), mode, size) != 0)
+    {
+        return false;
+    }
+    m_writeBuffer = std::move(buf);
+    return true;
+}
+
+LuaIoLibState::LuaIoLibState(VM* vm, UserHeapPointer<TableObject> fileMetatable)
+    : m_fileMetatable(fileMetatable)
+{
+    std::unique_ptr<LuaIoFile> stdinFile(new LuaIoFile(stdin, LuaIoFile::Kind::StandardStream));
+    std::unique_ptr<LuaIoFile> stdoutFile(new LuaIoFile(&vm->GetStdoutBuffer()));
+    std::unique_ptr<LuaIoFile> stderrFile(new LuaIoFile(&vm->GetStderrBuffer()));
+    m_stdin = stdinFile.get();
+    m_stdout = stdoutFile.get();
+    m_stderr = stderrFile.get();
+    m_stdinHandle = CreateHandle(vm, std::move(stdinFile));
+    m_stdoutHandle = CreateHandle(vm, std::move(stdoutFile));
+    m_stderrHandle = CreateHandle(vm, std::move(stderrFile));
+    m_defaultInput = m_stdinHandle;
+    m_defaultOutput = m_stdoutHandle;
+}
+
+LuaIoLibState::~LuaIoLibState()
+{
+    // The destructor of each LuaIoFile flushes and closes the file
+    //
+    m_files.clear();
+}
+
+TValue WARN_UNUSED LuaIoLibState::CreateHandle(VM* vm, std::unique_ptr<LuaIoFile> file)
+{
+    HeapPtr<HeapCDataObject> handle = HeapCDataObject::CreateNative<LuaIoFile*>(vm, m_fileMetatable.As(), file.get());
+    m_files.push_back(std::move(file));
+    return TValue::Create<tUserdata>(handle);
+}
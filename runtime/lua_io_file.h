@@ -0,0 +1,199 @@
+#pragma once
+
+#include "common_utils.h"
+#include "memory_ptr.h"
+#include "tvalue.h"
+#include "vm_output_buffer.h"
+#include "userdata_object.h"
+
+class VM;
+class HeapString;
+class TableObject;
+
+// A buffered file handle of the Lua io library
+//
+// Reads go through a large buffer owned by the handle, so line splitting and number scanning work directly on the buffered
+// bytes (newlines are searched 16 bytes at a time), and each line is turned into a string object with a single copy.
+// Writes to files go through the stdio buffer of the underlying FILE, which is enlarged for the files opened by the io library.
+// Since a FILE is only ever used by the thread running its VM, the unlocked stdio functions are used.
+// Writes to stdout and stderr go through the VM output buffer instead, which is shared with 'print'.
+//
+// A file opened in update mode may switch between reading and writing. Before writing, the unconsumed part of the read buffer
+// is given back by seeking backwards, and before reading, pending writes are flushed, as the C standard requires for FILEs.
+//
+class LuaIoFile
+{
+    MAKE_NONCOPYABLE(LuaIoFile);
+    MAKE_NONMOVABLE(LuaIoFile);
+
+public:
+    enum class Kind : uint8_t
+    {
+        // A file opened by io.open or io.tmpfile
+        //
+        File,
+        // A pipe opened by io.popen
+        //
+        Pipe,
+        // stdin, stdout or stderr, which can never be closed
+        //
+        StandardStream
+    };
+
+    static constexpr size_t x_readBufferSize = 65536;
+    static constexpr size_t x_writeBufferSize = 65536;
+
+    LuaIoFile(FILE* fp, Kind kind);
+
+    // Create io.stdout or io.stderr, whose writes go through 'outputBuffer'
+    //
+    explicit LuaIoFile(VMOutputBuffer* outputBuffer);
+    ~LuaIoFile();
+
+    // These functions return nullptr and set errno on failure
+    //
+    static std::unique_ptr<LuaIoFile> WARN_UNUSED Open(const char* fileName, const char* mode);
+    static std::unique_ptr<LuaIoFile> WARN_UNUSED OpenPipe(const char* command, const char* mode);
+    static std::unique_ptr<LuaIoFile> WARN_UNUSED OpenTemporary();
+
+    bool IsClosed() { return m_fp == nullptr; }
+    Kind GetKind() { return m_kind; }
+
+    // Returns nullptr if this is not io.stdout or io.stderr
+    //
+    VMOutputBuffer* GetOutputBuffer() { return m_outputBuffer; }
+
+    // Only used for stdout and stderr, which follow VM::RedirectStdout and VM::RedirectStderr
+    // The output buffer has been flushed to the old FILE at this point.
+    //
+    void SetFilePointer(FILE* fp)
+    {
+        Assert(m_kind == Kind::StandardStream && m_outputBuffer != nullptr);
+        Assert(m_outputBuffer->GetFilePointer() == fp);
+        m_fp = fp;
+    }
+
+    // Returns 0 on success, otherwise the errno
+    //
+    int WARN_UNUSED Close();
+
+    // Read a line, the trailing '\n' is kept only if 'keepNewline' is true
+    // Returns nullptr if the file is at EOF
+    //
+    UserHeapPointer<HeapString> WARN_UNUSED ReadLine(VM* vm, bool keepNewline);
+
+    // Read the rest of the file (which is an empty string if the file is at EOF)
+    //
+    UserHeapPointer<HeapString> WARN_UNUSED ReadAll(VM* vm);
+
+    // Read at most 'n' bytes. Returns nullptr if the file is at EOF.
+    // If 'n' is 0, returns an empty string unless the file is at EOF.
+    //
+    UserHeapPointer<HeapString> WARN_UNUSED ReadBytes(VM* vm, size_t n);
+
+    // Read a number in Lua syntax, skipping leading whitespaces
+    //
+    bool WARN_UNUSED ReadNumber(double& result /*out*/);
+
+    // Returns true if an error (as opposed to EOF) happened during the reads since the last call, and reset the error state
+    //
+    bool WARN_UNUSED CheckAndClearReadError();
+
+    bool WARN_UNUSED Write(const void* data, size_t len);
+    bool WARN_UNUSED Flush();
+
+    // Returns the new position from the beginning of the file, or -1 on failure
+    //
+    int64_t WARN_UNUSED Seek(int whence, int64_t offset);
+
+    bool WARN_UNUSED SetVBuf(int mode, size_t size);
+
+private:
+    enum class LastOp : uint8_t
+    {
+        None,
+        Read,
+        Write
+    };
+
+    void PrepareForRead();
+    void PrepareForWrite();
+    void DiscardReadBuffer();
+
+    // Move the unconsumed bytes to the beginning of the read buffer, and read more bytes from the file to fill the rest
+    // Returns false if no byte can be read (EOF or error)
+    //
+    bool WARN_UNUSED FillReadBuffer();
+
+    size_t WARN_UNUSED ReadFromUnderlyingFile(char* dst, size_t len);
+
+    size_t GetNumBufferedBytes() { return m_readEnd - m_readBegin; }
+
+    UserHeapPointer<HeapString> WARN_UNUSED NO_INLINE ReadLongLineSlowPath(VM* vm, bool keepNewline);
+
+    FILE* m_fp;
+    // The VM output buffer for io.stdout and io.stderr, nullptr otherwise
+    //
+    VMOutputBuffer* m_outputBuffer;
+    Kind m_kind;
+    LastOp m_lastOp;
+    // Whether the reads bypass stdio and use read(2) on the file descriptor
+    // Used for pipes and standard streams, so that we never block waiting for a full buffer when a line is already available
+    //
+    bool m_readFromDescriptor;
+    bool m_hasReadError;
+    char* m_readBuffer;
+    size_t m_readBegin;
+    size_t m_readEnd;
+    // The user-provided stdio buffer set by SetVBuf, if any, must outlive the FILE
+    //
+    std::unique_ptr<char[]> m_writeBuffer;
+};
+
+// The per-VM state of the Lua io library
+//
+// File handles are exposed to Lua as full userdata sharing one metatable, whose '__index' field is the table of file methods.
+// The payload of the userdata is a pointer to the native handle, which is owned by this class, since the userdata payload
+// is never destructed.
+//
+class LuaIoLibState
+{
+    MAKE_NONCOPYABLE(LuaIoLibState);
+    MAKE_NONMOVABLE(LuaIoLibState);
+
+public:
+    LuaIoLibState(VM* vm, UserHeapPointer<TableObject> fileMetatable);
+
+    // Flushes and closes all files that are still open, except the standard streams
+    //
+    ~LuaIoLibState();
+
+    // Create the Lua handle for 'file', returns the handle userdata
+    //
+    TValue WARN_UNUSED CreateHandle(VM* vm, std::unique_ptr<LuaIoFile> file);
+
+    // Returns nullptr if 'value' is not a file handle
+    //
+    LuaIoFile* WARN_UNUSED TryGetFile(TValue value)
+    {
+        LuaIoFile** file = HeapCDataObject::TryGetNative<LuaIoFile*>(value);
+        if (file == nullptr)
+        {
+            return nullptr;
+        }
+        return *file;
+    }
+
+    UserHeapPointer<TableObject> m_fileMetatable;
+    TValue m_stdinHandle;
+    TValue m_stdoutHandle;
+    TValue m_stderrHandle;
+    TValue m_defaultInput;
+    TValue m_defaultOutput;
+    LuaIoFile* m_stdin;
+    LuaIoFile* m_stdout;
+    LuaIoFile* m_stderr;
+
+private:
+    std::vector<std::unique_ptr<LuaIoFile>> m_files;
+};
@@ -0,0 +1,313 @@
+#include "runtime_utils.h"
+#include "lj_parser_wrapper.h"
+#include "deegen_enter_vm_from_c.h"
+
+// The library functions that are implemented in Lua
+//
+// A library function that calls a user-provided Lua function in a loop (e.g., table.sort with a comparator) is best implemented
+// in Lua: every call from a library function goes through a stack of in-place calls and continuations, which is opaque to the JIT,
+// while a call from Lua code goes through the call IC, so the baseline JIT calls the user function directly, and the DFG can
+// speculatively inline it into the loop.
+//
+// The chunk is run once when the VM is created. It must not use any global variable (the user may overwrite them), and it returns
+// the functions to be stored in the VM, which are not exposed to the user directly.
+//
+static const char x_luaImplementedLibFunctionsSource[] = R"LUASRC(
+-- table.sort with a user comparator: pattern-defeating quicksort (pdqsort) on t[1] .. t[n]
+--
+-- Returns false if the comparator is found to be inconsistent (in which case the native side throws 'invalid order function for
+-- sorting'), true otherwise.
+--
+local function insertionSort(t, lo, hi, lt)
+    for i = lo + 1, hi do
+        local v = t[i]
+        local j = i - 1
+        while j >= lo and lt(v, t[j]) do
+            t[j + 1] = t[j]
+            j = j - 1
+        end
+        t[j + 1] = v
+    end
+end
+
+-- Attempts to insertion sort t[lo] .. t[hi], but gives up if more than 8 elements are moved
+--
+local function partialInsertionSort(t, lo, hi, lt)
+    local numMoved = 0
+    for i = lo + 1, hi do
+        local v = t[i]
+        local j = i - 1
+        if lt(v, t[j]) then
+            repeat
+                t[j + 1] = t[j]
+                j = j - 1
+            until j < lo or not lt(v, t[j])
+            t[j + 1] = v
+            numMoved = numMoved + (i - j - 1)
+            if numMoved > 8 then
+                return false
+            end
+        end
+    end
+    return true
+end
+
+local function sort2(t, a, b, lt)
+    if lt(t[b], t[a]) then
+        t[a], t[b] = t[b], t[a]
+    end
+end
+
+local function sort3(t, a, b, c, lt)
+    sort2(t, a, b, lt)
+    sort2(t, b, c, lt)
+    sort2(t, a, b, lt)
+end
+
+local function siftDown(t, lo, root, size, lt)
+    local v = t[lo + root]
+    while true do
+        local child = 2 * root + 1
+        if child >= size then
+            break
+        end
+        if child + 1 < size and lt(t[lo + child], t[lo + child + 1]) then
+            child = child + 1
+        end
+        local c = t[lo + child]
+        if not lt(v, c) then
+            break
+        end
+        t[lo + root] = c
+        root = child
+    end
+    t[lo + root] = v
+end
+
+local function heapSort(t, lo, hi, lt)
+    local size = hi - lo + 1
+    local i = (size - size % 2) / 2 - 1
+    while i >= 0 do
+        siftDown(t, lo, i, size, lt)
+        i = i - 1
+    end
+    for last = size - 1, 1, -1 do
+        t[lo], t[lo + last] = t[lo + last], t[lo]
+        siftDown(t, lo, 0, last, lt)
+    end
+end
+
+-- Partitions t[lo] .. t[hi] around the pivot t[lo], elements equal to the pivot go to the right partition
+-- Returns the final position of the pivot and whether the range was already partitioned, or nil if the comparator is inconsistent
+--
+local function partitionRight(t, lo, hi, lt)
+    local pivot = t[lo]
+    local first = lo
+    repeat
+        first = first + 1
+    until first > hi or not lt(t[first], pivot)
+
+    local last = hi + 1
+    if first - 1 == lo then
+        while first < last do
+            last = last - 1
+            if lt(t[last], pivot) then
+                break
+            end
+        end
+    else
+        repeat
+            last = last - 1
+            if last <= lo then
+                return nil
+            end
+        until lt(t[last], pivot)
+    end
+
+    local alreadyPartitioned = first >= last
+    while first < last do
+        t[first], t[last] = t[last], t[first]
+        repeat
+            first = first + 1
+            if first > hi then
+                return nil
+            end
+        until not lt(t[first], pivot)
+        repeat
+            last = last - 1
+            if last <= lo then
+                return nil
+            end
+        until lt(t[last], pivot)
+    end
+
+    local pivotPos = first - 1
+    t[lo] = t[pivotPos]
+    t[pivotPos] = pivot
+    return pivotPos, alreadyPartitioned
+end
+
+-- Partitions t[lo] .. t[hi] around the pivot t[lo], elements equal to the pivot go to the left partition
+-- Only used when t[lo - 1] is equal to the pivot, so the left partition contains only elements equal to the pivot
+-- Returns the final position of the pivot, or nil if the comparator is inconsistent
+--
+local function partitionLeft(t, lo, hi, lt)
+    local pivot = t[lo]
+    local first = lo
+    local last = hi + 1
+    repeat
+        last = last - 1
+    until last <= lo or not lt(pivot, t[last])
+
+    if last == hi then
+        while first < last do
+            first = first + 1
+            if lt(pivot, t[first]) then
+                break
+            end
+        end
+    else
+        repeat
+            first = first + 1
+            if first > hi then
+                return nil
+            end
+        until lt(pivot, t[first])
+    end
+
+    while first < last do
+        t[first], t[last] = t[last], t[first]
+        repeat
+            last = last - 1
+            if last < lo then
+                return nil
+            end
+        until not lt(pivot, t[last])
+        repeat
+            first = first + 1
+            if first > hi then
+                return nil
+            end
+        until lt(pivot, t[first])
+    end
+
+    t[lo] = t[last]
+    t[last] = pivot
+    return last
+end
+
+local function pdqsortLoop(t, lo, hi, lt, badAllowed, leftmost)
+    while true do
+        local size = hi - lo + 1
+        if size <= 24 then
+            insertionSort(t, lo, hi, lt)
+            return true
+        end
+
+        -- Choose the pivot as the median of 3, or the pseudomedian of 9 for large ranges, and move it to t[lo]
+        --
+        local mid = lo + (size - size % 2) / 2
+        if size > 128 then
+            sort3(t, lo, mid, hi, lt)
+            sort3(t, lo + 1, mid - 1, hi - 1, lt)
+            sort3(t, lo + 2, mid + 1, hi - 2, lt)
+            sort3(t, mid - 1, mid, mid + 1, lt)
+            t[lo], t[mid] = t[mid], t[lo]
+        else
+            sort3(t, mid, lo, hi, lt)
+        end
+
+        -- If the element before the range is equal to the pivot, every element in the range is no less than the pivot,
+        -- so we put all elements equal to the pivot to the left, and they need no further sorting
+        --
+        if not leftmost and not lt(t[lo - 1], t[lo]) then
+            local pivotPos = partitionLeft(t, lo, hi, lt)
+            if pivotPos == nil then
+                return false
+            end
+            lo = pivotPos + 1
+        else
+            local pivotPos, alreadyPartitioned = partitionRight(t, lo, hi, lt)
+            if pivotPos == nil then
+                return false
+            end
+
+            local lsize = pivotPos - lo
+            local rsize = hi - pivotPos
+            if lsize < size / 8 or rsize < size / 8 then
+                -- Highly unbalanced partition: fall back to heapsort if this happened too many times,
+                -- otherwise shuffle some elements around to break the pattern
+                --
+                badAllowed = badAllowed - 1
+                if badAllowed == 0 then
+                    heapSort(t, lo, hi, lt)
+                    return true
+                end
+                if lsize >= 24 then
+                    local q = (lsize - lsize % 4) / 4
+                    t[lo], t[lo + q] = t[lo + q], t[lo]
+                    t[pivotPos - 1], t[pivotPos - q] = t[pivotPos - q], t[pivotPos - 1]
+                    if lsize > 128 then
+                        t[lo + 1], t[lo + q + 1] = t[lo + q + 1], t[lo + 1]
+                        t[lo + 2], t[lo + q + 2] = t[lo + q + 2], t[lo + 2]
+                        t[pivotPos - 2], t[pivotPos - q - 1] = t[pivotPos - q - 1], t[pivotPos - 2]
+                        t[pivotPos - 3], t[pivotPos - q - 2] = t[pivotPos - q - 2], t[pivotPos - 3]
+                    end
+                end
+                if rsize >= 24 then
+                    local q = (rsize - rsize % 4) / 4
+                    t[pivotPos + 1], t[pivotPos + 1 + q] = t[pivotPos + 1 + q], t[pivotPos + 1]
+                    t[hi], t[hi + 1 - q] = t[hi + 1 - q], t[hi]
+                    if rsize > 128 then
+                        t[pivotPos + 2], t[pivotPos + 2 + q] = t[pivotPos + 2 + q], t[pivotPos + 2]
+                        t[pivotPos + 3], t[pivotPos + 3 + q] = t[pivotPos + 3 + q], t[pivotPos + 3]
+                        t[hi - 1], t[hi - q] = t[hi - q], t[hi - 1]
+                        t[hi - 2], t[hi - 1 - q] = t[hi - 1 - q], t[hi - 2]
+                    end
+                end
+            elseif alreadyPartitioned then
+                -- The partition did not move anything, the range is likely already sorted
+                --
+                if partialInsertionSort(t, lo, pivotPos - 1, lt) and partialInsertionSort(t, pivotPos + 1, hi, lt) then
+                    return true
+                end
+            end
+
+            -- Recurse into the left partition, and loop on the right partition
+            --
+            if not pdqsortLoop(t, lo, pivotPos - 1, lt, badAllowed, leftmost) then
+                return false
+            end
+            lo = pivotPos + 1
+            leftmost = false
+        end
+    end
+end
+
+local function tableSortWithComparator(t, n, lt)
+    local badAllowed = 0
+    local s = n
+    while s > 1 do
+        s = (s - s % 2) / 2
+        badAllowed = badAllowed + 1
+    end
+    return pdqsortLoop(t, 1, n, lt, badAllowed, true)
+end
+
+return tableSortWithComparator
+)LUASRC";
+
+void VM::InitializeLuaImplementedLibFunctions()
+{
+    CoroutineRuntimeContext* rc = GetRootCoroutine();
+    HeapPtr<FunctionObject> entryPoint;
+    {
+        ParseResult res = ParseLuaScript(rc, x_luaImplementedLibFunctionsSource, sizeof(x_luaImplementedLibFunctionsSource) - 1);
+        ReleaseAssert(res.m_scriptModule.get() != nullptr);
+        entryPoint = res.m_scriptModule->m_defaultEntryPoint.As();
+    }
+
+    std::pair<TValue*, uint64_t> result = DeegenEnterVMFromC(rc, entryPoint, rc->m_stackBegin);
+    ReleaseAssert(result.second == 1 && result.first[0].Is<tFunction>());
+    InitializeLibFn<LibFn::TableSortWithComparator>(result.first[0]);
+}
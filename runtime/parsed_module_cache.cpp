@@ -0,0 +1,363 @@
+#include "parsed_module_cache.h"
+#include "lj_parser_wrapper.h"
+#include "hash_functions.h"
+#include "vm.h"
+#include "structure.h"
+
+std::unique_ptr<ParsedModuleImage> WARN_UNUSED ParsedModuleImage::Build(const char* source,
+                                                                       size_t sourceLength,
+                                                                       const std::vector<UnlinkedCodeBlock*>& ucbList,
+                                                                       const ParserVmStateRecord& vmStateRecord)
+{
+    std::unique_ptr<ParsedModuleImage> image(new ParsedModuleImage());
+    image->m_source.assign(source, sourceLength);
+    image->m_memoryUsage = sizeof(ParsedModuleImage);
+
+    std::unordered_map<UnlinkedCodeBlock*, uint32_t> ucbOrdMap;
+    for (uint32_t i = 0; i < ucbList.size(); i++)
+    {
+        ucbOrdMap[ucbList[i]] = i;
+    }
+
+    std::unordered_map<uint64_t /*tv*/, uint32_t> stringOrdMap;
+    std::unordered_map<uint64_t /*tv*/, const TableDupTemplateRecipe*> templateRecipeMap;
+    for (auto& it : vmStateRecord.m_tableDupTemplates)
+    {
+        templateRecipeMap[it.first.m_value] = &it.second;
+    }
+    std::unordered_map<uint64_t /*tv*/, uint32_t> templateOrdMap;
+    std::unordered_set<uint64_t /*tv*/> tableNewProfiles;
+    for (TValue tv : vmStateRecord.m_tableNewProfiles)
+    {
+        tableNewProfiles.insert(tv.m_value);
+    }
+
+    auto serializeString = [&](TValue tv) -> Constant
+    {
+        Assert(tv.Is<tString>());
+        auto iter = stringOrdMap.find(tv.m_value);
+        if (iter == stringOrdMap.end())
+        {
+            HeapString* s = TranslateToRawPointer(tv.As<tString>());
+            uint32_t ord = static_cast<uint32_t>(image->m_strings.size());
+            image->m_strings.push_back(std::string(reinterpret_cast<const char*>(s->m_string), s->m_length));
+            image->m_memoryUsage += sizeof(std::string) + s->m_length;
+            iter = stringOrdMap.insert(std::make_pair(tv.m_value, ord)).first;
+        }
+        return Constant { .m_kind = ConstantKind::String, .m_ord = iter->second, .m_rawValue = 0 };
+    };
+
+    // Serialize a constant that may be a key or value of a template table, returns false if not representable
+    //
+    auto serializeSimpleConstant = [&](TValue tv, Constant& result /*out*/) -> bool
+    {
+        if (tv.Is<tString>())
+        {
+            result = serializeString(tv);
+            return true;
+        }
+        if (tv.Is<tHeapEntity>())
+        {
+            return false;
+        }
+        result = Constant { .m_kind = ConstantKind::RawValue, .m_ord = 0, .m_rawValue = tv.m_value };
+        return true;
+    };
+
+    auto serializeTemplate = [&](TValue tv, Constant& result /*out*/) -> bool
+    {
+        auto iter = templateOrdMap.find(tv.m_value);
+        if (iter != templateOrdMap.end())
+        {
+            result = Constant { .m_kind = ConstantKind::TableDupTemplate, .m_ord = iter->second, .m_rawValue = 0 };
+            return true;
+        }
+        auto recipeIter = templateRecipeMap.find(tv.m_value);
+        if (recipeIter == templateRecipeMap.end())
+        {
+            return false;
+        }
+        const TableDupTemplateRecipe& recipe = *recipeIter->second;
+        TableDupTemplate tpl;
+        tpl.m_numPropertyPartKeys = recipe.m_numPropertyPartKeys;
+        tpl.m_initButterflyArrayPartCapacity = recipe.m_initButterflyArrayPartCapacity;
+        for (auto& kv : recipe.m_propertyPartKVs)
+        {
+            if (kv.first.Is<tNil>()) { continue; }
+            Constant k, v;
+            if (!serializeSimpleConstant(kv.first, k /*out*/)) { return false; }
+            if (!serializeSimpleConstant(kv.second, v /*out*/)) { return false; }
+            tpl.m_propertyPartKVs.push_back(std::make_pair(k, v));
+        }
+        for (auto& kv : recipe.m_arrayPartKVs)
+        {
+            TValue value; value.m_value = kv.second;
+            Constant v;
+            if (!serializeSimpleConstant(value, v /*out*/)) { return false; }
+            tpl.m_arrayPartKVs.push_back(std::make_pair(kv.first, v));
+        }
+        image->m_memoryUsage += sizeof(TableDupTemplate) + tpl.m_propertyPartKVs.size() * sizeof(std::pair<Constant, Constant>) + tpl.m_arrayPartKVs.size() * sizeof(std::pair<int32_t, Constant>);
+        uint32_t ord = static_cast<uint32_t>(image->m_tableDupTemplates.size());
+        image->m_tableDupTemplates.push_back(std::move(tpl));
+        templateOrdMap[tv.m_value] = ord;
+        result = Constant { .m_kind = ConstantKind::TableDupTemplate, .m_ord = ord, .m_rawValue = 0 };
+        return true;
+    };
+
+    image->m_functions.resize(ucbList.size());
+    for (uint32_t ucbOrd = 0; ucbOrd < ucbList.size(); ucbOrd++)
+    {
+        UnlinkedCodeBlock* ucb = ucbList[ucbOrd];
+        Assert(ucb->m_bytecodeBuilder == nullptr && ucb->m_parserUVGetFixupList == nullptr);
+        Function& fn = image->m_functions[ucbOrd];
+        fn.m_hasVariadicArguments = ucb->m_hasVariadicArguments;
+        fn.m_numFixedArguments = ucb->m_numFixedArguments;
+        fn.m_lineDefined = ucb->m_lineDefined;
+        fn.m_numUpvalues = ucb->m_numUpvalues;
+        fn.m_stackFrameNumSlots = ucb->m_stackFrameNumSlots;
+        fn.m_bytecodeMetadataLength = ucb->m_bytecodeMetadataLength;
+        if (ucb->m_parent == nullptr)
+        {
+            Assert(ucbOrd == ucbList.size() - 1);
+            fn.m_parentOrd = -1;
+        }
+        else
+        {
+            Assert(ucbOrdMap.count(ucb->m_parent) && ucbOrdMap[ucb->m_parent] > ucbOrd);
+            fn.m_parentOrd = static_cast<int32_t>(ucbOrdMap[ucb->m_parent]);
+        }
+
+        fn.m_bytecodeLengthIncludingTailPadding = ucb->m_bytecodeLengthIncludingTailPadding;
+        fn.m_bytecode.reset(new uint8_t[ucb->m_bytecodeLengthIncludingTailPadding]);
+        memcpy(fn.m_bytecode.get(), ucb->m_bytecode, ucb->m_bytecodeLengthIncludingTailPadding);
+
+        fn.m_upvalueInfo.reset(new UpvalueMetadata[ucb->m_numUpvalues]);
+        for (uint32_t i = 0; i < ucb->m_numUpvalues; i++)
+        {
+            fn.m_upvalueInfo[i] = ucb->m_upvalueInfo[i];
+        }
+
+        fn.m_bytecodeMetadataUseCounts.assign(ucb->m_bytecodeMetadataUseCounts, ucb->m_bytecodeMetadataUseCounts + x_num_bytecode_metadata_struct_kinds_);
+
+        // The constant table may contain UnlinkedCodeBlock pointers disguised as TValue, which must be the children of this function
+        //
+        fn.m_constantTable.resize(ucb->m_cstTableLength);
+        for (uint32_t i = 0; i < ucb->m_cstTableLength; i++)
+        {
+            uint64_t rawValue = ucb->m_cstTable[i];
+            UnlinkedCodeBlock* maybeChild = reinterpret_cast<UnlinkedCodeBlock*>(rawValue);
+            auto iter = ucbOrdMap.find(maybeChild);
+            if (iter != ucbOrdMap.end() && maybeChild->m_parent == ucb)
+            {
+                fn.m_constantTable[i] = Constant { .m_kind = ConstantKind::Function, .m_ord = iter->second, .m_rawValue = 0 };
+                continue;
+            }
+
+            if (tableNewProfiles.count(rawValue))
+            {
+                TableAllocationSiteProfile* profile = reinterpret_cast<TableAllocationSiteProfile*>(rawValue);
+                Assert(profile->IsObserving());
+                fn.m_constantTable[i] = Constant {
+                    .m_kind = ConstantKind::AllocationSiteProfile,
+                    .m_ord = 0,
+                    .m_rawValue = static_cast<uint64_t>(profile->m_inlineStorageSizeStepping) | (static_cast<uint64_t>(profile->m_arrayPartSizeHint) << 8)
+                };
+                continue;
+            }
+
+            TValue tv; tv.m_value = rawValue;
+            if (tv.Is<tTable>())
+            {
+                if (!serializeTemplate(tv, fn.m_constantTable[i] /*out*/))
+                {
+                    return nullptr;
+                }
+            }
+            else if (!serializeSimpleConstant(tv, fn.m_constantTable[i] /*out*/))
+            {
+                return nullptr;
+            }
+        }
+
+        image->m_memoryUsage += sizeof(Function)
+            + fn.m_bytecodeLengthIncludingTailPadding
+            + sizeof(UpvalueMetadata) * fn.m_numUpvalues
+            + sizeof(Constant) * fn.m_constantTable.size()
+            + sizeof(uint16_t) * fn.m_bytecodeMetadataUseCounts.size();
+    }
+
+    image->m_tableNewSteppings = vmStateRecord.m_tableNewSteppings;
+    std::sort(image->m_tableNewSteppings.begin(), image->m_tableNewSteppings.end());
+    image->m_tableNewSteppings.erase(std::unique(image->m_tableNewSteppings.begin(), image->m_tableNewSteppings.end()), image->m_tableNewSteppings.end());
+
+    return image;
+}
+
+TValue WARN_UNUSED ParsedModuleImage::MaterializeConstant(VM* vm, const Constant& cst, const std::vector<UnlinkedCodeBlock*>& ucbList, std::vector<TValue>& templateTables) const
+{
+    switch (cst.m_kind)
+    {
+    case ConstantKind::RawValue:
+    {
+        TValue tv; tv.m_value = cst.m_rawValue;
+        return tv;
+    }
+    case ConstantKind::String:
+    {
+        Assert(cst.m_ord < m_strings.size());
+        const std::string& str = m_strings[cst.m_ord];
+        return TValue::Create<tString>(vm->CreateStringObjectFromRawString(str.data(), static_cast<uint32_t>(str.length())).As());
+    }
+    case ConstantKind::Function:
+    {
+        Assert(cst.m_ord < ucbList.size());
+        TValue tv; tv.m_value = reinterpret_cast<uint64_t>(ucbList[cst.m_ord]);
+        return tv;
+    }
+    case ConstantKind::TableDupTemplate:
+    {
+        Assert(cst.m_ord < m_tableDupTemplates.size() && cst.m_ord < templateTables.size());
+        if (templateTables[cst.m_ord].m_value != TValue::Create<tNil>().m_value)
+        {
+            return templateTables[cst.m_ord];
+        }
+        const TableDupTemplate& tpl = m_tableDupTemplates[cst.m_ord];
+        TableDupTemplateRecipe recipe {
+            .m_numPropertyPartKeys = tpl.m_numPropertyPartKeys,
+            .m_initButterflyArrayPartCapacity = tpl.m_initButterflyArrayPartCapacity,
+            .m_propertyPartKVs = { },
+            .m_arrayPartKVs = { }
+        };
+        for (auto& kv : tpl.m_propertyPartKVs)
+        {
+            recipe.m_propertyPartKVs.push_back(std::make_pair(MaterializeConstant(vm, kv.first, ucbList, templateTables),
+                                                              MaterializeConstant(vm, kv.second, ucbList, templateTables)));
+        }
+        for (auto& kv : tpl.m_arrayPartKVs)
+        {
+            recipe.m_arrayPartKVs.push_back(std::make_pair(kv.first, MaterializeConstant(vm, kv.second, ucbList, templateTables).m_value));
+        }
+        TValue tv = TValue::Create<tTable>(CreateTableDupTemplateTable(vm, recipe));
+        templateTables[cst.m_ord] = tv;
+        return tv;
+    }
+    case ConstantKind::AllocationSiteProfile:
+    {
+        uint8_t stepping = static_cast<uint8_t>(cst.m_rawValue & 0xff);
+        uint16_t arrayPartSizeHint = static_cast<uint16_t>(cst.m_rawValue >> 8);
+        TValue tv; tv.m_value = reinterpret_cast<uint64_t>(TableAllocationSiteProfile::Create(vm, stepping, arrayPartSizeHint));
+        return tv;
+    }
+    }   /*switch*/
+    __builtin_unreachable();
+}
+
+std::vector<UnlinkedCodeBlock*> WARN_UNUSED ParsedModuleImage::Link(VM* vm, UserHeapPointer<TableObject> globalObject) const
+{
+    // Re-create the initial structures that the TNEW bytecodes expect to exist
+    //
+    for (uint8_t stepping : m_tableNewSteppings)
+    {
+        std::ignore = Structure::GetInitialStructureForStepping(vm, stepping);
+    }
+
+    std::vector<UnlinkedCodeBlock*> ucbList;
+    ucbList.reserve(m_functions.size());
+    for (const Function& fn : m_functions)
+    {
+        UnlinkedCodeBlock* ucb = UnlinkedCodeBlock::Create(vm, globalObject.As());
+        ucb->m_numFixedArguments = fn.m_numFixedArguments;
+        ucb->m_lineDefined = fn.m_lineDefined;
+        ucb->m_hasVariadicArguments = fn.m_hasVariadicArguments;
+        ucb->m_stackFrameNumSlots = fn.m_stackFrameNumSlots;
+        ucb->m_numUpvalues = fn.m_numUpvalues;
+        ucb->m_bytecodeMetadataLength = fn.m_bytecodeMetadataLength;
+        ucb->m_bytecodeBuilder = nullptr;
+        // The bytecode and upvalue metadata are read-only after parsing, so we can share them with the image
+        //
+        ucb->m_bytecode = fn.m_bytecode.get();
+        ucb->m_bytecodeLengthIncludingTailPadding = fn.m_bytecodeLengthIncludingTailPadding;
+        ucb->m_upvalueInfo = fn.m_upvalueInfo.get();
+        Assert(fn.m_bytecodeMetadataUseCounts.size() == x_num_bytecode_metadata_struct_kinds_);
+        memcpy(ucb->m_bytecodeMetadataUseCounts, fn.m_bytecodeMetadataUseCounts.data(), fn.m_bytecodeMetadataUseCounts.size() * sizeof(uint16_t));
+        // Same as the parser: every function except the chunk function has its upvalues fixed up by the parent
+        //
+        ucb->m_uvFixUpCompleted = (fn.m_parentOrd != -1);
+        ucbList.push_back(ucb);
+    }
+
+    std::vector<TValue> templateTables(m_tableDupTemplates.size(), TValue::Create<tNil>());
+    for (size_t ucbOrd = 0; ucbOrd < m_functions.size(); ucbOrd++)
+    {
+        const Function& fn = m_functions[ucbOrd];
+        UnlinkedCodeBlock* ucb = ucbList[ucbOrd];
+        ucb->m_parent = (fn.m_parentOrd == -1) ? nullptr : ucbList[static_cast<size_t>(fn.m_parentOrd)];
+
+        size_t cstTableLength = fn.m_constantTable.size();
+        ucb->m_cstTableLength = static_cast<uint32_t>(cstTableLength);
+        ucb->m_cstTable = new uint64_t[cstTableLength];
+        for (size_t i = 0; i < cstTableLength; i++)
+        {
+            ucb->m_cstTable[i] = MaterializeConstant(vm, fn.m_constantTable[i], ucbList, templateTables).m_value;
+        }
+    }
+    return ucbList;
+}
+
+ParsedModuleCache& ParsedModuleCache::Get()
+{
+    static ParsedModuleCache instance;
+    return instance;
+}
+
+std::shared_ptr<const ParsedModuleImage> WARN_UNUSED ParsedModuleCache::Find(const char* source, size_t sourceLength)
+{
+    uint64_t hash = HashString(source, sourceLength);
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto iter = m_map.find(hash);
+    if (iter != m_map.end())
+    {
+        for (auto& image : iter->second)
+        {
+            if (image->IsSameSource(source, sourceLength))
+            {
+                m_stats.m_numHits++;
+                return image;
+            }
+        }
+    }
+    m_stats.m_numMisses++;
+    return nullptr;
+}
+
+void ParsedModuleCache::Insert(const char* source, size_t sourceLength, const std::vector<UnlinkedCodeBlock*>& ucbList, const ParserVmStateRecord& vmStateRecord)
+{
+    uint64_t hash = HashString(source, sourceLength);
+    // Building the image does not need the lock
+    //
+    std::shared_ptr<const ParsedModuleImage> image = ParsedModuleImage::Build(source, sourceLength, ucbList, vmStateRecord);
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (image == nullptr)
+    {
+        m_stats.m_numUncacheable++;
+        return;
+    }
+    std::vector<std::shared_ptr<const ParsedModuleImage>>& bucket = m_map[hash];
+    for (auto& existing : bucket)
+    {
+        if (existing->IsSameSource(source, sourceLength))
+        {
+            return;
+        }
+    }
+    m_stats.m_numEntries++;
+    m_stats.m_totalImageSize += image->GetMemoryUsage();
+    bucket.push_back(std::move(image));
+}
+
+ParsedModuleCache::Statistics WARN_UNUSED ParsedModuleCache::GetStatistics()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_stats;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "common.h"
+#include "runtime_utils.h"
+
+#include <atomic>
+
+struct ParserVmStateRecord;
+
+// A VM-independent, immutable image of a parsed Lua chunk
+//
+// The UnlinkedCodeBlocks produced by the parser live in the system heap of the VM that parsed them,
+// and their constant tables reference objects (strings, template tables) in that VM's heap.
+// The image stores the same information in a VM-independent form, so it can be linked into any VM:
+// linking creates fresh UnlinkedCodeBlocks in the target VM, which then get their CodeBlocks through
+// UnlinkedCodeBlock::GetCodeBlock as usual.
+//
+// The bytecode and upvalue metadata are never modified after parsing, so the linked UnlinkedCodeBlocks
+// point directly into the image instead of owning a copy. Only the constant table is materialized per VM.
+//
+class ParsedModuleImage
+{
+    MAKE_NONCOPYABLE(ParsedModuleImage);
+    MAKE_NONMOVABLE(ParsedModuleImage);
+
+public:
+    // Returns nullptr if the parsed chunk contains something that cannot be represented in a VM-independent way
+    //
+    static std::unique_ptr<ParsedModuleImage> WARN_UNUSED Build(const char* source,
+                                                                size_t sourceLength,
+                                                                const std::vector<UnlinkedCodeBlock*>& ucbList,
+                                                                const ParserVmStateRecord& vmStateRecord);
+
+    // Create the UnlinkedCodeBlocks in the given VM, in the same topological order as the parser produces
+    // The caller should create the ScriptModule using CreateScriptModuleFromUnlinkedCodeBlocks
+    //
+    std::vector<UnlinkedCodeBlock*> WARN_UNUSED Link(VM* vm, UserHeapPointer<TableObject> globalObject) const;
+
+    bool WARN_UNUSED IsSameSource(const char* source, size_t sourceLength) const
+    {
+        return m_source.length() == sourceLength && memcmp(m_source.data(), source, sourceLength) == 0;
+    }
+
+    // The approximate amount of memory used by this image, excluding the source copy
+    //
+    size_t GetMemoryUsage() const { return m_memoryUsage; }
+
+private:
+    ParsedModuleImage() = default;
+
+    enum class ConstantKind : uint8_t
+    {
+        // A TValue that does not reference any heap object, its bit pattern is the same in every VM
+        //
+        RawValue,
+        // m_ord is the ordinal into m_strings
+        //
+        String,
+        // m_ord is the ordinal into m_functions (an UnlinkedCodeBlock disguised as a TValue)
+        //
+        Function,
+        // m_ord is the ordinal into m_tableDupTemplates
+        //
+        TableDupTemplate,
+        // A TableAllocationSiteProfile disguised as a TValue, created fresh in every VM
+        // m_rawValue holds the inline storage size stepping (low 8 bits) and the array part size hint (next 16 bits) guessed by the parser
+        //
+        AllocationSiteProfile
+    };
+
+    struct Constant
+    {
+        ConstantKind m_kind;
+        uint32_t m_ord;
+        uint64_t m_rawValue;
+    };
+
+    struct TableDupTemplate
+    {
+        uint32_t m_numPropertyPartKeys;
+        uint32_t m_initButterflyArrayPartCapacity;
+        std::vector<std::pair<Constant, Constant>> m_propertyPartKVs;
+        std::vector<std::pair<int32_t, Constant>> m_arrayPartKVs;
+    };
+
+    struct Function
+    {
+        bool m_hasVariadicArguments;
+        uint32_t m_numFixedArguments;
+        uint32_t m_lineDefined;
+        uint32_t m_numUpvalues;
+        uint32_t m_stackFrameNumSlots;
+        uint32_t m_bytecodeMetadataLength;
+        // -1 for the chunk function
+        //
+        int32_t m_parentOrd;
+        std::unique_ptr<uint8_t[]> m_bytecode;
+        uint32_t m_bytecodeLengthIncludingTailPadding;
+        std::unique_ptr<UpvalueMetadata[]> m_upvalueInfo;
+        std::vector<Constant> m_constantTable;
+        std::vector<uint16_t> m_bytecodeMetadataUseCounts;
+    };
+
+    TValue WARN_UNUSED MaterializeConstant(VM* vm, const Constant& cst, const std::vector<UnlinkedCodeBlock*>& ucbList, std::vector<TValue>& templateTables) const;
+
+    std::string m_source;
+    std::vector<Function> m_functions;
+    std::vector<std::string> m_strings;
+    std::vector<TableDupTemplate> m_tableDupTemplates;
+    std::vector<uint8_t> m_tableNewSteppings;
+    size_t m_memoryUsage;
+};
+
+// A process-wide cache of parsed Lua chunks, keyed by the hash of the source code, shared by all VMs
+//
+// When enabled, ParseLuaScript (for in-memory sources) and ParseLuaScriptFromFile (thus loadfile, dofile, etc)
+// look up the cache first, and link the cached image into the current VM on a hit, skipping the parser.
+// Cached images are never evicted, since the UnlinkedCodeBlocks linked from an image point into it.
+//
+class ParsedModuleCache
+{
+    MAKE_NONCOPYABLE(ParsedModuleCache);
+    MAKE_NONMOVABLE(ParsedModuleCache);
+
+public:
+    static ParsedModuleCache& Get();
+
+    // The cache is disabled by default. It only pays off when the same sources are loaded by many VMs
+    //
+    static bool IsEnabled() { return Get().m_isEnabled.load(std::memory_order_relaxed); }
+    static void SetEnabled(bool value) { Get().m_isEnabled.store(value, std::memory_order_relaxed); }
+
+    std::shared_ptr<const ParsedModuleImage> WARN_UNUSED Find(const char* source, size_t sourceLength);
+
+    // Build the image for a freshly parsed chunk and insert it into the cache
+    // Does nothing if the chunk is not cacheable, or if another thread has already inserted the same source
+    //
+    void Insert(const char* source, size_t sourceLength, const std::vector<UnlinkedCodeBlock*>& ucbList, const ParserVmStateRecord& vmStateRecord);
+
+    struct Statistics
+    {
+        uint64_t m_numHits;
+        uint64_t m_numMisses;
+        uint64_t m_numUncacheable;
+        uint64_t m_numEntries;
+        uint64_t m_totalImageSize;
+    };
+
+    Statistics WARN_UNUSED GetStatistics();
+
+private:
+    ParsedModuleCache() = default;
+
+    std::atomic<bool> m_isEnabled { false };
+    std::mutex m_lock;
+    std::unordered_map<uint64_t /*sourceHash*/, std::vector<std::shared_ptr<const ParsedModuleImage>>> m_map;
+    Statistics m_stats {};
+};
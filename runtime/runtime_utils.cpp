@@ -25,10 +25,6 @@ TValue WARN_UNUSED MakeErrorMessageForUnableToCall(TValue badValue)
     {
         snprintf(msg, 100, "attempt to call a %s value", ty);
     };
-    auto makeMsg2 = [&](int d)
-    {
-        snprintf(msg, 100, "attempt to call a (internal type %d) value", d);
-    };
 
     if (badValue.IsInt32())
     {
@@ -73,9 +69,8 @@ TValue WARN_UNUSED MakeErrorMessageForUnableToCall(TValue badValue)
         }
         else
         {
-            // TODO: handle userdata type
-            //
-            makeMsg2(static_cast<int>(p->m_type));
+            Assert(p->m_type == HeapEntityType::Userdata);
+            makeMsg("userdata");
         }
     }
     return MakeErrorMessage(msg);
@@ -108,9 +103,11 @@ CodeBlock* WARN_UNUSED CodeBlock::Create(VM* vm, UnlinkedCodeBlock* ucb, UserHea
     cb->m_bytecodeMetadataLength = ucb->m_bytecodeMetadataLength;
     cb->m_baselineCodeBlock = nullptr;
     cb->m_dfgCodeBlock = nullptr;
+    cb->m_dfgOsrExitProfile = nullptr;
+    cb->m_numDfgJettisons = 0;
     if (vm->InterpreterCanTierUpFurther())
     {
-        cb->m_interpreterTierUpCounter = x_interpreter_tier_up_threshold_bytecode_length_multiplier * ucb->m_bytecodeLengthIncludingTailPadding;
+        cb->m_interpreterTierUpCounter = vm->GetInterpreterTierUpThreshold(ucb->m_bytecodeLengthIncludingTailPadding);
     }
     else
     {
@@ -177,10 +174,237 @@ void CodeBlock::UpdateBestEntryPoint(void* newEntryPoint)
     m_bestEntryPoint = newEntryPoint;
 }
 
+// Collect the CodeBlocks of all the bytecode functions that have a call frame on the stack of a suspended coroutine
+//
+static void CollectCodeBlocksWithFramesOnSuspendedCoroutineStack(CoroutineRuntimeContext* coro, std::unordered_set<CodeBlock*>& result /*inout*/)
+{
+    Assert(!coro->m_coroutineStatus.IsDead() && coro->m_coroutineStatus.IsResumable());
+    StackFrameHeader* hdr = StackFrameHeader::Get(coro->m_suspendPointStackBase);
+    while (true)
+    {
+        // The bottom frame of a coroutine stack is a dummy frame with no function (see 'CreateNewCoroutine')
+        //
+        if (hdr->m_func != nullptr)
+        {
+            ExecutableCode* ec = TranslateToRawPointer(TCGet(hdr->m_func->m_executable).As());
+            if (ec->IsBytecodeFunction())
+            {
+                result.insert(static_cast<CodeBlock*>(ec));
+            }
+        }
+        hdr = reinterpret_cast<StackFrameHeader*>(hdr->m_caller);
+        if (hdr == nullptr)
+        {
+            break;
+        }
+        hdr = hdr - 1;
+    }
+}
+
+void VM::EvictColdBaselineJitCodeIfOverBudget()
+{
+    if (m_jitCodeMemoryBudget == 0)
+    {
+        return;
+    }
+
+    // At a safe point, every coroutine that has started but not finished should be suspended, so its call frames can be walked.
+    // If that is not the case, we cannot tell which JIT code is live, so do nothing.
+    //
+    for (CoroutineRuntimeContext* coro : m_liveCoroutines)
+    {
+        if (!coro->m_coroutineStatus.IsResumable())
+        {
+            return;
+        }
+    }
+
+    // Higher tiers may OSR exit into the baseline JIT code of any function they inlined,
+    // which we do not track, so eviction is only safe if baseline JIT is the highest tier.
+    //
+    if (BaselineJitCanTierUpFurther())
+    {
+        return;
+    }
+
+    m_baselineJitEvictionStats.m_numEvictionScans++;
+
+    // Age all the baseline JIT code: the age is the number of consecutive scans that observed no call
+    //
+    for (CodeBlock* cb : m_baselineJitCompiledCodeBlocks)
+    {
+        BaselineCodeBlock* bcb = cb->m_baselineCodeBlock;
+        Assert(bcb != nullptr);
+        if (bcb->m_calledSinceLastEvictionScan)
+        {
+            bcb->m_calledSinceLastEvictionScan = 0;
+            bcb->m_numEvictionScansWithoutCall = 0;
+        }
+        else if (bcb->m_numEvictionScansWithoutCall < std::numeric_limits<uint16_t>::max())
+        {
+            bcb->m_numEvictionScansWithoutCall++;
+        }
+    }
+
+    JitMemoryAllocator* jitAlloc = GetJITMemoryAlloc();
+    if (jitAlloc->GetTotalJITCodeSize() <= m_jitCodeMemoryBudget)
+    {
+        return;
+    }
+
+    // The code of a function that has a frame on the stack of a suspended coroutine will be returned to, so it cannot be evicted
+    //
+    std::unordered_set<CodeBlock*> codeBlocksWithLiveFrames;
+    for (CoroutineRuntimeContext* coro : m_liveCoroutines)
+    {
+        CollectCodeBlocksWithFramesOnSuspendedCoroutineStack(coro, codeBlocksWithLiveFrames /*inout*/);
+    }
+
+    // Evict the coldest code first. Code that has been called since the last scan is never evicted.
+    //
+    std::vector<CodeBlock*> candidates;
+    for (CodeBlock* cb : m_baselineJitCompiledCodeBlocks)
+    {
+        if (cb->m_baselineCodeBlock->m_numEvictionScansWithoutCall > 0 && cb->m_dfgCodeBlock == nullptr && !codeBlocksWithLiveFrames.count(cb))
+        {
+            candidates.push_back(cb);
+        }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [](CodeBlock* lhs, CodeBlock* rhs) {
+        return lhs->m_baselineCodeBlock->m_numEvictionScansWithoutCall > rhs->m_baselineCodeBlock->m_numEvictionScansWithoutCall;
+    });
+
+    for (CodeBlock* cb : candidates)
+    {
+        if (jitAlloc->GetTotalJITCodeSize() <= m_jitCodeMemoryBudget)
+        {
+            break;
+        }
+        size_t numBytes = EvictBaselineJitCode(cb);
+        RecordEvent(VMEventKind::BaselineJitCodeEvicted, cb, VMEvent::x_unknownBytecodeOffset, numBytes);
+        m_baselineJitEvictionStats.m_numCodeBlocksEvicted++;
+        m_baselineJitEvictionStats.m_numBytesEvicted += numBytes;
+    }
+
+    std::erase_if(m_baselineJitCompiledCodeBlocks, [](CodeBlock* cb) { return cb->m_baselineCodeBlock == nullptr; });
+}
+
+void NO_INLINE VM::RecordDfgOsrExit(DfgCodeBlock* dcb, CodeBlock* cb, size_t bytecodeIndex, TypeMaskTy exitValueTypeMask)
+{
+    Assert(dcb != nullptr && cb != nullptr);
+    m_dfgOsrExitStats.m_numOsrExits++;
+    dcb->m_numOsrExits++;
+
+    if (cb->m_dfgOsrExitProfile == nullptr)
+    {
+        cb->m_dfgOsrExitProfile = new DfgOsrExitProfile();
+    }
+    DfgOsrExitProfile::Site& site = cb->m_dfgOsrExitProfile->m_sites[SafeIntegerCast<uint32_t>(bytecodeIndex)];
+    if (site.m_numExits < std::numeric_limits<uint32_t>::max())
+    {
+        site.m_numExits++;
+    }
+    site.m_exitValueTypeMask |= exitValueTypeMask;
+
+    if (unlikely(m_eventLog != nullptr))
+    {
+        uint32_t bytecodeOffset = VMEvent::x_unknownBytecodeOffset;
+        BaselineCodeBlock* bcb = cb->m_baselineCodeBlock;
+        if (bcb != nullptr && bytecodeIndex < bcb->m_numBytecodes)
+        {
+            bytecodeOffset = SafeIntegerCast<uint32_t>(bcb->GetBytecodeOffsetFromBytecodeIndex(bytecodeIndex));
+        }
+        m_eventLog->Record(VMEventKind::DfgOsrExit, cb, bytecodeOffset, site.m_numExits);
+    }
+
+    // Only jettison the DFG code if it is still the one linked to its function: after a jettison, frames still running
+    // the old DFG code may continue to exit, and they must not jettison the recompiled code
+    //
+    CodeBlock* owner = dcb->m_owner;
+    if (dcb->m_numOsrExits >= m_options.m_dfgOsrExitJettisonThreshold && owner->m_dfgCodeBlock == dcb)
+    {
+        JettisonDfgCode(owner);
+    }
+}
+
+void VM::JettisonDfgCode(CodeBlock* cb)
+{
+    DfgCodeBlock* dcb = cb->m_dfgCodeBlock;
+    ReleaseAssert(dcb != nullptr);
+    Assert(cb->m_bestEntryPoint == dcb->m_jitCodeEntry);
+
+    // DFG code always OSR exits into baseline JIT code, so the function must have been compiled to baseline JIT code,
+    // but handle the no-baseline-JIT case anyway, so the logic does not depend on the tier configuration
+    //
+    void* newEntryPoint = (cb->m_baselineCodeBlock != nullptr) ? cb->m_baselineCodeBlock->m_jitCodeEntry : cb->m_owner->GetInterpreterEntryPoint();
+    cb->UpdateBestEntryPoint(newEntryPoint);
+    Assert(cb->m_bestEntryPoint == newEntryPoint);
+    cb->m_dfgCodeBlock = nullptr;
+
+    if (cb->m_numDfgJettisons < std::numeric_limits<uint32_t>::max())
+    {
+        cb->m_numDfgJettisons++;
+    }
+    m_dfgOsrExitStats.m_numJettisons++;
+    RecordEvent(VMEventKind::DfgJitCodeJettisoned, cb, VMEvent::x_unknownBytecodeOffset, cb->m_numDfgJettisons);
+}
+
+bool WARN_UNUSED VM::ShouldAllowDfgCompilation(CodeBlock* cb)
+{
+    return cb->m_numDfgJettisons <= m_options.m_dfgMaxNumRecompilations;
+}
+
+std::pair<CodeBlock*, uint32_t /*bytecodeOffset*/> WARN_UNUSED VM::FindBytecodeLocationFromBaselineJitSlowPathData(void* addr)
+{
+    uint8_t* target = reinterpret_cast<uint8_t*>(addr);
+    for (CodeBlock* cb : m_baselineJitCompiledCodeBlocks)
+    {
+        BaselineCodeBlock* bcb = cb->m_baselineCodeBlock;
+        if (bcb == nullptr || bcb->m_numBytecodes == 0)
+        {
+            continue;
+        }
+        uint8_t* streamStart = bcb->GetSlowPathDataStreamStart();
+        if (target < streamStart || target >= streamStart + bcb->m_slowPathDataStreamLength)
+        {
+            continue;
+        }
+
+        // The slow path data of the bytecodes are laid out in bytecode order, find the last one that starts at or before 'addr'
+        //
+        uint32_t offset = static_cast<uint32_t>(target - reinterpret_cast<uint8_t*>(bcb));
+        BaselineCodeBlock::SlowPathDataAndBytecodeOffset* begin = bcb->m_sbIndex;
+        BaselineCodeBlock::SlowPathDataAndBytecodeOffset* end = bcb->m_sbIndex + bcb->m_numBytecodes;
+        BaselineCodeBlock::SlowPathDataAndBytecodeOffset* it = std::upper_bound(
+            begin, end, offset,
+            [](uint32_t value, const BaselineCodeBlock::SlowPathDataAndBytecodeOffset& item) { return value < item.m_slowPathDataOffset; });
+        Assert(it != begin);
+        size_t bytecodeIndex = static_cast<size_t>(it - begin) - 1;
+        return std::make_pair(cb, SafeIntegerCast<uint32_t>(bcb->GetBytecodeOffsetFromBytecodeIndex(bytecodeIndex)));
+    }
+    return std::make_pair(nullptr, VMEvent::x_unknownBytecodeOffset);
+}
+
+void NO_INLINE VM::RecordEventAtJitIcSiteSlow(VMEventKind kind, void* icSite, uint64_t arg)
+{
+    Assert(m_eventLog != nullptr);
+    auto [cb, bytecodeOffset] = FindBytecodeLocationFromBaselineJitSlowPathData(icSite);
+    m_eventLog->Record(kind, cb, bytecodeOffset, arg);
+}
+
 std::pair<TValue* /*retStart*/, uint64_t /*numRet*/> VM::LaunchScript(ScriptModule* module)
 {
+    // No call frame is live at this point, so this is a safe point to evict JIT code
+    //
+    EvictColdBaselineJitCodeIfOverBudget();
+
     CoroutineRuntimeContext* rc = GetRootCoroutine();
-    return DeegenEnterVMFromC(rc, module->m_defaultEntryPoint.As(), rc->m_stackBegin);
+    std::pair<TValue*, uint64_t> result = DeegenEnterVMFromC(rc, module->m_defaultEntryPoint.As(), rc->m_stackBegin);
+
+    // The output of 'print' and the io library may still sit in the VM output buffers, make it visible to the caller
+    //
+    FlushOutputBuffers();
+    return result;
 }
 
 UserHeapPointer<FunctionObject> WARN_UNUSED NO_INLINE FunctionObject::CreateAndFillUpvalues(
@@ -260,7 +484,31 @@ FunctionObject* WARN_UNUSED NO_INLINE FunctionObject::CreateForDfgAndFillUpvalue
     return r;
 }
 
-CoroutineRuntimeContext* CoroutineRuntimeContext::Create(VM* vm, UserHeapPointer<TableObject> globalObject, size_t numStackSlots)
+CoroutineRuntimeContext* CoroutineRuntimeContext::Create(VM* vm, UserHeapPointer<TableObject> globalObject)
+{
+    return Create(vm, globalObject, x_defaultStackSlots, vm->GetCoroutineStackLimit());
+}
+
+CoroutineRuntimeContext* WARN_UNUSED CoroutineRuntimeContext::TryCreate(VM* vm, UserHeapPointer<TableObject> globalObject)
+{
+    CoroutineRuntimeContext* r = CreateWithoutStack(vm, globalObject);
+    if (unlikely(!r->TryAllocateStack(vm, x_defaultStackSlots, vm->GetCoroutineStackLimit())))
+    {
+        // The coroutine object is never exposed, so it is simply dropped (like every other unreachable object, since there is no GC)
+        //
+        return nullptr;
+    }
+    return r;
+}
+
+CoroutineRuntimeContext* CoroutineRuntimeContext::Create(VM* vm, UserHeapPointer<TableObject> globalObject, size_t initialStackSlots, size_t maxStackSlots)
+{
+    CoroutineRuntimeContext* r = CreateWithoutStack(vm, globalObject);
+    r->AllocateStack(vm, initialStackSlots, maxStackSlots);
+    return r;
+}
+
+CoroutineRuntimeContext* WARN_UNUSED CoroutineRuntimeContext::CreateWithoutStack(VM* vm, UserHeapPointer<TableObject> globalObject)
 {
     CoroutineRuntimeContext* r = TranslateToRawPointer(vm, vm->AllocFromUserHeap(static_cast<uint32_t>(sizeof(CoroutineRuntimeContext))).AsNoAssert<CoroutineRuntimeContext>());
     UserHeapGcObjectHeader::Populate(r);
@@ -270,23 +518,78 @@ CoroutineRuntimeContext* CoroutineRuntimeContext::Create(VM* vm, UserHeapPointer
     r->m_numVariadicRets = 0;
     r->m_variadicRetStart = nullptr;
     r->m_upvalueList.m_value = 0;
-    size_t bytesToAllocate = numStackSlots * sizeof(TValue);
-    bytesToAllocate = RoundUpToMultipleOf<VM::x_pageSize>(bytesToAllocate);
-    void* stackAreaWithOverflowProtection = mmap(nullptr, bytesToAllocate + x_stackOverflowProtectionAreaSize * 2,
-                                                 PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
-    VM_FAIL_WITH_ERRNO_IF(stackAreaWithOverflowProtection == MAP_FAILED,
-                          "Failed to reserve address range of length %llu",
-                          static_cast<unsigned long long>(bytesToAllocate + x_stackOverflowProtectionAreaSize * 2));
-
-    void* stackArea = mmap(reinterpret_cast<uint8_t*>(stackAreaWithOverflowProtection) + x_stackOverflowProtectionAreaSize,
-                           bytesToAllocate, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
-    VM_FAIL_WITH_ERRNO_IF(stackArea == MAP_FAILED,
-                          "Out of Memory: Allocation of length %llu failed", static_cast<unsigned long long>(bytesToAllocate));
-    Assert(stackArea == reinterpret_cast<uint8_t*>(stackAreaWithOverflowProtection) + x_stackOverflowProtectionAreaSize);
-    r->m_stackBegin = reinterpret_cast<TValue*>(stackArea);
     return r;
 }
 
+void CoroutineRuntimeContext::AllocateStack(VM* vm, size_t initialStackSlots, size_t maxStackSlots)
+{
+    VM_FAIL_IF(!TryAllocateStack(vm, initialStackSlots, maxStackSlots),
+               "Resource limit exceeded: coroutine stacks overflowed the coroutine stack region of the VM.");
+}
+
+bool WARN_UNUSED CoroutineRuntimeContext::TryAllocateStack(VM* vm, size_t initialStackSlots, size_t maxStackSlots)
+{
+    ReleaseAssert(maxStackSlots > 0 && maxStackSlots <= std::numeric_limits<uint32_t>::max() / 2);
+    size_t reservedBytes = GetReservedStackBytes(maxStackSlots);
+    size_t initialBytes = RoundUpToMultipleOf<VM::x_pageSize>(std::max(initialStackSlots, x_stackLimitMarginSlots + 1) * sizeof(TValue));
+    initialBytes = std::min(initialBytes, reservedBytes);
+    auto [stack, committedBytes] = vm->AllocateCoroutineStack(reservedBytes, initialBytes);
+    if (unlikely(stack == nullptr))
+    {
+        return false;
+    }
+    m_stackBegin = reinterpret_cast<TValue*>(stack);
+    m_numStackSlots = SafeIntegerCast<uint32_t>(reservedBytes / sizeof(TValue));
+    m_numCommittedStackSlots = SafeIntegerCast<uint32_t>(committedBytes / sizeof(TValue));
+    m_maxStackSlots = SafeIntegerCast<uint32_t>(maxStackSlots);
+    UpdateStackLimit();
+    return true;
+}
+
+void CoroutineRuntimeContext::CommitStack(size_t numSlots)
+{
+    Assert(numSlots <= m_numStackSlots);
+    if (numSlots > m_numCommittedStackSlots)
+    {
+        // Grow geometrically, so a deep recursion only needs to commit a logarithmic number of times
+        //
+        size_t newNumSlots = std::max(numSlots, static_cast<size_t>(m_numCommittedStackSlots) * 2);
+        size_t newBytes = std::min(RoundUpToMultipleOf<VM::x_pageSize>(newNumSlots * sizeof(TValue)), m_numStackSlots * sizeof(TValue));
+        VM* vm = VM::GetActiveVMForCurrentThread();
+        vm->CommitCoroutineStack(m_stackBegin, m_numCommittedStackSlots * sizeof(TValue), newBytes);
+        m_numCommittedStackSlots = SafeIntegerCast<uint32_t>(newBytes / sizeof(TValue));
+    }
+    UpdateStackLimit();
+}
+
+uint64_t WARN_UNUSED NO_INLINE CoroutineRuntimeContext::GrowStackForFunctionEntry(TValue* frameEnd)
+{
+    Assert(frameEnd > m_stackLimit);
+    size_t numSlotsNeeded = static_cast<size_t>(frameEnd - m_stackBegin);
+    bool isHandlingStackOverflow = (m_stackLimit > m_stackBegin + m_maxStackSlots);
+    if (unlikely(isHandlingStackOverflow))
+    {
+        // The error handler overflowed the raised stack limit
+        //
+        return MakeErrorMessageForTooManyNestedErrors().m_value;
+    }
+
+    if (likely(numSlotsNeeded <= m_maxStackSlots))
+    {
+        CommitStack(numSlotsNeeded + x_stackLimitMarginSlots);
+        Assert(frameEnd <= m_stackLimit);
+        return 0;
+    }
+
+    // Stack overflow. Commit the whole reserved range, and raise the stack limit until the error is caught,
+    // so that the error handler has some stack to run
+    //
+    CommitStack(m_numStackSlots);
+    m_stackLimit = m_stackBegin + m_maxStackSlots + x_stackSlotsForOverflowHandling;
+    Assert(m_stackLimit + x_stackSlotsForNestedErrors <= m_stackBegin + m_numStackSlots);
+    return MakeErrorMessage("stack overflow").m_value;
+}
+
 BaselineCodeBlock* WARN_UNUSED BaselineCodeBlock::Create(CodeBlock* cb,
                                                          uint32_t numBytecodes,
                                                          uint32_t slowPathDataStreamLength,
@@ -311,6 +614,11 @@ BaselineCodeBlock* WARN_UNUSED BaselineCodeBlock::Create(CodeBlock* cb,
     res->m_numBytecodes = numBytecodes;
     res->m_stackFrameNumSlots = cb->m_stackFrameNumSlots;
     res->m_maxObservedNumVariadicArgs = 0;
+    // Freshly compiled code should not be evicted by the very next scan, so treat it as if it has just been called
+    //
+    res->m_calledSinceLastEvictionScan = 1;
+    res->m_unused1 = 0;
+    res->m_numEvictionScansWithoutCall = 0;
     res->m_slowPathDataStreamLength = slowPathDataStreamLength;
     res->m_jitRegionStart = jitRegionStart;
     res->m_jitRegionSize = jitRegionSize;
@@ -370,7 +678,7 @@ void JitCallInlineCacheEntry::Destroy(VM* vm)
 
 void* WARN_UNUSED JitCallInlineCacheSite::InsertInDirectCallMode(uint16_t dcIcTraitKind, TValue tv, uint8_t* transitedToCCMode /*out*/)
 {
-    Assert(m_numEntries < x_maxEntries);
+    Assert(!IsMegamorphic());
     Assert(m_mode == Mode::DirectCall);
     Assert(tv.Is<tFunction>());
 
@@ -450,6 +758,8 @@ void* WARN_UNUSED JitCallInlineCacheSite::InsertInDirectCallMode(uint16_t dcIcTr
         //
         m_bloomFilter |= bloomFilterMask;
         m_numEntries++;
+        vm->RecordEventAtJitIcSite(VMEventKind::CallIcInsertDirectCall, this, m_numEntries);
+        UpdateStatisticsIfBecameMegamorphic(vm);
 
         JitCallInlineCacheEntry* newEntry = JitCallInlineCacheEntry::Create(vm,
                                                                             targetEc,
@@ -464,6 +774,7 @@ void* WARN_UNUSED JitCallInlineCacheSite::InsertInDirectCallMode(uint16_t dcIcTr
 
     // We need to transit to closure-call mode
     //
+    vm->RecordEventAtJitIcSite(VMEventKind::CallIcTransitToClosureCall, this, m_numEntries);
     {
         // Invalidate all existing ICs
         //
@@ -494,7 +805,7 @@ void* WARN_UNUSED JitCallInlineCacheSite::InsertInDirectCallMode(uint16_t dcIcTr
 
 void* WARN_UNUSED JitCallInlineCacheSite::InsertInClosureCallMode(uint16_t dcIcTraitKind, TValue tv)
 {
-    Assert(m_numEntries < x_maxEntries);
+    Assert(!IsMegamorphic());
     Assert(m_mode == Mode::ClosureCall || m_mode == Mode::ClosureCallWithMoreThanOneTargetObserved);
     Assert(tv.Is<tFunction>());
 
@@ -538,5 +849,7 @@ void* WARN_UNUSED JitCallInlineCacheSite::InsertInClosureCallMode(uint16_t dcIcT
                                                                      dcIcTraitKind + 1 /*icTraitKind*/);
     TCSet(m_linkedListHead, SpdsPtr<JitCallInlineCacheEntry> { entry });
     m_numEntries++;
+    vm->RecordEventAtJitIcSite(VMEventKind::CallIcInsertClosureCall, this, m_numEntries);
+    UpdateStatisticsIfBecameMegamorphic(vm);
     return entry->GetJitRegionStart();
 }
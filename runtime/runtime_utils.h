@@ -114,15 +114,124 @@ class alignas(8) CoroutineRuntimeContext
 {
 public:
     static constexpr uint32_t x_hiddenClassForCoroutineRuntimeContext = 0x10;
+
+    // The stack of a coroutine is a large reserved virtual range, of which only a prefix is committed.
+    // The function entry logic checks that the callee's stack frame fits below 'm_stackLimit', and if not, more stack is committed
+    // (see 'GrowStackForFunctionEntry'). So a coroutine only pays for the stack it actually uses, while deep recursion still works.
+    //
+    // The number of stack slots committed when a coroutine is created
+    //
     static constexpr size_t x_defaultStackSlots = 4096;
     static constexpr size_t x_rootCoroutineDefaultStackSlots = 16384;
-    static constexpr size_t x_stackOverflowProtectionAreaSize = 65536;
-    static_assert(x_stackOverflowProtectionAreaSize % VM::x_pageSize == 0);
 
-    static CoroutineRuntimeContext* Create(VM* vm, UserHeapPointer<TableObject> globalObject, size_t numStackSlots = x_defaultStackSlots);
+    // The default stack limit in number of slots. A call that would grow the stack beyond the limit results in a 'stack overflow' error.
+    // The limit of the root coroutine is much larger since deep recursion mostly happens there. The limit of the other coroutines is
+    // much smaller because their reserved ranges share the 2GB coroutine stack region of the VM, which limits the number of live coroutines.
+    // Since there is no GC, a coroutine abandoned while suspended stays live forever, so the reservation should be small:
+    // with the default limit, each coroutine reserves about 128KB including the guard area, so about 16K coroutines can be live at once.
+    // The cap can be traded against the stack limit at runtime, see 'VM::SetMaxLiveCoroutines'.
+    //
+    static constexpr size_t x_defaultMaxStackSlots = 8192;
+    static constexpr size_t x_rootCoroutineDefaultMaxStackSlots = 1000000;
+
+    // Once a stack overflow is raised, the stack limit is raised by this many slots until the error is caught,
+    // so that the error handler of 'xpcall' can run
+    //
+    static constexpr size_t x_stackSlotsForOverflowHandling = 4096;
+
+    // The error path may place the call frames of nested error handlers beyond the raised stack limit, so the reserved range has
+    // this many more slots at its end. Nested error handlers that would not fit result in 'error in error handling' (see 'ThrowError').
+    //
+    static constexpr size_t x_stackSlotsForNestedErrors = 2048;
+
+    // Library functions are entered without a stack check, and may use a few slots beyond their stack frame without checking
+    // (e.g., for nil-padding return values or passing arguments to an in-place call), so the stack limit is always at least
+    // this many slots below the end of the committed stack.
+    //
+    // The copies of variadic results (e.g., for 'f(...)' or 'return x, ...') also write beyond the stack frame without checking.
+    // They stay within this margin because the function entry check of a variadic argument function also covers the space to
+    // forward all of its variadic arguments beyond its stack frame (see 'GrowStackForFunctionEntry'), and the other variadic
+    // results are returned values, which already sit within the checked part of the stack.
+    //
+    static constexpr size_t x_stackLimitMarginSlots = 256;
+
+    // The lowest stack limit a coroutine may have, in number of slots
+    //
+    static constexpr size_t x_minMaxStackSlots = 1024;
+
+    // The size of the reserved range of the stack of a coroutine with the given stack limit
+    //
+    static size_t GetReservedStackBytes(size_t maxStackSlots)
+    {
+        return RoundUpToMultipleOf<VM::x_pageSize>((maxStackSlots + x_stackSlotsForOverflowHandling + x_stackSlotsForNestedErrors) * sizeof(TValue));
+    }
+
+    static CoroutineRuntimeContext* Create(VM* vm, UserHeapPointer<TableObject> globalObject);
+    static CoroutineRuntimeContext* Create(VM* vm, UserHeapPointer<TableObject> globalObject, size_t initialStackSlots, size_t maxStackSlots);
+
+    // Same as 'Create', but returns nullptr if the coroutine stack region of the VM is exhausted, instead of failing the VM
+    //
+    static CoroutineRuntimeContext* WARN_UNUSED TryCreate(VM* vm, UserHeapPointer<TableObject> globalObject);
 
     void CloseUpvalues(TValue* base);
 
+    // Set up a new stack for the coroutine. The old stack (if any) is not freed.
+    //
+    void AllocateStack(VM* vm, size_t initialStackSlots, size_t maxStackSlots);
+
+    // Same as 'AllocateStack', but returns false if the coroutine stack region of the VM is exhausted
+    //
+    bool WARN_UNUSED TryAllocateStack(VM* vm, size_t initialStackSlots, size_t maxStackSlots);
+
+    // Called when the coroutine becomes dead: closes all upvalues on the stack, and returns the stack to the VM for reuse
+    //
+    void ReleaseStackOfDeadCoroutine(VM* vm);
+
+    // Called by the function entry logic when the callee's stack frame ends beyond 'm_stackLimit'.
+    // For a variadic argument function, 'frameEnd' also includes the space to forward all its variadic arguments beyond its stack frame.
+    // Commits more stack if the frame is within the stack limit and returns 0. Otherwise raises the stack limit so the error can be
+    // handled, and returns the error object to throw ('stack overflow', or 'error in error handling' if we overflowed again while
+    // handling a stack overflow).
+    //
+    uint64_t WARN_UNUSED NO_INLINE GrowStackForFunctionEntry(TValue* frameEnd);
+
+    // Make sure that 'numSlots' slots starting at 'base' are usable, committing more stack if needed.
+    // Returns false if this would exceed the stack limit.
+    //
+    bool WARN_UNUSED TryEnsureStackSpace(TValue* base, size_t numSlots)
+    {
+        Assert(m_stackBegin <= base);
+        if (likely(numSlots <= x_stackLimitMarginSlots && base <= m_stackLimit))
+        {
+            return true;
+        }
+        size_t offset = static_cast<size_t>(base - m_stackBegin);
+        if (offset + numSlots <= static_cast<size_t>(m_stackLimit - m_stackBegin))
+        {
+            return true;
+        }
+        if (numSlots > m_maxStackSlots || offset + numSlots > m_maxStackSlots)
+        {
+            return false;
+        }
+        CommitStack(offset + numSlots + x_stackLimitMarginSlots);
+        return true;
+    }
+
+    // Returns true if the stack slots before 'end' may be written without a stack check (see 'x_stackLimitMarginSlots')
+    //
+    bool WARN_UNUSED IsStackWritableWithoutCheck(TValue* end)
+    {
+        return m_stackBegin <= end && end <= m_stackLimit + x_stackLimitMarginSlots;
+    }
+
+    // Called when an error is caught: if the stack limit was raised to handle a stack overflow, lower it back
+    //
+    void ResetStackLimitAfterError()
+    {
+        UpdateStackLimit();
+    }
+
     uint32_t m_hiddenClass;  // Always x_hiddenClassForCoroutineRuntimeContext
     HeapEntityType m_type;
     GcCellState m_cellState;
@@ -134,7 +243,9 @@ public:
     //
     TValue* m_variadicRetStart;
     uint32_t m_numVariadicRets;
-    uint32_t m_unused1;
+    // The size of the reserved range of the stack in number of slots (page aligned)
+    //
+    uint32_t m_numStackSlots;
 
     // The linked list head of the list of open upvalues
     //
@@ -144,6 +255,12 @@ public:
     //
     UserHeapPointer<TableObject> m_globalObject;
 
+    // Every function entry checks that the stack frame of the callee ends at or below this address.
+    // This is the end of the committed stack (minus x_stackLimitMarginSlots), capped by the stack limit of the coroutine
+    // (or the raised stack limit, when handling a stack overflow).
+    //
+    TValue* m_stackLimit;
+
     // A temporary buffer used by DFG JIT code to pass values between JIT code and AOT slow path
     // This buffer should come before the "cold" members of this struct, so we can index this with disp8 addressing mode
     // as much as possible, which saves a bit of DFG JIT code size.
@@ -173,6 +290,30 @@ public:
     // The beginning of the stack
     //
     TValue* m_stackBegin;
+
+    // The number of committed stack slots (page aligned), the stack slots beyond it up to m_numStackSlots are reserved but inaccessible
+    //
+    uint32_t m_numCommittedStackSlots;
+
+    // The stack limit in number of slots
+    //
+    uint32_t m_maxStackSlots;
+
+private:
+    // Allocate and initialize the coroutine object, the caller should set up the stack
+    //
+    static CoroutineRuntimeContext* WARN_UNUSED CreateWithoutStack(VM* vm, UserHeapPointer<TableObject> globalObject);
+
+    // Make sure at least 'numSlots' slots are committed, and update the stack limit
+    //
+    void CommitStack(size_t numSlots);
+
+    void UpdateStackLimit()
+    {
+        Assert(m_numCommittedStackSlots > x_stackLimitMarginSlots);
+        size_t limit = std::min(static_cast<size_t>(m_numCommittedStackSlots) - x_stackLimitMarginSlots, static_cast<size_t>(m_maxStackSlots));
+        m_stackLimit = m_stackBegin + limit;
+    }
 };
 
 UserHeapPointer<TableObject> CreateGlobalObject(VM* vm);
@@ -358,8 +499,6 @@ static_assert(sizeof(JitCallInlineCacheEntry) == 24);
 //
 struct __attribute__((__packed__, __aligned__(1))) JitCallInlineCacheSite
 {
-    static constexpr size_t x_maxEntries = x_maxJitCallInlineCacheEntries;
-
     // Try to keep this a zero initialization to avoid unnecessary work..
     //
     JitCallInlineCacheSite()
@@ -411,7 +550,15 @@ struct __attribute__((__packed__, __aligned__(1))) JitCallInlineCacheSite
         return m_numEntries == 1 && m_mode != Mode::ClosureCallWithMoreThanOneTargetObserved;
     }
 
-    // May only be called if m_numEntries < x_maxEntries and m_mode == DirectCall
+    // Once the site holds the maximum number of IC entries allowed by the VM, it is megamorphic:
+    // no more IC entries will be created, and IC misses are dispatched through the megamorphic path
+    //
+    bool WARN_UNUSED IsMegamorphic()
+    {
+        return m_numEntries >= VM::VM_GetMaxJitCallInlineCacheEntries();
+    }
+
+    // May only be called if !IsMegamorphic() and m_mode == DirectCall
     // This function handles everything except actually JIT'ting code
     //
     // Returns the address to populate JIT code
@@ -424,7 +571,7 @@ struct __attribute__((__packed__, __aligned__(1))) JitCallInlineCacheSite
     //
     __attribute__((__malloc__)) void* WARN_UNUSED InsertInDirectCallMode(uint16_t dcIcTraitKind, TValue tv, uint8_t* transitedToCCMode /*out*/);
 
-    // May only be called if m_numEntries < x_maxEntries and m_mode != DirectCall
+    // May only be called if !IsMegamorphic() and m_mode != DirectCall
     // This function handles everything except actually JIT'ting code
     //
     // Returns the address to populate JIT code
@@ -432,6 +579,16 @@ struct __attribute__((__packed__, __aligned__(1))) JitCallInlineCacheSite
     // Note that the passed in IcTraitKind is the DC one, not the CC one!
     //
     __attribute__((__malloc__)) void* WARN_UNUSED InsertInClosureCallMode(uint16_t dcIcTraitKind, TValue tv);
+
+private:
+    void UpdateStatisticsIfBecameMegamorphic(VM* vm)
+    {
+        if (unlikely(m_numEntries == vm->GetMaxJitCallInlineCacheEntries()))
+        {
+            vm->GetJitCallIcStatistics().m_numSitesBecameMegamorphic++;
+            vm->RecordEventAtJitIcSite(VMEventKind::CallIcBecameMegamorphic, this, 0 /*arg*/);
+        }
+    }
 };
 static_assert(sizeof(JitCallInlineCacheSite) == 8);
 static_assert(alignof(JitCallInlineCacheSite) == 1);
@@ -440,6 +597,33 @@ class UnlinkedCodeBlock;
 class BaselineCodeBlock;
 class DfgCodeBlock;
 
+// The OSR exits of DFG code at each bytecode of a function, kept across DFG recompilations of the function
+//
+// The exits are attributed to the function and bytecode that the exit destination belongs to, so an exit
+// in a function inlined into another function is recorded in the profile of the inlined function.
+// When a function is (re)compiled to DFG, the speculations made at the bytecodes that exited too often are widened.
+//
+struct DfgOsrExitProfile
+{
+    struct Site
+    {
+        uint32_t m_numExits;
+        // The union of the types of the values that failed the speculation at this bytecode, tBoxedValueTop if not known
+        //
+        TypeMaskTy m_exitValueTypeMask;
+    };
+
+    // Returns nullptr if there is no OSR exit at this bytecode
+    //
+    Site* WARN_UNUSED GetSite(size_t bytecodeIndex)
+    {
+        auto it = m_sites.find(SafeIntegerCast<uint32_t>(bytecodeIndex));
+        return (it == m_sites.end()) ? nullptr : &it->second;
+    }
+
+    std::unordered_map<uint32_t /*bytecodeIndex*/, Site> m_sites;
+};
+
 // This uniquely corresponds to each pair of <UnlinkedCodeBlock, GlobalObject>
 // It owns the bytecode and the corresponding metadata (the bytecode is copied from the UnlinkedCodeBlock,
 // we need our own copy because we do quickening, aka., dynamic bytecode opcode specialization optimization)
@@ -494,6 +678,13 @@ public:
     BaselineCodeBlock* m_baselineCodeBlock;
     DfgCodeBlock* m_dfgCodeBlock;
 
+    // nullptr if DFG code has never OSR exited into this function
+    //
+    DfgOsrExitProfile* m_dfgOsrExitProfile;
+    // The number of times the DFG code of this function has been jettisoned, see VM::ShouldAllowDfgCompilation
+    //
+    uint32_t m_numDfgJettisons;
+
     UnlinkedCodeBlock* m_owner;
 
     // All JIT call inline caches that cache on this CodeBlock, chained into a circular doubly linked list
@@ -527,6 +718,7 @@ public:
         ucb->m_parent = nullptr;
         ucb->m_defaultCodeBlock = nullptr;
         ucb->m_parserUVGetFixupList = nullptr;
+        ucb->m_lineDefined = 0;
         return ucb;
     }
 
@@ -590,6 +782,9 @@ public:
     uint32_t m_numUpvalues;
     uint32_t m_bytecodeMetadataLength;
     uint32_t m_stackFrameNumSlots;
+    // The line where the function is defined in the source code, 0 for the main chunk
+    //
+    uint32_t m_lineDefined;
 
     // Only used during parsing. Always nullptr at runtime.
     // It doesn't have to sit in this struct but the memory consumption of this struct simply shouldn't matter.
@@ -721,6 +916,17 @@ public:
     //
     uint32_t m_maxObservedNumVariadicArgs;
 
+    // Set to 1 by the JIT'ed function entry every time the function is called, and cleared by each JIT code eviction scan.
+    // This field needs to be accessed from LLVM, so use uint8_t to avoid ABI issues
+    //
+    uint8_t m_calledSinceLastEvictionScan;
+    uint8_t m_unused1;
+
+    // The number of consecutive eviction scans that observed no call to this function, saturated at UINT16_MAX
+    // Functions with a larger value are colder, and are evicted first.
+    //
+    uint16_t m_numEvictionScansWithoutCall;
+
     // Currently the JIT code is layouted as follow:
     //     [ Data Section ] [ FastPath Code ] [ SlowPath Code ]
     //
@@ -776,6 +982,10 @@ public:
     uint32_t m_jitRegionSize;
     uint32_t m_slowPathDataStreamLength;
 
+    // The number of OSR exits from this DFG code, the code is jettisoned when it exceeds the threshold (see VM::RecordDfgOsrExit)
+    //
+    uint64_t m_numOsrExits;
+
     uint8_t m_slowPathData[0];
 };
 
@@ -789,8 +999,7 @@ public:
         VM* vm = VM::GetActiveVMForCurrentThread();
         HeapPtr<Upvalue> r = vm->AllocFromUserHeap(static_cast<uint32_t>(sizeof(Upvalue))).AsNoAssert<Upvalue>();
         UserHeapGcObjectHeader::Populate(r);
-        r->m_hiddenClass.m_value = x_hiddenClassForUpvalue;
-        r->m_ptr = dst;
+        r->m_ptr = EncodeValuePtr(dst);
         r->m_isClosed = false;
         r->m_isImmutable = isImmutable;
         TCSet(r->m_prev, prev);
@@ -805,8 +1014,7 @@ public:
         HeapPtr<Upvalue> r = vm->AllocFromUserHeap(static_cast<uint32_t>(sizeof(Upvalue))).AsNoAssert<Upvalue>();
         Upvalue* raw = TranslateToRawPointer(vm, r);
         UserHeapGcObjectHeader::Populate(raw);
-        raw->m_hiddenClass.m_value = x_hiddenClassForUpvalue;
-        raw->m_ptr = &raw->m_tv;
+        raw->m_ptr = EncodeValuePtr(&raw->m_tv);
         raw->m_tv = val;
         raw->m_isClosed = true;
         raw->m_isImmutable = false;
@@ -815,7 +1023,8 @@ public:
 
     static HeapPtr<Upvalue> WARN_UNUSED Create(CoroutineRuntimeContext* rc, TValue* dst, bool isImmutable)
     {
-        if (rc->m_upvalueList.m_value == 0 || rc->m_upvalueList.As()->m_ptr < dst)
+        int32_t dstVal = EncodeValuePtr(dst);
+        if (rc->m_upvalueList.m_value == 0 || rc->m_upvalueList.As()->m_ptr < dstVal)
         {
             // Edge case: the open upvalue list is empty, or the upvalue shall be inserted as the first element in the list
             //
@@ -829,13 +1038,13 @@ public:
             // Invariant: after the loop, the node shall be inserted between 'cur' and 'prev'
             //
             HeapPtr<Upvalue> cur = rc->m_upvalueList.As();
-            TValue* curVal = cur->m_ptr;
+            int32_t curVal = cur->m_ptr;
             UserHeapPointer<Upvalue> prev;
             while (true)
             {
                 Assert(!cur->m_isClosed);
-                Assert(dst <= curVal);
-                if (curVal == dst)
+                Assert(dstVal <= curVal);
+                if (curVal == dstVal)
                 {
                     // We found an open upvalue for that slot, we are good
                     //
@@ -851,9 +1060,9 @@ public:
                 }
 
                 Assert(!prev.As()->m_isClosed);
-                TValue* prevVal = prev.As()->m_ptr;
+                int32_t prevVal = prev.As()->m_ptr;
                 Assert(prevVal < curVal);
-                if (prevVal < dst)
+                if (prevVal < dstVal)
                 {
                     // prevVal < dst < curVal, so we found the insertion location
                     //
@@ -866,8 +1075,8 @@ public:
 
             Assert(curVal == cur->m_ptr);
             Assert(prev == TCGet(cur->m_prev));
-            Assert(dst < curVal);
-            Assert(prev.m_value == 0 || prev.As()->m_ptr < dst);
+            Assert(dstVal < curVal);
+            Assert(prev.m_value == 0 || prev.As()->m_ptr < dstVal);
             HeapPtr<Upvalue> newNode = CreateUpvalueImpl(prev, dst, isImmutable);
             TCSet(cur->m_prev, UserHeapPointer<Upvalue>(newNode));
             WriteBarrier(cur);
@@ -875,50 +1084,73 @@ public:
         }
     }
 
+    // Note that for open upvalue, 'm_prev' shares storage with 'm_tv', so the caller must read 'm_prev' before closing the upvalue
+    //
     void Close()
     {
         Assert(!m_isClosed);
-        Assert(m_ptr != &m_tv);
-        m_tv = *m_ptr;
-        m_ptr = &m_tv;
+        Assert(m_ptr != EncodeValuePtr(&m_tv));
+        TValue val = TCGet(*GetValuePtr());
+        m_tv = val;
+        m_ptr = EncodeValuePtr(&m_tv);
         m_isClosed = true;
     }
 
-    static constexpr int32_t x_hiddenClassForUpvalue = 0x18;
+    // Returns the pointer to the value of this upvalue, which is either the stack slot (open upvalue) or 'm_tv' (closed upvalue)
+    //
+    HeapPtr<TValue> ALWAYS_INLINE GetValuePtr() const
+    {
+        return reinterpret_cast<HeapPtr<TValue>>(SignExtendTo<int64_t>(m_ptr) << x_valuePtrShift);
+    }
+
+    // Encode a pointer into the VM memory range to the 32-bit format stored in 'm_ptr'.
+    // Since the VM base is 32GB aligned, this does not need to know the VM base address.
+    //
+    template<typename T>
+    static int32_t WARN_UNUSED ALWAYS_INLINE EncodeValuePtr(T ptr)
+    {
+        static_assert(IsPtrOrHeapPtr<T, TValue>);
+        return BitwiseTruncateTo<int32_t>(SignExtendedShiftRight(reinterpret_cast<intptr_t>(ptr), x_valuePtrShift));
+    }
+
+    static constexpr uint32_t x_valuePtrShift = 3;
 
-    // TODO: we could have made this structure 16 bytes instead of 32 bytes by making m_ptr a GeneralHeapPointer and takes the place of m_hiddenClass
-    // (normally this is a bit risky as it might confuse all sort of things (like IC), but upvalue is so special: it is never exposed to user,
-    // so an Upvalue object will never be used as operand into any bytecode instruction other than the upvalue-dedicated ones, so we are fine).
-    // However, we are not doing this now because our stack is currently not placed in the VM memory range.
+    // Points to 'm_tv' for closed upvalue, or the stack slot for open upvalue, in the same encoding as GeneralHeapPointer
+    // (the offset from the VM base shifted right by 3). This works because coroutine stacks live in the VM memory range.
+    // All the open values are chained into a linked list (through prev) in reverse sorted order of m_ptr (i.e. absolute stack slot from high to low)
     //
-    SystemHeapPointer<void> m_hiddenClass;
+    // This field takes the place of the hidden class in the object header. This is fine because upvalue is never exposed to user,
+    // so an Upvalue object will never be used as operand into any bytecode instruction other than the upvalue-dedicated ones.
+    //
+    int32_t m_ptr;
     HeapEntityType m_type;
     GcCellState m_cellState;
-    // Always equal to (m_ptr == &m_u.tv)
+    // Always equal to (m_ptr == EncodeValuePtr(&m_tv))
     //
     bool m_isClosed;
     bool m_isImmutable;
 
-    // Points to &tv for closed upvalue, or the stack slot for open upvalue
-    // All the open values are chained into a linked list (through prev) in reverse sorted order of m_ptr (i.e. absolute stack slot from high to low)
-    //
-    TValue* m_ptr;
-    // Stores the value for closed upvalue
-    //
-    TValue m_tv;
-    // Stores the linked list if the upvalue is open
-    //
-    UserHeapPointer<Upvalue> m_prev;
+    union
+    {
+        // Stores the value for closed upvalue
+        //
+        TValue m_tv;
+        // Stores the linked list if the upvalue is open
+        //
+        UserHeapPointer<Upvalue> m_prev;
+    };
 };
-static_assert(sizeof(Upvalue) == 32);
+static_assert(sizeof(Upvalue) == 16);
+static_assert(offsetof_member_v<&Upvalue::m_ptr> == offsetof_member_v<&UserHeapGcObjectHeader::m_hiddenClass>);
 
 inline void CoroutineRuntimeContext::CloseUpvalues(TValue* base)
 {
     VM* vm = VM::GetActiveVMForCurrentThread();
+    int32_t baseVal = Upvalue::EncodeValuePtr(base);
     UserHeapPointer<Upvalue> cur = m_upvalueList;
     while (cur.m_value != 0)
     {
-        if (cur.As()->m_ptr < base)
+        if (cur.As()->m_ptr < baseVal)
         {
             break;
         }
@@ -935,6 +1167,19 @@ inline void CoroutineRuntimeContext::CloseUpvalues(TValue* base)
     }
 }
 
+inline void CoroutineRuntimeContext::ReleaseStackOfDeadCoroutine(VM* vm)
+{
+    Assert(m_coroutineStatus.IsDead());
+    Assert(m_stackBegin != nullptr);
+    // Open upvalues point into the stack, so they must be closed before the stack can be reused
+    //
+    CloseUpvalues(m_stackBegin);
+    Assert(m_upvalueList.m_value == 0);
+    vm->FreeCoroutineStack(m_stackBegin, m_numStackSlots * sizeof(TValue), m_numCommittedStackSlots * sizeof(TValue));
+    m_stackBegin = nullptr;
+    m_stackLimit = nullptr;
+}
+
 class FunctionObject
 {
 public:
@@ -1026,7 +1271,7 @@ public:
         else
         {
             Upvalue* uv = GetMutableUpvaluePtr(self, ord);
-            return *uv->m_ptr;
+            return TCGet(*uv->GetValuePtr());
         }
     }
 
@@ -82,11 +82,39 @@ public:
     static StructureTransitionTable* AllocateUninitialized(VM* vm, uint32_t hashTableSize)
     {
         uint32_t allocationSize = ComputeAllocationSize(hashTableSize);
-        StructureTransitionTable* result = TranslateToRawPointer(vm, vm->AllocFromSystemHeap(allocationSize).As<StructureTransitionTable>());
+        VM::StructureStatistics& stats = vm->GetStructureStatistics();
+        SystemHeapPointer<StructureTransitionTable>& freeList = vm->GetStructureTransitionTableFreeList(hashTableSize);
+        StructureTransitionTable* result;
+        if (freeList.m_value != 0)
+        {
+            // Reuse a table of the same size that has been replaced by an expanded table, see Free()
+            //
+            result = TranslateToRawPointer(vm, freeList.As());
+            Assert(result->m_hashTableMask == hashTableSize - 1);
+            freeList.m_value = result->m_numElementsInHashTable;
+            stats.m_transitionTableBytesReused += allocationSize;
+        }
+        else
+        {
+            result = TranslateToRawPointer(vm, vm->AllocFromSystemHeap(allocationSize).As<StructureTransitionTable>());
+            stats.m_numTransitionTables++;
+            stats.m_transitionTableBytes += allocationSize;
+        }
         ConstructInPlace(result);
         return result;
     }
 
+    // Put a table that is no longer referenced into the free list of its size, so its memory can be reused by a later table.
+    // The system heap is never freed, and without this, every expansion would leave the old table as garbage.
+    // The free list is linked through m_numElementsInHashTable, and m_hashTableMask is kept for assertion.
+    //
+    static void Free(VM* vm, StructureTransitionTable* table)
+    {
+        SystemHeapPointer<StructureTransitionTable>& freeList = vm->GetStructureTransitionTableFreeList(table->m_hashTableMask + 1);
+        table->m_numElementsInHashTable = freeList.m_value;
+        freeList = table;
+    }
+
     static StructureTransitionTable* AllocateInitialTable(VM* vm, int32_t key, SystemHeapPointer<Structure> value)
     {
         StructureTransitionTable* r = AllocateUninitialized(vm, x_initialHashTableSize);
@@ -371,6 +399,8 @@ struct ButterflyNamedStorageGrowthPolicy
 //
 // Future work: we can use one structure to store a chain of PropertyAdd transitions (and user
 // use pointer tag to distinguish which node in the chain it is referring to). This should further reduce memory consumption.
+// This is not implemented yet. The tagged pointer would still have to be a valid IC key, since the ICs of all tiers
+// compare and dereference the Structure pointer directly. VM::StructureStatistics reports how much memory it could save.
 //
 // [ hash table ] [ header ] [ non-full block elements ] [ optional last full block pointer ]
 //                ^
@@ -897,7 +927,9 @@ public:
                     StructureTransitionTable* newTable = table->Expand(vm);
                     m_transitionTable.Store(SystemHeapPointer<StructureTransitionTable>(newTable));
                     Assert(!newTable->ShouldResizeForThisInsertion());
-                    // FIXME: delete old table!
+                    // The old table is only referenced by us, so it can be recycled now
+                    //
+                    StructureTransitionTable::Free(vm, table);
                 }
 
                 return newStructure;
@@ -1225,45 +1257,117 @@ UserHeapPointer<void> WARN_UNUSED GetPolyMetatableFromObjectWithStructureHiddenC
 class CacheableDictionary final : public SystemHeapGcObjectHeader
 {
 public:
-    ~CacheableDictionary()
+    // The hash table of a CacheableDictionary, allocated in the system heap
+    //
+    // The keys and the slot ordinals are stored in two separate arrays (keys first, then slots, both of the hash table size),
+    // so the probing only walks the dense key array, and a cache line holds 16 keys instead of 8 key-slot pairs.
+    //
+    // The hash table may be shared by multiple CacheableDictionaries: Clone() shares it copy-on-write,
+    // and whoever modifies a shared hash table first copies it (see UnshareHashTable).
+    //
+    struct HashTable
     {
-        if (m_hashTable != nullptr)
+        static uint32_t ComputeAllocationSize(uint32_t hashTableSize)
         {
-            delete [] m_hashTable;
+            size_t size = sizeof(HashTable) + (sizeof(GeneralHeapPointer<void>) + sizeof(uint32_t)) * hashTableSize;
+            return SafeIntegerCast<uint32_t>(RoundUpToMultipleOf<8>(size));
         }
-    }
 
-    struct HashTableEntry
-    {
-        GeneralHeapPointer<void> m_key;
-        uint32_t m_slot;
+        GeneralHeapPointer<void>* GetKeys() { return m_keys; }
+        uint32_t* GetSlots(uint32_t hashTableSize) { return reinterpret_cast<uint32_t*>(m_keys + hashTableSize); }
+
+        // The number of CacheableDictionaries using this hash table
+        // When the hash table is in the VM free list, this is the link to the next hash table in the free list instead
+        //
+        uint32_t m_refCount;
+        uint32_t m_unused;
+        GeneralHeapPointer<void> m_keys[0];
     };
-    static_assert(sizeof(HashTableEntry) == 8);
+    static_assert(sizeof(HashTable) == 8);
+
+    // The smallest hash table we create, the load factor is kept under 1/2
+    //
+    static constexpr uint32_t x_minHashTableSize = 16;
 
     // Create an empty CacheableDictionary with expected 'numSlots' properties and specified inline storage capacity
     //
     static CacheableDictionary* WARN_UNUSED CreateEmptyDictionary(VM* vm, uint32_t anticipatedNumSlots, uint8_t inlineCapacity, bool shouldNeverTransitToUncacheableDictionary)
     {
         CacheableDictionary* r = TranslateToRawPointer(vm, vm->AllocFromSystemHeap(sizeof(CacheableDictionary)).AsNoAssert<CacheableDictionary>());
+        vm->GetStructureStatistics().m_numCacheableDictionaries++;
         SystemHeapGcObjectHeader::Populate(r);
         r->m_shouldNeverTransitToUncacheableDictionary = shouldNeverTransitToUncacheableDictionary;
         r->m_inlineNamedStorageCapacity = inlineCapacity;
         r->m_butterflyNamedStorageCapacity = 0;
-        uint32_t hashTableMask = RoundUpToPowerOfTwo(anticipatedNumSlots) * 2 - 1;
-        hashTableMask = std::max(hashTableMask, 127U);
-        r->m_hashTableMask = hashTableMask;
+        uint32_t hashTableSize = std::max(RoundUpToPowerOfTwo(std::max(anticipatedNumSlots, 1U)) * 2, x_minHashTableSize);
+        r->m_hashTableMask = hashTableSize - 1;
         r->m_slotCount = 0;
-        r->m_hashTable = new HashTableEntry[hashTableMask + 1];
+        r->m_hashTable = AllocateEmptyHashTable(vm, hashTableSize);
         r->m_metatable.m_value = 0;
-        memset(r->m_hashTable, 0, sizeof(HashTableEntry) * (hashTableMask + 1));
         return r;
     }
 
+    // Allocate an empty hash table, reusing a freed hash table of the same size if possible
+    //
+    static HashTable* WARN_UNUSED AllocateEmptyHashTable(VM* vm, uint32_t hashTableSize)
+    {
+        Assert(is_power_of_2(hashTableSize) && hashTableSize >= x_minHashTableSize);
+        uint32_t allocationSize = HashTable::ComputeAllocationSize(hashTableSize);
+        SystemHeapPointer<void>& freeList = vm->GetCacheableDictionaryHashTableFreeList(hashTableSize);
+        HashTable* ht;
+        if (freeList.m_value != 0)
+        {
+            ht = TranslateToRawPointer(vm, freeList.As<HashTable>());
+            freeList.m_value = ht->m_refCount;
+        }
+        else
+        {
+            ht = TranslateToRawPointer(vm, vm->AllocFromSystemHeap(allocationSize).As<HashTable>());
+            vm->GetStructureStatistics().m_numDictionaryHashTables++;
+            vm->GetStructureStatistics().m_dictionaryHashTableBytes += allocationSize;
+        }
+        ht->m_refCount = 1;
+        ht->m_unused = 0;
+        memset(ht->GetKeys(), 0, sizeof(GeneralHeapPointer<void>) * hashTableSize);
+        return ht;
+    }
+
+    // Drop one reference to the hash table, and put it into the free list of its size if it is no longer used.
+    // The system heap is never freed, so this is how the memory of a hash table replaced by resize is reused.
+    //
+    static void ReleaseHashTable(VM* vm, HashTable* ht, uint32_t hashTableSize)
+    {
+        Assert(ht->m_refCount > 0);
+        ht->m_refCount--;
+        if (ht->m_refCount > 0)
+        {
+            return;
+        }
+        SystemHeapPointer<void>& freeList = vm->GetCacheableDictionaryHashTableFreeList(hashTableSize);
+        ht->m_refCount = freeList.m_value;
+        freeList = SystemHeapPointer<void>(ht);
+    }
+
+    // Give this dictionary its own copy of the hash table, must be called before modifying a shared hash table
+    //
+    void NO_INLINE UnshareHashTable()
+    {
+        Assert(m_hashTable->m_refCount > 1);
+        VM* vm = VM::GetActiveVMForCurrentThread();
+        uint32_t hashTableSize = m_hashTableMask + 1;
+        HashTable* newHt = AllocateEmptyHashTable(vm, hashTableSize);
+        memcpy(newHt->GetKeys(), m_hashTable->GetKeys(), (sizeof(GeneralHeapPointer<void>) + sizeof(uint32_t)) * hashTableSize);
+        ReleaseHashTable(vm, m_hashTable, hashTableSize);
+        m_hashTable = newHt;
+        vm->GetStructureStatistics().m_numDictionaryHashTablesUnshared++;
+    }
+
     // FIXME: we need to think about the GC story and interaction with IC here
     //
     CacheableDictionary* WARN_UNUSED RelocateForAddingOrRemovingMetatable(VM* vm)
     {
         CacheableDictionary* r = TranslateToRawPointer(vm, vm->AllocFromSystemHeap(sizeof(CacheableDictionary)).AsNoAssert<CacheableDictionary>());
+        vm->GetStructureStatistics().m_numCacheableDictionaries++;
         // m_metatable field is intentionally not populated because it shall be populated by our caller
         //
         SystemHeapGcObjectHeader::Populate(r);
@@ -1274,6 +1378,7 @@ public:
         r->m_slotCount = m_slotCount;
         r->m_hashTable = m_hashTable;
         // Since CacheableDictionary and object is 1-on-1, 'this' will never be used anymore, so just have the new dictionary steal our hash table
+        // (and our reference to it, if it is shared)
         //
         m_hashTable = nullptr;
         return r;
@@ -1282,14 +1387,19 @@ public:
     CacheableDictionary* WARN_UNUSED Clone(VM* vm)
     {
         CacheableDictionary* r = TranslateToRawPointer(vm, vm->AllocFromSystemHeap(sizeof(CacheableDictionary)).AsNoAssert<CacheableDictionary>());
+        vm->GetStructureStatistics().m_numCacheableDictionaries++;
         SystemHeapGcObjectHeader::Populate(r);
         r->m_shouldNeverTransitToUncacheableDictionary = m_shouldNeverTransitToUncacheableDictionary;
         r->m_inlineNamedStorageCapacity = m_inlineNamedStorageCapacity;
         r->m_butterflyNamedStorageCapacity = m_butterflyNamedStorageCapacity;
         r->m_hashTableMask = m_hashTableMask;
         r->m_slotCount = m_slotCount;
-        r->m_hashTable = new HashTableEntry[m_hashTableMask + 1];
-        memcpy(r->m_hashTable, m_hashTable, sizeof(HashTableEntry) * (m_hashTableMask + 1));
+        // The hash table is shared copy-on-write: the clone (e.g., by TableDup) is often only read, or modified only after
+        // many reads, so copying it eagerly is a waste
+        //
+        r->m_hashTable = m_hashTable;
+        m_hashTable->m_refCount++;
+        vm->GetStructureStatistics().m_numDictionaryHashTablesShared++;
         r->m_metatable = m_metatable;
         return r;
     }
@@ -1415,15 +1525,17 @@ public:
     //
     void InsertNonExistentPropertyForInitOrResize(UserHeapPointer<void> prop, uint32_t propHash, uint32_t slotOrdinal)
     {
+        Assert(m_hashTable->m_refCount == 1);
         size_t htMask = m_hashTableMask;
+        GeneralHeapPointer<void>* keys = m_hashTable->GetKeys();
         size_t slot = propHash & htMask;
-        while (m_hashTable[slot].m_key.m_value != 0)
+        while (keys[slot].m_value != 0)
         {
-            Assert(m_hashTable[slot].m_key.As() != prop.As());
+            Assert(keys[slot].As() != prop.As());
             slot = (slot + 1) & htMask;
         }
-        m_hashTable[slot].m_key = prop.As();
-        m_hashTable[slot].m_slot = slotOrdinal;
+        keys[slot] = prop.As();
+        m_hashTable->GetSlots(m_hashTableMask + 1)[slot] = slotOrdinal;
     }
 
     // After an insertion, resize the hash table if needed. Return true if the hash table is resized.
@@ -1449,29 +1561,29 @@ public:
         uint32_t oldMask = m_hashTableMask;
         uint32_t newMask = oldMask * 2 + 1;
         ReleaseAssert(newMask < std::numeric_limits<uint32_t>::max());
-        m_hashTableMask = newMask;
 
-        HashTableEntry* oldHt = m_hashTable;
-        m_hashTable = new HashTableEntry[newMask + 1];
-        memset(m_hashTable, 0, sizeof(HashTableEntry) * (newMask + 1));
+        // Note that the old hash table may be shared with other dictionaries, in which case it is not modified
+        //
+        VM* vm = VM::GetActiveVMForCurrentThread();
+        HashTable* oldHt = m_hashTable;
+        m_hashTableMask = newMask;
+        m_hashTable = AllocateEmptyHashTable(vm, newMask + 1);
 
         DEBUG_ONLY([[maybe_unused]] uint32_t cnt = 0;)
-        HashTableEntry* oldHtEnd = oldHt + oldMask + 1;
-        HashTableEntry* curEntry = oldHt;
-        while (curEntry < oldHtEnd)
+        GeneralHeapPointer<void>* oldKeys = oldHt->GetKeys();
+        uint32_t* oldSlots = oldHt->GetSlots(oldMask + 1);
+        for (uint32_t i = 0; i <= oldMask; i++)
         {
-            if (curEntry->m_key.m_value != 0)
+            if (oldKeys[i].m_value != 0)
             {
-                UserHeapPointer<void> key = curEntry->m_key.As();
-                uint32_t keySlot = curEntry->m_slot;
-                InsertNonExistentPropertyForInitOrResize(key, StructureKeyHashHelper::GetHashValueForMaybeNonStringKey(key), keySlot);
+                UserHeapPointer<void> key = oldKeys[i].As();
+                InsertNonExistentPropertyForInitOrResize(key, StructureKeyHashHelper::GetHashValueForMaybeNonStringKey(key), oldSlots[i]);
                 DEBUG_ONLY(cnt++;)
             }
-            curEntry++;
         }
         Assert(cnt == m_slotCount);
 
-        delete [] oldHt;
+        ReleaseHashTable(vm, oldHt, oldMask + 1);
     }
 
     // Query the slot for a property
@@ -1481,11 +1593,13 @@ public:
     static bool WARN_UNUSED ALWAYS_INLINE GetSlotOrdinalFromPropertyImpl(T self, UserHeapPointer<void> prop, uint32_t propHash, size_t& slotForInsertion /*out*/, uint32_t& slotOrdinal /*out*/)
     {
         size_t hashMask = self->m_hashTableMask;
+        HashTable* ht = self->m_hashTable;
+        GeneralHeapPointer<void>* keys = ht->GetKeys();
         size_t slot = propHash & hashMask;
         GeneralHeapPointer<void> gprop = prop.As();
         while (true)
         {
-            GeneralHeapPointer<void> key = TCGet(self->m_hashTable[slot].m_key);
+            GeneralHeapPointer<void> key = keys[slot];
             if (key.m_value == 0)
             {
                 slotForInsertion = slot;
@@ -1493,7 +1607,7 @@ public:
             }
             if (key == gprop)
             {
-                slotOrdinal = self->m_hashTable[slot].m_slot;
+                slotOrdinal = ht->GetSlots(static_cast<uint32_t>(hashMask + 1))[slot];
                 return true;
             }
             slot = (slot + 1) & hashMask;
@@ -1506,11 +1620,12 @@ public:
     static uint32_t WARN_UNUSED GetHashTableSlotNumberForProperty(HeapPtr<CacheableDictionary> self, UserHeapPointer<void> prop)
     {
         size_t hashMask = self->m_hashTableMask;
+        GeneralHeapPointer<void>* keys = self->m_hashTable->GetKeys();
         size_t slot = StructureKeyHashHelper::GetHashValueForMaybeNonStringKey(prop) & hashMask;
         GeneralHeapPointer<void> gprop = prop.As();
         while (true)
         {
-            GeneralHeapPointer<void> key = TCGet(self->m_hashTable[slot].m_key);
+            GeneralHeapPointer<void> key = keys[slot];
             if (key.m_value == 0)
             {
                 return static_cast<uint32_t>(-1);
@@ -1571,9 +1686,15 @@ public:
         }
 
         // insert into hash table
+        // If the hash table is shared, copy it first. The copy has the same layout, so 'slotForInsertion' is still valid.
         //
-        TCSet(self->m_hashTable[slotForInsertion].m_key, GeneralHeapPointer<void>(prop.As()));
-        self->m_hashTable[slotForInsertion].m_slot = result.m_slot;
+        if (unlikely(self->m_hashTable->m_refCount > 1))
+        {
+            TranslateToRawPointer(self)->UnshareHashTable();
+        }
+        HashTable* ht = self->m_hashTable;
+        ht->GetKeys()[slotForInsertion] = GeneralHeapPointer<void>(prop.As());
+        ht->GetSlots(self->m_hashTableMask + 1)[slotForInsertion] = result.m_slot;
         self->m_slotCount++;
         result.m_shouldCheckForTransitionToUncacheableDictionary = ResizeIfNeeded(self);
     }
@@ -1597,7 +1718,7 @@ public:
     uint32_t m_butterflyNamedStorageCapacity;
     uint32_t m_hashTableMask;
     uint32_t m_slotCount;
-    HashTableEntry* m_hashTable;
+    HashTable* m_hashTable;
     // Whenever this value is changed from zero to non-zero, or from non-zero to zero, we must relocate the structure, otherwise we would break the IC!
     //
     UserHeapPointer<void> m_metatable;
@@ -1620,6 +1741,8 @@ inline StructureAnchorHashTable* WARN_UNUSED StructureAnchorHashTable::Create(VM
     uint32_t allocationSize = hashTableLengthBytes + static_cast<uint32_t>(OffsetOfTrailingVarLengthArray()) + trailingArrayLengthBytes;
     allocationSize = RoundUpToMultipleOf<8>(allocationSize);
     SystemHeapPointer<void> objectAddressStart = vm->AllocFromSystemHeap(allocationSize);
+    vm->GetStructureStatistics().m_numAnchorHashTables++;
+    vm->GetStructureStatistics().m_anchorHashTableBytes += allocationSize;
 
     // First, fill in the header
     //
@@ -2015,6 +2138,8 @@ end_setup:
     totalObjectLengthBytes = RoundUpToMultipleOf<8>(totalObjectLengthBytes);
 
     SystemHeapPointer<void> objectAddressStart = vm->AllocFromSystemHeap(totalObjectLengthBytes);
+    vm->GetStructureStatistics().m_numStructures++;
+    vm->GetStructureStatistics().m_structureBytes += totalObjectLengthBytes;
 
     // Populate the header
     //
@@ -2323,6 +2448,8 @@ inline Structure* WARN_UNUSED Structure::CreateInitialStructure(VM* vm, uint8_t
     totalObjectLengthBytes = RoundUpToMultipleOf<8>(totalObjectLengthBytes);
 
     SystemHeapPointer<void> objectAddressStart = vm->AllocFromSystemHeap(totalObjectLengthBytes);
+    vm->GetStructureStatistics().m_numStructures++;
+    vm->GetStructureStatistics().m_structureBytes += totalObjectLengthBytes;
 
     // Populate the structure
     //
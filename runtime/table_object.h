@@ -3,6 +3,7 @@
 #include "common_utils.h"
 #include "memory_ptr.h"
 #include "vm.h"
+#include "userdata_object.h"
 #include "structure.h"
 #include "butterfly.h"
 
@@ -1580,7 +1581,7 @@ public:
 
             if (needToGrowOrCreateButterfly)
             {
-                uint32_t newCapacity = ArrayGrowthPolicy::x_initialVectorPartCapacity;
+                uint32_t newCapacity = vm->GetOptions().m_arrayInitialVectorPartCapacity;
                 newCapacity = std::max(newCapacity, static_cast<uint32_t>(index + 1 - ArrayGrowthPolicy::x_arrayBaseOrd));
                 GrowButterfly<false /*isGrowNamedStorage*/>(newCapacity);
 
@@ -1656,10 +1657,10 @@ public:
                 }
 
                 // Figure out the new butterfly capacity
-                // By default we grow the capacity by x_vectorGrowthFactor (but do not exceed x_unconditionallySparseMapCutoff),
+                // By default we grow the capacity by the vector growth factor (but do not exceed x_unconditionallySparseMapCutoff),
                 // but if that's still not enough, we grow to just enough capacity to hold the index
                 //
-                uint32_t newCapacity = static_cast<uint32_t>(currentCapacity * ArrayGrowthPolicy::x_vectorGrowthFactor);
+                uint32_t newCapacity = static_cast<uint32_t>(currentCapacity * vm->GetOptions().m_arrayVectorGrowthFactor);
                 newCapacity = std::min(newCapacity, static_cast<uint32_t>(ArrayGrowthPolicy::x_unconditionallySparseMapCutoff));
                 newCapacity = std::max(newCapacity, static_cast<uint32_t>(index + 1 - ArrayGrowthPolicy::x_arrayBaseOrd));
 
@@ -1711,7 +1712,7 @@ public:
                     // We should probably make our growth strategy not depend on the initial butterfly size to fix this problem
                     // (and it's a good idea anyway once we have a real memory allocator). But for now let's be simple.
                     //
-                    uint64_t maxCapacityMaintainingMinimalDensity = nonNilCount * ArrayGrowthPolicy::x_densityCutoff;
+                    uint64_t maxCapacityMaintainingMinimalDensity = nonNilCount * vm->GetOptions().m_arrayDensityCutoff;
                     if (newCapacity > maxCapacityMaintainingMinimalDensity)
                     {
                         shouldPutToSparseMap = true;
@@ -2674,6 +2675,91 @@ public:
 };
 static_assert(sizeof(TableObject) == 16);
 
+// The allocation-site feedback of a TableNew bytecode
+//
+// The parser guesses the inline capacity and the array part size of the tables created by a TableNew from the table constructor,
+// but most objects are built up field by field after construction, so they go through several Structure transitions and
+// butterfly reallocations. The profile observes the size the objects from the site eventually reach, so later allocations
+// from the site (in every tier, since they all run the same TableNew logic) are presized to match.
+//
+// An object is observed when the next object from the same site is allocated, at which point it has usually been fully built.
+// After x_numObservations objects are observed, the profile is stable and stops observing, so the steady-state cost is
+// only a check of the profile on allocation.
+//
+// The profile is created by the parser and lives in the system heap. The TableNew bytecode references it by a pointer
+// in the constant table disguised as a TValue (which looks like a double, so it is never dereferenced as a TValue).
+//
+class TableAllocationSiteProfile
+{
+public:
+    static constexpr uint8_t x_numObservations = 8;
+
+    // Do not presize more than this many inline slots or array part slots, so one huge object does not bloat all objects from the site
+    //
+    static constexpr uint32_t x_maxPresizedInlineCapacity = 64;
+    static constexpr uint32_t x_maxPresizedArrayPartSize = 1024;
+    static_assert(x_maxPresizedArrayPartSize <= std::numeric_limits<uint16_t>::max());
+
+    static TableAllocationSiteProfile* WARN_UNUSED Create(VM* vm, uint8_t inlineStorageSizeStepping, uint16_t arrayPartSizeHint)
+    {
+        TableAllocationSiteProfile* r = TranslateToRawPointer(vm, vm->AllocFromSystemHeap(static_cast<uint32_t>(sizeof(TableAllocationSiteProfile))).AsNoAssert<TableAllocationSiteProfile>());
+        r->m_lastAllocatedObject = UserHeapPointer<TableObject>();
+        r->m_inlineStorageSizeStepping = inlineStorageSizeStepping;
+        r->m_numObservationsLeft = x_numObservations;
+        r->m_arrayPartSizeHint = arrayPartSizeHint;
+        return r;
+    }
+
+    bool WARN_UNUSED ALWAYS_INLINE IsObserving() { return m_numObservationsLeft > 0; }
+
+    // Observe the previously allocated object, and remember 'newObject' to be observed on the next allocation
+    //
+    void NO_INLINE ObserveAllocation(VM* vm, HeapPtr<TableObject> newObject)
+    {
+        Assert(IsObserving());
+        if (m_lastAllocatedObject.m_value != 0)
+        {
+            TableObject* obj = TranslateToRawPointer(vm, m_lastAllocatedObject.As());
+            HeapEntityType hcType = obj->m_hiddenClass.As<SystemHeapGcObjectHeader>()->m_type;
+            // Objects that became dictionaries are not going to benefit from presizing
+            //
+            if (hcType == HeapEntityType::Structure)
+            {
+                Structure* structure = TranslateToRawPointer(vm, obj->m_hiddenClass.As<Structure>());
+                uint32_t numSlots = std::min(static_cast<uint32_t>(structure->m_numSlots), x_maxPresizedInlineCapacity);
+                uint8_t stepping = Structure::GetInitialStructureSteppingForInlineCapacity(numSlots);
+                if (stepping > m_inlineStorageSizeStepping)
+                {
+                    // Create the structure now, so TableNew can call GetInitialStructureForSteppingKnowingAlreadyBuilt
+                    //
+                    std::ignore = Structure::GetInitialStructureForStepping(vm, stepping);
+                    m_inlineStorageSizeStepping = stepping;
+                }
+            }
+            if (obj->m_butterfly != nullptr && obj->m_arrayType.IsContinuous())
+            {
+                uint32_t arrayLength = static_cast<uint32_t>(obj->m_butterfly->GetHeader()->m_arrayLengthIfContinuous);
+                arrayLength = std::min(arrayLength, x_maxPresizedArrayPartSize);
+                if (arrayLength > m_arrayPartSizeHint)
+                {
+                    m_arrayPartSizeHint = static_cast<uint16_t>(arrayLength);
+                }
+            }
+            m_numObservationsLeft--;
+        }
+        m_lastAllocatedObject = IsObserving() ? UserHeapPointer<TableObject>(newObject) : UserHeapPointer<TableObject>();
+    }
+
+    // The object allocated by the previous TableNew from this site, null if none or if no longer observing
+    //
+    UserHeapPointer<TableObject> m_lastAllocatedObject;
+    // The inline storage size stepping and the array part size that objects from this site should be created with
+    //
+    uint8_t m_inlineStorageSizeStepping;
+    uint8_t m_numObservationsLeft;
+    uint16_t m_arrayPartSizeHint;
+};
+
 struct RawGetFromTableObjectResult
 {
     TValue m_value;
@@ -2735,8 +2821,8 @@ inline UserHeapPointer<void> GetMetatableForValue(TValue value)
             return VM::GetActiveVMForCurrentThread()->m_metatableForCoroutine;
         }
 
-        // TODO: support USERDATA type
-        ReleaseAssert(false && "unimplemented");
+        Assert(ty == HeapEntityType::Userdata);
+        return HeapCDataObject::GetMetatable(value.AsPointer<HeapCDataObject>().As());
     }
 
     if (value.IsMIV())
@@ -2811,8 +2897,8 @@ inline HeapPtr<FunctionObject> WARN_UNUSED NO_INLINE GetCallTargetViaMetatable(T
             return GetCallMetamethodFromMetatableImpl(VM::GetActiveVMForCurrentThread()->m_metatableForCoroutine);
         }
 
-        // TODO: support USERDATA type
-        ReleaseAssert(false && "unimplemented");
+        Assert(ty == HeapEntityType::Userdata);
+        return GetCallMetamethodFromMetatableImpl(HeapCDataObject::GetMetatable(value.As<tUserdata>()));
     }
 
     if (value.Is<tNil>())
@@ -2962,18 +3048,20 @@ try_get_next_structure_prop:
                 m_namedPropertyOrd++;
 
 try_find_and_get_cd_prop:
-                CacheableDictionary::HashTableEntry* ht = cacheableDict->m_hashTable;
+                CacheableDictionary::HashTable* ht = cacheableDict->m_hashTable;
                 uint32_t htMask = cacheableDict->m_hashTableMask;
+                GeneralHeapPointer<void>* htKeys = ht->GetKeys();
+                uint32_t* htSlots = ht->GetSlots(htMask + 1);
                 while (m_namedPropertyOrd <= htMask)
                 {
-                    CacheableDictionary::HashTableEntry& entry = ht[m_namedPropertyOrd];
-                    if (entry.m_key.m_value != 0)
+                    GeneralHeapPointer<void> entryKey = htKeys[m_namedPropertyOrd];
+                    if (entryKey.m_value != 0)
                     {
-                        TValue value = TableObject::GetValueForSlot(obj, entry.m_slot, cacheableDict->m_inlineNamedStorageCapacity);
+                        TValue value = TableObject::GetValueForSlot(obj, htSlots[m_namedPropertyOrd], cacheableDict->m_inlineNamedStorageCapacity);
                         if (!value.IsNil())
                         {
                             return KeyValuePair {
-                                .m_key = TValue::CreatePointer(UserHeapPointer<void>(entry.m_key.As())),
+                                .m_key = TValue::CreatePointer(UserHeapPointer<void>(entryKey.As())),
                                 .m_value = value
                             };
                         }
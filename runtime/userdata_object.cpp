@@ -0,0 +1,69 @@
+#include "userdata_object.h"
+#include "runtime_utils.h"
+
+HeapPtr<HeapCDataObject> WARN_UNUSED HeapCDataObject::GetLightUserdata(VM* vm, void* ptr)
+{
+    auto it = vm->m_lightUserdataMap->find(ptr);
+    if (it != vm->m_lightUserdataMap->end())
+    {
+        return it->second.As();
+    }
+
+    HeapPtr<HeapCDataObject> r = vm->AllocFromUserHeap(static_cast<uint32_t>(sizeof(HeapCDataObject))).AsNoAssert<HeapCDataObject>();
+    UserHeapGcObjectHeader::Populate(r);
+    r->m_hiddenClass = x_hiddenClassForUserdata;
+    r->m_kind = Kind::Light;
+    r->m_invalidArrayType = ArrayType::x_invalidArrayType;
+    TCSet(r->m_metatable, UserHeapPointer<void>());
+    r->m_typeTag = 0;
+    r->m_lengthOrPointer = reinterpret_cast<uint64_t>(ptr);
+    vm->m_lightUserdataMap->emplace(ptr, UserHeapPointer<HeapCDataObject>(r));
+    return r;
+}
+
+static void InsertFieldIntoTable(VM* vm, HeapPtr<TableObject> table, const char* propName, TValue value)
+{
+    UserHeapPointer<HeapString> hs = vm->CreateStringObjectFromRawCString(propName);
+    PutByIdICInfo icInfo;
+    TableObject::PreparePutById(table, hs /*prop*/, icInfo /*out*/);
+    TableObject::PutById(table, hs.As<void>(), value, icInfo);
+}
+
+NativeClassBuilder::NativeClassBuilder(VM* vm, uint32_t numMethods)
+    : m_vm(vm)
+    , m_methods(TableObject::CreateEmptyTableObject(vm, numMethods /*inlineCapacity*/, 0 /*initialButterflyArrayPartCapacity*/))
+    , m_metatable(TableObject::CreateEmptyTableObject(vm, 4 /*inlineCapacity*/, 0 /*initialButterflyArrayPartCapacity*/))
+    , m_finished(false)
+{ }
+
+NativeClassBuilder& NativeClassBuilder::AddMethod(const char* name, void* libFunc)
+{
+    Assert(!m_finished);
+    HeapPtr<FunctionObject> func = FunctionObject::CreateCFunc(m_vm, ExecutableCode::CreateCFunction(m_vm, libFunc)).As();
+    InsertFieldIntoTable(m_vm, m_methods.As(), name, TValue::Create<tFunction>(func));
+    return *this;
+}
+
+NativeClassBuilder& NativeClassBuilder::AddMetamethod(const char* name, void* libFunc)
+{
+    Assert(!m_finished);
+    Assert(strncmp(name, "__", 2) == 0);
+    HeapPtr<FunctionObject> func = FunctionObject::CreateCFunc(m_vm, ExecutableCode::CreateCFunction(m_vm, libFunc)).As();
+    InsertFieldIntoTable(m_vm, m_metatable.As(), name, TValue::Create<tFunction>(func));
+    return *this;
+}
+
+NativeClassBuilder& NativeClassBuilder::AddField(const char* name, TValue value)
+{
+    Assert(!m_finished);
+    InsertFieldIntoTable(m_vm, m_methods.As(), name, value);
+    return *this;
+}
+
+UserHeapPointer<TableObject> WARN_UNUSED NativeClassBuilder::Finish()
+{
+    Assert(!m_finished);
+    m_finished = true;
+    InsertFieldIntoTable(m_vm, m_metatable.As(), "__index", TValue::Create<tTable>(m_methods.As()));
+    return m_metatable;
+}
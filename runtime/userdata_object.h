@@ -0,0 +1,188 @@
+#pragma once
+
+#include "common_utils.h"
+#include "memory_ptr.h"
+#include "vm.h"
+
+class TableObject;
+
+// The type tag of the userdata created by the native binding API for native type 'T'
+//
+// The tag is the address of a per-type variable, so it is unique across the whole program without any registration,
+// and checking whether a userdata holds a 'T' is a single 64-bit comparison.
+//
+template<typename T>
+inline constexpr uint8_t x_userdataTypeTagAnchorFor = 0;
+
+template<typename T>
+uint64_t WARN_UNUSED GetUserdataTypeTag()
+{
+    return reinterpret_cast<uint64_t>(&x_userdataTypeTagAnchorFor<T>);
+}
+
+// A Lua userdata
+//
+// A full userdata owns a block of raw memory (the payload) that immediately follows the object header, and each full
+// userdata has its own metatable. A light userdata holds a native pointer, and all light userdata share one per-VM metatable,
+// same as in LuaJIT. Light userdata are interned per VM, so two light userdata holding the same pointer are the same heap
+// entity. This gives us the raw equality and table key semantics of Lua without any special case in the equality bytecodes
+// or in the table lookup logic.
+//
+// Each userdata also carries a type tag that identifies the native type of its payload (0 if unknown), see 'GetUserdataTypeTag'.
+//
+// Since we do not have a GC yet, the payload is never destructed, so only trivially destructible native types can be stored
+// in the payload. Native objects that own resources should be owned by the embedder, and the payload holds a pointer to them.
+//
+class alignas(8) HeapCDataObject
+{
+public:
+    static constexpr uint32_t x_hiddenClassForUserdata = 0x18;
+
+    enum class Kind : uint8_t
+    {
+        Full,
+        Light
+    };
+
+    // Common object header
+    //
+    uint32_t m_hiddenClass;         // always x_hiddenClassForUserdata
+    HeapEntityType m_type;          // always TypeEnumForHeapObject<HeapCDataObject>
+    GcCellState m_cellState;
+    Kind m_kind;
+    // Always ArrayType::x_invalidArrayType
+    //
+    uint8_t m_invalidArrayType;
+
+    // The metatable of a full userdata (0 if none)
+    // Unused for light userdata, whose metatable is VM::m_metatableForLightUserdata
+    //
+    UserHeapPointer<void> m_metatable;
+    uint64_t m_typeTag;
+    // For full userdata, the length of the payload. For light userdata, the native pointer.
+    //
+    uint64_t m_lengthOrPointer;
+    // The payload of a full userdata
+    //
+    alignas(8) uint8_t m_payload[0];
+
+    static constexpr size_t OffsetofPayload()
+    {
+        return offsetof_member_v<&HeapCDataObject::m_payload>;
+    }
+
+    // Create a full userdata with an uninitialized payload of 'length' bytes
+    //
+    static HeapPtr<HeapCDataObject> WARN_UNUSED Create(VM* vm, size_t length, uint64_t typeTag, UserHeapPointer<void> metatable)
+    {
+        ReleaseAssert(length <= std::numeric_limits<uint32_t>::max() - OffsetofPayload() - 8);
+        size_t sizeToAllocate = RoundUpToMultipleOf<8>(OffsetofPayload() + length);
+        HeapPtr<HeapCDataObject> r = vm->AllocFromUserHeap(static_cast<uint32_t>(sizeToAllocate)).AsNoAssert<HeapCDataObject>();
+        UserHeapGcObjectHeader::Populate(r);
+        r->m_hiddenClass = x_hiddenClassForUserdata;
+        r->m_kind = Kind::Full;
+        r->m_invalidArrayType = ArrayType::x_invalidArrayType;
+        TCSet(r->m_metatable, metatable);
+        r->m_typeTag = typeTag;
+        r->m_lengthOrPointer = length;
+        return r;
+    }
+
+    // Create a full userdata holding a 'T' constructed from 'args'
+    //
+    template<typename T, typename... Args>
+    static HeapPtr<HeapCDataObject> WARN_UNUSED CreateNative(VM* vm, UserHeapPointer<void> metatable, Args&&... args)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "the payload is never destructed, see comments on HeapCDataObject");
+        static_assert(alignof(T) <= 8);
+        HeapPtr<HeapCDataObject> r = Create(vm, sizeof(T), GetUserdataTypeTag<T>(), metatable);
+        ConstructInPlace(reinterpret_cast<T*>(TranslateToRawPointer(vm, r)->m_payload), std::forward<Args>(args)...);
+        return r;
+    }
+
+    // Returns the light userdata for 'ptr', which is created on first use
+    //
+    static HeapPtr<HeapCDataObject> WARN_UNUSED GetLightUserdata(VM* vm, void* ptr);
+
+    // Returns the native object if 'value' is a full userdata created by 'CreateNative<T>', nullptr otherwise
+    //
+    template<typename T>
+    static T* WARN_UNUSED TryGetNative(TValue value)
+    {
+        if (!value.Is<tUserdata>())
+        {
+            return nullptr;
+        }
+        HeapCDataObject* obj = TranslateToRawPointer(value.As<tUserdata>());
+        if (obj->m_typeTag != GetUserdataTypeTag<T>())
+        {
+            return nullptr;
+        }
+        Assert(obj->m_kind == Kind::Full && obj->m_lengthOrPointer == sizeof(T));
+        return reinterpret_cast<T*>(obj->m_payload);
+    }
+
+    static UserHeapPointer<void> WARN_UNUSED GetMetatable(HeapPtr<HeapCDataObject> self)
+    {
+        if (likely(self->m_kind == Kind::Full))
+        {
+            return TCGet(self->m_metatable);
+        }
+        Assert(self->m_kind == Kind::Light);
+        return VM::GetActiveVMForCurrentThread()->m_metatableForLightUserdata;
+    }
+
+    // The address shown by 'print' and 'tostring': the native pointer for light userdata, the object itself for full userdata
+    //
+    static void* WARN_UNUSED GetAddressForDisplay(HeapPtr<HeapCDataObject> self)
+    {
+        if (self->m_kind == Kind::Light)
+        {
+            return reinterpret_cast<void*>(self->m_lengthOrPointer);
+        }
+        return TranslateToRawPointer(self);
+    }
+};
+static_assert(sizeof(HeapCDataObject) == 32);
+static_assert(offsetof_member_v<&HeapCDataObject::m_hiddenClass> == offsetof_member_v<&UserHeapGcObjectHeader::m_hiddenClass>);
+static_assert(offsetof_member_v<&HeapCDataObject::m_kind> == offsetof_member_v<&UserHeapGcObjectHeader::m_opaque>);
+static_assert(offsetof_member_v<&HeapCDataObject::m_invalidArrayType> == offsetof_member_v<&UserHeapGcObjectHeader::m_arrayType>);
+
+// Build the metatable of a native class whose instances are exposed to Lua as full userdata
+//
+// Each method is a library function defined with DEEGEN_DEFINE_LIB_FUNC, so it is an ordinary function object: a call from
+// Lua goes through the call IC of the caller straight into the native code, which reads its arguments from the Lua stack and
+// returns its results with 'Return'. There is no marshalling layer in between. A method typically checks its 'self' argument
+// with 'HeapCDataObject::TryGetNative<T>' and then works on the native object in the payload.
+//
+// The methods are put into a table, which becomes the '__index' field of the metatable, so 'obj:method(...)' finds them.
+// Metamethods (e.g., '__tostring', '__eq', '__lt') are put into the metatable directly.
+//
+class NativeClassBuilder
+{
+    MAKE_NONCOPYABLE(NativeClassBuilder);
+    MAKE_NONMOVABLE(NativeClassBuilder);
+
+public:
+    // 'numMethods' is only used to presize the method table
+    //
+    NativeClassBuilder(VM* vm, uint32_t numMethods);
+
+    // 'libFunc' must be the DEEGEN_CODE_POINTER_FOR_LIB_FUNC of the function implementing the method
+    //
+    NativeClassBuilder& AddMethod(const char* name, void* libFunc);
+    NativeClassBuilder& AddMetamethod(const char* name, void* libFunc);
+    NativeClassBuilder& AddField(const char* name, TValue value);
+
+    UserHeapPointer<TableObject> WARN_UNUSED GetMethodTable() { return m_methods; }
+
+    // Returns the metatable
+    //
+    UserHeapPointer<TableObject> WARN_UNUSED Finish();
+
+private:
+    VM* m_vm;
+    UserHeapPointer<TableObject> m_methods;
+    UserHeapPointer<TableObject> m_metatable;
+    bool m_finished;
+};
@@ -1,5 +1,6 @@
 #include "vm.h"
 #include "runtime_utils.h"
+#include "lua_io_file.h"
 #include "deegen_options.h"
 
 VM* WARN_UNUSED VM::Create()
@@ -109,6 +110,7 @@ bool WARN_UNUSED VM::InitializeVMBase()
 
     m_isEngineStartingTierBaselineJit = false;
     m_engineMaxTier = EngineMaxTier::Unrestricted;
+    m_maxJitCallIcEntries = static_cast<uint8_t>(x_maxJitCallInlineCacheEntries);
 
     m_userHeapPtrLimit = -static_cast<int64_t>(x_vmBaseOffset - x_vmUserHeapSize);
     m_userHeapCurPtr = -static_cast<int64_t>(x_vmBaseOffset - x_vmUserHeapSize);
@@ -117,6 +119,10 @@ bool WARN_UNUSED VM::InitializeVMBase()
     m_systemHeapPtrLimit = static_cast<uint32_t>(RoundUpToMultipleOf<x_pageSize>(sizeof(VM)));
     m_systemHeapCurPtr = sizeof(VM);
 
+    m_coroutineStackRegionCurPtr = x_vmCoroutineStackRegionStart;
+    m_coroutineMaxStackSlots = CoroutineRuntimeContext::x_defaultMaxStackSlots;
+    m_options = VMOptions();
+
     m_spdsPageFreeList.store(static_cast<uint64_t>(x_spdsAllocationPageSize));
     m_spdsPageAllocLimit = -static_cast<int32_t>(x_pageSize);
 
@@ -134,6 +140,30 @@ bool WARN_UNUSED VM::InitializeVMBase()
     }
 
     m_totalBaselineJitCompilations = 0;
+    m_totalBaselineJitCompilationTime = 0;
+    m_jitCallIcStats.m_numSitesBecameMegamorphic = 0;
+    m_jitCallIcStats.m_numMegamorphicCalls = 0;
+
+    m_jitCodeMemoryBudget = 0;
+    m_baselineJitEvictionStats.m_numEvictionScans = 0;
+    m_baselineJitEvictionStats.m_numCodeBlocksEvicted = 0;
+    m_baselineJitEvictionStats.m_numBytesEvicted = 0;
+    m_dfgOsrExitStats.m_numOsrExits = 0;
+    m_dfgOsrExitStats.m_numJettisons = 0;
+
+    for (size_t i = 0; i < m_structureTransitionTableFreeLists.size(); i++)
+    {
+        m_structureTransitionTableFreeLists[i].m_value = 0;
+    }
+    for (size_t i = 0; i < m_cacheableDictionaryHashTableFreeLists.size(); i++)
+    {
+        m_cacheableDictionaryHashTableFreeLists[i].m_value = 0;
+    }
+    for (size_t i = 0; i < m_smallIntegerStringCache.size(); i++)
+    {
+        m_smallIntegerStringCache[i].m_value = 0;
+    }
+    m_structureStats = StructureStatistics();
 
     return true;
 }
@@ -189,6 +219,106 @@ void VM::BumpSystemHeap()
     Assert(m_systemHeapPtrLimit >= m_systemHeapCurPtr);
 }
 
+std::pair<void*, size_t> WARN_UNUSED VM::AllocateCoroutineStack(size_t reservedBytes, size_t minCommittedBytes)
+{
+    Assert(reservedBytes > 0 && reservedBytes % x_pageSize == 0);
+    Assert(minCommittedBytes > 0 && minCommittedBytes % x_pageSize == 0 && minCommittedBytes <= reservedBytes);
+
+    // Try to reuse the stack of a dead coroutine first
+    //
+    for (size_t i = m_freeCoroutineStacks.size(); i-- > 0;)
+    {
+        if (m_freeCoroutineStacks[i].m_reservedBytes == reservedBytes)
+        {
+            void* result = m_freeCoroutineStacks[i].m_stack;
+            size_t committedBytes = m_freeCoroutineStacks[i].m_committedBytes;
+            m_freeCoroutineStacks[i] = m_freeCoroutineStacks.back();
+            m_freeCoroutineStacks.pop_back();
+            if (committedBytes < minCommittedBytes)
+            {
+                CommitCoroutineStack(result, committedBytes, minCommittedBytes);
+                committedBytes = minCommittedBytes;
+            }
+            return std::make_pair(result, committedBytes);
+        }
+    }
+
+    // The whole VM memory range is reserved with PROT_NONE, so the guard areas and the reserved but uncommitted part of each stack
+    // are simply the parts that are not mapped yet.
+    // Each stack is preceded by a guard area, and the guard area of the next stack serves as its trailing guard.
+    // The last stack in the region is followed by a guard area as well, which separates it from the SPDS region.
+    //
+    int64_t stackStart = m_coroutineStackRegionCurPtr + static_cast<int64_t>(x_coroutineStackGuardSize);
+    int64_t stackEnd = stackStart + static_cast<int64_t>(reservedBytes);
+    if (unlikely(stackEnd + static_cast<int64_t>(x_coroutineStackGuardSize) > x_vmCoroutineStackRegionEnd))
+    {
+        return std::make_pair(nullptr, 0);
+    }
+
+    void* stack = reinterpret_cast<void*>(VMBaseAddress() + static_cast<uint64_t>(stackStart));
+    CommitCoroutineStack(stack, 0 /*oldCommittedBytes*/, minCommittedBytes);
+
+    m_coroutineStackRegionCurPtr = stackEnd;
+    return std::make_pair(stack, minCommittedBytes);
+}
+
+void VM::CommitCoroutineStack(void* stack, size_t oldCommittedBytes, size_t newCommittedBytes)
+{
+    Assert(oldCommittedBytes < newCommittedBytes);
+    Assert(oldCommittedBytes % x_pageSize == 0 && newCommittedBytes % x_pageSize == 0);
+    size_t numBytes = newCommittedBytes - oldCommittedBytes;
+    uintptr_t allocAddr = reinterpret_cast<uintptr_t>(stack) + oldCommittedBytes;
+    // The memory is lazily backed by the OS on first touch
+    //
+    void* r = mmap(reinterpret_cast<void*>(allocAddr), numBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+    VM_FAIL_WITH_ERRNO_IF(r == MAP_FAILED,
+                          "Out of Memory: Allocation of length %llu failed", static_cast<unsigned long long>(numBytes));
+    Assert(r == reinterpret_cast<void*>(allocAddr));
+}
+
+// The number of bytes in the coroutine stack region available to non-root coroutines
+//
+size_t WARN_UNUSED VM::GetCoroutineStackRegionBytesForNonRootCoroutines()
+{
+    // The last stack in the region is followed by a guard area, and every stack is preceded by one
+    //
+    size_t regionBytes = static_cast<size_t>(x_vmCoroutineStackRegionEnd - x_vmCoroutineStackRegionStart) - x_coroutineStackGuardSize;
+    size_t rootBytes = GetRootCoroutine()->m_numStackSlots * sizeof(TValue) + x_coroutineStackGuardSize;
+    return regionBytes > rootBytes ? regionBytes - rootBytes : 0;
+}
+
+size_t WARN_UNUSED VM::GetMaxLiveCoroutines()
+{
+    size_t bytesPerCoroutine = CoroutineRuntimeContext::GetReservedStackBytes(m_coroutineMaxStackSlots) + x_coroutineStackGuardSize;
+    return GetCoroutineStackRegionBytesForNonRootCoroutines() / bytesPerCoroutine;
+}
+
+void VM::SetMaxLiveCoroutines(size_t numCoroutines)
+{
+    ReleaseAssert(numCoroutines > 0);
+    size_t bytesPerCoroutine = GetCoroutineStackRegionBytesForNonRootCoroutines() / numCoroutines;
+    size_t numExtraSlots = CoroutineRuntimeContext::x_stackSlotsForOverflowHandling + CoroutineRuntimeContext::x_stackSlotsForNestedErrors;
+    size_t maxStackSlots = 0;
+    if (bytesPerCoroutine > x_coroutineStackGuardSize)
+    {
+        // The reserved range is page aligned, so only whole pages count
+        //
+        size_t numSlots = (bytesPerCoroutine - x_coroutineStackGuardSize) / x_pageSize * x_pageSize / sizeof(TValue);
+        maxStackSlots = numSlots > numExtraSlots ? numSlots - numExtraSlots : 0;
+    }
+    SetCoroutineStackLimit(std::max(maxStackSlots, CoroutineRuntimeContext::x_minMaxStackSlots));
+}
+
+void VM::SetRootCoroutineStackLimit(size_t maxStackSlots)
+{
+    CoroutineRuntimeContext* rc = GetRootCoroutine();
+    // No call frame can be live on the old stack, but there may be open upvalues left by the scripts that have finished
+    //
+    rc->CloseUpvalues(rc->m_stackBegin);
+    FreeCoroutineStack(rc->m_stackBegin, rc->m_numStackSlots * sizeof(TValue), rc->m_numCommittedStackSlots * sizeof(TValue));
+    rc->AllocateStack(this, CoroutineRuntimeContext::x_rootCoroutineDefaultStackSlots, maxStackSlots);
+}
+
 int32_t WARN_UNUSED VM::SpdsAllocatePageSlowPath()
 {
     while (true)
@@ -298,8 +428,8 @@ bool WARN_UNUSED VM::InitializeVMGlobalData()
     {
         m_initialStructureForDifferentInlineCapacity[i].m_value = 0;
     }
-    m_filePointerForStdout = stdout;
-    m_filePointerForStderr = stderr;
+    m_stdoutBuffer = new VMOutputBuffer(stdout, false /*isStderr*/);
+    m_stderrBuffer = new VMOutputBuffer(stderr, true /*isStderr*/);
 
     m_metatableForNil = UserHeapPointer<void>();
     m_metatableForBoolean = UserHeapPointer<void>();
@@ -307,6 +437,12 @@ bool WARN_UNUSED VM::InitializeVMGlobalData()
     m_metatableForString = UserHeapPointer<void>();
     m_metatableForFunction = UserHeapPointer<void>();
     m_metatableForCoroutine = UserHeapPointer<void>();
+    m_metatableForLightUserdata = UserHeapPointer<void>();
+
+    m_lightUserdataMap = new std::unordered_map<void*, UserHeapPointer<HeapCDataObject>>();
+
+    m_ioLibState = nullptr;
+    m_eventLog = nullptr;
 
     m_emptyString = nullptr;
     m_toStringString.m_value = 0;
@@ -394,9 +530,51 @@ bool WARN_UNUSED VM::Initialize()
 
 void VM::Cleanup()
 {
+    delete m_ioLibState;
+    m_ioLibState = nullptr;
+    // The destructor flushes the buffer
+    //
+    delete m_stdoutBuffer;
+    m_stdoutBuffer = nullptr;
+    delete m_stderrBuffer;
+    m_stderrBuffer = nullptr;
+    delete m_lightUserdataMap;
+    m_lightUserdataMap = nullptr;
+    delete m_eventLog;
+    m_eventLog = nullptr;
     CleanupVMStringManager();
 }
 
+void VM::EnableEventLog(size_t capacity)
+{
+    delete m_eventLog;
+    m_eventLog = new VMEventLog(capacity);
+}
+
+void VM::DisableEventLog()
+{
+    delete m_eventLog;
+    m_eventLog = nullptr;
+}
+
+void VM::RedirectStdout(FILE* newStdout)
+{
+    m_stdoutBuffer->SetFilePointer(newStdout);
+    if (m_ioLibState != nullptr)
+    {
+        m_ioLibState->m_stdout->SetFilePointer(newStdout);
+    }
+}
+
+void VM::RedirectStderr(FILE* newStderr)
+{
+    m_stderrBuffer->SetFilePointer(newStderr);
+    if (m_ioLibState != nullptr)
+    {
+        m_ioLibState->m_stderr->SetFilePointer(newStderr);
+    }
+}
+
 namespace {
 
 // Compare if 's' is equal to the abstract multi-piece string represented by 'iterator'
@@ -466,6 +644,31 @@ HeapString* WARN_UNUSED ALWAYS_INLINE MaterializeMultiPieceString(VM* vm, Iterat
     return ptr;
 }
 
+struct SinglePieceStringIterator
+{
+    SinglePieceStringIterator(const void* str, uint32_t len)
+        : m_str(str)
+        , m_len(len)
+        , m_isFirst(true)
+    { }
+
+    bool HasMore()
+    {
+        return m_isFirst;
+    }
+
+    std::pair<const void*, uint32_t> GetAndAdvance()
+    {
+        Assert(m_isFirst);
+        m_isFirst = false;
+        return std::make_pair(m_str, m_len);
+    }
+
+    const void* m_str;
+    uint32_t m_len;
+    bool m_isFirst;
+};
+
 }   // anonymous namespace
 
 void VM::ReinsertDueToResize(GeneralHeapPointer<HeapString>* hashTable, uint32_t hashTableSizeMask, GeneralHeapPointer<HeapString> e)
@@ -512,21 +715,20 @@ void VM::ExpandStringConserHashTableIfNeeded()
     m_hashTableSizeMask = newMask;
 }
 
-// Insert an abstract multi-piece string into the hash table if it does not exist
-// Return the HeapString
+// Look up an abstract multi-piece string in the hash table
+// Returns the string if it exists. Otherwise returns nullptr, and 'slotForInsertion' is set to the slot where the string should be inserted
 //
 template<typename Iterator>
-UserHeapPointer<HeapString> WARN_UNUSED VM::InsertMultiPieceString(Iterator iterator)
+HeapString* WARN_UNUSED VM::FindMultiPieceString(Iterator iterator, StringLengthAndHash lenAndHash, uint32_t& slotForInsertion /*out*/)
 {
     HeapPtrTranslator translator = GetHeapPtrTranslator();
 
-    StringLengthAndHash lenAndHash = HashMultiPieceString(iterator);
     uint64_t hash = lenAndHash.m_hashValue;
     size_t length = lenAndHash.m_length;
     uint8_t expectedHashHigh = static_cast<uint8_t>(hash >> 56);
     uint32_t expectedHashLow = BitwiseTruncateTo<uint32_t>(hash);
 
-    uint32_t slotForInsertion = static_cast<uint32_t>(-1);
+    slotForInsertion = static_cast<uint32_t>(-1);
     uint32_t slot = static_cast<uint32_t>(hash) & m_hashTableSizeMask;
     while (true)
     {
@@ -564,17 +766,35 @@ UserHeapPointer<HeapString> WARN_UNUSED VM::InsertMultiPieceString(Iterator iter
 
             // We found the string
             //
-            return translator.TranslateToUserHeapPtr(rawPtr);
+            return rawPtr;
         }
 next_slot:
         slot = (slot + 1) & m_hashTableSizeMask;
     }
 
-    // The string is not found, insert it into the hash table
-    //
     Assert(slotForInsertion != static_cast<uint32_t>(-1));
     Assert(StringHtCellValueIsNonExistentOrDeleted(m_hashTable[slotForInsertion]));
+    return nullptr;
+}
 
+// Insert an abstract multi-piece string into the hash table if it does not exist
+// Return the HeapString
+//
+template<typename Iterator>
+UserHeapPointer<HeapString> WARN_UNUSED VM::InsertMultiPieceString(Iterator iterator)
+{
+    HeapPtrTranslator translator = GetHeapPtrTranslator();
+
+    StringLengthAndHash lenAndHash = HashMultiPieceString(iterator);
+    uint32_t slotForInsertion;
+    HeapString* existing = FindMultiPieceString(iterator, lenAndHash, slotForInsertion /*out*/);
+    if (existing != nullptr)
+    {
+        return translator.TranslateToUserHeapPtr(existing);
+    }
+
+    // The string is not found, insert it into the hash table
+    //
     m_elementCount++;
     HeapString* element = MaterializeMultiPieceString(this, iterator, lenAndHash);
     m_hashTable[slotForInsertion] = translator.TranslateToGeneralHeapPtr(element);
@@ -584,6 +804,46 @@ next_slot:
     return translator.TranslateToUserHeapPtr(element);
 }
 
+HeapString* WARN_UNUSED VM::AllocateStringObjectForPrefill(size_t maxLength)
+{
+    size_t allocationLength = HeapString::ComputeAllocationLengthForString(maxLength);
+    VM_FAIL_IF(!IntegerCanBeRepresentedIn<uint32_t>(allocationLength),
+               "Cannot create a string longer than 4GB (attempted length: %llu bytes).", static_cast<unsigned long long>(allocationLength));
+
+    UserHeapPointer<void> uhp = AllocFromUserHeap(static_cast<uint32_t>(allocationLength));
+    return GetHeapPtrTranslator().TranslateToRawPtr(uhp.AsNoAssert<HeapString>());
+}
+
+UserHeapPointer<HeapString> WARN_UNUSED VM::InternPrefilledStringObject(HeapString* s, size_t length)
+{
+    HeapPtrTranslator translator = GetHeapPtrTranslator();
+
+    SinglePieceStringIterator iterator(s->m_string, SafeIntegerCast<uint32_t>(length));
+    StringLengthAndHash lenAndHash {
+        .m_length = length,
+        .m_hashValue = HashString(s->m_string, length)
+    };
+
+    uint32_t slotForInsertion;
+    HeapString* existing = FindMultiPieceString(iterator, lenAndHash, slotForInsertion /*out*/);
+    if (existing != nullptr)
+    {
+        // The prefilled object is simply abandoned. This should be rare, as the use cases are long strings read from external sources.
+        //
+        return translator.TranslateToUserHeapPtr(existing);
+    }
+
+    s->PopulateHeader(lenAndHash);
+    s->m_string[length] = 0;
+
+    m_elementCount++;
+    m_hashTable[slotForInsertion] = translator.TranslateToGeneralHeapPtr(s);
+
+    ExpandStringConserHashTableIfNeeded();
+
+    return translator.TranslateToUserHeapPtr(s);
+}
+
 UserHeapPointer<HeapString> WARN_UNUSED VM::CreateStringObjectFromConcatenation(TValue* start, size_t len)
 {
 #ifndef NDEBUG
@@ -703,32 +963,24 @@ UserHeapPointer<HeapString> WARN_UNUSED VM::CreateStringObjectFromConcatenation(
 
 UserHeapPointer<HeapString> WARN_UNUSED VM::CreateStringObjectFromRawString(const void* str, uint32_t len)
 {
-    struct Iterator
-    {
-        Iterator(const void* str, uint32_t len)
-            : m_str(str)
-            , m_len(len)
-            , m_isFirst(true)
-        { }
-
-        bool HasMore()
-        {
-            return m_isFirst;
-        }
-
-        std::pair<const void*, uint32_t> GetAndAdvance()
-        {
-            Assert(m_isFirst);
-            m_isFirst = false;
-            return std::make_pair(m_str, m_len);
-        }
+    return InsertMultiPieceString(SinglePieceStringIterator(str, len));
+}
 
-        const void* m_str;
-        uint32_t m_len;
-        bool m_isFirst;
-    };
+UserHeapPointer<HeapString> WARN_UNUSED VM::PopulateSmallIntegerStringCache(uint32_t value)
+{
+    Assert(value < x_numCachedSmallIntegerStrings && m_smallIntegerStringCache[value].m_value == 0);
+    char buf[x_default_tostring_buffersize_int];
+    char* bufEnd = StringifyInt32UsingDefaultLuaFormattingOptions(buf /*out*/, static_cast<int32_t>(value));
+    UserHeapPointer<HeapString> res = CreateStringObjectFromRawString(buf, static_cast<uint32_t>(bufEnd - buf));
+    m_smallIntegerStringCache[value] = res;
+    return res;
+}
 
-    return InsertMultiPieceString(Iterator(str, len));
+UserHeapPointer<HeapString> WARN_UNUSED VM::CreateStringObjectFromDoubleSlow(double value)
+{
+    char buf[x_default_tostring_buffersize_double];
+    char* bufEnd = StringifyDoubleUsingDefaultLuaFormattingOptions(buf /*out*/, value);
+    return CreateStringObjectFromRawString(buf, static_cast<uint32_t>(bufEnd - buf));
 }
 
 UserHeapPointer<HeapString> WARN_UNUSED VM::CreateStringObjectFromConcatenationOfSameString(const char* inputStringPtr, uint32_t inputStringLen, size_t n)
@@ -831,9 +1083,13 @@ void VM::CreateRootCoroutine()
     // Create global object
     //
     UserHeapPointer<TableObject> globalObject = CreateGlobalObject(this);
-    m_rootCoroutine = CoroutineRuntimeContext::Create(this, globalObject, CoroutineRuntimeContext::x_rootCoroutineDefaultStackSlots);
+    m_rootCoroutine = CoroutineRuntimeContext::Create(this, globalObject,
+                                                      CoroutineRuntimeContext::x_rootCoroutineDefaultStackSlots,
+                                                      CoroutineRuntimeContext::x_rootCoroutineDefaultMaxStackSlots);
     m_rootCoroutine->m_coroutineStatus.SetResumable(false);
     m_rootCoroutine->m_parent = nullptr;
+
+    InitializeLuaImplementedLibFunctions();
 }
 
 HeapPtr<TableObject> VM::GetRootGlobalObject()
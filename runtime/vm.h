@@ -4,6 +4,10 @@
 #include "tvalue.h"
 #include "array_type.h"
 #include "jit_memory_allocator.h"
+#include "jit_inline_cache_utils.h"
+#include "vm_output_buffer.h"
+#include "vm_event_log.h"
+#include "vm_options.h"
 
 enum ThreadKind : uint8_t
 {
@@ -498,10 +502,18 @@ public:
 static_assert(sizeof(HeapString) == 16);
 
 class ScriptModule;
-
-// [ 12GB user heap ] [ 2GB padding ] [ 2GB short-pointer data structures ] [ 2GB system heap ]
-//                                                                          ^
-//     userheap                                   SPDS region     32GB aligned baseptr   systemheap
+class CodeBlock;
+class DfgCodeBlock;
+class StructureTransitionTable;
+class LuaIoLibState;
+
+// [ 12GB user heap ] [ 2GB coroutine stacks ] [ 2GB short-pointer data structures ] [ 2GB system heap ]
+//                                                                                   ^
+//     userheap                coroutine stacks            SPDS region     32GB aligned baseptr   systemheap
+//
+// Multiple VMs may co-exist in one process, and different VMs may run concurrently on different threads.
+// Each thread has at most one active VM, which is identified by the GS segment base of the thread.
+// A VM becomes the active VM of the thread that created it, and a VM must only be used by one thread at a time.
 //
 class VM
 {
@@ -509,11 +521,22 @@ public:
     static VM* WARN_UNUSED Create();
     void Destroy();
 
+    // May only be called if the current thread has an active VM
+    //
     static VM* GetActiveVMForCurrentThread()
     {
         return reinterpret_cast<VM*>(reinterpret_cast<HeapPtr<VM>>(0)->m_self);
     }
 
+    // Make this VM the active VM of the current thread, so the VM can be used on a thread other than the one that created it.
+    // The caller is responsible for making sure that no other thread is using this VM at the same time.
+    //
+    void SetActiveVMForCurrentThread()
+    {
+        SetUpSegmentationRegister();
+        Assert(GetActiveVMForCurrentThread() == this);
+    }
+
     HeapPtrTranslator GetHeapPtrTranslator() const
     {
         return HeapPtrTranslator { VMBaseAddress() };
@@ -706,6 +729,62 @@ public:
     //
     UserHeapPointer<HeapString> WARN_UNUSED CreateStringObjectFromConcatenationOfSameString(const char* ptr, uint32_t len, size_t n);
 
+    // Strings of the integers in [0, x_numCachedSmallIntegerStrings) are cached, so converting such a number to string
+    // (e.g., 'tostring(i)' or '"key" .. i' in a loop) needs neither formatting nor a lookup in the global string hash table
+    //
+    static constexpr uint32_t x_numCachedSmallIntegerStrings = 1024;
+
+    // Create the string of a number, formatted as Lua's default number-to-string conversion
+    //
+    UserHeapPointer<HeapString> WARN_UNUSED ALWAYS_INLINE CreateStringObjectFromDouble(double value)
+    {
+        // Note that -0 is not cached, as it is formatted as "-0"
+        //
+        if (value >= 0 && value < x_numCachedSmallIntegerStrings)
+        {
+            uint32_t k = static_cast<uint32_t>(value);
+            if (UnsafeFloatEqual(static_cast<double>(k), value) && (k != 0 || !std::signbit(value)))
+            {
+                return GetStringForSmallInteger(k);
+            }
+        }
+        return CreateStringObjectFromDoubleSlow(value);
+    }
+
+    UserHeapPointer<HeapString> WARN_UNUSED ALWAYS_INLINE CreateStringObjectFromInt32(int32_t value)
+    {
+        if (static_cast<uint32_t>(value) < x_numCachedSmallIntegerStrings)
+        {
+            return GetStringForSmallInteger(static_cast<uint32_t>(value));
+        }
+        char buf[x_default_tostring_buffersize_int];
+        char* bufEnd = StringifyInt32UsingDefaultLuaFormattingOptions(buf /*out*/, value);
+        return CreateStringObjectFromRawString(buf, static_cast<uint32_t>(bufEnd - buf));
+    }
+
+    UserHeapPointer<HeapString> WARN_UNUSED ALWAYS_INLINE GetStringForSmallInteger(uint32_t value)
+    {
+        Assert(value < x_numCachedSmallIntegerStrings);
+        UserHeapPointer<HeapString> res = m_smallIntegerStringCache[value];
+        if (unlikely(res.m_value == 0))
+        {
+            res = PopulateSmallIntegerStringCache(value);
+        }
+        return res;
+    }
+
+    // Allocate a string object with room for 'maxLength' bytes, so the caller can produce the content (e.g., read it from a file)
+    // directly into the string object instead of into an intermediate buffer.
+    // The object is not a valid string until it is passed to InternPrefilledStringObject.
+    //
+    HeapString* WARN_UNUSED AllocateStringObjectForPrefill(size_t maxLength);
+
+    // Turn an object from AllocateStringObjectForPrefill, whose first 'length' bytes have been filled, into a string
+    // 'length' must not exceed the 'maxLength' used to allocate the object.
+    // If the string already exists, the existing string is returned and the prefilled object is abandoned.
+    //
+    UserHeapPointer<HeapString> WARN_UNUSED InternPrefilledStringObject(HeapString* s, size_t length);
+
     uint32_t GetGlobalStringHashConserCurrentHashTableSize() const
     {
         return m_hashTableSizeMask + 1;
@@ -731,17 +810,105 @@ public:
         return offsetof_member_v<&VM::m_specialKeyForBooleanIndex>;
     }
 
-    FILE* WARN_UNUSED GetStdout() { return m_filePointerForStdout; }
-    FILE* WARN_UNUSED GetStderr() { return m_filePointerForStderr; }
+    // Returns the FILE for writing to the VM's stdout or stderr directly
+    // The VM output buffers are flushed first, so that the output order is preserved.
+    //
+    FILE* WARN_UNUSED GetStdout()
+    {
+        std::ignore = m_stdoutBuffer->Flush();
+        return m_stdoutBuffer->GetFilePointer();
+    }
+
+    FILE* WARN_UNUSED GetStderr()
+    {
+        std::ignore = m_stdoutBuffer->Flush();
+        std::ignore = m_stderrBuffer->Flush();
+        return m_stderrBuffer->GetFilePointer();
+    }
+
+    // The buffers used by 'print' and the io library to write to stdout and stderr
+    //
+    VMOutputBuffer& GetStdoutBuffer() { return *m_stdoutBuffer; }
+    VMOutputBuffer& GetStderrBuffer() { return *m_stderrBuffer; }
+
+    void FlushOutputBuffers()
+    {
+        std::ignore = m_stdoutBuffer->Flush();
+        std::ignore = m_stderrBuffer->Flush();
+    }
+
+    // Also redirects io.stdout and io.stderr of the io library
+    //
+    void RedirectStdout(FILE* newStdout);
+    void RedirectStderr(FILE* newStderr);
 
-    void RedirectStdout(FILE* newStdout) { m_filePointerForStdout = newStdout; }
-    void RedirectStderr(FILE* newStderr) { m_filePointerForStderr = newStderr; }
+    LuaIoLibState* GetIoLibState()
+    {
+        Assert(m_ioLibState != nullptr);
+        return m_ioLibState;
+    }
 
     std::array<SystemHeapPointer<Structure>, x_numInlineCapacitySteppings>& GetInitialStructureForDifferentInlineCapacityArray()
     {
         return m_initialStructureForDifferentInlineCapacity;
     }
 
+    // Statistics of the system heap memory used by hidden classes
+    //
+    struct StructureStatistics
+    {
+        // The number of Structures created, and the total size of them (including their inline hash tables)
+        //
+        uint64_t m_numStructures;
+        uint64_t m_structureBytes;
+        // The number of anchor hash tables created, and the total size of them
+        //
+        uint64_t m_numAnchorHashTables;
+        uint64_t m_anchorHashTableBytes;
+        // The number of outlined transition tables allocated from the system heap, and the total size of them
+        //
+        uint64_t m_numTransitionTables;
+        uint64_t m_transitionTableBytes;
+        // The total size of the transition tables that are served by reusing a transition table replaced by an expanded one
+        //
+        uint64_t m_transitionTableBytesReused;
+        // The number of CacheableDictionaries created
+        //
+        uint64_t m_numCacheableDictionaries;
+        // The number of CacheableDictionary hash tables allocated from the system heap, and the total size of them
+        //
+        uint64_t m_numDictionaryHashTables;
+        uint64_t m_dictionaryHashTableBytes;
+        // The number of CacheableDictionary clones that shared the hash table of the source dictionary,
+        // and the number of times a shared hash table is copied because one of its users is modified
+        //
+        uint64_t m_numDictionaryHashTablesShared;
+        uint64_t m_numDictionaryHashTablesUnshared;
+    };
+
+    StructureStatistics& GetStructureStatistics() { return m_structureStats; }
+
+    // The free list of StructureTransitionTables of the given hash table size
+    // A transition table is put here when its owner replaces it with an expanded table, so it can be reused later
+    //
+    SystemHeapPointer<StructureTransitionTable>& GetStructureTransitionTableFreeList(uint32_t hashTableSize)
+    {
+        Assert(is_power_of_2(hashTableSize));
+        uint32_t ord = CountTrailingZeros(hashTableSize);
+        Assert(ord < m_structureTransitionTableFreeLists.size());
+        return m_structureTransitionTableFreeLists[ord];
+    }
+
+    // The free list of CacheableDictionary hash tables of the given hash table size, see CacheableDictionary::ReleaseHashTable
+    //
+    SystemHeapPointer<void>& GetCacheableDictionaryHashTableFreeList(uint32_t hashTableSize)
+    {
+        Assert(is_power_of_2(hashTableSize));
+        uint32_t ord = CountTrailingZeros(hashTableSize);
+        Assert(ord < m_cacheableDictionaryHashTableFreeLists.size());
+        return m_cacheableDictionaryHashTableFreeLists[ord];
+    }
+
     CoroutineRuntimeContext* GetRootCoroutine()
     {
         return m_rootCoroutine;
@@ -768,7 +935,11 @@ public:
         BaseIPairsIter,
         BaseToString,
         BaseLoad,
+        BaseSelect,
         IoLinesIter,
+        // The Lua-implemented sort function used by table.sort with a user comparator, see lualib_lua_implemented.cpp
+        //
+        TableSortWithComparator,
         // A special object denoting that the 'is_next' validation of a key-value for-loop has passed
         //
         BaseNextValidationOk,
@@ -780,6 +951,7 @@ public:
     enum class LibFnProto
     {
         CoroutineWrapCall,
+        IoFileLinesIter,
         // must be last member
         //
         X_END_OF_ENUM
@@ -913,6 +1085,13 @@ public:
     //
     bool WARN_UNUSED InterpreterCanTierUpFurther() { return m_engineMaxTier > EngineMaxTier::Interpreter; }
 
+    // The tier-up threshold of the interpreter for a function with the given bytecode length, see VMOptions::m_interpreterTierUpMultiplier
+    //
+    int64_t WARN_UNUSED GetInterpreterTierUpThreshold(size_t bytecodeLength)
+    {
+        return static_cast<int64_t>(m_options.m_interpreterTierUpMultiplier * bytecodeLength);
+    }
+
     // Return true if baseline JIT may tier up to a higher tier
     //
     bool WARN_UNUSED BaselineJitCanTierUpFurther() { return false; }
@@ -925,8 +1104,250 @@ public:
     uint32_t GetNumTotalBaselineJitCompilations() { return m_totalBaselineJitCompilations; }
     void IncrementNumTotalBaselineJitCompilations() { m_totalBaselineJitCompilations++; }
 
+    // Total wall time (in seconds) spent in baseline JIT codegen
+    //
+    double GetTotalBaselineJitCompilationTime() { return m_totalBaselineJitCompilationTime; }
+    void AddBaselineJitCompilationTime(double seconds) { m_totalBaselineJitCompilationTime += seconds; }
+
+    // The number of bytes logically allocated from the user heap and the system heap so far
+    //
+    size_t GetUserHeapBytesAllocated()
+    {
+        return static_cast<size_t>(-static_cast<int64_t>(x_vmBaseOffset - x_vmUserHeapSize) - m_userHeapCurPtr);
+    }
+
+    size_t GetSystemHeapBytesAllocated()
+    {
+        return m_systemHeapCurPtr - sizeof(VM);
+    }
+
+    // The maximum number of IC entries a JIT call IC site may hold. Once reached, the site becomes megamorphic.
+    // Lowering the limit makes existing sites with more entries megamorphic immediately, but their existing IC entries are not destroyed.
+    //
+    void SetMaxJitCallInlineCacheEntries(size_t value)
+    {
+        ReleaseAssert(value <= x_jitCallInlineCacheEntriesHardLimit);
+        m_maxJitCallIcEntries = static_cast<uint8_t>(value);
+    }
+
+    size_t GetMaxJitCallInlineCacheEntries() { return m_maxJitCallIcEntries; }
+
+    static size_t ALWAYS_INLINE VM_GetMaxJitCallInlineCacheEntries()
+    {
+        constexpr size_t offset = offsetof_member_v<&VM::m_maxJitCallIcEntries>;
+        using T = typeof_member_t<&VM::m_maxJitCallIcEntries>;
+        return *reinterpret_cast<HeapPtr<T>>(offset);
+    }
+
+    struct JitCallIcStatistics
+    {
+        // The number of JIT call IC sites that have reached the IC entry limit and became megamorphic
+        //
+        uint64_t m_numSitesBecameMegamorphic;
+        // The number of calls that missed all IC entries of a megamorphic site and went through the megamorphic dispatch path
+        //
+        uint64_t m_numMegamorphicCalls;
+    };
+
+    JitCallIcStatistics& GetJitCallIcStatistics() { return m_jitCallIcStats; }
+
+    static void ALWAYS_INLINE VM_IncrementNumJitCallIcMegamorphicCalls()
+    {
+        constexpr size_t offset = offsetof_member_v<&VM::m_jitCallIcStats> + offsetof_member_v<&JitCallIcStatistics::m_numMegamorphicCalls>;
+        HeapPtr<uint64_t> addr = reinterpret_cast<HeapPtr<uint64_t>>(offset);
+        *addr = *addr + 1;
+    }
+
+    // The budget (in bytes) for the total amount of JIT code memory. 0 means unlimited.
+    //
+    // The budget is soft: it is only enforced at safe points (see EvictColdBaselineJitCodeIfOverBudget),
+    // by evicting baseline JIT code that has not been executed since the previous safe point.
+    // Hot code is never evicted, so the usage may stay above the budget if the working set is larger than it.
+    //
+    void SetJitCodeMemoryBudget(size_t numBytes) { m_jitCodeMemoryBudget = numBytes; }
+    size_t GetJitCodeMemoryBudget() { return m_jitCodeMemoryBudget; }
+
+    struct BaselineJitEvictionStatistics
+    {
+        // The number of safe points at which the eviction logic ran
+        //
+        uint64_t m_numEvictionScans;
+        // The number of CodeBlocks whose baseline JIT code has been evicted
+        //
+        uint64_t m_numCodeBlocksEvicted;
+        // The total size of the JIT regions of the evicted baseline JIT code (not including IC stubs)
+        //
+        uint64_t m_numBytesEvicted;
+    };
+
+    BaselineJitEvictionStatistics& GetBaselineJitEvictionStatistics() { return m_baselineJitEvictionStats; }
+
+    // Called every time a CodeBlock gets compiled to baseline JIT code, so it becomes a candidate for eviction
+    //
+    void RegisterBaselineJitCompiledCodeBlock(CodeBlock* cb) { m_baselineJitCompiledCodeBlocks.push_back(cb); }
+
+    // Bookkeeping of coroutines that have started running but have not finished yet.
+    // Such coroutines have live call frames on their stacks, whose JIT code must not be evicted.
+    // Note that a coroutine abandoned while suspended is never finished, so it stays in the set forever.
+    //
+    void RegisterLiveCoroutine(CoroutineRuntimeContext* coro)
+    {
+        [[maybe_unused]] bool inserted = m_liveCoroutines.insert(coro).second;
+        Assert(inserted);
+    }
+
+    void UnregisterLiveCoroutine(CoroutineRuntimeContext* coro)
+    {
+        [[maybe_unused]] size_t numErased = m_liveCoroutines.erase(coro);
+        Assert(numErased == 1);
+    }
+
+    // If the JIT code memory usage exceeds the budget, evict cold baseline JIT code.
+    //
+    // This must only be called at a safe point where the only live call frames are those on the stacks of suspended coroutines.
+    // The code of the functions that have a frame on those stacks is not evicted. Currently this is called when a script is
+    // launched from C++.
+    //
+    void EvictColdBaselineJitCodeIfOverBudget();
+
+    struct DfgOsrExitStatistics
+    {
+        // The total number of OSR exits from DFG code
+        //
+        uint64_t m_numOsrExits;
+        // The number of times DFG code has been jettisoned due to too many OSR exits
+        //
+        uint64_t m_numJettisons;
+    };
+
+    DfgOsrExitStatistics& GetDfgOsrExitStatistics() { return m_dfgOsrExitStats; }
+
+    // Called by the OSR exit logic every time DFG code 'dcb' exits to a lower tier.
+    //
+    // 'cb' and 'bytecodeIndex' is the function and the bytecode where the execution resumes, where 'cb' may be a function
+    // inlined into dcb->m_owner. 'exitValueTypeMask' is the type of the value that failed the speculation, or tBoxedValueTop if not known.
+    //
+    // This updates the OSR exit profile of 'cb', and jettisons 'dcb' if it has exited too many times (see VMOptions).
+    //
+    void NO_INLINE RecordDfgOsrExit(DfgCodeBlock* dcb, CodeBlock* cb, size_t bytecodeIndex, TypeMaskTy exitValueTypeMask);
+
+    // Unlink the DFG code of 'cb', so all future calls run the baseline JIT code (or the interpreter if there is none).
+    //
+    // The DFG code itself is not freed, since call frames running it may still be live. Those frames will OSR exit
+    // (or return) normally. The OSR exit profile of 'cb' is kept, so the recompiled DFG code can avoid the failing speculations.
+    //
+    void JettisonDfgCode(CodeBlock* cb);
+
+    // Return false if the DFG code of 'cb' has been jettisoned too many times, in which case 'cb' should stay in the lower tier
+    //
+    bool WARN_UNUSED ShouldAllowDfgCompilation(CodeBlock* cb);
+
+    // The event log records IC state transitions, tier-ups and OSR exits, so one can see why code is slow (see VMEventLog).
+    // It is disabled by default. Enabling it discards the existing log, if any.
+    //
+    void EnableEventLog(size_t capacity = VMEventLog::x_defaultCapacity);
+    void DisableEventLog();
+
+    // Returns nullptr if the event log is disabled
+    //
+    VMEventLog* WARN_UNUSED GetEventLog() { return m_eventLog; }
+
+    // Record an event if the event log is enabled
+    //
+    void RecordEvent(VMEventKind kind, CodeBlock* codeBlock, uint32_t bytecodeOffset, uint64_t arg)
+    {
+        if (unlikely(m_eventLog != nullptr))
+        {
+            m_eventLog->Record(kind, codeBlock, bytecodeOffset, arg);
+        }
+    }
+
+    // Record an event that happens at a JIT IC site, if the event log is enabled
+    // The function and bytecode of the event is found from the address of the IC site, if it is in baseline JIT code.
+    //
+    void RecordEventAtJitIcSite(VMEventKind kind, void* icSite, uint64_t arg)
+    {
+        if (unlikely(m_eventLog != nullptr))
+        {
+            RecordEventAtJitIcSiteSlow(kind, icSite, arg);
+        }
+    }
+
+    void NO_INLINE RecordEventAtJitIcSiteSlow(VMEventKind kind, void* icSite, uint64_t arg);
+
+    // Find the function and the bytecode offset that own 'addr', which must point into the slow path data of baseline JIT code
+    // (e.g., a JIT IC site). Returns nullptr if not found.
+    //
+    // This does a linear scan over all baseline JIT compiled functions, so it should only be used for diagnosis.
+    //
+    std::pair<CodeBlock*, uint32_t /*bytecodeOffset*/> WARN_UNUSED FindBytecodeLocationFromBaselineJitSlowPathData(void* addr);
+
     static constexpr size_t x_pageSize = 4096;
 
+    // The size of the inaccessible guard area between two coroutine stacks, so a stack overflow that escaped the stack checks results
+    // in a segfault instead of silently corrupting the neighboring stack. The unchecked writes beyond the stack limit are bounded by
+    // CoroutineRuntimeContext::x_stackLimitMarginSlots, so a few pages are plenty, and a small guard leaves room for more coroutines.
+    //
+    static constexpr size_t x_coroutineStackGuardSize = 16384;
+    static_assert(x_coroutineStackGuardSize % x_pageSize == 0);
+
+    // Reserve a coroutine stack of 'reservedBytes' bytes in the coroutine stack region of the VM, and commit at least its first
+    // 'minCommittedBytes' bytes. Returns the stack and the number of committed bytes.
+    // The stack lives in the VM memory range, so stack slots can be addressed by 32-bit offsets from the VM base, just like heap objects.
+    // The reserved part beyond the committed part is inaccessible until it is committed by 'CommitCoroutineStack'.
+    //
+    // Returns { nullptr, 0 } if the coroutine stack region is exhausted. This can happen in a correct program, since the stack of a
+    // coroutine that is abandoned while suspended is never freed, so the caller should turn it into a Lua error if possible.
+    //
+    std::pair<void*, size_t> WARN_UNUSED AllocateCoroutineStack(size_t reservedBytes, size_t minCommittedBytes);
+
+    // Commit the part [oldCommittedBytes, newCommittedBytes) of a coroutine stack
+    //
+    void CommitCoroutineStack(void* stack, size_t oldCommittedBytes, size_t newCommittedBytes);
+
+    // Return the stack of a dead coroutine to the VM, so it can be reused by a coroutine with the same reserved stack size.
+    // The committed part stays committed, so the coroutine reusing the stack does not need to commit it again.
+    //
+    void FreeCoroutineStack(void* stack, size_t reservedBytes, size_t committedBytes)
+    {
+        Assert(reservedBytes % x_pageSize == 0 && committedBytes % x_pageSize == 0 && committedBytes <= reservedBytes);
+        m_freeCoroutineStacks.push_back({ .m_stack = stack, .m_reservedBytes = reservedBytes, .m_committedBytes = committedBytes });
+    }
+
+    // The stack limit (in number of slots) of the coroutines created from now on.
+    // A call that would grow the stack of a coroutine beyond its limit results in a 'stack overflow' error.
+    //
+    void SetCoroutineStackLimit(size_t maxStackSlots)
+    {
+        ReleaseAssert(maxStackSlots > 0);
+        m_coroutineMaxStackSlots = maxStackSlots;
+    }
+
+    size_t GetCoroutineStackLimit() { return m_coroutineMaxStackSlots; }
+
+    // Every live coroutine (including one abandoned while suspended, which is never freed since there is no GC) keeps its stack
+    // and a guard area reserved in the 2GB coroutine stack region, so the number of coroutines that can be live at once is capped.
+    // With the default stack limit, the cap is about 16K. Creating a coroutine beyond the cap raises a 'too many live coroutines' error.
+    //
+    // Returns the cap for coroutines with the current stack limit. This is an estimate: it accounts for the stack of the root
+    // coroutine, but not for the stacks already reserved by coroutines with a different stack limit.
+    //
+    size_t WARN_UNUSED GetMaxLiveCoroutines();
+
+    // Set the stack limit of the coroutines created from now on to the largest one that allows 'numCoroutines' live coroutines.
+    // The stack limit does not go below CoroutineRuntimeContext::x_minMaxStackSlots, so 'GetMaxLiveCoroutines' may end up lower.
+    //
+    void SetMaxLiveCoroutines(size_t numCoroutines);
+
+    // Replace the stack of the root coroutine with a new stack that has the given stack limit (in number of slots).
+    // Must not be called when a script is running.
+    //
+    void SetRootCoroutineStackLimit(size_t maxStackSlots);
+
+    // The runtime tuning knobs of the VM, see VMOptions
+    //
+    VMOptions& GetOptions() { return m_options; }
+
 private:
     static constexpr size_t x_vmLayoutLength = 18ULL << 30;
     // The start address of the VM is always at 16GB % 32GB, this makes sure the VM base is aligned at 32GB
@@ -936,8 +1357,15 @@ private:
     static constexpr size_t x_vmBaseOffset = 16ULL << 30;
     static constexpr size_t x_vmUserHeapSize = 12ULL << 30;
 
+    // The coroutine stack region sits between the user heap and the SPDS region (offsets from the VM base)
+    //
+    static constexpr int64_t x_vmCoroutineStackRegionStart = -static_cast<int64_t>(x_vmBaseOffset - x_vmUserHeapSize);
+    static constexpr int64_t x_vmCoroutineStackRegionEnd = -(2LL << 30);
+
     static_assert((1ULL << x_vmBasePtrLog2Alignment) == x_vmLayoutAlignment, "the constants must match");
 
+    size_t WARN_UNUSED GetCoroutineStackRegionBytesForNonRootCoroutines();
+
     uintptr_t VMBaseAddress() const
     {
         uintptr_t result = reinterpret_cast<uintptr_t>(this);
@@ -984,6 +1412,10 @@ private:
     // In Lua all strings are hash-consed
     // The global string conser implementation
     //
+    // This includes long strings (Lua 5.2+ does not intern them): string equality is pointer equality everywhere,
+    // including the equality bytecodes, the JIT tiers, and the Structure and dictionary key lookups. So not interning
+    // long strings would need a content-compare slow path at all of these places.
+    //
 
     // The hash table stores GeneralHeapPointer
     // We know that they must be UserHeapPointer, so the below values should never appear as valid values
@@ -1019,6 +1451,12 @@ private:
     template<typename Iterator>
     UserHeapPointer<HeapString> WARN_UNUSED InsertMultiPieceString(Iterator iterator);
 
+    template<typename Iterator>
+    HeapString* WARN_UNUSED FindMultiPieceString(Iterator iterator, StringLengthAndHash lenAndHash, uint32_t& slotForInsertion /*out*/);
+
+    UserHeapPointer<HeapString> WARN_UNUSED NO_INLINE PopulateSmallIntegerStringCache(uint32_t value);
+    UserHeapPointer<HeapString> WARN_UNUSED NO_INLINE CreateStringObjectFromDoubleSlow(double value);
+
     static std::mt19937* WARN_UNUSED NO_INLINE GetUserPRNGSlow()
     {
         VM* vm = VM::GetActiveVMForCurrentThread();
@@ -1034,6 +1472,7 @@ private:
     bool WARN_UNUSED Initialize();
     void Cleanup();
     void CreateRootCoroutine();
+    void InitializeLuaImplementedLibFunctions();
 
     // The data members
     //
@@ -1044,6 +1483,7 @@ private:
 
     bool m_isEngineStartingTierBaselineJit;
     EngineMaxTier m_engineMaxTier;
+    uint8_t m_maxJitCallIcEntries;
 
     alignas(64) SpdsAllocImpl<VM, false /*isTempAlloc*/> m_executionThreadSpdsAlloc;
 
@@ -1070,6 +1510,37 @@ private:
     JitMemoryAllocator m_jitMemoryAllocator;
 
     uint32_t m_totalBaselineJitCompilations;
+    double m_totalBaselineJitCompilationTime;
+
+    JitCallIcStatistics m_jitCallIcStats;
+
+    size_t m_jitCodeMemoryBudget;
+    std::unordered_set<CoroutineRuntimeContext*> m_liveCoroutines;
+    BaselineJitEvictionStatistics m_baselineJitEvictionStats;
+    std::vector<CodeBlock*> m_baselineJitCompiledCodeBlocks;
+    DfgOsrExitStatistics m_dfgOsrExitStats;
+
+    // coroutine stack region grows from low address to high address
+    // lowest unused address of the coroutine stack region (offsets from m_self)
+    //
+    int64_t m_coroutineStackRegionCurPtr;
+
+    struct FreeCoroutineStackInfo
+    {
+        void* m_stack;
+        size_t m_reservedBytes;
+        size_t m_committedBytes;
+    };
+
+    // The stacks of dead coroutines available for reuse
+    //
+    std::vector<FreeCoroutineStackInfo> m_freeCoroutineStacks;
+
+    // The stack limit of newly created coroutines, see 'SetCoroutineStackLimit'
+    //
+    size_t m_coroutineMaxStackSlots;
+
+    VMOptions m_options;
 
     alignas(64) std::mutex m_spdsAllocationMutex;
 
@@ -1102,8 +1573,19 @@ private:
 
     std::array<UserHeapPointer<HeapString>, x_totalLuaMetamethodKind> m_stringNameForMetatableKind;
 
+    // Lazily populated, see GetStringForSmallInteger
+    //
+    std::array<UserHeapPointer<HeapString>, x_numCachedSmallIntegerStrings> m_smallIntegerStringCache;
+
     std::array<SystemHeapPointer<Structure>, x_numInlineCapacitySteppings> m_initialStructureForDifferentInlineCapacity;
 
+    // Indexed by log2 of the hash table size
+    //
+    std::array<SystemHeapPointer<StructureTransitionTable>, 32> m_structureTransitionTableFreeLists;
+    std::array<SystemHeapPointer<void>, 32> m_cacheableDictionaryHashTableFreeLists;
+
+    StructureStatistics m_structureStats;
+
     TValue m_vmLibFunctionObjects[static_cast<size_t>(LibFn::X_END_OF_ENUM)];
     SystemHeapPointer<ExecutableCode> m_vmLibFnProtos[static_cast<size_t>(LibFnProto::X_END_OF_ENUM)];
 
@@ -1111,10 +1593,10 @@ private:
     //
     std::mt19937* m_usrPRNG;
 
-    // Allow unit test to hook stdout and stderr to a custom temporary file
+    // Unit tests may redirect stdout and stderr to a custom temporary file
     //
-    FILE* m_filePointerForStdout;
-    FILE* m_filePointerForStderr;
+    VMOutputBuffer* m_stdoutBuffer;
+    VMOutputBuffer* m_stderrBuffer;
 
 public:
     // Per-type Lua metatables
@@ -1125,6 +1607,19 @@ public:
     UserHeapPointer<void> m_metatableForString;
     UserHeapPointer<void> m_metatableForFunction;
     UserHeapPointer<void> m_metatableForCoroutine;
+    UserHeapPointer<void> m_metatableForLightUserdata;
+
+    // Maps a native pointer to its light userdata, see HeapCDataObject
+    //
+    std::unordered_map<void*, UserHeapPointer<HeapCDataObject>>* m_lightUserdataMap;
+
+    // The file handles and default files of the io library, created together with the global object
+    //
+    LuaIoLibState* m_ioLibState;
+
+    // nullptr if the event log is disabled
+    //
+    VMEventLog* m_eventLog;
 
     // The string ""
     //
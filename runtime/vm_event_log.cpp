@@ -0,0 +1,163 @@
+#include "vm_event_log.h"
+#include "runtime_utils.h"
+
+VMEventLog::VMEventLog(size_t capacity)
+    : m_numEventsRecorded(0)
+    , m_startTimeNs(0)
+{
+    ReleaseAssert(capacity > 0 && capacity <= (1U << 31));
+    capacity = RoundUpToPowerOfTwo(static_cast<uint32_t>(capacity));
+    m_events = new VMEvent[capacity];
+    m_capacityMask = capacity - 1;
+    m_startTimeNs = GetTimestampNs();
+}
+
+VMEventLog::~VMEventLog()
+{
+    delete [] m_events;
+}
+
+static void PrintFunctionName(FILE* fp, CodeBlock* cb)
+{
+    if (cb == nullptr)
+    {
+        fprintf(fp, "<unknown function>");
+    }
+    else if (cb->m_owner->m_lineDefined == 0)
+    {
+        fprintf(fp, "main chunk [%p]", static_cast<void*>(cb));
+    }
+    else
+    {
+        fprintf(fp, "function at line %u [%p]", static_cast<unsigned int>(cb->m_owner->m_lineDefined), static_cast<void*>(cb));
+    }
+}
+
+static void PrintBytecodeOffset(FILE* fp, uint32_t bytecodeOffset)
+{
+    if (bytecodeOffset == VMEvent::x_unknownBytecodeOffset)
+    {
+        fprintf(fp, "%-10s", "-");
+    }
+    else
+    {
+        fprintf(fp, "bc %-7u", static_cast<unsigned int>(bytecodeOffset));
+    }
+}
+
+static const char* WARN_UNUSED GetVMEventKindName(VMEventKind kind)
+{
+    Assert(kind < VMEventKind::X_END_OF_ENUM);
+    return x_vmEventKindDisplayNames[static_cast<size_t>(kind)];
+}
+
+void VMEventLog::PrintEvents(FILE* fp)
+{
+    fprintf(fp, "== VM event log: %llu events recorded, %llu retained ==\n",
+            static_cast<unsigned long long>(m_numEventsRecorded), static_cast<unsigned long long>(GetNumEventsRetained()));
+    ForEachEvent([&](const VMEvent& e) {
+        fprintf(fp, "[%12.6f ms] %-34s ", static_cast<double>(e.m_timestampNs) / 1e6, GetVMEventKindName(e.m_kind));
+        PrintBytecodeOffset(fp, e.m_bytecodeOffset);
+        fprintf(fp, " arg=%-8llu ", static_cast<unsigned long long>(e.m_arg));
+        PrintFunctionName(fp, e.m_codeBlock);
+        fprintf(fp, "\n");
+    });
+}
+
+void VMEventLog::PrintSummary(FILE* fp)
+{
+    struct SiteStats
+    {
+        uint64_t m_count;
+        uint64_t m_argSum;
+        uint64_t m_argMax;
+    };
+
+    struct FunctionStats
+    {
+        uint64_t m_numEvents;
+        // Keyed by (bytecodeOffset, kind), so the entries are sorted by bytecode
+        //
+        std::map<std::pair<uint32_t, VMEventKind>, SiteStats> m_sites;
+    };
+
+    std::unordered_map<CodeBlock*, FunctionStats> functions;
+    ForEachEvent([&](const VMEvent& e) {
+        FunctionStats& fs = functions[e.m_codeBlock];
+        fs.m_numEvents++;
+        SiteStats& ss = fs.m_sites[std::make_pair(e.m_bytecodeOffset, e.m_kind)];
+        ss.m_count++;
+        ss.m_argSum += e.m_arg;
+        ss.m_argMax = std::max(ss.m_argMax, e.m_arg);
+    });
+
+    std::vector<std::pair<CodeBlock*, FunctionStats*>> sortedFunctions;
+    for (auto& it : functions)
+    {
+        sortedFunctions.push_back(std::make_pair(it.first, &it.second));
+    }
+    std::stable_sort(sortedFunctions.begin(), sortedFunctions.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second->m_numEvents > rhs.second->m_numEvents;
+    });
+
+    fprintf(fp, "== VM event log summary: %llu events recorded, %llu retained, %llu functions ==\n",
+            static_cast<unsigned long long>(m_numEventsRecorded),
+            static_cast<unsigned long long>(GetNumEventsRetained()),
+            static_cast<unsigned long long>(sortedFunctions.size()));
+
+    for (auto& [cb, fs] : sortedFunctions)
+    {
+        fprintf(fp, "\n");
+        PrintFunctionName(fp, cb);
+        fprintf(fp, ": %llu events\n", static_cast<unsigned long long>(fs->m_numEvents));
+        for (auto& [key, ss] : fs->m_sites)
+        {
+            VMEventKind kind = key.second;
+            fprintf(fp, "    ");
+            PrintBytecodeOffset(fp, key.first);
+            fprintf(fp, " %-34s x%-6llu", GetVMEventKindName(kind), static_cast<unsigned long long>(ss.m_count));
+            switch (kind)
+            {
+            case VMEventKind::BaselineJitGenericIcInsert:
+            case VMEventKind::DfgJitGenericIcInsert:
+            case VMEventKind::CallIcInsertDirectCall:
+            case VMEventKind::CallIcInsertClosureCall:
+            {
+                fprintf(fp, " max entries %llu", static_cast<unsigned long long>(ss.m_argMax));
+                break;
+            }
+            case VMEventKind::CallIcTransitToClosureCall:
+            {
+                fprintf(fp, " evicted %llu entries", static_cast<unsigned long long>(ss.m_argSum));
+                break;
+            }
+            case VMEventKind::BaselineJitCompile:
+            {
+                fprintf(fp, " total %.3f ms", static_cast<double>(ss.m_argSum) / 1e6);
+                break;
+            }
+            case VMEventKind::BaselineJitCodeEvicted:
+            {
+                fprintf(fp, " freed %llu bytes", static_cast<unsigned long long>(ss.m_argSum));
+                break;
+            }
+            case VMEventKind::DfgJitCodeJettisoned:
+            {
+                fprintf(fp, " max jettisons %llu", static_cast<unsigned long long>(ss.m_argMax));
+                break;
+            }
+            case VMEventKind::CallIcBecameMegamorphic:
+            case VMEventKind::BaselineJitOsrEntry:
+            case VMEventKind::DfgOsrExit:
+            {
+                break;
+            }
+            case VMEventKind::X_END_OF_ENUM:
+            {
+                ReleaseAssert(false);
+            }
+            }   /*switch*/
+            fprintf(fp, "\n");
+        }
+    }
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "common_utils.h"
+
+class CodeBlock;
+
+// The kinds of events recorded by VMEventLog, and the meaning of VMEvent::m_arg for each kind:
+//
+// BaselineJitGenericIcInsert:  a generic IC entry is created at an IC site in baseline JIT code, arg: #entries of the site
+// DfgJitGenericIcInsert:       a generic IC entry is created at an IC site in DFG JIT code, arg: #entries of the site
+// CallIcInsertDirectCall:      a direct-call IC entry is created at a call IC site, arg: #entries of the site
+// CallIcTransitToClosureCall:  a call IC site transits to closure-call mode, evicting all its direct-call IC entries, arg: #entries evicted
+// CallIcInsertClosureCall:     a closure-call IC entry is created at a call IC site, arg: #entries of the site
+// CallIcBecameMegamorphic:     a call IC site reaches the IC entry limit and becomes megamorphic, arg: unused
+// BaselineJitCompile:          a function is compiled to baseline JIT code, arg: compilation time in nanoseconds
+// BaselineJitOsrEntry:         a function running in the interpreter enters its baseline JIT code at a loop, arg: unused
+// BaselineJitCodeEvicted:      the baseline JIT code of a function is evicted, arg: #bytes of JIT code freed
+// DfgOsrExit:                  DFG JIT code exits to a lower tier, arg: #exits at this bytecode so far
+// DfgJitCodeJettisoned:        the DFG JIT code of a function is jettisoned due to too many OSR exits, arg: #jettisons of the function so far
+//
+#define VM_EVENT_KIND_LIST                                                      \
+    /* Enum Name,                  Display Name */                              \
+    (BaselineJitGenericIcInsert,   "generic IC insert (baseline JIT)")          \
+  , (DfgJitGenericIcInsert,        "generic IC insert (DFG JIT)")               \
+  , (CallIcInsertDirectCall,       "call IC insert (direct call)")              \
+  , (CallIcTransitToClosureCall,   "call IC transit to closure call")           \
+  , (CallIcInsertClosureCall,      "call IC insert (closure call)")             \
+  , (CallIcBecameMegamorphic,      "call IC became megamorphic")                \
+  , (BaselineJitCompile,           "baseline JIT compile")                      \
+  , (BaselineJitOsrEntry,          "baseline JIT OSR entry")                    \
+  , (BaselineJitCodeEvicted,       "baseline JIT code evicted")                 \
+  , (DfgOsrExit,                   "DFG OSR exit")                              \
+  , (DfgJitCodeJettisoned,         "DFG JIT code jettisoned")
+
+enum class VMEventKind : uint8_t
+{
+#define macro(e) PP_TUPLE_GET_1(e),
+    PP_FOR_EACH(macro, VM_EVENT_KIND_LIST)
+#undef macro
+    X_END_OF_ENUM
+};
+
+constexpr const char* x_vmEventKindDisplayNames[] = {
+#define macro(e) PP_TUPLE_GET_2(e),
+    PP_FOR_EACH(macro, VM_EVENT_KIND_LIST)
+#undef macro
+};
+static_assert(std::size(x_vmEventKindDisplayNames) == static_cast<size_t>(VMEventKind::X_END_OF_ENUM));
+
+struct VMEvent
+{
+    static constexpr uint32_t x_unknownBytecodeOffset = static_cast<uint32_t>(-1);
+
+    // Nanoseconds since the event log is enabled
+    //
+    uint64_t m_timestampNs;
+    // The function where the event happens, nullptr if unknown
+    //
+    CodeBlock* m_codeBlock;
+    uint64_t m_arg;
+    // The offset of the bytecode in the bytecode stream of m_codeBlock, x_unknownBytecodeOffset if unknown or not applicable
+    //
+    uint32_t m_bytecodeOffset;
+    VMEventKind m_kind;
+};
+static_assert(sizeof(VMEvent) == 32);
+
+// A log of the events that explain the performance of the JIT tiers: IC insertions and evictions, tier-ups and JIT
+// compilations, and OSR exits, each with the function and bytecode where it happens
+//
+// The log is a ring buffer, so it only retains the most recent events, and it is only allocated when enabled
+// (see VM::EnableEventLog). All events are recorded from slow paths (IC misses, compilations, etc.),
+// so the cost when the log is disabled is a predictable branch on those slow paths, and nothing on the fast paths.
+//
+class VMEventLog
+{
+    MAKE_NONCOPYABLE(VMEventLog);
+    MAKE_NONMOVABLE(VMEventLog);
+
+public:
+    static constexpr size_t x_defaultCapacity = 65536;
+
+    // The capacity is rounded up to a power of 2
+    //
+    VMEventLog(size_t capacity);
+    ~VMEventLog();
+
+    void Record(VMEventKind kind, CodeBlock* codeBlock, uint32_t bytecodeOffset, uint64_t arg)
+    {
+        VMEvent& e = m_events[m_numEventsRecorded & m_capacityMask];
+        e.m_timestampNs = GetTimestampNs();
+        e.m_codeBlock = codeBlock;
+        e.m_arg = arg;
+        e.m_bytecodeOffset = bytecodeOffset;
+        e.m_kind = kind;
+        m_numEventsRecorded++;
+    }
+
+    // The total number of events recorded, including those overwritten in the ring buffer
+    //
+    uint64_t WARN_UNUSED GetNumEventsRecorded() { return m_numEventsRecorded; }
+
+    size_t WARN_UNUSED GetNumEventsRetained()
+    {
+        return static_cast<size_t>(std::min(m_numEventsRecorded, static_cast<uint64_t>(m_capacityMask + 1)));
+    }
+
+    // Iterate the retained events from the oldest to the newest
+    //
+    template<typename Func>
+    void ForEachEvent(const Func& func)
+    {
+        size_t numEvents = GetNumEventsRetained();
+        for (uint64_t i = m_numEventsRecorded - numEvents; i < m_numEventsRecorded; i++)
+        {
+            func(m_events[i & m_capacityMask]);
+        }
+    }
+
+    void Clear() { m_numEventsRecorded = 0; }
+
+    // Print every retained event, one per line
+    //
+    void PrintEvents(FILE* fp);
+
+    // Print the retained events aggregated by function, and by bytecode within each function.
+    // Functions with more events are printed first.
+    //
+    void PrintSummary(FILE* fp);
+
+private:
+    uint64_t WARN_UNUSED GetTimestampNs()
+    {
+        struct timespec ts;
+        int r = clock_gettime(CLOCK_MONOTONIC, &ts);
+        Assert(r == 0);
+        std::ignore = r;
+        uint64_t now = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+        return now - m_startTimeNs;
+    }
+
+    VMEvent* m_events;
+    size_t m_capacityMask;
+    uint64_t m_numEventsRecorded;
+    uint64_t m_startTimeNs;
+};
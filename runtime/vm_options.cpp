@@ -0,0 +1,183 @@
+#include "vm_options.h"
+#include "runtime_utils.h"
+
+namespace {
+
+struct VMOptionInfo
+{
+    const char* m_name;
+    const char* m_description;
+    size_t m_minValue;
+    size_t m_maxValue;
+    size_t (*m_getter)(VM* vm);
+    void (*m_setter)(VM* vm, size_t value);
+};
+
+}   // anonymous namespace
+
+// An option that is a field of VMOptions
+//
+#define VM_OPTION_FIELD(name, field, minValue, maxValue, description)                                          \
+    VMOptionInfo {                                                                                              \
+        .m_name = name,                                                                                         \
+        .m_description = description,                                                                           \
+        .m_minValue = minValue,                                                                                 \
+        .m_maxValue = maxValue,                                                                                 \
+        .m_getter = [](VM* vm) -> size_t { return static_cast<size_t>(vm->GetOptions().field); },               \
+        .m_setter = [](VM* vm, size_t value) {                                                                  \
+            using T = std::remove_reference_t<decltype(vm->GetOptions().field)>;                                \
+            vm->GetOptions().field = SafeIntegerCast<T>(value);                                                 \
+        }                                                                                                       \
+    }
+
+// An option that is accessed by a getter and setter of the VM
+//
+#define VM_OPTION_ACCESSOR(name, getterExpr, setterStmt, minValue, maxValue, description)                      \
+    VMOptionInfo {                                                                                              \
+        .m_name = name,                                                                                         \
+        .m_description = description,                                                                           \
+        .m_minValue = minValue,                                                                                 \
+        .m_maxValue = maxValue,                                                                                 \
+        .m_getter = [](VM* vm) -> size_t { return static_cast<size_t>(getterExpr); },                           \
+        .m_setter = [](VM* vm, size_t value) { setterStmt; }                                                    \
+    }
+
+static const VMOptionInfo x_vmOptionList[] = {
+    VM_OPTION_FIELD("tier_up_multiplier", m_interpreterTierUpMultiplier, 0, 1ULL << 24,
+                    "a function tiers up to baseline JIT after executing this many times its bytecode length in the interpreter"),
+    VM_OPTION_ACCESSOR("max_call_ic_entries",
+                       vm->GetMaxJitCallInlineCacheEntries(), vm->SetMaxJitCallInlineCacheEntries(value),
+                       1, x_jitCallInlineCacheEntriesHardLimit,
+                       "the maximum number of entries of a JIT call IC site before it becomes megamorphic"),
+    VM_OPTION_ACCESSOR("jit_code_memory_budget",
+                       vm->GetJitCodeMemoryBudget(), vm->SetJitCodeMemoryBudget(value),
+                       0, std::numeric_limits<size_t>::max(),
+                       "the soft budget in bytes of JIT code memory, cold baseline JIT code is evicted when over budget (0 = unlimited)"),
+    VM_OPTION_ACCESSOR("coroutine_max_stack_slots",
+                       vm->GetCoroutineStackLimit(), vm->SetCoroutineStackLimit(value),
+                       CoroutineRuntimeContext::x_minMaxStackSlots, 1ULL << 24,
+                       "the stack limit in slots of coroutines created later"),
+    VM_OPTION_ACCESSOR("max_live_coroutines",
+                       vm->GetMaxLiveCoroutines(), vm->SetMaxLiveCoroutines(value),
+                       1, 1ULL << 20,
+                       "the number of coroutines that can be live at once (sets coroutine_max_stack_slots to the largest limit allowing it)"),
+    VM_OPTION_ACCESSOR("root_coroutine_max_stack_slots",
+                       vm->GetRootCoroutine()->m_maxStackSlots, vm->SetRootCoroutineStackLimit(value),
+                       1024, 1ULL << 26,
+                       "the stack limit in slots of the root coroutine"),
+    VM_OPTION_FIELD("array_initial_capacity", m_arrayInitialVectorPartCapacity, 1, ArrayGrowthPolicy::x_alwaysVectorCutoff,
+                    "the initial capacity of the vector part of a table"),
+    VM_OPTION_FIELD("array_growth_factor", m_arrayVectorGrowthFactor, 2, ArrayGrowthPolicy::x_maxVectorGrowthFactor,
+                    "the factor by which the vector part of a table grows"),
+    VM_OPTION_FIELD("array_density_cutoff", m_arrayDensityCutoff, 1, 1024,
+                    "a vector part grown beyond the always-vector cutoff must have at least 1/N of its slots non-nil"),
+    VM_OPTION_FIELD("inline_disable_cutoff", m_speculativeInlinerHeuristic.m_disableAllInliningCutOff, 0, x_forbid_tier_up_to_dfg_num_bytecodes_threshold,
+                    "the DFG does not inline anything into a function with at least this many bytecodes"),
+    VM_OPTION_FIELD("inline_budget_root", m_speculativeInlinerHeuristic.m_inlineBudgetForRootFunction, 0, 1000000,
+                    "the total number of bytecodes the DFG may directly inline into the root function"),
+    VM_OPTION_FIELD("inline_budget_direct_call", m_speculativeInlinerHeuristic.m_inlineBudgetForInlinedDirectCall, 0, 1000000,
+                    "the total number of bytecodes the DFG may directly inline into a function inlined in direct call mode"),
+    VM_OPTION_FIELD("inline_budget_closure_call", m_speculativeInlinerHeuristic.m_inlineBudgetForInlinedClosureCall, 0, 1000000,
+                    "the total number of bytecodes the DFG may directly inline into a function inlined in closure call mode"),
+    VM_OPTION_FIELD("inline_max_depth", m_speculativeInlinerHeuristic.m_maximumInliningDepth, 0, 64,
+                    "the maximum depth of nested inlining in the DFG"),
+    VM_OPTION_FIELD("inline_max_recursion", m_speculativeInlinerHeuristic.m_maximumRecursiveInliningCount, 0, 64,
+                    "the maximum number of times a function may recursively inline itself in the DFG"),
+    VM_OPTION_FIELD("dfg_jettison_threshold", m_dfgOsrExitJettisonThreshold, 1, 1U << 30,
+                    "DFG code is jettisoned after it has OSR exited this many times"),
+    VM_OPTION_FIELD("dfg_max_recompilations", m_dfgMaxNumRecompilations, 0, 1000,
+                    "the maximum number of times a function may be recompiled to DFG after its DFG code is jettisoned"),
+    VM_OPTION_FIELD("dfg_widening_threshold", m_dfgOsrExitSiteWideningThreshold, 1, 1U << 30,
+                    "on DFG recompilation, the speculations at a bytecode that OSR exited at least this many times are widened"),
+};
+
+#undef VM_OPTION_FIELD
+#undef VM_OPTION_ACCESSOR
+
+bool WARN_UNUSED SetVMOption(VM* vm, const char* name, const char* value, std::string& errMsg /*out*/)
+{
+    const VMOptionInfo* info = nullptr;
+    for (const VMOptionInfo& it : x_vmOptionList)
+    {
+        if (strcmp(it.m_name, name) == 0)
+        {
+            info = &it;
+            break;
+        }
+    }
+    if (info == nullptr)
+    {
+        errMsg = std::string("unknown VM option '") + name + "'";
+        return false;
+    }
+
+    // strtoull silently accepts a leading '-' and leading whitespaces, so only accept digits
+    //
+    bool isValid = (*value != '\0');
+    for (const char* p = value; *p != '\0'; p++)
+    {
+        if (*p < '0' || *p > '9')
+        {
+            isValid = false;
+            break;
+        }
+    }
+    unsigned long long parsedValue = 0;
+    if (isValid)
+    {
+        errno = 0;
+        parsedValue = strtoull(value, nullptr, 10);
+        isValid = (errno == 0 && parsedValue >= info->m_minValue && parsedValue <= info->m_maxValue);
+    }
+    if (!isValid)
+    {
+        errMsg = std::string("invalid value '") + value + "' for VM option '" + name + "', expects an integer in ["
+            + std::to_string(info->m_minValue) + ", " + std::to_string(info->m_maxValue) + "]";
+        return false;
+    }
+
+    info->m_setter(vm, static_cast<size_t>(parsedValue));
+    Assert(info->m_getter(vm) == parsedValue);
+    return true;
+}
+
+bool WARN_UNUSED SetVMOptionsFromString(VM* vm, const char* options, std::string& errMsg /*out*/)
+{
+    std::string_view rest(options);
+    while (!rest.empty())
+    {
+        size_t end = rest.find(',');
+        std::string_view item = rest.substr(0, end);
+        rest = (end == std::string_view::npos) ? std::string_view() : rest.substr(end + 1);
+        if (item.empty())
+        {
+            continue;
+        }
+        size_t eq = item.find('=');
+        if (eq == std::string_view::npos)
+        {
+            errMsg = "expects 'name=value' for VM option, got '" + std::string(item) + "'";
+            return false;
+        }
+        std::string name(item.substr(0, eq));
+        std::string value(item.substr(eq + 1));
+        if (!SetVMOption(vm, name.c_str(), value.c_str(), errMsg /*out*/))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void PrintVMOptions(VM* vm, FILE* fp)
+{
+    for (const VMOptionInfo& it : x_vmOptionList)
+    {
+        fprintf(fp, "  %-32s = %-12llu [%llu, %llu] %s\n",
+                it.m_name,
+                static_cast<unsigned long long>(it.m_getter(vm)),
+                static_cast<unsigned long long>(it.m_minValue),
+                static_cast<unsigned long long>(it.m_maxValue),
+                it.m_description);
+    }
+}
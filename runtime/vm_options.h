@@ -0,0 +1,52 @@
+#pragma once
+
+#include "common_utils.h"
+#include "deegen_options.h"
+#include "array_type.h"
+#include "dfg_speculative_inliner_heuristic.h"
+
+class VM;
+
+// The tuning knobs of the VM that are read at runtime, so they can be changed without rebuilding the VM
+//
+// Each knob defaults to the compile-time constant it replaces, which documents what the knob does.
+// The knobs can be changed directly through VM::GetOptions(), or by name through SetVMOption (see below),
+// which also covers the other runtime-settable limits of the VM (e.g., the call IC entry limit and the stack limits).
+//
+struct VMOptions
+{
+    // See x_interpreter_tier_up_threshold_bytecode_length_multiplier
+    // Only affects CodeBlocks created (or whose baseline JIT code is evicted) after the change.
+    //
+    size_t m_interpreterTierUpMultiplier = x_interpreter_tier_up_threshold_bytecode_length_multiplier;
+
+    // See ArrayGrowthPolicy
+    //
+    uint32_t m_arrayInitialVectorPartCapacity = ArrayGrowthPolicy::x_initialVectorPartCapacity;
+    uint32_t m_arrayVectorGrowthFactor = ArrayGrowthPolicy::x_vectorGrowthFactor;
+    uint32_t m_arrayDensityCutoff = ArrayGrowthPolicy::x_densityCutoff;
+
+    dfg::SpeculativeInlinerHeuristic m_speculativeInlinerHeuristic;
+
+    // See x_dfg_osr_exit_jettison_threshold, x_dfg_max_num_recompilations and x_dfg_osr_exit_site_widening_threshold
+    //
+    uint32_t m_dfgOsrExitJettisonThreshold = x_dfg_osr_exit_jettison_threshold;
+    uint32_t m_dfgMaxNumRecompilations = x_dfg_max_num_recompilations;
+    uint32_t m_dfgOsrExitSiteWideningThreshold = x_dfg_osr_exit_site_widening_threshold;
+};
+
+// Set the VM option named 'name' to 'value', which must be a decimal integer within the range of the option.
+// Returns false and sets 'errMsg' if the option does not exist or the value is invalid.
+//
+// Must not be called when a script is running.
+//
+bool WARN_UNUSED SetVMOption(VM* vm, const char* name, const char* value, std::string& errMsg /*out*/);
+
+// Set the VM options in a comma-separated list of 'name=value', e.g. "tier_up_multiplier=10,max_call_ic_entries=4"
+// Stops at the first invalid option.
+//
+bool WARN_UNUSED SetVMOptionsFromString(VM* vm, const char* options, std::string& errMsg /*out*/);
+
+// Print the name, current value, valid range and description of every VM option, one per line
+//
+void PrintVMOptions(VM* vm, FILE* fp);
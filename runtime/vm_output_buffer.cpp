@@ -0,0 +1,151 @@
+#include "vm_output_buffer.h"
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+static bool WARN_UNUSED IsInteractiveStream(FILE* fp)
+{
+    int fd = fileno(fp);
+    return fd >= 0 && isatty(fd);
+}
+
+VMOutputBuffer::VMOutputBuffer(FILE* fp, bool isStderr)
+    : m_fp(fp)
+    , m_buffer(new char[x_bufferSize])
+    , m_size(0)
+    , m_isStderr(isStderr)
+    , m_flushAtEndOfOperation(isStderr || IsInteractiveStream(fp))
+    , m_hasWriteError(false)
+    , m_writeErrno(0)
+{
+    Assert(m_fp != nullptr);
+}
+
+VMOutputBuffer::~VMOutputBuffer()
+{
+    std::ignore = Flush();
+    delete [] m_buffer;
+}
+
+void VMOutputBuffer::SetFilePointer(FILE* fp)
+{
+    Assert(fp != nullptr);
+    std::ignore = Flush();
+    m_fp = fp;
+    if (!m_isStderr)
+    {
+        m_flushAtEndOfOperation = IsInteractiveStream(fp);
+    }
+}
+
+bool WARN_UNUSED VMOutputBuffer::WriteOut(const void* data, size_t len)
+{
+    Auto(m_size = 0);
+
+    // Anything written to the FILE directly was written before the bytes in our buffer, so it must go out first
+    //
+    if (unlikely(fflush(m_fp) != 0))
+    {
+        RecordWriteError();
+        return false;
+    }
+
+    int fd = fileno(m_fp);
+    if (unlikely(fd < 0))
+    {
+        // The FILE is not backed by a file descriptor (e.g., a memory stream), so we have to go through stdio
+        //
+        bool success = fwrite(m_buffer, 1, m_size, m_fp) == m_size && fwrite(data, 1, len, m_fp) == len && fflush(m_fp) == 0;
+        if (unlikely(!success))
+        {
+            RecordWriteError();
+        }
+        return success;
+    }
+
+    struct iovec iov[2];
+    iov[0].iov_base = m_buffer;
+    iov[0].iov_len = m_size;
+    iov[1].iov_base = const_cast<void*>(data);
+    iov[1].iov_len = len;
+
+    size_t cur = 0;
+    while (true)
+    {
+        while (cur < 2 && iov[cur].iov_len == 0)
+        {
+            cur++;
+        }
+        if (cur == 2)
+        {
+            return true;
+        }
+        ssize_t res = writev(fd, iov + cur, static_cast<int>(2 - cur));
+        if (unlikely(res < 0))
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            RecordWriteError();
+            return false;
+        }
+        // Handle partial writes
+        //
+        size_t numWritten = static_cast<size_t>(res);
+        while (cur < 2 && numWritten >= iov[cur].iov_len)
+        {
+            numWritten -= iov[cur].iov_len;
+            iov[cur].iov_len = 0;
+            cur++;
+        }
+        if (cur < 2)
+        {
+            iov[cur].iov_base = reinterpret_cast<uint8_t*>(iov[cur].iov_base) + numWritten;
+            iov[cur].iov_len -= numWritten;
+        }
+    }
+}
+
+bool WARN_UNUSED VMOutputBuffer::Flush()
+{
+    return WriteOut(nullptr, 0);
+}
+
+void NO_INLINE VMOutputBuffer::FlushForMoreSpace()
+{
+    std::ignore = Flush();
+}
+
+void NO_INLINE VMOutputBuffer::AppendSlowPath(const void* data, size_t len)
+{
+    if (len >= x_directWriteThreshold)
+    {
+        std::ignore = WriteOut(data, len);
+        return;
+    }
+    Assert(len > x_bufferSize - m_size);
+    FlushForMoreSpace();
+    memcpy(m_buffer, data, len);
+    m_size = len;
+}
+
+void VMOutputBuffer::AppendObjectAddress(const char* typeName, void* ptr)
+{
+    size_t maxLen = strlen(typeName) + 2 + x_default_tostring_buffersize_ptr;
+    EnsureSpace(maxLen);
+    int len = snprintf(m_buffer + m_size, maxLen, "%s: %p", typeName, ptr);
+    Assert(len > 0 && static_cast<size_t>(len) < maxLen);
+    m_size += static_cast<size_t>(len);
+}
+
+bool WARN_UNUSED VMOutputBuffer::CheckAndClearWriteError()
+{
+    if (likely(!m_hasWriteError))
+    {
+        return false;
+    }
+    m_hasWriteError = false;
+    errno = m_writeErrno;
+    return true;
+}
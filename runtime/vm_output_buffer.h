@@ -0,0 +1,144 @@
+#pragma once
+
+#include "common_utils.h"
+#include "lj_strfmt_num.h"
+
+// The VM-owned output buffer in front of the VM's stdout or stderr FILE
+//
+// 'print' and the io library write into this buffer instead of calling stdio for every value, which avoids the per-call
+// locking in stdio. Numbers are stringified directly into the buffer. The buffer is written to the file descriptor of the
+// FILE with writev, either when it is full or when the output operation ends if the stream is not fully buffered.
+// Long strings are not copied into the buffer at all: they are written together with the buffered bytes in one writev.
+//
+// Anyone who wants to write to the FILE directly must flush this buffer first (VM::GetStdout and VM::GetStderr do this),
+// and this buffer always flushes the FILE before writing to the file descriptor, so the output order is preserved.
+//
+class VMOutputBuffer
+{
+    MAKE_NONCOPYABLE(VMOutputBuffer);
+    MAKE_NONMOVABLE(VMOutputBuffer);
+
+public:
+    static constexpr size_t x_bufferSize = 65536;
+
+    // Strings at least this long are written directly from the string object instead of being copied into the buffer
+    //
+    static constexpr size_t x_directWriteThreshold = 4096;
+
+    // The buffering mode follows the C convention: stderr is unbuffered, and stdout is line buffered if it is a terminal and
+    // fully buffered otherwise. Since 'print' always ends with a newline, a line-buffered stream is simply flushed at the end of
+    // each output operation, same as an unbuffered stream.
+    //
+    VMOutputBuffer(FILE* fp, bool isStderr);
+
+    // Flushes the buffer
+    //
+    ~VMOutputBuffer();
+
+    FILE* WARN_UNUSED GetFilePointer() { return m_fp; }
+
+    // Flush the buffer to the old FILE, then switch to 'fp'
+    //
+    void SetFilePointer(FILE* fp);
+
+    // Set by file:setvbuf on io.stdout and io.stderr
+    //
+    void SetFullyBuffered(bool fullyBuffered) { m_flushAtEndOfOperation = !fullyBuffered; }
+
+    void Append(const void* data, size_t len)
+    {
+        if (likely(len <= x_bufferSize - m_size && len < x_directWriteThreshold))
+        {
+            memcpy(m_buffer + m_size, data, len);
+            m_size += len;
+            return;
+        }
+        AppendSlowPath(data, len);
+    }
+
+    void Append(const char* str)
+    {
+        Append(str, strlen(str));
+    }
+
+    void AppendChar(char c)
+    {
+        if (unlikely(m_size == x_bufferSize))
+        {
+            FlushForMoreSpace();
+        }
+        m_buffer[m_size] = c;
+        m_size++;
+    }
+
+    void AppendDouble(double value)
+    {
+        EnsureSpace(x_default_tostring_buffersize_double);
+        char* end = StringifyDoubleUsingDefaultLuaFormattingOptions(m_buffer + m_size /*out*/, value);
+        m_size = static_cast<size_t>(end - m_buffer);
+    }
+
+    void AppendInt32(int32_t value)
+    {
+        EnsureSpace(x_default_tostring_buffersize_int);
+        char* end = StringifyInt32UsingDefaultLuaFormattingOptions(m_buffer + m_size /*out*/, value);
+        m_size = static_cast<size_t>(end - m_buffer);
+    }
+
+    // Append "<typeName>: <pointer>", the default Lua string representation of a heap object
+    //
+    void AppendObjectAddress(const char* typeName, void* ptr);
+
+    // Must be called when an output operation (e.g., a 'print' call or an io.write call) completes
+    //
+    void EndOfOperation()
+    {
+        if (m_flushAtEndOfOperation)
+        {
+            std::ignore = Flush();
+        }
+    }
+
+    // Write everything in the buffer to the file. Returns false and sets errno on failure.
+    //
+    bool WARN_UNUSED Flush();
+
+    // Returns true if a write error happened since the last call, and reset the error state
+    // On error, errno is set to the error that happened.
+    //
+    bool WARN_UNUSED CheckAndClearWriteError();
+
+private:
+    void EnsureSpace(size_t len)
+    {
+        Assert(len <= x_bufferSize);
+        if (unlikely(x_bufferSize - m_size < len))
+        {
+            FlushForMoreSpace();
+        }
+    }
+
+    void NO_INLINE FlushForMoreSpace();
+    void NO_INLINE AppendSlowPath(const void* data, size_t len);
+
+    // Write the buffered bytes followed by [data, data + len) to the file, and empty the buffer
+    //
+    bool WARN_UNUSED WriteOut(const void* data, size_t len);
+
+    void RecordWriteError()
+    {
+        if (!m_hasWriteError)
+        {
+            m_hasWriteError = true;
+            m_writeErrno = errno;
+        }
+    }
+
+    FILE* m_fp;
+    char* m_buffer;
+    size_t m_size;
+    bool m_isStderr;
+    bool m_flushAtEndOfOperation;
+    bool m_hasWriteError;
+    int m_writeErrno;
+};
@@ -0,0 +1,631 @@
+#include "runtime_utils.h"
+#include "lj_parser_wrapper.h"
+#include "json_utils.h"
+#include "interpreter_bytecode_pair_profile.h"
+
+#include <fstream>
+
+// The in-process benchmark driver
+//
+// Each iteration of each benchmark runs in a fresh VM, so iterations are independent of each other,
+// but unlike running the 'luajitr' executable, process startup and teardown are not measured.
+//
+
+extern const char* x_git_commit_hash;
+constexpr const char* x_build_flavor_version_output = x_isTestBuild ? (x_isDebugBuild ? "**DEBUG** build" : "**TESTREL** build") : "release build";
+
+namespace {
+
+struct BenchmarkDesc
+{
+    const char* m_name;
+    std::vector<const char*> m_args;
+};
+
+// Keep in sync with run_bench.sh
+//
+const BenchmarkDesc x_defaultBenchmarkList[] = {
+    { "array3d", { "300", "packed" } },
+    { "binary-trees-num", { "16" } },
+    { "binary-trees-name", { "15" } },
+    { "bounce", { "3000" } },
+    { "cd", { } },
+    { "chameneos", { "1e7" } },
+    { "coroutine-ring", { "2e7" } },
+    { "deltablue", { } },
+    { "fannkuch", { "11" } },
+    { "fasta", { "5e6" } },
+    { "fixpoint-fact", { "1000" } },
+    { "havlak", { } },
+    { "heapsort", { "1", "3000000" } },
+    { "json", { } },
+    { "k-nucleotide", { "5e6" } },
+    { "life", { "2000" } },
+    { "linear-sieve", { "3e7" } },
+    { "list", { } },
+    { "mandelbrot", { "3000" } },
+    { "mandel-metatable", { "256" } },
+    { "nbody", { "5e6" } },
+    { "nsieve", { "12" } },
+    { "partialsums", { "3e7" } },
+    { "permute", { } },
+    { "pidigits-nogmp", { "5000" } },
+    { "qt", { "14" } },
+    { "quadtree-2", { "14" } },
+    { "queen", { "12" } },
+    { "ray", { "9" } },
+    { "ray-prop", { "9" } },
+    { "recursive-fib-uv", { "40" } },
+    { "recursive-fib-gv", { "40" } },
+    { "revcomp", { "5e6" } },
+    { "richard", { } },
+    { "scimark-fft", { "10" } },
+    { "scimark-lu", { "5" } },
+    { "scimark-sor", { "5" } },
+    { "scimark-sparse", { "300" } },
+    { "series", { "5000" } },
+    { "spectral-norm", { "2000" } },
+    { "storage", { } },
+    { "table-sort", { "5e6" } },
+    { "table-sort-cmp", { "1e6" } },
+    { "towers", { } },
+};
+
+// The tier configurations that the driver can run each benchmark with
+//
+struct TierConfig
+{
+    const char* m_name;
+    VM::EngineStartingTier m_startingTier;
+    VM::EngineMaxTier m_maxTier;
+};
+
+const TierConfig x_tierConfigs[] = {
+    // Interpreter only
+    //
+    { "interpreter", VM::EngineStartingTier::Interpreter, VM::EngineMaxTier::Interpreter },
+    // Every function is compiled to baseline JIT code before its first execution
+    //
+    { "baseline", VM::EngineStartingTier::BaselineJIT, VM::EngineMaxTier::BaselineJIT },
+    // The default configuration of 'luajitr': start in the interpreter and tier up when hot
+    //
+    { "tierup", VM::EngineStartingTier::Interpreter, VM::EngineMaxTier::Unrestricted },
+};
+
+struct BenchOptions
+{
+    size_t m_numIterations = 5;
+    size_t m_numWarmupIterations = 1;
+    std::string m_benchDir = "luabench";
+    std::string m_inputFile = "luabench/FASTA_5000000";
+    std::vector<const TierConfig*> m_tiers;
+    std::vector<std::string> m_selectedBenchmarks;
+    std::string m_jsonOutputFile;
+    std::string m_compareBaselineFile;
+    double m_regressionThresholdPercent = 5;
+    // Comma-separated list of 'name=value' VM options applied to every run, see SetVMOptionsFromString
+    //
+    std::string m_vmOptions;
+    // If not empty, write the interpreter bytecode pair profile accumulated over all runs to this file
+    //
+    std::string m_bytecodePairProfileFile;
+};
+
+// The measurements of one run of a benchmark
+//
+struct RunResult
+{
+    bool m_success;
+    double m_totalTime;
+    double m_parseTime;
+    double m_baselineJitCompileTime;
+    uint64_t m_numBaselineJitCompilations;
+    uint64_t m_jitCodeBytes;
+    uint64_t m_userHeapBytes;
+    uint64_t m_systemHeapBytes;
+    VM::StructureStatistics m_structureStats;
+};
+
+struct SampleStatistics
+{
+    double m_median;
+    double m_mean;
+    double m_stddev;
+    double m_min;
+    double m_max;
+};
+
+SampleStatistics WARN_UNUSED ComputeStatistics(std::vector<double> samples)
+{
+    ReleaseAssert(samples.size() > 0);
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    double median = (n % 2 == 1) ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    double sum = 0;
+    for (double x : samples) { sum += x; }
+    double mean = sum / static_cast<double>(n);
+    double sqSum = 0;
+    for (double x : samples) { sqSum += (x - mean) * (x - mean); }
+    // Sample standard deviation
+    //
+    double stddev = (n > 1) ? sqrt(sqSum / static_cast<double>(n - 1)) : 0;
+    return {
+        .m_median = median,
+        .m_mean = mean,
+        .m_stddev = stddev,
+        .m_min = samples.front(),
+        .m_max = samples.back()
+    };
+}
+
+double WARN_UNUSED ComputeGeomean(const std::vector<double>& values)
+{
+    ReleaseAssert(values.size() > 0);
+    double logSum = 0;
+    for (double x : values)
+    {
+        ReleaseAssert(x > 0);
+        logSum += log(x);
+    }
+    return exp(logSum / static_cast<double>(values.size()));
+}
+
+void SetUpArgTable(VM* vm, const std::string& scriptFilename, const std::vector<const char*>& args)
+{
+    // Same as 'luajitr': the script name is at index 0, and the arguments are at index 1, 2, ...
+    //
+    HeapPtr<TableObject> arg = TableObject::CreateEmptyTableObject(vm, 0U /*inlineCapacity*/, static_cast<uint32_t>(args.size() + 2) /*arrayCapacity*/);
+    TableObject::RawPutByValIntegerIndex(arg, 0 /*index*/, TValue::Create<tString>(vm->CreateStringObjectFromRawCString(scriptFilename.c_str())));
+    for (size_t i = 0; i < args.size(); i++)
+    {
+        TValue opt = TValue::Create<tString>(vm->CreateStringObjectFromRawCString(args[i]));
+        TableObject::RawPutByValIntegerIndex(arg, static_cast<int64_t>(i + 1) /*index*/, opt);
+    }
+
+    UserHeapPointer<void> strArg = vm->CreateStringObjectFromRawCString("arg");
+    HeapPtr<TableObject> globalObj = vm->GetRootGlobalObject();
+    PutByIdICInfo info;
+    TableObject::PreparePutByIdForGlobalObject(globalObj, strArg, info);
+    TableObject::PutById(globalObj, strArg, TValue::Create<tTable>(arg), info);
+}
+
+RunResult WARN_UNUSED RunBenchmarkOnce(const BenchOptions& options, const BenchmarkDesc& bench, const TierConfig& tier)
+{
+    RunResult result {};
+
+    // Some benchmarks read the input data from stdin, so rewind it for every run
+    //
+    if (options.m_inputFile != "")
+    {
+        if (freopen(options.m_inputFile.c_str(), "rb", stdin) == nullptr)
+        {
+            std::ignore = freopen("/dev/null", "rb", stdin);
+        }
+    }
+
+    FILE* devNull = fopen("/dev/null", "w");
+    ReleaseAssert(devNull != nullptr);
+    Auto(fclose(devNull));
+    FILE* errFile = tmpfile();
+    ReleaseAssert(errFile != nullptr);
+    Auto(fclose(errFile));
+
+    PerfTimer totalTimer;
+
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+    vm->SetEngineStartingTier(tier.m_startingTier);
+    vm->SetEngineMaxTier(tier.m_maxTier);
+    {
+        std::string errMsg;
+        if (!SetVMOptionsFromString(vm, options.m_vmOptions.c_str(), errMsg /*out*/))
+        {
+            fprintf(stderr, "[ERROR] --vm-options: %s\n", errMsg.c_str());
+            result.m_success = false;
+            return result;
+        }
+    }
+    vm->RedirectStdout(devNull);
+    vm->RedirectStderr(errFile);
+
+    std::string scriptFilename = options.m_benchDir + "/" + bench.m_name + ".lua";
+    SetUpArgTable(vm, scriptFilename, bench.m_args);
+
+    PerfTimer parseTimer;
+    ParseResult pr = ParseLuaScriptFromFile(vm->GetRootCoroutine(), scriptFilename.c_str());
+    result.m_parseTime = parseTimer.GetElapsedTime();
+    if (pr.m_scriptModule.get() == nullptr)
+    {
+        fprintf(stderr, "[ERROR] Failed to parse benchmark '%s'. Error message:\n", scriptFilename.c_str());
+        PrintTValue(stderr, pr.errMsg);
+        fprintf(stderr, "\n");
+        result.m_success = false;
+        return result;
+    }
+
+    vm->LaunchScript(pr.m_scriptModule.get());
+
+    result.m_totalTime = totalTimer.GetElapsedTime();
+    result.m_baselineJitCompileTime = vm->GetTotalBaselineJitCompilationTime();
+    result.m_numBaselineJitCompilations = vm->GetNumTotalBaselineJitCompilations();
+    result.m_jitCodeBytes = vm->GetJITMemoryAlloc()->GetTotalJITCodeSize();
+    result.m_userHeapBytes = vm->GetUserHeapBytesAllocated();
+    result.m_systemHeapBytes = vm->GetSystemHeapBytesAllocated();
+    result.m_structureStats = vm->GetStructureStatistics();
+
+    // An uncaught Lua error is reported to stderr
+    //
+    // The VM output buffer writes to the file descriptor directly, so seek to the end to get the actual file size
+    //
+    fflush(errFile);
+    ReleaseAssert(fseek(errFile, 0, SEEK_END) == 0);
+    result.m_success = (ftell(errFile) == 0);
+    if (!result.m_success)
+    {
+        fprintf(stderr, "[ERROR] Benchmark '%s' (tier = %s) wrote to stderr:\n", bench.m_name, tier.m_name);
+        rewind(errFile);
+        char buf[1024];
+        size_t len;
+        while ((len = fread(buf, 1, sizeof(buf), errFile)) > 0)
+        {
+            fwrite(buf, 1, len, stderr);
+        }
+    }
+    return result;
+}
+
+json_t WARN_UNUSED StatisticsToJson(const SampleStatistics& stats)
+{
+    json_t j = json_t::object();
+    j["median"] = stats.m_median;
+    j["mean"] = stats.m_mean;
+    j["stddev"] = stats.m_stddev;
+    j["min"] = stats.m_min;
+    j["max"] = stats.m_max;
+    return j;
+}
+
+// Run one benchmark under one tier configuration, returns nullopt on failure
+//
+std::optional<json_t> WARN_UNUSED RunBenchmark(const BenchOptions& options, const BenchmarkDesc& bench, const TierConfig& tier)
+{
+    for (size_t i = 0; i < options.m_numWarmupIterations; i++)
+    {
+        RunResult r = RunBenchmarkOnce(options, bench, tier);
+        if (!r.m_success) { return std::nullopt; }
+    }
+
+    std::vector<RunResult> results;
+    for (size_t i = 0; i < options.m_numIterations; i++)
+    {
+        RunResult r = RunBenchmarkOnce(options, bench, tier);
+        if (!r.m_success) { return std::nullopt; }
+        results.push_back(r);
+    }
+
+    auto collect = [&](auto getter) -> SampleStatistics
+    {
+        std::vector<double> samples;
+        for (const RunResult& r : results) { samples.push_back(static_cast<double>(getter(r))); }
+        return ComputeStatistics(samples);
+    };
+
+    SampleStatistics totalTime = collect([](const RunResult& r) { return r.m_totalTime; });
+    SampleStatistics parseTime = collect([](const RunResult& r) { return r.m_parseTime; });
+    SampleStatistics compileTime = collect([](const RunResult& r) { return r.m_baselineJitCompileTime; });
+
+    json_t j = json_t::object();
+    j["benchmark"] = bench.m_name;
+    j["tier"] = tier.m_name;
+    json_t samples = json_t::array();
+    for (const RunResult& r : results) { samples.push_back(r.m_totalTime); }
+    j["samples"] = samples;
+    j["time"] = StatisticsToJson(totalTime);
+    j["parse_time"] = StatisticsToJson(parseTime);
+    j["baseline_jit_compile_time"] = StatisticsToJson(compileTime);
+    // Execution time excluding parsing and compilation
+    //
+    j["execution_time"] = StatisticsToJson(collect([](const RunResult& r) { return r.m_totalTime - r.m_parseTime - r.m_baselineJitCompileTime; }));
+    // The following are deterministic for a given benchmark and tier, so only the last run is reported
+    //
+    j["baseline_jit_compilations"] = results.back().m_numBaselineJitCompilations;
+    j["jit_code_bytes"] = results.back().m_jitCodeBytes;
+    j["user_heap_bytes"] = results.back().m_userHeapBytes;
+    j["system_heap_bytes"] = results.back().m_systemHeapBytes;
+    {
+        const VM::StructureStatistics& ss = results.back().m_structureStats;
+        j["structures"] = ss.m_numStructures;
+        j["structure_bytes"] = ss.m_structureBytes;
+        j["structure_anchor_hash_table_bytes"] = ss.m_anchorHashTableBytes;
+        j["structure_transition_table_bytes"] = ss.m_transitionTableBytes;
+        j["structure_transition_table_bytes_reused"] = ss.m_transitionTableBytesReused;
+        j["cacheable_dictionaries"] = ss.m_numCacheableDictionaries;
+        j["dictionary_hash_table_bytes"] = ss.m_dictionaryHashTableBytes;
+    }
+
+    fprintf(stderr, "%-20s %-12s median %9.4fs  stddev %7.4fs (%5.2f%%)  exec %9.4fs  compile %7.4fs (%llu fns)  heap %8.2fMB\n",
+            bench.m_name, tier.m_name, totalTime.m_median, totalTime.m_stddev,
+            totalTime.m_median > 0 ? totalTime.m_stddev / totalTime.m_median * 100 : 0.0,
+            totalTime.m_median - parseTime.m_median - compileTime.m_median,
+            compileTime.m_median,
+            static_cast<unsigned long long>(results.back().m_numBaselineJitCompilations),
+            static_cast<double>(results.back().m_userHeapBytes + results.back().m_systemHeapBytes) / 1048576.0);
+
+    return j;
+}
+
+// Compare the results against a saved baseline, returns false if any benchmark regressed beyond the threshold
+//
+bool WARN_UNUSED CompareWithBaseline(const BenchOptions& options, json_t& current, json_t& baseline)
+{
+    std::map<std::pair<std::string, std::string>, double> baselineMedians;
+    for (json_t& r : baseline["results"])
+    {
+        std::string name = JSONCheckedGet<std::string>(r, "benchmark");
+        std::string tier = JSONCheckedGet<std::string>(r, "tier");
+        baselineMedians[std::make_pair(name, tier)] = JSONCheckedGet<double>(r["time"], "median");
+    }
+
+    bool ok = true;
+    std::map<std::string, std::vector<double>> ratiosByTier;
+    fprintf(stderr, "\n%-20s %-12s %12s %12s %9s\n", "benchmark", "tier", "baseline", "current", "change");
+    for (json_t& r : current["results"])
+    {
+        std::string name = JSONCheckedGet<std::string>(r, "benchmark");
+        std::string tier = JSONCheckedGet<std::string>(r, "tier");
+        double cur = JSONCheckedGet<double>(r["time"], "median");
+        auto it = baselineMedians.find(std::make_pair(name, tier));
+        if (it == baselineMedians.end())
+        {
+            fprintf(stderr, "%-20s %-12s %12s %11.4fs %9s\n", name.c_str(), tier.c_str(), "(none)", cur, "");
+            continue;
+        }
+        double base = it->second;
+        double ratio = cur / base;
+        ratiosByTier[tier].push_back(ratio);
+        double changePercent = (ratio - 1) * 100;
+        bool regressed = changePercent > options.m_regressionThresholdPercent;
+        if (regressed) { ok = false; }
+        fprintf(stderr, "%-20s %-12s %11.4fs %11.4fs %+8.2f%%%s\n", name.c_str(), tier.c_str(), base, cur, changePercent, regressed ? "  REGRESSION" : "");
+    }
+
+    for (auto& it : ratiosByTier)
+    {
+        double geomeanRatio = ComputeGeomean(it.second);
+        fprintf(stderr, "Geomean change (tier = %s): %+.2f%%\n", it.first.c_str(), (geomeanRatio - 1) * 100);
+        current["comparison"][it.first]["geomean_ratio"] = geomeanRatio;
+    }
+    return ok;
+}
+
+void PrintUsage()
+{
+    fprintf(stderr, "usage: luajitr_bench [options] [benchmark]...\n\n");
+    fprintf(stderr, "Runs the benchmarks in-process and reports statistics. Runs all benchmarks in run_bench.sh if none is given.\n\n");
+    fprintf(stderr, "options:\n");
+    fprintf(stderr, "  --iterations=N     number of measured iterations (default 5)\n");
+    fprintf(stderr, "  --warmup=N         number of warmup iterations (default 1)\n");
+    fprintf(stderr, "  --tier=T[,T...]    tier configurations to run: interpreter, baseline, tierup (default tierup)\n");
+    fprintf(stderr, "  --bench-dir=DIR    directory of the benchmark scripts (default luabench)\n");
+    fprintf(stderr, "  --input=FILE       file fed to stdin of each run (default luabench/FASTA_5000000)\n");
+    fprintf(stderr, "  --json=FILE        write the results as JSON to FILE\n");
+    fprintf(stderr, "  --compare=FILE     compare against a JSON file saved by --json, exits with 1 on regression\n");
+    fprintf(stderr, "  --threshold=PCT    regression threshold in percent of the median time for --compare (default 5)\n");
+    fprintf(stderr, "  --vm-options=LIST  VM options applied to every run, as a comma-separated list of name=value (see luajitr --list-vm-options)\n");
+    fprintf(stderr, "  --bytecode-pair-profile=FILE  write the interpreter bytecode pair profile over all runs to FILE\n");
+    fprintf(stderr, "                     (needs a build with x_deegen_enable_interpreter_bytecode_pair_profiling)\n");
+}
+
+bool WARN_UNUSED ParseOptions(int argc, char** argv, BenchOptions& options /*out*/)
+{
+    auto startsWith = [](const char* s, const char* prefix, const char*& rest /*out*/) -> bool
+    {
+        size_t len = strlen(prefix);
+        if (strncmp(s, prefix, len) != 0) { return false; }
+        rest = s + len;
+        return true;
+    };
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        const char* val;
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0)
+        {
+            return false;
+        }
+        else if (startsWith(arg, "--iterations=", val /*out*/))
+        {
+            options.m_numIterations = static_cast<size_t>(atoll(val));
+            if (options.m_numIterations == 0) { return false; }
+        }
+        else if (startsWith(arg, "--warmup=", val /*out*/))
+        {
+            options.m_numWarmupIterations = static_cast<size_t>(atoll(val));
+        }
+        else if (startsWith(arg, "--tier=", val /*out*/))
+        {
+            std::stringstream ss(val);
+            std::string name;
+            while (std::getline(ss, name, ','))
+            {
+                const TierConfig* found = nullptr;
+                for (const TierConfig& tc : x_tierConfigs)
+                {
+                    if (name == tc.m_name) { found = &tc; }
+                }
+                if (found == nullptr)
+                {
+                    fprintf(stderr, "[ERROR] Unknown tier '%s'\n", name.c_str());
+                    return false;
+                }
+                options.m_tiers.push_back(found);
+            }
+        }
+        else if (startsWith(arg, "--bench-dir=", val /*out*/))
+        {
+            options.m_benchDir = val;
+        }
+        else if (startsWith(arg, "--input=", val /*out*/))
+        {
+            options.m_inputFile = val;
+        }
+        else if (startsWith(arg, "--json=", val /*out*/))
+        {
+            options.m_jsonOutputFile = val;
+        }
+        else if (startsWith(arg, "--compare=", val /*out*/))
+        {
+            options.m_compareBaselineFile = val;
+        }
+        else if (startsWith(arg, "--threshold=", val /*out*/))
+        {
+            options.m_regressionThresholdPercent = atof(val);
+        }
+        else if (startsWith(arg, "--vm-options=", val /*out*/))
+        {
+            options.m_vmOptions = val;
+        }
+        else if (startsWith(arg, "--bytecode-pair-profile=", val /*out*/))
+        {
+            options.m_bytecodePairProfileFile = val;
+        }
+        else if (arg[0] == '-')
+        {
+            fprintf(stderr, "[ERROR] Unknown option '%s'\n", arg);
+            return false;
+        }
+        else
+        {
+            std::string name = arg;
+            if (name.ends_with(".lua")) { name = name.substr(0, name.length() - 4); }
+            options.m_selectedBenchmarks.push_back(name);
+        }
+    }
+
+    if (options.m_tiers.empty())
+    {
+        options.m_tiers.push_back(&x_tierConfigs[2]);
+    }
+    return true;
+}
+
+}   // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, options /*out*/))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    if (options.m_bytecodePairProfileFile != "" && !IsInterpreterBytecodePairProfilingEnabled())
+    {
+        fprintf(stderr, "[ERROR] --bytecode-pair-profile needs a build with x_deegen_enable_interpreter_bytecode_pair_profiling\n");
+        return 1;
+    }
+
+    if (x_isTestBuild)
+    {
+        fprintf(stderr, "[WARNING] This is a %s. Benchmark results are not meaningful unless using a release build.\n", x_build_flavor_version_output);
+    }
+
+    std::vector<const BenchmarkDesc*> benchList;
+    if (options.m_selectedBenchmarks.empty())
+    {
+        for (const BenchmarkDesc& bench : x_defaultBenchmarkList) { benchList.push_back(&bench); }
+    }
+    else
+    {
+        for (const std::string& name : options.m_selectedBenchmarks)
+        {
+            const BenchmarkDesc* found = nullptr;
+            for (const BenchmarkDesc& bench : x_defaultBenchmarkList)
+            {
+                if (name == bench.m_name) { found = &bench; }
+            }
+            if (found == nullptr)
+            {
+                fprintf(stderr, "[ERROR] Unknown benchmark '%s'\n", name.c_str());
+                return 1;
+            }
+            benchList.push_back(found);
+        }
+    }
+
+    json_t output = json_t::object();
+    output["git_commit_hash"] = x_git_commit_hash;
+    output["build_flavor"] = x_build_flavor_version_output;
+    output["iterations"] = options.m_numIterations;
+    output["warmup_iterations"] = options.m_numWarmupIterations;
+    output["vm_options"] = options.m_vmOptions;
+    output["results"] = json_t::array();
+
+    bool hasFailure = false;
+    std::map<std::string, std::vector<double>> mediansByTier;
+    for (const BenchmarkDesc* bench : benchList)
+    {
+        for (const TierConfig* tier : options.m_tiers)
+        {
+            std::optional<json_t> res = RunBenchmark(options, *bench, *tier);
+            if (!res.has_value())
+            {
+                hasFailure = true;
+                continue;
+            }
+            mediansByTier[tier->m_name].push_back(JSONCheckedGet<double>(res.value()["time"], "median"));
+            output["results"].push_back(res.value());
+        }
+    }
+
+    for (auto& it : mediansByTier)
+    {
+        double geomean = ComputeGeomean(it.second);
+        output["geomean"][it.first] = geomean;
+        fprintf(stderr, "Geomean of median time (tier = %s): %.4fs over %d benchmarks\n", it.first.c_str(), geomean, static_cast<int>(it.second.size()));
+    }
+
+    if (options.m_bytecodePairProfileFile != "")
+    {
+        FILE* fp = fopen(options.m_bytecodePairProfileFile.c_str(), "w");
+        if (fp == nullptr)
+        {
+            fprintf(stderr, "[ERROR] Failed to open bytecode pair profile file '%s'\n", options.m_bytecodePairProfileFile.c_str());
+            return 1;
+        }
+        PrintInterpreterBytecodePairProfile(fp, 1000 /*maxPairs*/);
+        fclose(fp);
+    }
+
+    bool regressed = false;
+    if (options.m_compareBaselineFile != "")
+    {
+        std::ifstream f(options.m_compareBaselineFile);
+        if (!f.good())
+        {
+            fprintf(stderr, "[ERROR] Failed to open baseline file '%s'\n", options.m_compareBaselineFile.c_str());
+            return 1;
+        }
+        json_t baseline = json_t::parse(f);
+        regressed = !CompareWithBaseline(options, output, baseline);
+    }
+
+    if (options.m_jsonOutputFile != "")
+    {
+        std::ofstream f(options.m_jsonOutputFile);
+        f << output.dump(4) << std::endl;
+        if (!f.good())
+        {
+            fprintf(stderr, "[ERROR] Failed to write JSON output file '%s'\n", options.m_jsonOutputFile.c_str());
+            return 1;
+        }
+    }
+    else
+    {
+        printf("%s\n", output.dump(4).c_str());
+    }
+
+    return (hasFailure || regressed) ? 1 : 0;
+}
@@ -1,5 +1,6 @@
 #include "runtime_utils.h"
 #include "lj_parser_wrapper.h"
+#include "interpreter_bytecode_pair_profile.h"
 
 #define LJR_VERSION_MAJOR_NUMBER 0
 #define LJR_VERSION_MINOR_NUMBER 0
@@ -19,13 +20,152 @@ static void PrintLJRVersion()
 static void PrintLJRUsage()
 {
     PrintLJRVersion();
-    fprintf(stderr, "\nusage: luajitr <script> [args]...\n");
+    fprintf(stderr, "\nusage: luajitr [options] <script> [args]...\n");
+    fprintf(stderr, "Available options are:\n");
+    fprintf(stderr, "  -v                 show version information\n");
+    fprintf(stderr, "  -O name=value,...  set VM options, overriding the ones set by the environment variable LJR_OPTIONS\n");
+    fprintf(stderr, "  --list-vm-options  list the VM options and their default values\n");
+}
+
+static void SetVMOptionsOrDie(VM* vm, const char* options, const char* source)
+{
+    std::string errMsg;
+    if (!SetVMOptionsFromString(vm, options, errMsg /*out*/))
+    {
+        fprintf(stderr, "%s: %s\n", source, errMsg.c_str());
+        exit(1);
+    }
+}
+
+// If the environment variable LJR_EVENT_LOG is set, the VM event log (see VMEventLog) is enabled, and dumped to the file
+// named by it ('-' for stderr) when the script finishes: first the summary aggregated by function, then the individual events.
+// LJR_EVENT_LOG_SIZE optionally sets the number of most recent events retained.
+//
+static const char* WARN_UNUSED SetupEventLogFromEnvironment(VM* vm)
+{
+    const char* eventLogFile = getenv("LJR_EVENT_LOG");
+    if (eventLogFile == nullptr || *eventLogFile == '\0')
+    {
+        return nullptr;
+    }
+    size_t capacity = VMEventLog::x_defaultCapacity;
+    const char* capacityStr = getenv("LJR_EVENT_LOG_SIZE");
+    if (capacityStr != nullptr && *capacityStr != '\0')
+    {
+        char* end;
+        unsigned long long value = strtoull(capacityStr, &end, 10);
+        if (*end != '\0' || value == 0 || value > (1ULL << 31))
+        {
+            fprintf(stderr, "Invalid LJR_EVENT_LOG_SIZE '%s', expects an integer in [1, 2^31]\n", capacityStr);
+            exit(1);
+        }
+        capacity = static_cast<size_t>(value);
+    }
+    vm->EnableEventLog(capacity);
+    return eventLogFile;
+}
+
+static void DumpEventLog(VM* vm, const char* eventLogFile)
+{
+    VMEventLog* log = vm->GetEventLog();
+    Assert(log != nullptr);
+    bool isStderr = (strcmp(eventLogFile, "-") == 0);
+    FILE* fp = isStderr ? vm->GetStderr() : fopen(eventLogFile, "w");
+    if (fp == nullptr)
+    {
+        fprintf(stderr, "Failed to open event log file '%s'\n", eventLogFile);
+        return;
+    }
+    log->PrintSummary(fp);
+    fprintf(fp, "\n");
+    log->PrintEvents(fp);
+    if (!isStderr)
+    {
+        fclose(fp);
+    }
+}
+
+// If the environment variable LJR_BYTECODE_PAIR_PROFILE is set, the interpreter bytecode pair profile (see
+// interpreter_bytecode_pair_profile.h) is dumped to the file named by it ('-' for stderr) when the script finishes.
+// The profile is only collected in builds with x_deegen_enable_interpreter_bytecode_pair_profiling.
+//
+static void DumpBytecodePairProfileIfRequested(VM* vm)
+{
+    const char* profileFile = getenv("LJR_BYTECODE_PAIR_PROFILE");
+    if (profileFile == nullptr || *profileFile == '\0')
+    {
+        return;
+    }
+    bool isStderr = (strcmp(profileFile, "-") == 0);
+    FILE* fp = isStderr ? vm->GetStderr() : fopen(profileFile, "w");
+    if (fp == nullptr)
+    {
+        fprintf(stderr, "Failed to open bytecode pair profile file '%s'\n", profileFile);
+        return;
+    }
+    PrintInterpreterBytecodePairProfile(fp, 200 /*maxPairs*/);
+    if (!isStderr)
+    {
+        fclose(fp);
+    }
 }
 
 static void LaunchScript(int argc, char** argv)
 {
     Assert(argc >= 2);
     VM* vm = VM::Create();
+    const char* eventLogFile = SetupEventLogFromEnvironment(vm);
+
+    const char* envOptions = getenv("LJR_OPTIONS");
+    if (envOptions != nullptr)
+    {
+        SetVMOptionsOrDie(vm, envOptions, "LJR_OPTIONS");
+    }
+
+    // Parse the options before the script name
+    //
+    int scriptArgOrd = 1;
+    while (scriptArgOrd < argc && argv[scriptArgOrd][0] == '-')
+    {
+        const char* option = argv[scriptArgOrd];
+        if (strcmp(option, "-O") == 0)
+        {
+            if (scriptArgOrd + 1 >= argc)
+            {
+                fprintf(stderr, "'-O' needs an argument\n");
+                exit(1);
+            }
+            SetVMOptionsOrDie(vm, argv[scriptArgOrd + 1], "-O");
+            scriptArgOrd += 2;
+        }
+        else if (strncmp(option, "-O", 2) == 0)
+        {
+            SetVMOptionsOrDie(vm, option + 2, "-O");
+            scriptArgOrd++;
+        }
+        else if (strcmp(option, "--list-vm-options") == 0)
+        {
+            fprintf(stderr, "VM options (name = current value [min, max] description):\n");
+            PrintVMOptions(vm, stderr);
+            exit(0);
+        }
+        else if (strcmp(option, "--") == 0)
+        {
+            scriptArgOrd++;
+            break;
+        }
+        else
+        {
+            fprintf(stderr, "unrecognized option '%s'\n", option);
+            PrintLJRUsage();
+            exit(1);
+        }
+    }
+    if (scriptArgOrd >= argc)
+    {
+        PrintLJRUsage();
+        exit(1);
+    }
 
     // According to Lua Standard:
     //     Before starting to run the script, lua collects all arguments in the command line in a global table called arg.
@@ -33,12 +173,10 @@ static void LaunchScript(int argc, char** argv)
     //     Any arguments before the script name (that is, the interpreter name plus the options) go to negative indices.
     //
     HeapPtr<TableObject> arg = TableObject::CreateEmptyTableObject(vm, 0U /*inlineCapacity*/, static_cast<uint32_t>(argc) /*arrayCapacity*/);
-    // TODO: this needs to be changed when we support options
-    //
     for (int i = 0; i < argc; i++)
     {
         TValue opt = TValue::Create<tString>(vm->CreateStringObjectFromRawCString(argv[i]));
-        TableObject::RawPutByValIntegerIndex(arg, i - 1 /*index*/, opt);
+        TableObject::RawPutByValIntegerIndex(arg, i - scriptArgOrd /*index*/, opt);
     }
 
     {
@@ -49,7 +187,7 @@ static void LaunchScript(int argc, char** argv)
         TableObject::PutById(globalObj, strArg, TValue::Create<tTable>(arg), info);
     }
 
-    const char* scriptFilename = argv[1];
+    const char* scriptFilename = argv[scriptArgOrd];
     ParseResult pr = ParseLuaScriptFromFile(vm->GetRootCoroutine(), scriptFilename);
     if (pr.m_scriptModule.get() == nullptr)
     {
@@ -60,6 +198,12 @@ static void LaunchScript(int argc, char** argv)
     }
 
     vm->LaunchScript(pr.m_scriptModule.get());
+
+    if (eventLogFile != nullptr)
+    {
+        DumpEventLog(vm, eventLogFile);
+    }
+    DumpBytecodePairProfileIfRequested(vm);
 }
 
 int main(int argc, char** argv)
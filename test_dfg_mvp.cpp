@@ -16,43 +16,49 @@
 
 using namespace dfg;
 
-// 'm' must be a freshly parsed module that has not been executed yet
-// Run a minimal end-to-end DFG pipeline that compiles each function to DFG code without speculative inlining or value profile
+// Run a minimal end-to-end DFG pipeline that compiles 'cb' to DFG code without speculative inlining or value profile
 //
-inline void RunMinimalDfgCompilationPipeline(ScriptModule* m)
+inline void RunMinimalDfgCompilationPipelineForCodeBlock(CodeBlock* cb)
 {
-    for (UnlinkedCodeBlock* ucb : m->m_unlinkedCodeBlocks)
-    {
-        CodeBlock* cb = ucb->m_defaultCodeBlock;
-        ReleaseAssert(cb != nullptr);
-        arena_unique_ptr<Graph> graph = RunDfgFrontend(cb);
-        ReleaseAssert(ValidateDfgIrGraph(graph.get()));
+    ReleaseAssert(cb != nullptr);
+    arena_unique_ptr<Graph> graph = RunDfgFrontend(cb);
+    ReleaseAssert(ValidateDfgIrGraph(graph.get()));
 
-        TempArenaAllocator alloc;
-        std::ignore = RunPredictionPropagationWithoutValueProfile(alloc, graph.get());
+    TempArenaAllocator alloc;
+    std::ignore = RunPredictionPropagationWithoutValueProfile(alloc, graph.get());
 
-        RunSpeculationAssignmentPass(graph.get());
+    RunSpeculationAssignmentPass(graph.get());
 
-        RunPhantomInsertionPass(graph.get());
-        StackLayoutPlanningResult slp = RunStackLayoutPlanningPass(alloc, graph.get());
-        RunRegisterBankAssignmentPass(graph.get());
-        ReleaseAssert(ValidateDfgIrGraph(graph.get()));
-        DfgBackendResult backendResult = RunDfgBackend(alloc, graph.get(), slp);
-        ReleaseAssert(ValidateDfgIrGraph(graph.get()));
+    RunPhantomInsertionPass(graph.get());
+    StackLayoutPlanningResult slp = RunStackLayoutPlanningPass(alloc, graph.get());
+    RunRegisterBankAssignmentPass(graph.get());
+    ReleaseAssert(ValidateDfgIrGraph(graph.get()));
+    DfgBackendResult backendResult = RunDfgBackend(alloc, graph.get(), slp);
+    ReleaseAssert(ValidateDfgIrGraph(graph.get()));
 
-        DfgCodeBlock* dcb = backendResult.m_dfgCodeBlock;
-        ReleaseAssert(dcb != nullptr);
+    DfgCodeBlock* dcb = backendResult.m_dfgCodeBlock;
+    ReleaseAssert(dcb != nullptr);
 
-        // fprintf(stderr, "New function:\n");
-        // fprintf(stderr, "cb stackSlots = %d, dcb stackSlots = %d\n", static_cast<int>(cb->m_stackFrameNumSlots), static_cast<int>(dcb->m_stackFrameNumSlots));
-        // fprintf(stderr, "%s\n", backendResult.m_codegenLogDump);
-        // fprintf(stderr, "JIT: [%llx, %llx)\n\n", reinterpret_cast<unsigned long long>(dcb->m_jitCodeEntry), reinterpret_cast<unsigned long long>(dcb->m_jitRegionStart) + dcb->m_jitRegionSize);
+    // fprintf(stderr, "New function:\n");
+    // fprintf(stderr, "cb stackSlots = %d, dcb stackSlots = %d\n", static_cast<int>(cb->m_stackFrameNumSlots), static_cast<int>(dcb->m_stackFrameNumSlots));
+    // fprintf(stderr, "%s\n", backendResult.m_codegenLogDump);
+    // fprintf(stderr, "JIT: [%llx, %llx)\n\n", reinterpret_cast<unsigned long long>(dcb->m_jitCodeEntry), reinterpret_cast<unsigned long long>(dcb->m_jitRegionStart) + dcb->m_jitRegionSize);
 
-        ReleaseAssert(cb->m_dfgCodeBlock == nullptr);
-        cb->m_dfgCodeBlock = dcb;
-        cb->UpdateBestEntryPoint(dcb->m_jitCodeEntry);
+    ReleaseAssert(cb->m_dfgCodeBlock == nullptr);
+    cb->m_dfgCodeBlock = dcb;
+    cb->UpdateBestEntryPoint(dcb->m_jitCodeEntry);
 
-        ReleaseAssert(cb->m_bestEntryPoint == dcb->m_jitCodeEntry);
+    ReleaseAssert(cb->m_bestEntryPoint == dcb->m_jitCodeEntry);
+}
+
+// 'm' must be a freshly parsed module that has not been executed yet
+// Compile each function in the module with RunMinimalDfgCompilationPipelineForCodeBlock
+//
+inline void RunMinimalDfgCompilationPipeline(ScriptModule* m)
+{
+    for (UnlinkedCodeBlock* ucb : m->m_unlinkedCodeBlocks)
+    {
+        RunMinimalDfgCompilationPipelineForCodeBlock(ucb->m_defaultCodeBlock);
     }
 }
 
@@ -70,8 +76,7 @@ inline void RunSimpleLuaTestWithDfgMvp(const std::string& filename, const std::s
 
     if (manualStackSize != static_cast<size_t>(-1))
     {
-        CoroutineRuntimeContext* rc = vm->GetRootCoroutine();
-        rc->m_stackBegin = new TValue[manualStackSize];
+        SetRootCoroutineStackSize(vm, manualStackSize);
     }
 
     vm->LaunchScript(module.get());
@@ -1197,3 +1202,97 @@ TEST(DfgMvp, towers)
     RunSimpleLuaTestWithDfgMvp("luatests/towers.lua", "LuaBenchmark");
 }
 
+// Simulate OSR exits at every bytecode of every function, so the DFG code gets jettisoned,
+// then recompile the functions with the widened speculations and check that the recompiled code still works
+//
+TEST(DfgMvp, OsrExitJettisonAndRecompile)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+    vm->SetEngineStartingTier(VM::EngineStartingTier::BaselineJIT);
+    vm->SetEngineMaxTier(VM::EngineMaxTier::BaselineJIT);
+    vm->EnableEventLog();
+    VMOutputInterceptor vmoutput(vm);
+
+    std::string errMsg;
+    ReleaseAssert(SetVMOptionsFromString(vm, "dfg_jettison_threshold=5,dfg_widening_threshold=1,dfg_max_recompilations=1", errMsg));
+
+    std::unique_ptr<ScriptModule> module = ParseLuaScriptOrFail("luatests/fib.lua", LuaTestOption::ForceBaselineJit);
+    RunMinimalDfgCompilationPipeline(module.get());
+
+    std::vector<void*> jettisonedJitRegions;
+    size_t numFunctions = 0;
+    size_t numExits = 0;
+    for (UnlinkedCodeBlock* ucb : module->m_unlinkedCodeBlocks)
+    {
+        CodeBlock* cb = ucb->m_defaultCodeBlock;
+        DfgCodeBlock* dcb = cb->m_dfgCodeBlock;
+        BaselineCodeBlock* bcb = cb->m_baselineCodeBlock;
+        ReleaseAssert(dcb != nullptr && bcb != nullptr);
+        ReleaseAssert(cb->m_dfgOsrExitProfile == nullptr);
+        ReleaseAssert(vm->ShouldAllowDfgCompilation(cb));
+
+        // Exit at every bytecode until the DFG code is jettisoned.
+        // Exits from a jettisoned DfgCodeBlock are still profiled, but must not jettison anything else.
+        //
+        size_t numExitsInFunction = 0;
+        while (numExitsInFunction < 5 || numExitsInFunction < bcb->m_numBytecodes)
+        {
+            vm->RecordDfgOsrExit(dcb, cb, numExitsInFunction % bcb->m_numBytecodes, x_typeMaskFor<tBoxedValueTop>);
+            numExitsInFunction++;
+            ReleaseAssert(dcb->m_numOsrExits == numExitsInFunction);
+            ReleaseAssertIff(cb->m_dfgCodeBlock == nullptr, numExitsInFunction >= 5);
+        }
+        numFunctions++;
+        numExits += numExitsInFunction;
+
+        ReleaseAssert(cb->m_numDfgJettisons == 1);
+        ReleaseAssert(cb->m_bestEntryPoint == bcb->m_jitCodeEntry);
+        ReleaseAssert(vm->ShouldAllowDfgCompilation(cb));
+        ReleaseAssert(cb->m_dfgOsrExitProfile != nullptr);
+        for (size_t i = 0; i < bcb->m_numBytecodes; i++)
+        {
+            DfgOsrExitProfile::Site* site = cb->m_dfgOsrExitProfile->GetSite(i);
+            ReleaseAssert(site != nullptr && site->m_numExits >= 1);
+            ReleaseAssert(site->m_exitValueTypeMask == x_typeMaskFor<tBoxedValueTop>);
+        }
+        jettisonedJitRegions.push_back(dcb->m_jitRegionStart);
+
+        RunMinimalDfgCompilationPipelineForCodeBlock(cb);
+    }
+    ReleaseAssert(vm->GetDfgOsrExitStatistics().m_numOsrExits == numExits);
+    ReleaseAssert(vm->GetDfgOsrExitStatistics().m_numJettisons == numFunctions);
+
+    size_t numJettisonEvents = 0;
+    vm->GetEventLog()->ForEachEvent([&](const VMEvent& e) {
+        if (e.m_kind == VMEventKind::DfgJitCodeJettisoned)
+        {
+            numJettisonEvents++;
+        }
+    });
+    ReleaseAssert(numJettisonEvents == numFunctions);
+
+    vm->LaunchScript(module.get());
+
+    std::string out = vmoutput.GetAndResetStdOut();
+    std::string err = vmoutput.GetAndResetStdErr();
+    AssertOutputAgreesWithExpectedOutputFile(out, GetExpectedOutputFileNameForTestCase("LuaTest", "Fib", "" /*suffix*/));
+    ReleaseAssert(err == "");
+
+    // After the recompiled DFG code is jettisoned again, the function has used up its recompilation
+    //
+    for (UnlinkedCodeBlock* ucb : module->m_unlinkedCodeBlocks)
+    {
+        CodeBlock* cb = ucb->m_defaultCodeBlock;
+        jettisonedJitRegions.push_back(cb->m_dfgCodeBlock->m_jitRegionStart);
+        vm->JettisonDfgCode(cb);
+        ReleaseAssert(cb->m_numDfgJettisons == 2);
+        ReleaseAssert(!vm->ShouldAllowDfgCompilation(cb));
+    }
+
+    FreeScriptModuleJITMemory(module.get());
+    for (void* jitRegion : jettisonedJitRegions)
+    {
+        vm->GetJITMemoryAlloc()->Free(jitRegion);
+    }
+}
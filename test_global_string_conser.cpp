@@ -118,4 +118,57 @@ TEST(GlobalStringHashConser, Stress)
     ReleaseAssert(vec.size() == expectedMap.size());
 }
 
+// Number-to-string conversion must match '%.14g', and small integers must come from the cache
+//
+TEST(GlobalStringHashConser, NumberToString)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+
+    auto check = [&](double value)
+    {
+        char expected[64];
+        snprintf(expected, 64, "%.14g", value);
+        CheckStringObjectIsAsExpected(vm->CreateStringObjectFromDouble(value), expected, strlen(expected));
+        ReleaseAssert(vm->CreateStringObjectFromDouble(value) == vm->CreateStringObjectFromRawCString(expected));
+    };
+
+    double specialValues[] = {
+        0.0, -0.0, 1, -1, 0.5, -0.5, 1023, 1024, -1023, 1e14 - 1, -(1e14 - 1), 1e14, -1e14, 1e15, 2147483647.0, 2147483648.0,
+        -2147483648.0, -2147483649.0, 999999999.0, 1000000000.0, 1000000001.0, 123456789012.0, 1e300, 1e-300, 0.1, 1.0 / 3,
+        0.1 + 0.2, 123.456, -0.0001, 0.00001, 99999999999999.5, 0.30000000000000004
+    };
+    for (double value : specialValues)
+    {
+        check(value);
+    }
+    for (int i = 0; i < 100000; i++)
+    {
+        int64_t k = static_cast<int64_t>(static_cast<uint64_t>(rand()) * static_cast<uint64_t>(rand()) % 200000000000000ULL) - 100000000000000LL;
+        check(static_cast<double>(k >> (rand() % 48)));
+        check(static_cast<double>(rand() % 100000) / static_cast<double>(rand() % 1000 + 1));
+        // Non-integers across (and just beyond) the decimal exponents that '%.14g' prints in fixed notation
+        //
+        double scale = pow(10.0, rand() % 24 - 8);
+        check(static_cast<double>(rand()) / static_cast<double>(RAND_MAX) * scale);
+        check(-static_cast<double>(rand()) / static_cast<double>(RAND_MAX) * scale);
+        check(std::nextafter(scale, 0.0));
+        check(scale * (1 - 5e-15));
+        check(scale * 0.5 + static_cast<double>(rand() % 1000) * scale * 1e-14);
+    }
+
+    for (int32_t i = -5; i < 2000; i++)
+    {
+        char expected[64];
+        snprintf(expected, 64, "%d", static_cast<int>(i));
+        UserHeapPointer<HeapString> p = vm->CreateStringObjectFromInt32(i);
+        CheckStringObjectIsAsExpected(p, expected, strlen(expected));
+        ReleaseAssert(p == vm->CreateStringObjectFromDouble(i));
+        if (i >= 0 && static_cast<uint32_t>(i) < VM::x_numCachedSmallIntegerStrings)
+        {
+            ReleaseAssert(p == vm->GetStringForSmallInteger(static_cast<uint32_t>(i)));
+        }
+    }
+}
+
 }   // anonymous namespace
@@ -174,6 +174,45 @@ TEST(BaselineJitCallIc, Sanity_3_TierUp)
     RunSimpleLuaTest("luatests/baseline_jit_call_ic_sanity_3.lua", LuaTestOption::UpToBaselineJit);
 }
 
+TEST(BaselineJitCallIc, Megamorphic_1)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+    vm->SetEngineStartingTier(GetVMEngineStartingTierFromEngineTestOption(LuaTestOption::ForceBaselineJit));
+    vm->SetMaxJitCallInlineCacheEntries(2);
+    VMOutputInterceptor vmoutput(vm);
+
+    std::unique_ptr<ScriptModule> module = ParseLuaScriptOrFail("luatests/baseline_jit_call_ic_sanity_1.lua", LuaTestOption::ForceBaselineJit);
+    vm->LaunchScript(module.get());
+
+    std::string out = vmoutput.GetAndResetStdOut();
+    std::string err = vmoutput.GetAndResetStdErr();
+    AssertIsExpectedOutput(out);
+    ReleaseAssert(err == "");
+
+    // The IC site in 'f' should have cached 'add1' and 'add2', then became megamorphic,
+    // so all 3 calls to 'add3' should have gone through the megamorphic path
+    //
+    ReleaseAssert(vm->GetJitCallIcStatistics().m_numSitesBecameMegamorphic == 1);
+    ReleaseAssert(vm->GetJitCallIcStatistics().m_numMegamorphicCalls == 3);
+
+    size_t totalIcs = 0;
+    for (UnlinkedCodeBlock* ucb : module->m_unlinkedCodeBlocks)
+    {
+        if (ucb->m_numFixedArguments == 1 && !ucb->m_hasVariadicArguments)
+        {
+            CodeBlock* cb = ucb->m_defaultCodeBlock;
+            ReleaseAssert(cb != nullptr);
+            for (JitCallInlineCacheEntry* entry : cb->m_jitCallIcList.elements())
+            {
+                ReleaseAssert(entry->GetIcTrait()->m_isDirectCallMode);
+                totalIcs++;
+            }
+        }
+    }
+    ReleaseAssert(totalIcs == 2);
+}
+
 TEST(BaselineJitCallIc, Stress_1)
 {
     RunSimpleLuaTest("luatests/baseline_jit_call_ic_stress_direct_call_1.lua", LuaTestOption::ForceBaselineJit);
@@ -293,3 +332,274 @@ TEST(BaselineJitCallIc, Stress_8_TierUp)
 {
     RunSimpleLuaTest("luatests/baseline_jit_call_ic_stress_closure_call_4.lua", LuaTestOption::UpToBaselineJit);
 }
+
+TEST(BaselineJitCallIc, Eviction_1)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+    vm->SetEngineStartingTier(GetVMEngineStartingTierFromEngineTestOption(LuaTestOption::ForceBaselineJit));
+    vm->SetEngineMaxTier(VM::EngineMaxTier::BaselineJIT);
+    // Use a tiny budget so that every cold function is evicted
+    //
+    vm->SetJitCodeMemoryBudget(1);
+    VMOutputInterceptor vmoutput(vm);
+
+    auto launchAndCheckOutput = [&](ScriptModule* module)
+    {
+        vm->LaunchScript(module);
+        std::string out = vmoutput.GetAndResetStdOut();
+        std::string err = vmoutput.GetAndResetStdErr();
+        AssertIsExpectedOutput(out);
+        ReleaseAssert(err == "");
+    };
+
+    std::unique_ptr<ScriptModule> moduleA = ParseLuaScriptOrFail("luatests/baseline_jit_call_ic_sanity_1.lua", LuaTestOption::ForceBaselineJit);
+    launchAndCheckOutput(moduleA.get());
+
+    // Module A has just executed, so its code should survive the scan at the launch of module B
+    //
+    std::unique_ptr<ScriptModule> moduleB = ParseLuaScriptOrFail("luatests/baseline_jit_call_ic_sanity_1.lua", LuaTestOption::ForceBaselineJit);
+    launchAndCheckOutput(moduleB.get());
+    ReleaseAssert(vm->GetBaselineJitEvictionStatistics().m_numEvictionScans == 2);
+    ReleaseAssert(vm->GetBaselineJitEvictionStatistics().m_numCodeBlocksEvicted == 0);
+    for (UnlinkedCodeBlock* ucb : moduleA->m_unlinkedCodeBlocks)
+    {
+        ReleaseAssert(ucb->m_defaultCodeBlock->m_baselineCodeBlock != nullptr);
+    }
+
+    // Module A is not executed by the second launch of module B, so all of its code should be evicted by the next scan,
+    // together with all the call ICs owned by it. Module B should not be affected.
+    //
+    size_t jitMemoryBeforeEviction = vm->GetJITMemoryAlloc()->GetTotalJITCodeSize();
+    launchAndCheckOutput(moduleB.get());
+    ReleaseAssert(vm->GetBaselineJitEvictionStatistics().m_numEvictionScans == 3);
+    ReleaseAssert(vm->GetBaselineJitEvictionStatistics().m_numCodeBlocksEvicted == moduleA->m_unlinkedCodeBlocks.size());
+    ReleaseAssert(vm->GetBaselineJitEvictionStatistics().m_numBytesEvicted > 0);
+    ReleaseAssert(vm->GetJITMemoryAlloc()->GetTotalJITCodeSize() < jitMemoryBeforeEviction);
+
+    for (UnlinkedCodeBlock* ucb : moduleA->m_unlinkedCodeBlocks)
+    {
+        CodeBlock* cb = ucb->m_defaultCodeBlock;
+        ReleaseAssert(cb->m_baselineCodeBlock == nullptr);
+        ReleaseAssert(cb->m_bestEntryPoint == ucb->GetInterpreterEntryPoint());
+        ReleaseAssert(cb->m_jitCallIcList.IsEmpty());
+    }
+    for (UnlinkedCodeBlock* ucb : moduleB->m_unlinkedCodeBlocks)
+    {
+        ReleaseAssert(ucb->m_defaultCodeBlock->m_baselineCodeBlock != nullptr);
+    }
+
+    // The evicted code should still execute correctly
+    //
+    launchAndCheckOutput(moduleA.get());
+}
+
+// A coroutine left suspended (possibly forever) should not prevent eviction: only the code of the functions that have
+// a frame on its stack is kept, and it is evicted normally once the coroutine finishes
+//
+TEST(BaselineJitCallIc, Eviction_2)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+    vm->SetEngineStartingTier(GetVMEngineStartingTierFromEngineTestOption(LuaTestOption::ForceBaselineJit));
+    vm->SetEngineMaxTier(VM::EngineMaxTier::BaselineJIT);
+    vm->SetJitCodeMemoryBudget(1);
+    VMOutputInterceptor vmoutput(vm);
+
+    auto launch = [&](ScriptModule* module) -> std::string
+    {
+        vm->LaunchScript(module);
+        std::string err = vmoutput.GetAndResetStdErr();
+        ReleaseAssert(err == "");
+        return vmoutput.GetAndResetStdOut();
+    };
+
+    std::unique_ptr<ScriptModule> moduleC = ParseLuaScriptOrFail("luatests/baseline_jit_eviction_suspended_coroutine.lua", LuaTestOption::ForceBaselineJit);
+    ReleaseAssert(launch(moduleC.get()) == "9\ntrue\t2\n");
+
+    // The functions of module C, identified by the line where they are defined
+    //
+    auto getBaselineCodeBlock = [&](uint32_t lineDefined) -> BaselineCodeBlock*
+    {
+        for (UnlinkedCodeBlock* ucb : moduleC->m_unlinkedCodeBlocks)
+        {
+            if (ucb->m_lineDefined == lineDefined)
+            {
+                return ucb->m_defaultCodeBlock->m_baselineCodeBlock;
+            }
+        }
+        ReleaseAssert(false);
+    };
+    constexpr uint32_t x_lineOfChunk = 0;
+    constexpr uint32_t x_lineOfInner = 2;
+    constexpr uint32_t x_lineOfOuter = 6;
+    constexpr uint32_t x_lineOfUnused = 9;
+
+    // Module C is not executed by the second launch of module B, so its code becomes cold by the third scan,
+    // but 'inner' and 'outer' have frames on the stack of the suspended coroutine
+    //
+    std::unique_ptr<ScriptModule> moduleB = ParseLuaScriptOrFail("luatests/baseline_jit_call_ic_sanity_1.lua", LuaTestOption::ForceBaselineJit);
+    std::string outputOfModuleB = launch(moduleB.get());
+    ReleaseAssert(outputOfModuleB != "");
+    ReleaseAssert(launch(moduleB.get()) == outputOfModuleB);
+    ReleaseAssert(vm->GetBaselineJitEvictionStatistics().m_numEvictionScans == 3);
+    ReleaseAssert(vm->GetBaselineJitEvictionStatistics().m_numCodeBlocksEvicted > 0);
+    ReleaseAssert(getBaselineCodeBlock(x_lineOfChunk) == nullptr);
+    ReleaseAssert(getBaselineCodeBlock(x_lineOfUnused) == nullptr);
+    ReleaseAssert(getBaselineCodeBlock(x_lineOfInner) != nullptr);
+    ReleaseAssert(getBaselineCodeBlock(x_lineOfOuter) != nullptr);
+
+    // The coroutine returns into the code that is kept
+    //
+    std::unique_ptr<ScriptModule> moduleD = ParseLuaScriptOrFail("luatests/baseline_jit_eviction_resume_coroutine.lua", LuaTestOption::ForceBaselineJit);
+    ReleaseAssert(launch(moduleD.get()) == "true\t41\ndead\n");
+
+    // Now that the coroutine is dead, its functions are evicted once they become cold
+    //
+    ReleaseAssert(launch(moduleB.get()) == outputOfModuleB);
+    ReleaseAssert(launch(moduleB.get()) == outputOfModuleB);
+    ReleaseAssert(vm->GetBaselineJitEvictionStatistics().m_numEvictionScans == 6);
+    ReleaseAssert(getBaselineCodeBlock(x_lineOfInner) == nullptr);
+    ReleaseAssert(getBaselineCodeBlock(x_lineOfOuter) == nullptr);
+}
+
+TEST(BaselineJitCallIc, EventLog_1)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+    vm->SetEngineStartingTier(GetVMEngineStartingTierFromEngineTestOption(LuaTestOption::ForceBaselineJit));
+    vm->SetMaxJitCallInlineCacheEntries(2);
+    vm->EnableEventLog();
+    VMOutputInterceptor vmoutput(vm);
+
+    std::unique_ptr<ScriptModule> module = ParseLuaScriptOrFail("luatests/baseline_jit_call_ic_sanity_1.lua", LuaTestOption::ForceBaselineJit);
+    vm->LaunchScript(module.get());
+
+    std::string out = vmoutput.GetAndResetStdOut();
+    std::string err = vmoutput.GetAndResetStdErr();
+    AssertIsExpectedOutput(out);
+    ReleaseAssert(err == "");
+
+    // 'f' is the only function with 2 args
+    //
+    CodeBlock* fCb = nullptr;
+    for (UnlinkedCodeBlock* ucb : module->m_unlinkedCodeBlocks)
+    {
+        if (ucb->m_numFixedArguments == 2)
+        {
+            ReleaseAssert(fCb == nullptr);
+            fCb = ucb->m_defaultCodeBlock;
+            ReleaseAssert(ucb->m_lineDefined == 1);
+        }
+    }
+    ReleaseAssert(fCb != nullptr);
+
+    // Every function is compiled once. The call IC site in 'f' should have cached 'add1' and 'add2' and then became megamorphic.
+    //
+    VMEventLog* log = vm->GetEventLog();
+    ReleaseAssert(log != nullptr);
+    size_t numCompiles = 0;
+    size_t numDirectCallInsertsInF = 0;
+    size_t numMegamorphicInF = 0;
+    std::unordered_set<uint32_t> icSitesInF;
+    uint64_t lastTimestamp = 0;
+    log->ForEachEvent([&](const VMEvent& e) {
+        ReleaseAssert(e.m_timestampNs >= lastTimestamp);
+        lastTimestamp = e.m_timestampNs;
+        if (e.m_kind == VMEventKind::BaselineJitCompile)
+        {
+            ReleaseAssert(e.m_codeBlock != nullptr && e.m_bytecodeOffset == VMEvent::x_unknownBytecodeOffset);
+            numCompiles++;
+        }
+        if (e.m_codeBlock == fCb)
+        {
+            if (e.m_kind == VMEventKind::CallIcInsertDirectCall)
+            {
+                numDirectCallInsertsInF++;
+                ReleaseAssert(e.m_arg == numDirectCallInsertsInF);
+                icSitesInF.insert(e.m_bytecodeOffset);
+            }
+            if (e.m_kind == VMEventKind::CallIcBecameMegamorphic)
+            {
+                numMegamorphicInF++;
+                icSitesInF.insert(e.m_bytecodeOffset);
+            }
+            ReleaseAssert(e.m_kind != VMEventKind::CallIcTransitToClosureCall && e.m_kind != VMEventKind::CallIcInsertClosureCall);
+        }
+    });
+    ReleaseAssert(numCompiles == module->m_unlinkedCodeBlocks.size());
+    ReleaseAssert(numDirectCallInsertsInF == 2);
+    ReleaseAssert(numMegamorphicInF == 1);
+    ReleaseAssert(icSitesInF.size() == 1);
+    ReleaseAssert(*icSitesInF.begin() < fCb->GetBytecodeLength());
+    ReleaseAssert(log->GetNumEventsRecorded() == log->GetNumEventsRetained());
+
+    // Sanity check the dump functions
+    //
+    {
+        char* buf = nullptr;
+        size_t len = 0;
+        FILE* fp = open_memstream(&buf, &len);
+        ReleaseAssert(fp != nullptr);
+        log->PrintSummary(fp);
+        log->PrintEvents(fp);
+        fclose(fp);
+        std::string dump(buf, len);
+        free(buf);
+        ReleaseAssert(dump.find("function at line 1 [") != std::string::npos);
+        ReleaseAssert(dump.find("call IC became megamorphic") != std::string::npos);
+        ReleaseAssert(dump.find("baseline JIT compile") != std::string::npos);
+    }
+
+    // A small log retains only the most recent events
+    //
+    vm->EnableEventLog(4);
+    ReleaseAssert(vm->GetEventLog()->GetNumEventsRecorded() == 0);
+    std::unique_ptr<ScriptModule> module2 = ParseLuaScriptOrFail("luatests/baseline_jit_call_ic_sanity_1.lua", LuaTestOption::ForceBaselineJit);
+    vm->LaunchScript(module2.get());
+    AssertIsExpectedOutput(vmoutput.GetAndResetStdOut());
+    ReleaseAssert(vm->GetEventLog()->GetNumEventsRecorded() > 4);
+    ReleaseAssert(vm->GetEventLog()->GetNumEventsRetained() == 4);
+
+    vm->DisableEventLog();
+    ReleaseAssert(vm->GetEventLog() == nullptr);
+}
+
+TEST(BaselineJitCallIc, VMOptions_1)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+    vm->SetEngineStartingTier(GetVMEngineStartingTierFromEngineTestOption(LuaTestOption::ForceBaselineJit));
+
+    // Invalid options are rejected without changing anything
+    //
+    std::string errMsg;
+    ReleaseAssert(!SetVMOptionsFromString(vm, "no_such_option=1", errMsg /*out*/));
+    ReleaseAssert(!SetVMOptionsFromString(vm, "max_call_ic_entries", errMsg /*out*/));
+    ReleaseAssert(!SetVMOptionsFromString(vm, "max_call_ic_entries=-1", errMsg /*out*/));
+    ReleaseAssert(!SetVMOptionsFromString(vm, "max_call_ic_entries=0x2", errMsg /*out*/));
+    ReleaseAssert(!SetVMOptionsFromString(vm, "max_call_ic_entries=100000", errMsg /*out*/));
+    ReleaseAssert(!SetVMOptionsFromString(vm, "array_growth_factor=1", errMsg /*out*/));
+    ReleaseAssert(vm->GetMaxJitCallInlineCacheEntries() == x_maxJitCallInlineCacheEntries);
+    ReleaseAssert(vm->GetOptions().m_arrayVectorGrowthFactor == ArrayGrowthPolicy::x_vectorGrowthFactor);
+
+    ReleaseAssert(SetVMOptionsFromString(vm, "tier_up_multiplier=7,,inline_budget_root=33,max_call_ic_entries=2", errMsg /*out*/));
+    ReleaseAssert(vm->GetInterpreterTierUpThreshold(10) == 70);
+    ReleaseAssert(vm->GetOptions().m_speculativeInlinerHeuristic.m_inlineBudgetForRootFunction == 33);
+    ReleaseAssert(vm->GetMaxJitCallInlineCacheEntries() == 2);
+
+    VMOutputInterceptor vmoutput(vm);
+
+    std::unique_ptr<ScriptModule> module = ParseLuaScriptOrFail("luatests/baseline_jit_call_ic_sanity_1.lua", LuaTestOption::ForceBaselineJit);
+    vm->LaunchScript(module.get());
+
+    std::string out = vmoutput.GetAndResetStdOut();
+    std::string err = vmoutput.GetAndResetStdErr();
+    AssertIsExpectedOutput(out);
+    ReleaseAssert(err == "");
+
+    // Same as Megamorphic_1, since the call IC entry limit is set to 2 by the options
+    //
+    ReleaseAssert(vm->GetJitCallIcStatistics().m_numSitesBecameMegamorphic == 1);
+    ReleaseAssert(vm->GetJitCallIcStatistics().m_numMegamorphicCalls == 3);
+}
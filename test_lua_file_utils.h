@@ -114,6 +114,14 @@ inline void FreeScriptModuleJITMemory(ScriptModule* module)
     }
 }
 
+// Replace the stack of the root coroutine with a new stack whose stack limit is the given number of slots,
+// so that using more stack results in a 'stack overflow' error
+//
+inline void SetRootCoroutineStackSize(VM* vm, size_t numStackSlots)
+{
+    vm->SetRootCoroutineStackLimit(numStackSlots);
+}
+
 inline void RunSimpleLuaTest(const std::string& filename, LuaTestOption testOption)
 {
     VM* vm = VM::Create();
@@ -40,6 +40,141 @@ TEST(LuaTestTierUpToBaselineJit, Fib)
     RunSimpleLuaTest("luatests/fib.lua", LuaTestOption::UpToBaselineJit);
 }
 
+TEST(LuaTest, LexerFastPaths)
+{
+    RunSimpleLuaTest("luatests/lexer_fast_paths.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaTestForceBaselineJit, LexerFastPaths)
+{
+    RunSimpleLuaTest("luatests/lexer_fast_paths.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaTestTierUpToBaselineJit, LexerFastPaths)
+{
+    RunSimpleLuaTest("luatests/lexer_fast_paths.lua", LuaTestOption::UpToBaselineJit);
+}
+
+TEST(LuaTest, IoLibrary)
+{
+    RunSimpleLuaTest("luatests/io_library.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaTestForceBaselineJit, IoLibrary)
+{
+    RunSimpleLuaTest("luatests/io_library.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaTestTierUpToBaselineJit, IoLibrary)
+{
+    RunSimpleLuaTest("luatests/io_library.lua", LuaTestOption::UpToBaselineJit);
+}
+
+TEST(LuaTest, BufferedOutput)
+{
+    RunSimpleLuaTest("luatests/buffered_output.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaTestForceBaselineJit, BufferedOutput)
+{
+    RunSimpleLuaTest("luatests/buffered_output.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaTestTierUpToBaselineJit, BufferedOutput)
+{
+    RunSimpleLuaTest("luatests/buffered_output.lua", LuaTestOption::UpToBaselineJit);
+}
+
+TEST(LuaTest, UserdataNewproxy)
+{
+    RunSimpleLuaTest("luatests/userdata_newproxy.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaTestForceBaselineJit, UserdataNewproxy)
+{
+    RunSimpleLuaTest("luatests/userdata_newproxy.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaTestTierUpToBaselineJit, UserdataNewproxy)
+{
+    RunSimpleLuaTest("luatests/userdata_newproxy.lua", LuaTestOption::UpToBaselineJit);
+}
+
+TEST(LuaTest, VarargSelect)
+{
+    RunSimpleLuaTest("luatests/vararg_select.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaTestForceBaselineJit, VarargSelect)
+{
+    RunSimpleLuaTest("luatests/vararg_select.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaTestTierUpToBaselineJit, VarargSelect)
+{
+    RunSimpleLuaTest("luatests/vararg_select.lua", LuaTestOption::UpToBaselineJit);
+}
+
+TEST(LuaTest, StackOverflow)
+{
+    RunSimpleLuaTest("luatests/stack_overflow.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaTestForceBaselineJit, StackOverflow)
+{
+    RunSimpleLuaTest("luatests/stack_overflow.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaTestTierUpToBaselineJit, StackOverflow)
+{
+    RunSimpleLuaTest("luatests/stack_overflow.lua", LuaTestOption::UpToBaselineJit);
+}
+
+TEST(LuaTest, StackUncheckedWrites)
+{
+    RunSimpleLuaTest("luatests/stack_unchecked_writes.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaTestForceBaselineJit, StackUncheckedWrites)
+{
+    RunSimpleLuaTest("luatests/stack_unchecked_writes.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaTestTierUpToBaselineJit, StackUncheckedWrites)
+{
+    RunSimpleLuaTest("luatests/stack_unchecked_writes.lua", LuaTestOption::UpToBaselineJit);
+}
+
+TEST(LuaTest, EqualityQuickening)
+{
+    RunSimpleLuaTest("luatests/equality_quickening.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaTestForceBaselineJit, EqualityQuickening)
+{
+    RunSimpleLuaTest("luatests/equality_quickening.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaTestTierUpToBaselineJit, EqualityQuickening)
+{
+    RunSimpleLuaTest("luatests/equality_quickening.lua", LuaTestOption::UpToBaselineJit);
+}
+
+TEST(LuaTest, TableAllocationSiteProfile)
+{
+    RunSimpleLuaTest("luatests/table_alloc_site_presize.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaTestForceBaselineJit, TableAllocationSiteProfile)
+{
+    RunSimpleLuaTest("luatests/table_alloc_site_presize.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaTestTierUpToBaselineJit, TableAllocationSiteProfile)
+{
+    RunSimpleLuaTest("luatests/table_alloc_site_presize.lua", LuaTestOption::UpToBaselineJit);
+}
+
 static void LuaTest_TestPrint_Impl(LuaTestOption testOption)
 {
     VM* vm = VM::Create();
@@ -344,8 +479,7 @@ static void LuaTest_TailCall_Impl(LuaTestOption testOption)
 
     // Manually lower the stack size
     //
-    CoroutineRuntimeContext* rc = vm->GetRootCoroutine();
-    rc->m_stackBegin = new TValue[200];
+    SetRootCoroutineStackSize(vm, 200);
 
     vm->LaunchScript(module.get());
 
@@ -382,8 +516,7 @@ static void LuaTest_VariadicTailCall_1_Impl(LuaTestOption testOption)
 
     // Manually lower the stack size
     //
-    CoroutineRuntimeContext* rc = vm->GetRootCoroutine();
-    rc->m_stackBegin = new TValue[200];
+    SetRootCoroutineStackSize(vm, 200);
 
     vm->LaunchScript(module.get());
 
@@ -420,8 +553,7 @@ static void LuaTest_VariadicTailCall_2_Impl(LuaTestOption testOption)
 
     // Manually lower the stack size
     //
-    CoroutineRuntimeContext* rc = vm->GetRootCoroutine();
-    rc->m_stackBegin = new TValue[200];
+    SetRootCoroutineStackSize(vm, 200);
 
     vm->LaunchScript(module.get());
 
@@ -458,8 +590,7 @@ static void LuaTest_VariadicTailCall_3_Impl(LuaTestOption testOption)
 
     // Manually lower the stack size
     //
-    CoroutineRuntimeContext* rc = vm->GetRootCoroutine();
-    rc->m_stackBegin = new TValue[200];
+    SetRootCoroutineStackSize(vm, 200);
 
     vm->LaunchScript(module.get());
 
@@ -993,8 +1124,7 @@ static void LuaBenchmark_Ack_Impl(LuaTestOption testOption)
 
     // This benchmark needs a larger stack
     //
-    CoroutineRuntimeContext* rc = vm->GetRootCoroutine();
-    rc->m_stackBegin = new TValue[1000000];
+    SetRootCoroutineStackSize(vm, 1000000);
 
     vm->LaunchScript(module.get());
 
@@ -2609,6 +2739,76 @@ TEST(LuaLibTierUpToBaselineJit, coroutine_ring)
     RunSimpleLuaTest("luatests/coroutine_ring.lua", LuaTestOption::UpToBaselineJit);
 }
 
+TEST(LuaLib, coroutine_stack_reuse)
+{
+    RunSimpleLuaTest("luatests/coroutine_stack_reuse.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaLibForceBaselineJit, coroutine_stack_reuse)
+{
+    RunSimpleLuaTest("luatests/coroutine_stack_reuse.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaLibTierUpToBaselineJit, coroutine_stack_reuse)
+{
+    RunSimpleLuaTest("luatests/coroutine_stack_reuse.lua", LuaTestOption::UpToBaselineJit);
+}
+
+TEST(LuaLib, coroutine_abandon)
+{
+    RunSimpleLuaTest("luatests/coroutine_abandon.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaLibForceBaselineJit, coroutine_abandon)
+{
+    RunSimpleLuaTest("luatests/coroutine_abandon.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaLibTierUpToBaselineJit, coroutine_abandon)
+{
+    RunSimpleLuaTest("luatests/coroutine_abandon.lua", LuaTestOption::UpToBaselineJit);
+}
+
+// The 'max_live_coroutines' VM option trades the stack limit of coroutines for a higher cap on the number of live coroutines
+//
+static void LuaLib_coroutine_live_cap_Impl(LuaTestOption testOption)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+    vm->SetEngineStartingTier(GetVMEngineStartingTierFromEngineTestOption(testOption));
+    vm->SetEngineMaxTier(GetVMEngineMaxTierFromEngineTestOption(testOption));
+    VMOutputInterceptor vmoutput(vm);
+
+    ReleaseAssert(vm->GetMaxLiveCoroutines() > 15000 && vm->GetMaxLiveCoroutines() < 17000);
+    std::string errMsg;
+    ReleaseAssert(SetVMOption(vm, "max_live_coroutines", "25000", errMsg /*out*/));
+    ReleaseAssert(vm->GetMaxLiveCoroutines() >= 25000);
+    ReleaseAssert(vm->GetCoroutineStackLimit() < CoroutineRuntimeContext::x_defaultMaxStackSlots);
+
+    std::unique_ptr<ScriptModule> module = ParseLuaScriptOrFail("luatests/coroutine_live_cap.lua", testOption);
+    vm->LaunchScript(module.get());
+
+    std::string out = vmoutput.GetAndResetStdOut();
+    std::string err = vmoutput.GetAndResetStdErr();
+    AssertIsExpectedOutput(out);
+    ReleaseAssert(err == "");
+}
+
+TEST(LuaLib, coroutine_live_cap)
+{
+    LuaLib_coroutine_live_cap_Impl(LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaLibForceBaselineJit, coroutine_live_cap)
+{
+    LuaLib_coroutine_live_cap_Impl(LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaLibTierUpToBaselineJit, coroutine_live_cap)
+{
+    LuaLib_coroutine_live_cap_Impl(LuaTestOption::UpToBaselineJit);
+}
+
 TEST(LuaLib, coroutine_error_1)
 {
     RunSimpleLuaTest("luatests/coroutine_error_1.lua", LuaTestOption::ForceInterpreter);
@@ -3224,6 +3424,21 @@ TEST(LuaLibTierUpToBaselineJit, table_sort_4)
     RunSimpleLuaTest("luatests/table_sort_4.lua", LuaTestOption::UpToBaselineJit);
 }
 
+TEST(LuaLib, table_sort_5)
+{
+    RunSimpleLuaTest("luatests/table_sort_5.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaLibForceBaselineJit, table_sort_5)
+{
+    RunSimpleLuaTest("luatests/table_sort_5.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaLibTierUpToBaselineJit, table_sort_5)
+{
+    RunSimpleLuaTest("luatests/table_sort_5.lua", LuaTestOption::UpToBaselineJit);
+}
+
 TEST(LuaLib, table_lib_concat)
 {
     RunSimpleLuaTest("luatests/table_lib_concat.lua", LuaTestOption::ForceInterpreter);
@@ -3254,6 +3469,21 @@ TEST(LuaLibTierUpToBaselineJit, table_concat_overflow)
     RunSimpleLuaTest("luatests/table_concat_overflow.lua", LuaTestOption::UpToBaselineJit);
 }
 
+TEST(LuaLib, table_concat_number_array)
+{
+    RunSimpleLuaTest("luatests/table_concat_number_array.lua", LuaTestOption::ForceInterpreter);
+}
+
+TEST(LuaLibForceBaselineJit, table_concat_number_array)
+{
+    RunSimpleLuaTest("luatests/table_concat_number_array.lua", LuaTestOption::ForceBaselineJit);
+}
+
+TEST(LuaLibTierUpToBaselineJit, table_concat_number_array)
+{
+    RunSimpleLuaTest("luatests/table_concat_number_array.lua", LuaTestOption::UpToBaselineJit);
+}
+
 TEST(LuaBenchmark, array3d)
 {
     RunSimpleLuaTest("luatests/array3d.lua", LuaTestOption::ForceInterpreter);
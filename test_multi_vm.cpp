@@ -0,0 +1,212 @@
+#include "gtest/gtest.h"
+#include "test_lua_file_utils.h"
+#include "parsed_module_cache.h"
+
+#include <thread>
+
+namespace {
+
+struct MultiVmTestCase
+{
+    const char* m_luaFile;
+    LuaTestOption m_option;
+    // The existing test that has the expected output for this test case
+    //
+    const char* m_expectedOutputSuiteName;
+    const char* m_expectedOutputCaseName;
+};
+
+constexpr MultiVmTestCase x_multiVmTestCases[] = {
+    { "luatests/binary-trees-1.lua", LuaTestOption::ForceInterpreter, "LuaBenchmark", "BinaryTrees_1" },
+    { "luatests/binary-trees-1.lua", LuaTestOption::ForceBaselineJit, "LuaBenchmarkForceBaselineJit", "BinaryTrees_1" },
+    { "luatests/binary-trees-1.lua", LuaTestOption::UpToBaselineJit, "LuaBenchmarkTierUpToBaselineJit", "BinaryTrees_1" },
+    { "luatests/fannkuch-redux.lua", LuaTestOption::ForceBaselineJit, "LuaBenchmarkForceBaselineJit", "Fannkuch_Redux" },
+    { "luatests/coroutine_ring.lua", LuaTestOption::ForceInterpreter, "LuaLib", "coroutine_ring" },
+    { "luatests/coroutine_ring.lua", LuaTestOption::ForceBaselineJit, "LuaLibForceBaselineJit", "coroutine_ring" },
+};
+
+constexpr size_t x_numMultiVmTestCases = std::extent_v<decltype(x_multiVmTestCases)>;
+
+// Test cases that exercise the different kinds of constants in the parsed module cache:
+// strings, closures, template tables, TNEW structures, and modules loaded by loadfile
+//
+constexpr MultiVmTestCase x_parsedModuleCacheTestCases[] = {
+    { "luatests/table_dup.lua", LuaTestOption::ForceInterpreter, "LuaTest", "TestTableDup" },
+    { "luatests/table_dup2.lua", LuaTestOption::ForceBaselineJit, "LuaTestForceBaselineJit", "TestTableDup2" },
+    { "luatests/table_dup3.lua", LuaTestOption::ForceInterpreter, "LuaTest", "TestTableDup3" },
+    { "luatests/json.lua", LuaTestOption::ForceInterpreter, "LuaBenchmark", "json" },
+    { "luatests/deltablue.lua", LuaTestOption::ForceBaselineJit, "LuaBenchmarkForceBaselineJit", "deltablue" },
+    { "luatests/base_loadfile.lua", LuaTestOption::ForceInterpreter, "LuaLib", "base_loadfile" },
+};
+
+// Run one test case in a fresh VM owned by the current thread, and return the output
+//
+std::string RunMultiVmTestCase(const MultiVmTestCase& testCase)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+    ReleaseAssert(VM::GetActiveVMForCurrentThread() == vm);
+    vm->SetEngineStartingTier(GetVMEngineStartingTierFromEngineTestOption(testCase.m_option));
+    vm->SetEngineMaxTier(GetVMEngineMaxTierFromEngineTestOption(testCase.m_option));
+    VMOutputInterceptor vmoutput(vm);
+
+    std::unique_ptr<ScriptModule> module = ParseLuaScriptOrFail(testCase.m_luaFile, testCase.m_option);
+    vm->LaunchScript(module.get());
+
+    std::string err = vmoutput.GetAndResetStdErr();
+    ReleaseAssert(err == "");
+    return vmoutput.GetAndResetStdOut();
+}
+
+// Parse the file in a fresh VM, and return the line where each function is defined, in the order of the UnlinkedCodeBlocks
+//
+std::vector<uint32_t> GetLineDefinedOfAllFunctions(const char* luaFile)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+    std::unique_ptr<ScriptModule> module = ParseLuaScriptOrFail(luaFile, LuaTestOption::ForceInterpreter);
+    std::vector<uint32_t> res;
+    for (UnlinkedCodeBlock* ucb : module->m_unlinkedCodeBlocks)
+    {
+        res.push_back(ucb->m_lineDefined);
+    }
+    return res;
+}
+
+}   // anonymous namespace
+
+// Each thread owns one VM at a time, and all the VMs run concurrently
+//
+TEST(MultiVM, ConcurrentStress)
+{
+    std::vector<std::string> expectedOutputs;
+    for (const MultiVmTestCase& testCase : x_multiVmTestCases)
+    {
+        std::string filename = GetExpectedOutputFileNameForTestCase(testCase.m_expectedOutputSuiteName, testCase.m_expectedOutputCaseName, "" /*suffix*/);
+        expectedOutputs.push_back(LoadFile(filename));
+    }
+
+    constexpr size_t x_numThreads = 8;
+    constexpr size_t x_numIterationsPerThread = 3;
+
+    std::atomic<size_t> numMismatches { 0 };
+    std::vector<std::thread> threads;
+    for (size_t threadOrd = 0; threadOrd < x_numThreads; threadOrd++)
+    {
+        threads.emplace_back([&, threadOrd]()
+        {
+            for (size_t iter = 0; iter < x_numIterationsPerThread; iter++)
+            {
+                size_t caseOrd = (threadOrd + iter) % x_numMultiVmTestCases;
+                std::string out = RunMultiVmTestCase(x_multiVmTestCases[caseOrd]);
+                if (out != expectedOutputs[caseOrd])
+                {
+                    fprintf(stderr, "[MultiVM] Output mismatch for %s in thread %d\n", x_multiVmTestCases[caseOrd].m_luaFile, static_cast<int>(threadOrd));
+                    numMismatches++;
+                }
+            }
+        });
+    }
+    for (std::thread& t : threads)
+    {
+        t.join();
+    }
+    ReleaseAssert(numMismatches.load() == 0);
+}
+
+// A VM may be created on one thread and used on another, as long as only one thread uses it at a time
+//
+TEST(MultiVM, MigrateBetweenThreads)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+    vm->SetEngineStartingTier(VM::EngineStartingTier::BaselineJIT);
+
+    std::unique_ptr<ScriptModule> module = ParseLuaScriptOrFail("luatests/fib.lua", LuaTestOption::ForceBaselineJit);
+    std::string expectedOutput = LoadFile(GetExpectedOutputFileNameForTestCase("LuaTestForceBaselineJit", "Fib", "" /*suffix*/));
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        std::thread t([&]()
+        {
+            vm->SetActiveVMForCurrentThread();
+            VMOutputInterceptor vmoutput(vm);
+            vm->LaunchScript(module.get());
+            ReleaseAssert(vmoutput.GetAndResetStdErr() == "");
+            ReleaseAssert(vmoutput.GetAndResetStdOut() == expectedOutput);
+        });
+        t.join();
+    }
+}
+
+// The VMs share the parsed modules through the process-wide cache, and must behave the same as if each VM parsed the sources itself
+//
+TEST(MultiVM, ParsedModuleCache)
+{
+    ParsedModuleCache::SetEnabled(true);
+    Auto(ParsedModuleCache::SetEnabled(false));
+
+    std::vector<std::string> expectedOutputs;
+    for (const MultiVmTestCase& testCase : x_parsedModuleCacheTestCases)
+    {
+        std::string filename = GetExpectedOutputFileNameForTestCase(testCase.m_expectedOutputSuiteName, testCase.m_expectedOutputCaseName, "" /*suffix*/);
+        expectedOutputs.push_back(LoadFile(filename));
+    }
+
+    // Populate the cache first
+    //
+    for (size_t caseOrd = 0; caseOrd < std::extent_v<decltype(x_parsedModuleCacheTestCases)>; caseOrd++)
+    {
+        ReleaseAssert(RunMultiVmTestCase(x_parsedModuleCacheTestCases[caseOrd]) == expectedOutputs[caseOrd]);
+    }
+
+    ParsedModuleCache::Statistics statsBefore = ParsedModuleCache::Get().GetStatistics();
+    ReleaseAssert(statsBefore.m_numUncacheable == 0);
+
+    constexpr size_t x_numThreads = 4;
+    std::atomic<size_t> numMismatches { 0 };
+    std::vector<std::thread> threads;
+    for (size_t threadOrd = 0; threadOrd < x_numThreads; threadOrd++)
+    {
+        threads.emplace_back([&, threadOrd]()
+        {
+            for (size_t caseOrd = 0; caseOrd < std::extent_v<decltype(x_parsedModuleCacheTestCases)>; caseOrd++)
+            {
+                std::string out = RunMultiVmTestCase(x_parsedModuleCacheTestCases[caseOrd]);
+                if (out != expectedOutputs[caseOrd])
+                {
+                    fprintf(stderr, "[MultiVM] Output mismatch for %s in thread %d\n", x_parsedModuleCacheTestCases[caseOrd].m_luaFile, static_cast<int>(threadOrd));
+                    numMismatches++;
+                }
+            }
+        });
+    }
+    for (std::thread& t : threads)
+    {
+        t.join();
+    }
+    ReleaseAssert(numMismatches.load() == 0);
+
+    // Every parse (including the chunk loaded by loadfile) should have been served by the cache
+    //
+    ParsedModuleCache::Statistics statsAfter = ParsedModuleCache::Get().GetStatistics();
+    ReleaseAssert(statsAfter.m_numMisses == statsBefore.m_numMisses);
+    ReleaseAssert(statsAfter.m_numEntries == statsBefore.m_numEntries);
+    ReleaseAssert(statsAfter.m_numHits >= statsBefore.m_numHits + x_numThreads * std::extent_v<decltype(x_parsedModuleCacheTestCases)>);
+
+    // The function metadata linked from the cache should be the same as if the VM parsed the source itself
+    //
+    {
+        const char* luaFile = x_parsedModuleCacheTestCases[4].m_luaFile;
+        ParsedModuleCache::SetEnabled(false);
+        std::vector<uint32_t> expectedLines = GetLineDefinedOfAllFunctions(luaFile);
+        ParsedModuleCache::SetEnabled(true);
+        ParsedModuleCache::Statistics statsBeforeLink = ParsedModuleCache::Get().GetStatistics();
+        std::vector<uint32_t> lines = GetLineDefinedOfAllFunctions(luaFile);
+        ReleaseAssert(ParsedModuleCache::Get().GetStatistics().m_numHits == statsBeforeLink.m_numHits + 1);
+        ReleaseAssert(lines == expectedLines);
+        // Only the chunk function is defined at line 0
+        //
+        ReleaseAssert(lines.size() > 1 && std::count(lines.begin(), lines.end(), 0U) == 1);
+    }
+}
@@ -424,4 +424,79 @@ TEST(ObjectGetPutById, MissedGetByIdIsUncacheableForCacheableDicitonary)
     }
 }
 
+// Cloning a CacheableDictionary object shares the hash table, which must be copied before either side adds a property
+//
+TEST(ObjectGetPutById, CacheableDictionaryCloneIsCopyOnWrite)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+    const uint32_t numStrings = 600;
+    StringList strings = GetStringList(VM::GetActiveVMForCurrentThread(), numStrings);
+    Structure* initStructure = Structure::CreateInitialStructure(VM::GetActiveVMForCurrentThread(), 8 /*inlineCapacity*/);
+
+    auto putById = [&](HeapPtr<TableObject> obj, uint32_t ord, TValue val)
+    {
+        PutByIdICInfo icInfo;
+        TableObject::PreparePutById(obj, strings[ord], icInfo /*out*/);
+        TableObject::PutById(obj, strings[ord].As<void>(), val, icInfo);
+    };
+    auto getById = [&](HeapPtr<TableObject> obj, uint32_t ord) -> TValue
+    {
+        GetByIdICInfo icInfo;
+        TableObject::PrepareGetById(obj, strings[ord], icInfo /*out*/);
+        return TableObject::GetById(obj, strings[ord].As<void>(), icInfo);
+    };
+
+    const uint32_t numInitProps = 300;
+    HeapPtr<TableObject> obj = TableObject::CreateEmptyTableObject(vm, initStructure, 0 /*initArraySize*/);
+    for (uint32_t i = 0; i < numInitProps; i++)
+    {
+        putById(obj, i, TValue::CreateInt32(static_cast<int32_t>(i)));
+    }
+    ReleaseAssert(TCGet(obj->m_hiddenClass).As<SystemHeapGcObjectHeader>()->m_type == HeapEntityType::CacheableDictionary);
+
+    VM::StructureStatistics statsBeforeClone = vm->GetStructureStatistics();
+    HeapPtr<TableObject> clone = obj->ShallowCloneTableObject(vm);
+    ReleaseAssert(TCGet(clone->m_hiddenClass).As<SystemHeapGcObjectHeader>()->m_type == HeapEntityType::CacheableDictionary);
+    ReleaseAssert(TCGet(clone->m_hiddenClass).As<CacheableDictionary>()->m_hashTable == TCGet(obj->m_hiddenClass).As<CacheableDictionary>()->m_hashTable);
+    ReleaseAssert(vm->GetStructureStatistics().m_numDictionaryHashTablesShared == statsBeforeClone.m_numDictionaryHashTablesShared + 1);
+
+    // Overwriting an existing property does not modify the hash table, so it is still shared
+    //
+    putById(clone, 0, TValue::CreateInt32(12345));
+    ReleaseAssert(TCGet(clone->m_hiddenClass).As<CacheableDictionary>()->m_hashTable == TCGet(obj->m_hiddenClass).As<CacheableDictionary>()->m_hashTable);
+
+    // Adding properties to the clone copies the hash table, and must not affect the original object
+    //
+    for (uint32_t i = numInitProps; i < numStrings; i++)
+    {
+        putById(clone, i, TValue::CreateInt32(static_cast<int32_t>(i + 1000)));
+    }
+    ReleaseAssert(TCGet(clone->m_hiddenClass).As<CacheableDictionary>()->m_hashTable != TCGet(obj->m_hiddenClass).As<CacheableDictionary>()->m_hashTable);
+    ReleaseAssert(vm->GetStructureStatistics().m_numDictionaryHashTablesUnshared == statsBeforeClone.m_numDictionaryHashTablesUnshared + 1);
+
+    for (uint32_t i = 0; i < numStrings; i++)
+    {
+        TValue origVal = getById(obj, i);
+        TValue cloneVal = getById(clone, i);
+        if (i < numInitProps)
+        {
+            ReleaseAssert(origVal.m_value == TValue::CreateInt32(static_cast<int32_t>(i)).m_value);
+            ReleaseAssert(cloneVal.m_value == TValue::CreateInt32(i == 0 ? 12345 : static_cast<int32_t>(i)).m_value);
+        }
+        else
+        {
+            ReleaseAssert(origVal.IsNil());
+            ReleaseAssert(cloneVal.m_value == TValue::CreateInt32(static_cast<int32_t>(i + 1000)).m_value);
+        }
+    }
+
+    // The original object now owns its hash table alone, so adding properties to it does not copy the hash table again
+    //
+    putById(obj, numStrings - 1, TValue::CreateInt32(1));
+    ReleaseAssert(vm->GetStructureStatistics().m_numDictionaryHashTablesUnshared == statsBeforeClone.m_numDictionaryHashTablesUnshared + 1);
+    ReleaseAssert(getById(obj, numStrings - 1).m_value == TValue::CreateInt32(1).m_value);
+    ReleaseAssert(getById(clone, numStrings - 1).m_value == TValue::CreateInt32(static_cast<int32_t>(numStrings - 1 + 1000)).m_value);
+}
+
 }   // anonymous namespace
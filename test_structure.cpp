@@ -611,4 +611,63 @@ TEST(Structure, ArrayTypeTransition)
     DoArrayTypeTransitionTest(400 /*numStrings*/, 1500 /*numNodes*/, 3 /*degreeParam*/);
 }
 
+Structure* AddPropertyForTest(VM* vm, Structure* structure, UserHeapPointer<HeapString> key)
+{
+    Structure::AddNewPropertyResult result;
+    structure->AddNonExistentProperty(vm, key.As<void>(), result);
+    ReleaseAssert(!result.m_shouldTransitionToDictionaryMode);
+    ReleaseAssert(result.m_newStructure != nullptr);
+    return reinterpret_cast<Structure*>(result.m_newStructure);
+}
+
+TEST(Structure, TransitionTableRecycling)
+{
+    VM* vm = VM::Create();
+    Auto(vm->Destroy());
+
+    constexpr size_t numChildren = 100;
+    StringList strings = GetStringList(vm, numChildren + 2);
+    Structure* initStructure = Structure::CreateInitialStructure(vm, 2 /*initialInlineCap*/);
+    Structure* parentA = AddPropertyForTest(vm, initStructure, strings[0]);
+    Structure* parentB = AddPropertyForTest(vm, initStructure, strings[1]);
+
+    // Each transition of parent A adds a Structure, and its transition table is expanded several times
+    //
+    VM::StructureStatistics statsBeforeA = vm->GetStructureStatistics();
+    std::vector<Structure*> childrenA;
+    for (size_t i = 0; i < numChildren; i++)
+    {
+        childrenA.push_back(AddPropertyForTest(vm, parentA, strings[i + 2]));
+    }
+    VM::StructureStatistics statsAfterA = vm->GetStructureStatistics();
+    ReleaseAssert(statsAfterA.m_numStructures == statsBeforeA.m_numStructures + numChildren);
+    ReleaseAssert(statsAfterA.m_structureBytes > statsBeforeA.m_structureBytes);
+    ReleaseAssert(statsAfterA.m_numTransitionTables > statsBeforeA.m_numTransitionTables + 1);
+
+    // The tables replaced by expansions of parent A's table are reused by parent B's table,
+    // so only B's final table needs to be allocated from the system heap
+    //
+    std::vector<Structure*> childrenB;
+    for (size_t i = 0; i < numChildren; i++)
+    {
+        childrenB.push_back(AddPropertyForTest(vm, parentB, strings[i + 2]));
+    }
+    VM::StructureStatistics statsAfterB = vm->GetStructureStatistics();
+    ReleaseAssert(statsAfterB.m_numStructures == statsAfterA.m_numStructures + numChildren);
+    ReleaseAssert(statsAfterB.m_numTransitionTables == statsAfterA.m_numTransitionTables + 1);
+    ReleaseAssert(statsAfterB.m_transitionTableBytesReused > statsAfterA.m_transitionTableBytesReused);
+
+    // The transitions still resolve to the same Structures, without creating new ones
+    //
+    for (size_t i = 0; i < numChildren; i++)
+    {
+        ReleaseAssert(AddPropertyForTest(vm, parentA, strings[i + 2]) == childrenA[i]);
+        ReleaseAssert(AddPropertyForTest(vm, parentB, strings[i + 2]) == childrenB[i]);
+        uint32_t slot;
+        ReleaseAssert(Structure::GetSlotOrdinalFromStringProperty(childrenB[i], strings[i + 2], slot /*out*/));
+        ReleaseAssert(slot == 1);
+    }
+    ReleaseAssert(vm->GetStructureStatistics().m_numStructures == statsAfterB.m_numStructures);
+}
+
 }   // anonymous namespace